@@ -0,0 +1,203 @@
+// DAOBase/ColumnBinding.h
+#ifndef DAOBASE_COLUMNBINDING_H
+#define DAOBASE_COLUMNBINDING_H
+
+#include <string>       // For std::string
+#include <vector>       // For std::vector
+#include <optional>     // For std::optional
+#include <variant>      // For std::variant, std::visit
+#include <functional>   // For std::function (custom column setters)
+#include <chrono>       // For std::chrono::system_clock::time_point
+#include <type_traits>  // For std::is_enum, std::is_base_of
+
+#include "Modules/Database/ResultSet.h" // Typed columnar query results
+#include "BaseDTO.h"     // For BaseDTO fields
+#include "Common.h"      // For ERP::Common::DATETIME_FORMAT, EntityStatus
+#include "DateUtils.h"   // For ERP::Utils::DateUtils::parseDateTime
+
+namespace ERP {
+    namespace DAOBase {
+
+        /**
+         * @brief ColumnBinding maps result-set columns directly onto DTO members.
+         *
+         * A binding is a list of (column name, pointer-to-member) pairs built once per DAO.
+         * materialize() resolves every column name to an index once per ResultSet and then
+         * fills each DTO straight from the typed column buffers, without building an
+         * intermediate std::map<std::string, std::any> per row.
+         *
+         * Usage:
+         * ```cpp
+         * static const ColumnBinding<InventoryDTO> binding = ColumnBinding<InventoryDTO>()
+         *     .bindBaseFields()
+         *     .bind("product_id", &InventoryDTO::productId)
+         *     .bind("quantity", &InventoryDTO::quantity);
+         * std::vector<InventoryDTO> rows = binding.materialize(resultSet);
+         * ```
+         * @tparam T The DTO type.
+         */
+        template <typename T>
+        class ColumnBinding {
+        public:
+            using TimePoint = std::chrono::system_clock::time_point;
+            using Cell = ERP::Database::ResultSet::Cell;
+            using CustomSetter = std::function<void(T&, const Cell&)>;
+
+            ColumnBinding& bind(const std::string& column, std::string T::* member) { return add(column, member); }
+            ColumnBinding& bind(const std::string& column, double T::* member) { return add(column, member); }
+            ColumnBinding& bind(const std::string& column, int T::* member) { return add(column, member); }
+            ColumnBinding& bind(const std::string& column, bool T::* member) { return add(column, member); }
+            ColumnBinding& bind(const std::string& column, TimePoint T::* member) { return add(column, member); }
+            ColumnBinding& bind(const std::string& column, std::optional<std::string> T::* member) { return add(column, member); }
+            ColumnBinding& bind(const std::string& column, std::optional<double> T::* member) { return add(column, member); }
+            ColumnBinding& bind(const std::string& column, std::optional<int> T::* member) { return add(column, member); }
+            ColumnBinding& bind(const std::string& column, std::optional<TimePoint> T::* member) { return add(column, member); }
+
+            /**
+             * @brief Binds an enum member stored as an INTEGER column (the convention used by toMap()).
+             */
+            template <typename E, typename = std::enable_if_t<std::is_enum<E>::value>>
+            ColumnBinding& bindEnum(const std::string& column, E T::* member) {
+                return bindCustom(column, [member](T& dto, const Cell& cell) {
+                    if (const auto* i = std::get_if<long long>(&cell)) {
+                        dto.*member = static_cast<E>(*i);
+                    }
+                });
+            }
+
+            /**
+             * @brief Binds a column through an arbitrary setter (JSON columns, enums stored as text, ...).
+             */
+            ColumnBinding& bindCustom(const std::string& column, CustomSetter setter) {
+                entries_.push_back({column, Member(std::move(setter))});
+                return *this;
+            }
+
+            /**
+             * @brief Binds the common BaseDTO columns (id, status, created_at, updated_at, created_by, updated_by).
+             * Mirrors ERP::Utils::DTOUtils::fromMap.
+             */
+            ColumnBinding& bindBaseFields() {
+                static_assert(std::is_base_of<ERP::DataObjects::BaseDTO, T>::value, "bindBaseFields requires a BaseDTO-derived DTO");
+                bind("id", static_cast<std::string T::*>(&ERP::DataObjects::BaseDTO::id));
+                bindEnum("status", static_cast<ERP::Common::EntityStatus T::*>(&ERP::DataObjects::BaseDTO::status));
+                bind("created_at", static_cast<TimePoint T::*>(&ERP::DataObjects::BaseDTO::createdAt));
+                bind("updated_at", static_cast<std::optional<TimePoint> T::*>(&ERP::DataObjects::BaseDTO::updatedAt));
+                bind("created_by", static_cast<std::optional<std::string> T::*>(&ERP::DataObjects::BaseDTO::createdBy));
+                bind("updated_by", static_cast<std::optional<std::string> T::*>(&ERP::DataObjects::BaseDTO::updatedBy));
+                return *this;
+            }
+
+            /**
+             * @brief Builds one DTO per row of the result set.
+             * Columns missing from the result set are skipped; the DTO keeps its default value.
+             * @param rs The decoded query result.
+             * @return The DTOs in row order.
+             */
+            std::vector<T> materialize(const ERP::Database::ResultSet& rs) const {
+                std::vector<int> indexes = resolve(rs);
+                std::vector<T> results;
+                results.reserve(rs.rowCount());
+                for (std::size_t row = 0; row < rs.rowCount(); ++row) {
+                    results.push_back(materializeRow(rs, row, indexes));
+                }
+                return results;
+            }
+
+            /**
+             * @brief Resolves the column index of every bound member (-1 if the result set lacks the column).
+             * Resolve once and reuse the indexes for every row of results with the same columns.
+             */
+            std::vector<int> resolve(const ERP::Database::ResultSet& rs) const {
+                std::vector<int> indexes;
+                indexes.reserve(entries_.size());
+                for (const auto& entry : entries_) {
+                    indexes.push_back(rs.columnIndex(entry.column));
+                }
+                return indexes;
+            }
+
+            /**
+             * @brief Builds the DTO of a single row using indexes obtained from resolve().
+             */
+            T materializeRow(const ERP::Database::ResultSet& rs, std::size_t row, const std::vector<int>& indexes) const {
+                T dto;
+                for (std::size_t e = 0; e < entries_.size(); ++e) {
+                    if (indexes[e] >= 0) {
+                        assign(dto, entries_[e].member, rs.cell(row, static_cast<std::size_t>(indexes[e])));
+                    }
+                }
+                return dto;
+            }
+
+        private:
+            using Member = std::variant<
+                std::string T::*, double T::*, int T::*, bool T::*, TimePoint T::*,
+                std::optional<std::string> T::*, std::optional<double> T::*, std::optional<int> T::*,
+                std::optional<TimePoint> T::*, CustomSetter>;
+
+            struct Entry {
+                std::string column;
+                Member member;
+            };
+
+            std::vector<Entry> entries_;
+
+            template <typename M>
+            ColumnBinding& add(const std::string& column, M member) {
+                entries_.push_back({column, Member(member)});
+                return *this;
+            }
+
+            static std::optional<TimePoint> toTime(const Cell& cell) {
+                if (const auto* s = std::get_if<std::string>(&cell)) {
+                    return ERP::Utils::DateUtils::parseDateTime(*s, ERP::Common::DATETIME_FORMAT);
+                }
+                return std::nullopt;
+            }
+
+            static std::optional<double> toDouble(const Cell& cell) {
+                if (const auto* d = std::get_if<double>(&cell)) return *d;
+                if (const auto* i = std::get_if<long long>(&cell)) return static_cast<double>(*i);
+                return std::nullopt;
+            }
+
+            static std::optional<std::string> toString(const Cell& cell) {
+                if (const auto* s = std::get_if<std::string>(&cell)) return *s;
+                if (const auto* i = std::get_if<long long>(&cell)) return std::to_string(*i);
+                return std::nullopt;
+            }
+
+            static void assign(T& dto, const Member& member, const Cell& cell) {
+                std::visit([&dto, &cell](const auto& m) {
+                    using M = std::decay_t<decltype(m)>;
+                    if constexpr (std::is_same_v<M, CustomSetter>) {
+                        m(dto, cell);
+                    } else if constexpr (std::is_same_v<M, std::string T::*>) {
+                        if (auto v = toString(cell)) dto.*m = std::move(*v);
+                    } else if constexpr (std::is_same_v<M, double T::*>) {
+                        if (auto v = toDouble(cell)) dto.*m = *v;
+                    } else if constexpr (std::is_same_v<M, int T::*>) {
+                        if (auto v = toDouble(cell)) dto.*m = static_cast<int>(*v);
+                    } else if constexpr (std::is_same_v<M, bool T::*>) {
+                        if (const auto* i = std::get_if<long long>(&cell)) dto.*m = (*i != 0);
+                        else if (const auto* s = std::get_if<std::string>(&cell)) dto.*m = (*s == "1" || *s == "true");
+                    } else if constexpr (std::is_same_v<M, TimePoint T::*>) {
+                        if (auto v = toTime(cell)) dto.*m = *v;
+                    } else if constexpr (std::is_same_v<M, std::optional<std::string> T::*>) {
+                        dto.*m = toString(cell);
+                    } else if constexpr (std::is_same_v<M, std::optional<double> T::*>) {
+                        dto.*m = toDouble(cell);
+                    } else if constexpr (std::is_same_v<M, std::optional<int> T::*>) {
+                        auto v = toDouble(cell);
+                        dto.*m = v ? std::optional<int>(static_cast<int>(*v)) : std::nullopt;
+                    } else if constexpr (std::is_same_v<M, std::optional<TimePoint> T::*>) {
+                        dto.*m = toTime(cell);
+                    }
+                }, member);
+            }
+        };
+
+    } // namespace DAOBase
+} // namespace ERP
+#endif // DAOBASE_COLUMNBINDING_H
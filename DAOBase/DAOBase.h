@@ -10,15 +10,21 @@
 #include <functional>   // For std::function
 #include <sstream>      // For stringstream in generic CRUD
 #include <stdexcept>    // For std::runtime_error in generic CRUD
+#include <algorithm>    // For std::min, std::find
+#include <iterator>     // For std::back_inserter
 
 // Include the ConnectionPool header
 #include "Modules/Database/ConnectionPool.h" // Đã thêm Modules/Database để đường dẫn tuyệt đối hơn
 #include "Modules/Database/DBConnection.h"    // Đã thêm Modules/Database để đường dẫn tuyệt đối hơn
+#include "Modules/Database/UnitOfWork.h"      // For the connection bound to the current transaction
 #include "Logger.h"         // For logging
 #include "ErrorHandler.h"   // For error handling
 #include "Common.h"         // For ErrorCode
 #include "AutoRelease.h"    // For AutoRelease
 #include "DAOHelpers.h"     // For DAOHelpers (getPlainValue, putOptionalString etc.)
+#include "ColumnBinding.h"  // For typed ResultSet -> DTO decoding
+#include "Paging.h"         // For PageRequest, Page
+#include "QueryFilter.h"    // For QueryFilter, CompiledFilter
 
 namespace ERP {
     namespace DAOBase {
@@ -44,10 +50,10 @@ namespace ERP {
             explicit DAOBase(std::shared_ptr<ERP::Database::ConnectionPool> connectionPool, const std::string& tableName)
                 : connectionPool_(connectionPool), tableName_(tableName) {
                 if (!connectionPool_) {
-                    ERP::Logger::Logger::getInstance().critical("DAOBase", "Initialized with null ConnectionPool.");
+                    ERP::Logger::Logger::getInstance().critical("Initialized with null ConnectionPool.", "DAOBase");
                     throw std::runtime_error("DAOBase: ConnectionPool is null.");
                 }
-                ERP::Logger::Logger::getInstance().debug("DAOBase: Initialized for table " + tableName_ + ".");
+                ERP_LOG_DEBUG("DAOBase: Initialized for table " + tableName_ + ".");
             }
 
             /**
@@ -71,13 +77,21 @@ namespace ERP {
              */
             virtual T fromMap(const std::map<std::string, std::any>& data) const = 0;
 
+            /**
+             * @brief Optional typed column binding for this DAO's DTO.
+             * DAOs that return a binding are decoded straight from the typed ResultSet in get(),
+             * skipping the per-row std::map and fromMap(). The default keeps the map path.
+             * @return A pointer to a binding that outlives the DAO (usually a function-local static), or nullptr.
+             */
+            virtual const ColumnBinding<T>* columnBinding() const { return nullptr; }
+
             /**
              * @brief Creates a new record in the database.
              * @param dto The DTO containing data for the new record.
              * @return true if the record was created successfully, false otherwise.
              */
             bool create(const T& dto) {
-                ERP::Logger::Logger::getInstance().info("DAOBase: Attempting to create a new record in " + tableName_ + ".");
+                ERP_LOG_DEBUG("DAOBase: Attempting to create a new record in " + tableName_ + ".");
                 std::map<std::string, std::any> data = toMap(dto);
                 if (data.empty()) {
                     ERP::Logger::Logger::getInstance().warning("DAOBase: Create operation called with empty data for table " + tableName_ + ".");
@@ -96,7 +110,7 @@ namespace ERP {
                         placeholders += ", ";
                     }
                     columns += pair.first;
-                    placeholders += "?";
+                    placeholders += ":" + pair.first;
                     params[pair.first] = pair.second;
                     first = false;
                 }
@@ -110,31 +124,106 @@ namespace ERP {
                 );
             }
 
+            /**
+             * @brief Creates many records with multi-row INSERT statements, as many rows per statement as
+             * fit under MAX_BIND_PARAMETERS. Call it inside a unit of work to make the whole batch atomic.
+             * @param dtos The DTOs to insert; toMap must give every one the same columns (a batch that
+             * mixes column sets is rejected, since a missing column would be written as NULL instead of
+             * taking its default).
+             * @return true if every record was created, false otherwise.
+             */
+            bool createMany(const std::vector<T>& dtos) {
+                if (dtos.empty()) {
+                    return true;
+                }
+                ERP_LOG_DEBUG("DAOBase: Attempting to create " + std::to_string(dtos.size()) + " records in " + tableName_ + ".");
+                std::vector<std::map<std::string, std::any>> rows;
+                rows.reserve(dtos.size());
+                for (const T& dto : dtos) {
+                    rows.push_back(toMap(dto));
+                }
+                std::vector<std::string> columnNames;
+                for (const auto& pair : rows.front()) {
+                    columnNames.push_back(pair.first);
+                }
+                if (columnNames.empty()) {
+                    ERP::Logger::Logger::getInstance().warning("DAOBase: CreateMany operation called with empty data for table " + tableName_ + ".");
+                    ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::InvalidInput, "DAOBase: CreateMany operation called with empty data.", "DAOBase");
+                    return false;
+                }
+                for (std::size_t r = 1; r < rows.size(); ++r) {
+                    bool sameColumns = rows[r].size() == columnNames.size();
+                    std::size_t c = 0;
+                    for (auto it = rows[r].begin(); sameColumns && it != rows[r].end(); ++it, ++c) {
+                        sameColumns = it->first == columnNames[c]; // Both in map key order
+                    }
+                    if (!sameColumns) {
+                        ERP::Logger::Logger::getInstance().warning("DAOBase: CreateMany rows for table " + tableName_ + " do not share one column set (row " + std::to_string(r) + ").");
+                        ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::InvalidInput, "DAOBase: CreateMany rows have different column sets.", "DAOBase");
+                        return false;
+                    }
+                }
+
+                std::string columns;
+                for (std::size_t c = 0; c < columnNames.size(); ++c) {
+                    columns += (c == 0 ? "" : ", ") + columnNames[c];
+                }
+                const std::size_t rowsPerStatement = std::max<std::size_t>(1, MAX_BIND_PARAMETERS / columnNames.size());
+                for (std::size_t offset = 0; offset < rows.size(); offset += rowsPerStatement) {
+                    const std::size_t end = std::min(offset + rowsPerStatement, rows.size());
+                    std::string values;
+                    std::map<std::string, std::any> params;
+                    for (std::size_t r = offset; r < end; ++r) {
+                        const std::string suffix = "_" + std::to_string(r - offset);
+                        values += (r == offset ? "(" : ", (");
+                        for (std::size_t c = 0; c < columnNames.size(); ++c) {
+                            values += (c == 0 ? ":" : ", :") + columnNames[c] + suffix;
+                            params[columnNames[c] + suffix] = rows[r].at(columnNames[c]);
+                        }
+                        values += ")";
+                    }
+                    std::string sql = "INSERT INTO " + tableName_ + " (" + columns + ") VALUES " + values + ";";
+                    if (!executeDbOperation(
+                            [](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
+                                return conn->execute(sql_l, p_l);
+                            },
+                            tableName_, "createMany", sql, params)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
             /**
              * @brief Reads records from the database based on a filter.
-             * @param filter A map representing the filter conditions.
+             * @param filter A map representing the filter conditions (range suffixes such as _ge are honored, see QueryFilter::fromMap).
              * @return A vector of DTOs, where each element represents a record.
              */
             std::vector<T> get(const std::map<std::string, std::any>& filter = {}) {
-                ERP::Logger::Logger::getInstance().info("DAOBase: Attempting to retrieve records from " + tableName_ + ".");
+                return find(QueryFilter::fromMap(filter));
+            }
+
+            /**
+             * @brief Reads records matching a typed filter (ranges, IN lists, prefixes, null checks, order, limit).
+             * @param filter The filter; every value is bound as a parameter.
+             * @return A vector of DTOs, or an empty vector if the filter is invalid.
+             */
+            std::vector<T> find(const QueryFilter& filter) {
+                ERP_LOG_DEBUG("DAOBase: Attempting to retrieve records from " + tableName_ + ".");
+                CompiledFilter compiled = compileFilter(filter);
+                if (!compiled.valid) {
+                    return {};
+                }
                 // Note: SELECT * is used for simplicity. In production, list columns explicitly.
-                std::string sql = "SELECT * FROM " + tableName_;
-                std::string whereClause;
-                std::map<std::string, std::any> params;
+                std::string sql = "SELECT * FROM " + tableName_ + compiled.whereClause() + compiled.orderClause + compiled.limitClause + ";";
+                const std::map<std::string, std::any>& params = compiled.params;
 
-                if (!filter.empty()) {
-                    whereClause = " WHERE ";
-                    bool first = true;
-                    for (const auto& pair : filter) {
-                        if (!first) {
-                            whereClause += " AND ";
-                        }
-                        whereClause += pair.first + " = ?"; // Basic equality filter
-                        params[pair.first] = pair.second;
-                        first = false;
-                    }
+                if (const ColumnBinding<T>* binding = columnBinding()) {
+                    ERP::Database::ResultSet resultSet = queryResultSetDbOperation(tableName_, "get", sql, params);
+                    std::vector<T> resultsDto = binding->materialize(resultSet);
+                    ERP_LOG_DEBUG("DAOBase: Retrieved " + std::to_string(resultsDto.size()) + " records from " + tableName_ + ".");
+                    return resultsDto;
                 }
-                sql += whereClause + ";";
 
                 std::vector<std::map<std::string, std::any>> resultsMap = queryDbOperation(
                     [](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
@@ -147,17 +236,132 @@ namespace ERP {
                 for (const auto& rowMap : resultsMap) {
                     resultsDto.push_back(fromMap(rowMap)); // Gọi phương thức ảo của lớp con
                 }
-                ERP::Logger::Logger::getInstance().info("DAOBase: Retrieved " + std::to_string(resultsDto.size()) + " records from " + tableName_ + ".");
+                ERP_LOG_DEBUG("DAOBase: Retrieved " + std::to_string(resultsDto.size()) + " records from " + tableName_ + ".");
                 return resultsDto;
             }
 
+            /**
+             * @brief Reads the records with the given ids, one id IN (...) query per MAX_BIND_PARAMETERS ids.
+             * @param ids The ids; duplicates are read once.
+             * @return The records found, in no particular order; ids without a record are skipped.
+             */
+            std::vector<T> findByIds(const std::vector<std::string>& ids) {
+                std::vector<std::string> distinctIds = ids;
+                std::sort(distinctIds.begin(), distinctIds.end());
+                distinctIds.erase(std::unique(distinctIds.begin(), distinctIds.end()), distinctIds.end());
+                std::vector<T> results;
+                results.reserve(distinctIds.size());
+                for (std::size_t offset = 0; offset < distinctIds.size(); offset += MAX_BIND_PARAMETERS) {
+                    const std::size_t end = std::min(offset + MAX_BIND_PARAMETERS, distinctIds.size());
+                    QueryFilter filter;
+                    filter.in("id", std::vector<std::string>(distinctIds.begin() + offset, distinctIds.begin() + end));
+                    std::vector<T> chunk = find(filter);
+                    std::move(chunk.begin(), chunk.end(), std::back_inserter(results));
+                }
+                return results;
+            }
+
+            /**
+             * @brief Reads one page of records in (created_at, id) order using keyset pagination.
+             * Uses an index range on (created_at, id) rather than OFFSET, so deep pages cost the same as the first.
+             * @param filter Filter conditions (legacy map, see QueryFilter::fromMap).
+             * @param request Page size, cursor, direction and column projection.
+             * @return The page. Columns left out of the projection keep their DTO defaults.
+             */
+            Page<T> getPage(const std::map<std::string, std::any>& filter, const PageRequest& request) {
+                return getPage(QueryFilter::fromMap(filter), request);
+            }
+
+            /**
+             * @brief Reads one page of records matching a typed filter. The filter's own order and limit are ignored.
+             */
+            Page<T> getPage(const QueryFilter& filter, const PageRequest& request) {
+                ERP_LOG_DEBUG("DAOBase: Retrieving a page of up to " + std::to_string(request.pageSize) + " records from " + tableName_ + ".");
+                Page<T> page;
+                std::string selectList = buildSelectList(request.columns);
+                CompiledFilter compiled = compileFilter(filter);
+                if (selectList.empty() || request.pageSize == 0 || !compiled.valid) {
+                    return page;
+                }
+
+                std::map<std::string, std::any>& params = compiled.params;
+                if (request.afterCreatedAt && request.afterId) {
+                    compiled.conditions.push_back(std::string("(created_at, id) ") + (request.descending ? "<" : ">") + " (:page_after_created_at, :page_after_id)");
+                    params["page_after_created_at"] = *request.afterCreatedAt;
+                    params["page_after_id"] = *request.afterId;
+                }
+                const std::string direction = request.descending ? " DESC" : " ASC";
+                std::string sql = "SELECT " + selectList + " FROM " + tableName_ + compiled.whereClause() +
+                                  " ORDER BY created_at" + direction + ", id" + direction + " LIMIT :page_limit;";
+                params["page_limit"] = static_cast<long long>(request.pageSize) + 1; // One extra row tells whether another page follows
+
+                ERP::Database::ResultSet resultSet = queryResultSetDbOperation(tableName_, "getPage", sql, params);
+                std::size_t rows = std::min(resultSet.rowCount(), request.pageSize);
+                page.hasMore = resultSet.rowCount() > request.pageSize;
+                page.items.reserve(rows);
+                decodeRows(resultSet, rows, page.items);
+                if (rows > 0) {
+                    int createdAtIndex = resultSet.columnIndex("created_at");
+                    int idIndex = resultSet.columnIndex("id");
+                    if (createdAtIndex >= 0 && idIndex >= 0) {
+                        page.lastCreatedAt = resultSet.getString(rows - 1, static_cast<std::size_t>(createdAtIndex));
+                        page.lastId = resultSet.getString(rows - 1, static_cast<std::size_t>(idIndex));
+                    }
+                }
+                return page;
+            }
+
+            /**
+             * @brief Streams matching records to a visitor one row at a time, without building a vector.
+             * The read connection is held until the visitor has seen the last row or stops, so keep the visitor short.
+             * @param filter Filter conditions (legacy map, see QueryFilter::fromMap).
+             * @param visitor Called once per record; return false to stop early.
+             * @param columns Columns to select; empty selects all.
+             * @return The number of records handed to the visitor.
+             */
+            std::size_t forEach(const std::map<std::string, std::any>& filter, const std::function<bool(const T&)>& visitor,
+                                const std::vector<std::string>& columns = {}) {
+                return forEach(QueryFilter::fromMap(filter), visitor, columns);
+            }
+
+            /**
+             * @brief Streams records matching a typed filter, in the filter's order and up to its limit.
+             */
+            std::size_t forEach(const QueryFilter& filter, const std::function<bool(const T&)>& visitor,
+                                const std::vector<std::string>& columns = {}) {
+                ERP_LOG_DEBUG("DAOBase: Streaming records from " + tableName_ + ".");
+                std::string selectList = buildSelectList(columns);
+                CompiledFilter compiled = compileFilter(filter);
+                if (selectList.empty() || !compiled.valid) {
+                    return 0;
+                }
+                const std::map<std::string, std::any>& params = compiled.params;
+                std::string sql = "SELECT " + selectList + " FROM " + tableName_ + compiled.whereClause() + compiled.orderClause + compiled.limitClause + ";";
+
+                const ColumnBinding<T>* binding = columnBinding();
+                std::vector<int> indexes; // Resolved on the first row; every row has the same columns
+                std::size_t visited = 0;
+                streamDbOperation(tableName_, "forEach", sql, params, [&](const ERP::Database::ResultSet& row) {
+                    ++visited;
+                    if (binding) {
+                        if (indexes.empty()) {
+                            indexes = binding->resolve(row);
+                        }
+                        return visitor(binding->materializeRow(row, 0, indexes));
+                    }
+                    return visitor(fromMap(row.rowToMap(0)));
+                });
+                ERP_LOG_DEBUG("DAOBase: Streamed " + std::to_string(visited) + " records from " + tableName_ + ".");
+                return visited;
+            }
+
             /**
              * @brief Updates existing records in the database.
              * @param dto The DTO containing updated data (must have 'id' field set).
              * @return true if the records were updated successfully, false otherwise.
              */
             bool update(const T& dto) {
-                ERP::Logger::Logger::getInstance().info("DAOBase: Attempting to update record in " + tableName_ + " with ID: " + dto.id + ".");
+                ERP_LOG_DEBUG("DAOBase: Attempting to update record in " + tableName_ + " with ID: " + dto.id + ".");
                 std::map<std::string, std::any> data = toMap(dto);
                 if (data.empty() || data.find("id") == data.end() || ERP::DAOHelpers::getPlainValue<std::string>(data, "id", std::string()).empty()) {
                     ERP::Logger::Logger::getInstance().warning("DAOBase: Update operation called with empty data or missing ID for table " + tableName_ + ".");
@@ -172,12 +376,12 @@ namespace ERP {
                 for (const auto& pair : data) {
                     if (pair.first == "id") continue; // Don't update the ID in SET clause
                     if (!firstSet) setClause += ", ";
-                    setClause += pair.first + " = ?";
+                    setClause += pair.first + " = :" + pair.first;
                     params[pair.first] = pair.second;
                     firstSet = false;
                 }
 
-                std::string sql = "UPDATE " + tableName_ + " SET " + setClause + " WHERE id = ?;";
+                std::string sql = "UPDATE " + tableName_ + " SET " + setClause + " WHERE id = :id_filter;";
                 params["id_filter"] = dto.id; // Add ID for WHERE clause
 
                 return executeDbOperation(
@@ -194,10 +398,10 @@ namespace ERP {
              * @return true if the record was deleted successfully, false otherwise.
              */
             bool remove(const std::string& id) {
-                ERP::Logger::Logger::getInstance().info("DAOBase: Attempting to remove record from " + tableName_ + " with ID: " + id + ".");
+                ERP_LOG_DEBUG("DAOBase: Attempting to remove record from " + tableName_ + " with ID: " + id + ".");
                 std::map<std::string, std::any> filter;
                 filter["id"] = id;
-                std::string sql = "DELETE FROM " + tableName_ + " WHERE id = ?;";
+                std::string sql = "DELETE FROM " + tableName_ + " WHERE id = :id;";
                 return executeDbOperation(
                     [](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
                         return conn->execute(sql_l, p_l);
@@ -212,14 +416,14 @@ namespace ERP {
              * @return An optional DTO representing the record, or std::nullopt if not found.
              */
             std::optional<T> getById(const std::string& id) {
-                ERP::Logger::Logger::getInstance().info("DAOBase: Attempting to get record from " + tableName_ + " by ID: " + id + ".");
+                ERP_LOG_DEBUG("DAOBase: Attempting to get record from " + tableName_ + " by ID: " + id + ".");
                 std::map<std::string, std::any> filter;
                 filter["id"] = id;
                 const auto results = get(filter); // Calls generic get() which uses fromMap()
                 if (!results.empty()) {
                     return results.front();
                 }
-                ERP::Logger::Logger::getInstance().debug("DAOBase: Record with ID " + id + " not found in " + tableName_ + ".");
+                ERP_LOG_DEBUG("DAOBase: Record with ID " + id + " not found in " + tableName_ + ".");
                 return std::nullopt;
             }
 
@@ -229,24 +433,22 @@ namespace ERP {
              * @return The number of matching records.
              */
             int count(const std::map<std::string, std::any>& filter = {}) {
-                ERP::Logger::Logger::getInstance().info("DAOBase: Counting records in " + tableName_ + ".");
-                std::string sql = "SELECT COUNT(*) FROM " + tableName_;
-                std::string whereClause;
-                std::map<std::string, std::any> params;
+                return countWhere(QueryFilter::fromMap(filter));
+            }
 
-                if (!filter.empty()) {
-                    whereClause = " WHERE ";
-                    bool first = true;
-                    for (const auto& pair : filter) {
-                        if (!first) {
-                            whereClause += " AND ";
-                        }
-                        whereClause += pair.first + " = ?";
-                        params[pair.first] = pair.second;
-                        first = false;
-                    }
+            /**
+             * @brief Counts the records matching a typed filter. The filter's order and limit are ignored.
+             * @param filter The filter.
+             * @return The number of matching records, 0 if the filter is invalid.
+             */
+            int countWhere(const QueryFilter& filter) {
+                ERP_LOG_DEBUG("DAOBase: Counting records in " + tableName_ + ".");
+                CompiledFilter compiled = compileFilter(filter);
+                if (!compiled.valid) {
+                    return 0;
                 }
-                sql += whereClause + ";";
+                std::string sql = "SELECT COUNT(*) FROM " + tableName_ + compiled.whereClause() + ";";
+                const std::map<std::string, std::any>& params = compiled.params;
 
                 std::vector<std::map<std::string, std::any>> results = queryDbOperation(
                     [](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
@@ -269,15 +471,85 @@ namespace ERP {
             std::shared_ptr<ERP::Database::ConnectionPool> connectionPool_;
             std::string tableName_;
 
+            static constexpr std::size_t MAX_BIND_PARAMETERS = 999; // SQLite's default limit before 3.32
+
+            /**
+             * @brief Checks that a column name is a plain SQL identifier, so it can be spliced into SQL.
+             */
+            static bool isSafeIdentifier(const std::string& name) {
+                return QueryFilter::isIdentifier(name);
+            }
+
+            /**
+             * @brief Builds the SELECT list of a projection. id and created_at are always included (paging cursor).
+             * @param columns Requested columns; empty selects all.
+             * @return The select list, or an empty string if a column name is invalid.
+             */
+            std::string buildSelectList(const std::vector<std::string>& columns) const {
+                if (columns.empty()) {
+                    return "*";
+                }
+                std::vector<std::string> selected = columns;
+                for (const char* required : {"id", "created_at"}) {
+                    if (std::find(selected.begin(), selected.end(), required) == selected.end()) {
+                        selected.push_back(required);
+                    }
+                }
+                std::string selectList;
+                for (const auto& column : selected) {
+                    if (!isSafeIdentifier(column)) {
+                        ERP::Logger::Logger::getInstance().error("Invalid column name in projection for " + tableName_ + ": " + column, "DAOBase");
+                        ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::InvalidInput, "DAOBase: Invalid column name in projection: " + column, "DAOBase");
+                        return std::string();
+                    }
+                    selectList += (selectList.empty() ? "" : ", ") + column;
+                }
+                return selectList;
+            }
+
+            /**
+             * @brief Compiles a filter, logging and reporting an invalid column name.
+             */
+            CompiledFilter compileFilter(const QueryFilter& filter) const {
+                CompiledFilter compiled = filter.compile();
+                if (!compiled.valid) {
+                    ERP::Logger::Logger::getInstance().error("Invalid filter for " + tableName_ + ": " + compiled.error, "DAOBase");
+                    ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::InvalidInput, "DAOBase: " + compiled.error, "DAOBase");
+                }
+                return compiled;
+            }
+
+            /**
+             * @brief Decodes the first rowCount rows of a result set into DTOs, through the column binding if there is one.
+             */
+            void decodeRows(const ERP::Database::ResultSet& resultSet, std::size_t rowCount, std::vector<T>& out) const {
+                if (const ColumnBinding<T>* binding = columnBinding()) {
+                    std::vector<int> indexes = binding->resolve(resultSet);
+                    for (std::size_t row = 0; row < rowCount; ++row) {
+                        out.push_back(binding->materializeRow(resultSet, row, indexes));
+                    }
+                    return;
+                }
+                for (std::size_t row = 0; row < rowCount; ++row) {
+                    out.push_back(fromMap(resultSet.rowToMap(row)));
+                }
+            }
+
             /**
              * @brief Helper method to acquire a database connection from the pool.
+             * Inside a UnitOfWork the connection bound to the thread is returned for any intent,
+             * so the statement joins the open transaction and sees its uncommitted writes.
+             * @param intent Write for modifications, Read for selects (served by a reader in split mode).
              * @return A shared pointer to an active DBConnection.
              */
-            std::shared_ptr<ERP::Database::DBConnection> acquireConnection() {
+            std::shared_ptr<ERP::Database::DBConnection> acquireConnection(ERP::Database::ConnectionIntent intent = ERP::Database::ConnectionIntent::Write) {
+                if (std::shared_ptr<ERP::Database::DBConnection> unitOfWorkConn = ERP::Database::UnitOfWork::current()) {
+                    return unitOfWorkConn;
+                }
                 // Lấy instance của ConnectionPool và yêu cầu một kết nối
-                std::shared_ptr<ERP::Database::DBConnection> conn = connectionPool_->getConnection();
+                std::shared_ptr<ERP::Database::DBConnection> conn = connectionPool_->getConnection(intent);
                 if (!conn) {
-                    ERP::Logger::Logger::getInstance().critical("DAOBase", "Failed to acquire database connection from pool.");
+                    ERP::Logger::Logger::getInstance().critical("Failed to acquire database connection from pool.", "DAOBase");
                     ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "DAOBase: Failed to acquire database connection.", "Không thể lấy kết nối cơ sở dữ liệu từ pool.");
                 }
                 return conn;
@@ -285,13 +557,17 @@ namespace ERP {
 
             /**
              * @brief Helper method to release a database connection back to the pool.
+             * The connection of the thread's UnitOfWork stays checked out; the UnitOfWork releases it.
              * @param connection The connection to release.
              */
             void releaseConnection(std::shared_ptr<ERP::Database::DBConnection> connection) {
+                if (connection && connection == ERP::Database::UnitOfWork::current()) {
+                    return;
+                }
                 if (connection) {
                     connectionPool_->releaseConnection(connection);
                 } else {
-                    ERP::Logger::Logger::getInstance().warning("DAOBase", "Attempted to release a null database connection.");
+                    ERP::Logger::Logger::getInstance().warning("Attempted to release a null database connection.", "DAOBase");
                 }
             }
 
@@ -312,21 +588,21 @@ namespace ERP {
                 std::shared_ptr<ERP::Database::DBConnection> conn = acquireConnection();
                 ERP::Utils::AutoRelease releaseGuard([&]() { releaseConnection(conn); }); // Use AutoRelease to ensure connection is released
                 if (!conn) {
-                    ERP::Logger::Logger::getInstance().error(daoName, "Failed to acquire database connection for " + operationName + " operation.");
+                    ERP::Logger::Logger::getInstance().error("Failed to acquire database connection for " + operationName + " operation.", daoName);
                     ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::DatabaseError, daoName + ": Failed to acquire connection.", daoName);
                     return false;
                 }
                 try {
                     bool success = operation_lambda(conn, sql, params);
                     if (success) {
-                        ERP::Logger::Logger::getInstance().info(daoName, operationName + " operation completed successfully.");
+                        ERP_LOG_DEBUG(operationName + " operation completed successfully.", daoName);
                     } else {
-                        ERP::Logger::Logger::getInstance().error(daoName, "Failed to complete " + operationName + " operation. SQL: " + sql);
+                        ERP::Logger::Logger::getInstance().error("Failed to complete " + operationName + " operation. SQL: " + sql, daoName);
                         ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::DatabaseError, daoName + ": Failed to " + operationName + ". SQL: " + sql, daoName);
                     }
                     return success;
                 } catch (const std::exception& e) {
-                    ERP::Logger::Logger::getInstance().error(daoName, "Exception during " + operationName + " operation: " + std::string(e.what()));
+                    ERP::Logger::Logger::getInstance().error("Exception during " + operationName + " operation: " + std::string(e.what()), daoName);
                     ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::DatabaseError, daoName + ": Exception during " + operationName + ": " + std::string(e.what()), daoName);
                     return false;
                 }
@@ -334,6 +610,7 @@ namespace ERP {
 
             /**
              * @brief Generic helper for querying database operations (select).
+             * Runs on a read connection; the lambda must not modify the database.
              * This function manages connection acquisition and release via AutoRelease,
              * and handles common logging and error reporting.
              * @param operation_lambda A lambda representing the specific database query operation (e.g., conn->query).
@@ -346,23 +623,81 @@ namespace ERP {
             std::vector<std::map<std::string, std::any>> queryDbOperation(
                 std::function<std::vector<std::map<std::string, std::any>>(std::shared_ptr<ERP::Database::DBConnection>, const std::string&, const std::map<std::string, std::any>&)> operation_lambda,
                 const std::string& daoName, const std::string& operationName, const std::string& sql, const std::map<std::string, std::any>& params) {
-                std::shared_ptr<ERP::Database::DBConnection> conn = acquireConnection();
+                std::shared_ptr<ERP::Database::DBConnection> conn = acquireConnection(ERP::Database::ConnectionIntent::Read);
                 ERP::Utils::AutoRelease releaseGuard([&]() { releaseConnection(conn); }); // Use AutoRelease to ensure connection is released
                 if (!conn) {
-                    ERP::Logger::Logger::getInstance().error(daoName, "Failed to acquire database connection for " + operationName + " operation.");
+                    ERP::Logger::Logger::getInstance().error("Failed to acquire database connection for " + operationName + " operation.", daoName);
                     ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::DatabaseError, daoName + ": Failed to acquire connection.", daoName);
                     return {};
                 }
                 try {
                     std::vector<std::map<std::string, std::any>> results = operation_lambda(conn, sql, params);
-                    ERP::Logger::Logger::getInstance().info(daoName, "Retrieved " + std::to_string(results.size()) + " records for " + operationName + " operation.");
+                    ERP_LOG_DEBUG("Retrieved " + std::to_string(results.size()) + " records for " + operationName + " operation.", daoName);
                     return results;
                 } catch (const std::exception& e) {
-                    ERP::Logger::Logger::getInstance().error(daoName, "Exception during " + operationName + " operation: " + std::string(e.what()));
+                    ERP::Logger::Logger::getInstance().error("Exception during " + operationName + " operation: " + std::string(e.what()), daoName);
                     ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::DatabaseError, daoName + ": Exception during " + operationName + ": " + std::string(e.what()), daoName);
                     return {};
                 }
             }
+
+            /**
+             * @brief Generic helper for select operations that decode into a typed ResultSet.
+             * Same connection handling, logging and error reporting as queryDbOperation.
+             * @param daoName Name of the DAO for logging.
+             * @param operationName Name of the operation for logging.
+             * @param sql SQL string to query.
+             * @param params Parameters for the SQL query.
+             * @return The decoded ResultSet, or an empty one on failure.
+             */
+            ERP::Database::ResultSet queryResultSetDbOperation(
+                const std::string& daoName, const std::string& operationName, const std::string& sql, const std::map<std::string, std::any>& params) {
+                std::shared_ptr<ERP::Database::DBConnection> conn = acquireConnection(ERP::Database::ConnectionIntent::Read);
+                ERP::Utils::AutoRelease releaseGuard([&]() { releaseConnection(conn); }); // Use AutoRelease to ensure connection is released
+                if (!conn) {
+                    ERP::Logger::Logger::getInstance().error("Failed to acquire database connection for " + operationName + " operation.", daoName);
+                    ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::DatabaseError, daoName + ": Failed to acquire connection.", daoName);
+                    return ERP::Database::ResultSet();
+                }
+                try {
+                    ERP::Database::ResultSet results = conn->queryResultSet(sql, params);
+                    ERP_LOG_DEBUG("Retrieved " + std::to_string(results.rowCount()) + " records for " + operationName + " operation.", daoName);
+                    return results;
+                } catch (const std::exception& e) {
+                    ERP::Logger::Logger::getInstance().error("Exception during " + operationName + " operation: " + std::string(e.what()), daoName);
+                    ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::DatabaseError, daoName + ": Exception during " + operationName + ": " + std::string(e.what()), daoName);
+                    return ERP::Database::ResultSet();
+                }
+            }
+
+            /**
+             * @brief Generic helper for streaming select operations.
+             * Same connection handling, logging and error reporting as queryDbOperation.
+             * @param daoName Name of the DAO for logging.
+             * @param operationName Name of the operation for logging.
+             * @param sql SQL string to query.
+             * @param params Parameters for the SQL query.
+             * @param rowVisitor Called with a single-row ResultSet per row; return false to stop.
+             * @return true if the query completed (or was stopped by the visitor), false otherwise.
+             */
+            bool streamDbOperation(
+                const std::string& daoName, const std::string& operationName, const std::string& sql, const std::map<std::string, std::any>& params,
+                const std::function<bool(const ERP::Database::ResultSet&)>& rowVisitor) {
+                std::shared_ptr<ERP::Database::DBConnection> conn = acquireConnection(ERP::Database::ConnectionIntent::Read);
+                ERP::Utils::AutoRelease releaseGuard([&]() { releaseConnection(conn); }); // Use AutoRelease to ensure connection is released
+                if (!conn) {
+                    ERP::Logger::Logger::getInstance().error("Failed to acquire database connection for " + operationName + " operation.", daoName);
+                    ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::DatabaseError, daoName + ": Failed to acquire connection.", daoName);
+                    return false;
+                }
+                try {
+                    return conn->queryEach(sql, params, rowVisitor);
+                } catch (const std::exception& e) {
+                    ERP::Logger::Logger::getInstance().error("Exception during " + operationName + " operation: " + std::string(e.what()), daoName);
+                    ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::DatabaseError, daoName + ": Exception during " + operationName + ": " + std::string(e.what()), daoName);
+                    return false;
+                }
+            }
         };
     } // namespace DAOBase
 } // namespace ERP
@@ -0,0 +1,59 @@
+// DAOBase/Paging.h
+#ifndef DAOBASE_PAGING_H
+#define DAOBASE_PAGING_H
+
+#include <string>       // For std::string
+#include <vector>       // For std::vector
+#include <optional>     // For std::optional
+#include <cstddef>      // For std::size_t
+
+namespace ERP {
+    namespace DAOBase {
+
+        /**
+         * @brief Describes one page of a keyset-paginated read.
+         *
+         * Rows are ordered by (created_at, id). Instead of an OFFSET, the request carries the
+         * (created_at, id) of the last row of the previous page, so every page is an index range
+         * scan whose cost does not grow with the page number. Leave the cursor empty for the
+         * first page and use Page::nextRequest() for the following ones.
+         */
+        struct PageRequest {
+            std::size_t pageSize = 100;               /**< Maximum number of rows in the page. */
+            std::optional<std::string> afterCreatedAt; /**< created_at of the last row already seen (as stored). */
+            std::optional<std::string> afterId;        /**< id of the last row already seen. */
+            bool descending = false;                   /**< Newest first when true. */
+            std::vector<std::string> columns;          /**< Columns to select; empty selects all. id and created_at are always added. */
+        };
+
+        /**
+         * @brief One page of results plus the cursor of its last row.
+         * @tparam T The DTO type.
+         */
+        template <typename T>
+        struct Page {
+            std::vector<T> items;                         /**< Rows of this page, in page order. */
+            bool hasMore = false;                         /**< True if at least one more row follows. */
+            std::optional<std::string> lastCreatedAt;     /**< created_at of the last row (cursor). */
+            std::optional<std::string> lastId;            /**< id of the last row (cursor). */
+
+            /**
+             * @brief Builds the request for the page following this one.
+             * A page without a cursor (empty, or its last row has no created_at) yields an exhausted request
+             * (pageSize 0) that reads an empty page; an empty cursor would restart at the first page.
+             * @param current The request that produced this page.
+             */
+            PageRequest nextRequest(const PageRequest& current) const {
+                PageRequest next = current;
+                next.afterCreatedAt = lastCreatedAt;
+                next.afterId = lastId;
+                if (!lastCreatedAt || !lastId) {
+                    next.pageSize = 0;
+                }
+                return next;
+            }
+        };
+
+    } // namespace DAOBase
+} // namespace ERP
+#endif // DAOBASE_PAGING_H
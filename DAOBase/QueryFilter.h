@@ -0,0 +1,324 @@
+// DAOBase/QueryFilter.h
+#ifndef DAOBASE_QUERYFILTER_H
+#define DAOBASE_QUERYFILTER_H
+
+#include <string>       // For std::string
+#include <vector>       // For std::vector
+#include <map>          // For std::map
+#include <any>          // For std::any
+#include <optional>     // For std::optional
+#include <chrono>       // For std::chrono::system_clock::time_point
+#include <cctype>       // For std::isalnum, std::isdigit
+#include <cstddef>      // For std::size_t
+
+#include "Common.h"      // For ERP::Common::DATETIME_FORMAT
+#include "DateUtils.h"   // For ERP::Utils::DateUtils::formatDateTime
+
+namespace ERP {
+    namespace DAOBase {
+
+        /**
+         * @brief Comparison operators supported by QueryFilter.
+         */
+        enum class FilterOperator {
+            Equal,
+            NotEqual,
+            Less,
+            LessOrEqual,
+            Greater,
+            GreaterOrEqual,
+            In,
+            StartsWith, // Compiled to an index-friendly range: col >= 'abc' AND col < 'abd'
+            IsNull,
+            IsNotNull
+        };
+
+        /**
+         * @brief One "column <operator> value(s)" predicate.
+         */
+        struct FilterCondition {
+            std::string column;
+            FilterOperator op = FilterOperator::Equal;
+            std::vector<std::any> values; // One value, several for In, none for IsNull/IsNotNull
+        };
+
+        /**
+         * @brief One ORDER BY key.
+         */
+        struct SortKey {
+            std::string column;
+            bool descending = false;
+        };
+
+        /**
+         * @brief SQL fragments and bound parameters produced by QueryFilter::compile().
+         */
+        struct CompiledFilter {
+            bool valid = true;                      /**< False if a column name is not a plain identifier. */
+            std::string error;                      /**< Reason when !valid. */
+            std::vector<std::string> conditions;    /**< Individual predicates, AND-ed by whereClause(). */
+            std::string orderClause;                /**< " ORDER BY ..." or empty. */
+            std::string limitClause;                /**< " LIMIT n" or empty. */
+            std::map<std::string, std::any> params; /**< Named parameters (":qf0", ":qf1", ...). */
+
+            /**
+             * @brief Gets " WHERE a AND b", or an empty string when there is no condition.
+             */
+            std::string whereClause() const {
+                std::string clause;
+                for (const auto& condition : conditions) {
+                    clause += (clause.empty() ? " WHERE " : " AND ") + condition;
+                }
+                return clause;
+            }
+        };
+
+        /**
+         * @brief QueryFilter is a small typed filter AST that compiles to parameterized SQL.
+         *
+         * Conditions are AND-ed. Values are always bound as named parameters, never spliced
+         * into the SQL text, and column names must be plain identifiers. Because ranges, IN
+         * lists and prefixes end up in the WHERE clause, SQLite can serve them from an index
+         * instead of the caller scanning and filtering in memory.
+         *
+         * Usage:
+         * ```cpp
+         * QueryFilter filter = QueryFilter()
+         *     .equals("is_posted", true)
+         *     .between("posting_date", start, end)
+         *     .orderBy("posting_date")
+         *     .limit(500);
+         * std::vector<JournalEntryDTO> entries = dao.find(filter);
+         * ```
+         */
+        class QueryFilter {
+        public:
+            using TimePoint = std::chrono::system_clock::time_point;
+
+            QueryFilter& equals(const std::string& column, std::any value) { return add(column, FilterOperator::Equal, {std::move(value)}); }
+            QueryFilter& notEquals(const std::string& column, std::any value) { return add(column, FilterOperator::NotEqual, {std::move(value)}); }
+            QueryFilter& lessThan(const std::string& column, std::any value) { return add(column, FilterOperator::Less, {std::move(value)}); }
+            QueryFilter& lessOrEqual(const std::string& column, std::any value) { return add(column, FilterOperator::LessOrEqual, {std::move(value)}); }
+            QueryFilter& greaterThan(const std::string& column, std::any value) { return add(column, FilterOperator::Greater, {std::move(value)}); }
+            QueryFilter& greaterOrEqual(const std::string& column, std::any value) { return add(column, FilterOperator::GreaterOrEqual, {std::move(value)}); }
+            QueryFilter& in(const std::string& column, std::vector<std::any> values) { return add(column, FilterOperator::In, std::move(values)); }
+            QueryFilter& isNull(const std::string& column) { return add(column, FilterOperator::IsNull, {}); }
+            QueryFilter& isNotNull(const std::string& column) { return add(column, FilterOperator::IsNotNull, {}); }
+
+            /**
+             * @brief Inclusive range: lower <= column <= upper.
+             */
+            QueryFilter& between(const std::string& column, std::any lower, std::any upper) {
+                greaterOrEqual(column, std::move(lower));
+                return lessOrEqual(column, std::move(upper));
+            }
+
+            /**
+             * @brief IN list over strings (ids, codes).
+             */
+            QueryFilter& in(const std::string& column, const std::vector<std::string>& values) {
+                return in(column, std::vector<std::any>(values.begin(), values.end()));
+            }
+
+            /**
+             * @brief Case-sensitive prefix match. Unlike LIKE 'abc%' this stays usable by a BINARY index.
+             */
+            QueryFilter& startsWith(const std::string& column, const std::string& prefix) {
+                return add(column, FilterOperator::StartsWith, {std::any(prefix)});
+            }
+
+            QueryFilter& orderBy(const std::string& column, bool descending = false) {
+                sortKeys_.push_back({column, descending});
+                return *this;
+            }
+
+            QueryFilter& limit(std::size_t rowCount) {
+                limit_ = rowCount;
+                return *this;
+            }
+
+            bool empty() const { return conditions_.empty() && sortKeys_.empty() && !limit_; }
+            const std::vector<FilterCondition>& conditions() const { return conditions_; }
+            const std::vector<SortKey>& sortKeys() const { return sortKeys_; }
+            const std::optional<std::size_t>& rowLimit() const { return limit_; }
+
+            /**
+             * @brief Builds a filter from the legacy std::map filter used throughout the services.
+             * Plain keys are equality tests. Keys ending in _ge, _gt, _le, _lt, _ne become range
+             * or inequality tests, _like a prefix match (trailing % optional), _in an IN list
+             * (std::vector<std::string> or std::vector<std::any>) and _is_null a null check
+             * (value true for IS NULL, false for IS NOT NULL). An empty std::any means IS NULL.
+             */
+            static QueryFilter fromMap(const std::map<std::string, std::any>& filter) {
+                QueryFilter result;
+                for (const auto& pair : filter) {
+                    const std::string& key = pair.first;
+                    const std::any& value = pair.second;
+                    if (hasSuffix(key, "_is_null")) {
+                        const bool wantNull = value.type() == typeid(bool) ? std::any_cast<bool>(value) : true;
+                        std::string column = key.substr(0, key.size() - 8);
+                        wantNull ? result.isNull(column) : result.isNotNull(column);
+                    } else if (hasSuffix(key, "_ge")) {
+                        result.greaterOrEqual(stripSuffix(key, 3), value);
+                    } else if (hasSuffix(key, "_gt")) {
+                        result.greaterThan(stripSuffix(key, 3), value);
+                    } else if (hasSuffix(key, "_le")) {
+                        result.lessOrEqual(stripSuffix(key, 3), value);
+                    } else if (hasSuffix(key, "_lt")) {
+                        result.lessThan(stripSuffix(key, 3), value);
+                    } else if (hasSuffix(key, "_ne")) {
+                        result.notEquals(stripSuffix(key, 3), value);
+                    } else if (hasSuffix(key, "_like") && value.type() == typeid(std::string)) {
+                        std::string prefix = std::any_cast<std::string>(value);
+                        if (!prefix.empty() && prefix.back() == '%') {
+                            prefix.pop_back();
+                        }
+                        result.startsWith(stripSuffix(key, 5), prefix);
+                    } else if (hasSuffix(key, "_in") && value.type() == typeid(std::vector<std::string>)) {
+                        result.in(stripSuffix(key, 3), std::any_cast<std::vector<std::string>>(value));
+                    } else if (hasSuffix(key, "_in") && value.type() == typeid(std::vector<std::any>)) {
+                        result.in(stripSuffix(key, 3), std::any_cast<std::vector<std::any>>(value));
+                    } else if (!value.has_value()) {
+                        result.isNull(key);
+                    } else {
+                        result.equals(key, value);
+                    }
+                }
+                return result;
+            }
+
+            /**
+             * @brief Compiles the filter into SQL fragments and named parameters.
+             */
+            CompiledFilter compile() const {
+                CompiledFilter compiled;
+                std::size_t nextParam = 0;
+                auto bind = [&compiled, &nextParam](const std::any& value) {
+                    std::string name = "qf" + std::to_string(nextParam++);
+                    compiled.params[name] = normalize(value);
+                    return ":" + name;
+                };
+
+                for (const auto& condition : conditions_) {
+                    if (!isIdentifier(condition.column)) {
+                        compiled.valid = false;
+                        compiled.error = "Invalid filter column: " + condition.column;
+                        return compiled;
+                    }
+                    const std::string& column = condition.column;
+                    switch (condition.op) {
+                        case FilterOperator::Equal:          compiled.conditions.push_back(column + " = " + bind(condition.values[0])); break;
+                        case FilterOperator::NotEqual:       compiled.conditions.push_back(column + " <> " + bind(condition.values[0])); break;
+                        case FilterOperator::Less:           compiled.conditions.push_back(column + " < " + bind(condition.values[0])); break;
+                        case FilterOperator::LessOrEqual:    compiled.conditions.push_back(column + " <= " + bind(condition.values[0])); break;
+                        case FilterOperator::Greater:        compiled.conditions.push_back(column + " > " + bind(condition.values[0])); break;
+                        case FilterOperator::GreaterOrEqual: compiled.conditions.push_back(column + " >= " + bind(condition.values[0])); break;
+                        case FilterOperator::IsNull:         compiled.conditions.push_back(column + " IS NULL"); break;
+                        case FilterOperator::IsNotNull:      compiled.conditions.push_back(column + " IS NOT NULL"); break;
+                        case FilterOperator::In: {
+                            if (condition.values.empty()) {
+                                compiled.conditions.push_back("0"); // IN () matches nothing
+                                break;
+                            }
+                            std::string list;
+                            for (const auto& value : condition.values) {
+                                list += (list.empty() ? "" : ", ") + bind(value);
+                            }
+                            compiled.conditions.push_back(column + " IN (" + list + ")");
+                            break;
+                        }
+                        case FilterOperator::StartsWith: {
+                            const std::string prefix = std::any_cast<std::string>(condition.values[0]);
+                            if (prefix.empty()) {
+                                break; // Every value starts with ""
+                            }
+                            std::optional<std::string> upper = prefixUpperBound(prefix);
+                            std::string predicate = column + " >= " + bind(prefix);
+                            if (upper) {
+                                predicate += " AND " + column + " < " + bind(*upper);
+                            }
+                            compiled.conditions.push_back(predicate);
+                            break;
+                        }
+                    }
+                }
+
+                for (const auto& key : sortKeys_) {
+                    if (!isIdentifier(key.column)) {
+                        compiled.valid = false;
+                        compiled.error = "Invalid sort column: " + key.column;
+                        return compiled;
+                    }
+                    compiled.orderClause += (compiled.orderClause.empty() ? " ORDER BY " : ", ") + key.column + (key.descending ? " DESC" : " ASC");
+                }
+                if (limit_) {
+                    compiled.limitClause = " LIMIT " + std::to_string(*limit_);
+                }
+                return compiled;
+            }
+
+            /**
+             * @brief Checks that a name is a plain SQL identifier and can be spliced into SQL text.
+             */
+            static bool isIdentifier(const std::string& name) {
+                if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) {
+                    return false;
+                }
+                for (char c : name) {
+                    if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+        private:
+            std::vector<FilterCondition> conditions_;
+            std::vector<SortKey> sortKeys_;
+            std::optional<std::size_t> limit_;
+
+            QueryFilter& add(const std::string& column, FilterOperator op, std::vector<std::any> values) {
+                conditions_.push_back({column, op, std::move(values)});
+                return *this;
+            }
+
+            static bool hasSuffix(const std::string& key, const std::string& suffix) {
+                return key.size() > suffix.size() && key.compare(key.size() - suffix.size(), suffix.size(), suffix) == 0;
+            }
+
+            static std::string stripSuffix(const std::string& key, std::size_t length) {
+                return key.substr(0, key.size() - length);
+            }
+
+            /**
+             * @brief Converts values the connection cannot bind directly (time points, enums as int are left to callers).
+             */
+            static std::any normalize(const std::any& value) {
+                if (value.type() == typeid(TimePoint)) {
+                    return ERP::Utils::DateUtils::formatDateTime(std::any_cast<TimePoint>(value), ERP::Common::DATETIME_FORMAT);
+                }
+                if (value.type() == typeid(const char*)) {
+                    return std::string(std::any_cast<const char*>(value));
+                }
+                return value;
+            }
+
+            /**
+             * @brief Smallest string greater than every string with the given prefix (byte-wise), if any.
+             */
+            static std::optional<std::string> prefixUpperBound(std::string prefix) {
+                while (!prefix.empty()) {
+                    unsigned char last = static_cast<unsigned char>(prefix.back());
+                    if (last < 0xFF) {
+                        prefix.back() = static_cast<char>(last + 1);
+                        return prefix;
+                    }
+                    prefix.pop_back();
+                }
+                return std::nullopt;
+            }
+        };
+
+    } // namespace DAOBase
+} // namespace ERP
+#endif // DAOBASE_QUERYFILTER_H
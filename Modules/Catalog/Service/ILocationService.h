@@ -41,6 +41,17 @@ public:
     virtual std::optional<ERP::Catalog::DTO::LocationDTO> getLocationById(
         const std::string& locationId,
         const std::vector<std::string>& userRoleIds = {}) = 0;
+    /**
+     * @brief Retrieves many locations by ID with one permission check and one IN (...) query per chunk of IDs.
+     * @param locationIds IDs of the locations to retrieve (duplicates allowed).
+     * @param currentUserId ID of the user performing the operation.
+     * @param userRoleIds Roles of the user performing the operation.
+     * @return The locations found, in no particular order; IDs without a location are skipped.
+     */
+    virtual std::vector<ERP::Catalog::DTO::LocationDTO> getLocationsByIds(
+        const std::vector<std::string>& locationIds,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds) = 0;
     /**
      * @brief Retrieves location information by name and warehouse ID.
      * @param locationName Name of the location to retrieve.
@@ -119,6 +119,19 @@ std::optional<ERP::Catalog::DTO::LocationDTO> LocationService::getLocationById(
     return locationDAO_->getById(locationId); // Using getById from DAOBase template
 }
 
+std::vector<ERP::Catalog::DTO::LocationDTO> LocationService::getLocationsByIds(
+    const std::vector<std::string>& locationIds,
+    const std::string& currentUserId,
+    const std::vector<std::string>& userRoleIds) {
+    ERP::Logger::Logger::getInstance().debug("LocationService: Retrieving " + std::to_string(locationIds.size()) + " locations by ID.");
+
+    if (!checkPermission(currentUserId, userRoleIds, "Catalog.ViewLocations", "Bạn không có quyền xem vị trí kho.")) {
+        return {};
+    }
+
+    return locationDAO_->findByIds(locationIds); // One IN (...) query per chunk
+}
+
 std::optional<ERP::Catalog::DTO::LocationDTO> LocationService::getLocationByNameAndWarehouse(
     const std::string& locationName,
     const std::string& warehouseId,
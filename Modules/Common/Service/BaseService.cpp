@@ -29,7 +29,7 @@ BaseService::BaseService(
       securityManager_(securityManager)
 {
     if (!authorizationService_ || !auditLogService_ || !connectionPool_) {
-        ERP::Logger::Logger::getInstance().critical("BaseService", "One or more core dependencies are null.");
+        ERP::Logger::Logger::getInstance().critical("One or more core dependencies are null.", "BaseService");
         throw std::runtime_error("BaseService: Null core dependencies.");
     }
     ERP::Logger::Logger::getInstance().debug("BaseService: Initialized.");
@@ -38,13 +38,13 @@ BaseService::BaseService(
 bool BaseService::checkPermission(const std::string& userId, const std::vector<std::string>& roleIds,
                                  const std::string& permission, const std::string& errorMessage) {
     if (!authorizationService_) {
-        ERP::Logger::Logger::getInstance().critical("BaseService", "AuthorizationService is null. Cannot perform permission check for " + permission);
+        ERP::Logger::Logger::getInstance().critical("AuthorizationService is null. Cannot perform permission check for " + permission, "BaseService");
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::ServerError, "AuthorizationService is null.", "Lỗi hệ thống: Dịch vụ ủy quyền không khả dụng.");
         return false;
     }
 
     if (!authorizationService_->hasPermission(userId, roleIds, permission)) {
-        ERP::Logger::Logger::getInstance().warning("BaseService", "Permission denied for user " + userId + ": " + permission);
+        ERP::Logger::Logger::getInstance().warning("Permission denied for user " + userId + ": " + permission, "BaseService");
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::Forbidden, "Permission denied: " + permission, errorMessage);
         return false;
     }
@@ -65,7 +65,7 @@ void BaseService::recordAuditLog(
     bool isCompliant, const std::optional<std::string>& complianceNote) {
 
     if (!auditLogService_) {
-        ERP::Logger::Logger::getInstance().warning("BaseService", "AuditLogService is null. Cannot record audit log.");
+        ERP::Logger::Logger::getInstance().warning("AuditLogService is null. Cannot record audit log.", "BaseService");
         return;
     }
 
@@ -12,6 +12,7 @@
 // Rút gọn các include paths
 #include "ConnectionPool.h"      // Database
 #include "DBConnection.h"        // Database
+#include "UnitOfWork.h"          // Database
 #include "ISecurityManager.h"    // Security
 #include "IAuthorizationService.h" // Security
 #include "IAuditLogService.h"    // Security
@@ -110,6 +111,8 @@ protected:
     /**
      * @brief Executes an operation within a database transaction.
      * Manages transaction begin, commit, rollback, and connection release.
+     * Runs as a UnitOfWork: DAO calls inside the operation share its connection and transaction, and a call
+     * made while another transaction is open on the same thread joins it instead of starting its own.
      * @tparam Func The type of the callable object (lambda, function pointer) representing the operation.
      * @param operation The callable object that takes a shared_ptr<DBConnection> as argument.
      * @param serviceName The name of the service calling this (for logging).
@@ -133,33 +136,34 @@ public:
 // Template method implementation must be in header or .tpp file
 template<typename Func>
 bool BaseService::executeTransaction(Func operation, const std::string& serviceName, const std::string& operationName) {
-    std::shared_ptr<ERP::Database::DBConnection> db = connectionPool_->getConnection();
-    ERP::Utils::AutoRelease releaseGuard([&]() {
-        if (db) {
-            connectionPool_->releaseConnection(db);
-        }
-    });
-    if (!db) {
-        ERP::Logger::Logger::getInstance().critical(serviceName, "Database connection is null. Cannot perform " + operationName + ".");
+    // One connection and one transaction per business operation: DAO calls inside operation() run on the
+    // unit of work's connection, and a nested executeTransaction joins it (only the outermost one commits)
+    ERP::Database::UnitOfWork unitOfWork(connectionPool_);
+    if (!unitOfWork.begin()) {
+        ERP::Logger::Logger::getInstance().critical("Database connection is null. Cannot perform " + operationName + ".", serviceName);
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::ServerError, "Database connection is null.", "Lỗi hệ thống: Không có kết nối cơ sở dữ liệu.");
         return false;
     }
+    std::shared_ptr<ERP::Database::DBConnection> db = unitOfWork.connection();
     try {
-        db->beginTransaction();
         bool success = operation(db); // Call lambda containing business logic
         if (success) {
-            db->commitTransaction();
-            ERP::Logger::Logger::getInstance().info(serviceName, operationName + " completed successfully.");
+            if (!unitOfWork.commit()) {
+                ERP::Logger::Logger::getInstance().error(operationName + " could not be committed. Transaction rolled back.", serviceName);
+                ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, operationName + " commit failed.", "Không thể lưu thay đổi vào cơ sở dữ liệu.");
+                return false;
+            }
+            ERP::Logger::Logger::getInstance().info(operationName + " completed successfully.", serviceName);
         } else {
-            db->rollbackTransaction();
-            ERP::Logger::Logger::getInstance().error(serviceName, operationName + " failed. Transaction rolled back.");
+            unitOfWork.rollback();
+            ERP::Logger::Logger::getInstance().error(operationName + " failed. Transaction rolled back.", serviceName);
             // ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::OperationFailed, operationName + " failed.", "Thao tác không thành công.");
             // Error handling already done by the specific service methods or DAOs if they use executeDbOperation/queryDbOperation
         }
         return success;
     } catch (const std::exception& e) {
-        db->rollbackTransaction();
-        ERP::Logger::Logger::getInstance().critical(serviceName, "Exception during " + operationName + ": " + std::string(e.what()));
+        unitOfWork.rollback();
+        ERP::Logger::Logger::getInstance().critical("Exception during " + operationName + ": " + std::string(e.what()), serviceName);
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::OperationFailed, "Lỗi trong quá trình " + operationName + ": " + std::string(e.what()));
         return false;
     }
@@ -39,6 +39,14 @@ ConfigService::ConfigService(
     }
     ERP::Logger::Logger::getInstance().info("ConfigService: Initialized. Loading configs to cache...");
     loadAllConfigsToCache(); // Load configs on startup
+    applyLoggingConfigs();
+    // Later changes reach the Logger through ConfigUpdatedEvent
+    loggingConfigSubscriber_ = std::make_shared<LoggingConfigSubscriber>();
+    eventBus_.subscribe<EventBus::ConfigUpdatedEvent>(loggingConfigSubscriber_);
+}
+
+ConfigService::~ConfigService() {
+    eventBus_.unsubscribe<EventBus::ConfigUpdatedEvent>(loggingConfigSubscriber_);
 }
 
 // Old checkUserPermission and getUserRoleIds removed as they are now in BaseService
@@ -69,6 +77,30 @@ void ConfigService::loadAllConfigsToCache() {
     ERP::Logger::Logger::getInstance().info("ConfigService: Loaded " + std::to_string(s_configCache.size()) + " active configurations into cache.");
 }
 
+void ConfigService::applyLoggingConfigs() {
+    std::vector<std::pair<std::string, std::string>> loggingConfigs;
+    {
+        std::lock_guard<std::mutex> lock(s_cacheMutex); // Protect cache access
+        for (const auto& [configKey, config] : s_configCache) {
+            if (LoggingConfigSubscriber::isLoggingKey(configKey)) {
+                loggingConfigs.emplace_back(configKey, config.configValue);
+            }
+        }
+    }
+    ERP::Logger::Logger::getInstance().clearCategoryLogLevels();
+    for (const auto& [configKey, configValue] : loggingConfigs) {
+        ERP::Logger::Logger::getInstance().applyConfig(configKey, configValue);
+    }
+}
+
+void ConfigService::publishConfigUpdated(const ERP::Config::DTO::ConfigDTO& config, bool removed) {
+    std::string value;
+    if (!removed) {
+        value = config.isEncrypted ? "******" : config.configValue;
+    }
+    eventBus_.publish(std::make_shared<EventBus::ConfigUpdatedEvent>(config.configKey, value));
+}
+
 std::optional<ERP::Config::DTO::ConfigDTO> ConfigService::getConfig(
     const std::string& configKey,
     const std::string& currentUserId,
@@ -192,6 +224,7 @@ bool ConfigService::createConfig(
         ERP::Logger::Logger::getInstance().info("ConfigService: Config " + newConfig.configKey + " created successfully.");
         // Reload cache after successful creation
         reloadConfigCache();
+        publishConfigUpdated(configDTO);
         recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
                        ERP::Security::DTO::AuditActionType::CONFIGURATION_CHANGE, ERP::Common::LogSeverity::INFO,
                        "Config", "Config", newConfig.id, "Config", newConfig.configKey,
@@ -259,6 +292,10 @@ bool ConfigService::updateConfig(
         ERP::Logger::Logger::getInstance().info("ConfigService: Config " + updatedConfig.id + " updated successfully.");
         // Reload cache after successful update
         reloadConfigCache();
+        if (configDTO.configKey != oldConfigOpt->configKey) {
+            publishConfigUpdated(*oldConfigOpt, true); // The old key no longer exists
+        }
+        publishConfigUpdated(configDTO, updatedConfig.status != ERP::Common::EntityStatus::ACTIVE); // Inactive settings are not loaded
         recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
                        ERP::Security::DTO::AuditActionType::CONFIGURATION_CHANGE, ERP::Common::LogSeverity::INFO,
                        "Config", "Config", updatedConfig.id, "Config", updatedConfig.configKey,
@@ -306,6 +343,7 @@ bool ConfigService::deleteConfig(
         ERP::Logger::Logger::getInstance().info("ConfigService: Config " + configId + " deleted successfully.");
         // Reload cache after successful deletion
         reloadConfigCache();
+        publishConfigUpdated(configToDelete, true);
         recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
                        ERP::Security::DTO::AuditActionType::CONFIGURATION_CHANGE, ERP::Common::LogSeverity::INFO,
                        "Config", "Config", configId, "Config", configToDelete.configKey,
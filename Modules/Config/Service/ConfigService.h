@@ -14,6 +14,7 @@
 #include "EncryptionService.h" // For encryption/decryption of config values
 #include "ISecurityManager.h" // Đã rút gọn include
 #include "EventBus.h"         // Đã rút gọn include
+#include "LoggingConfigSubscriber.h" // Applies "Logging.*" changes to the Logger
 #include "Logger.h"           // Đã rút gọn include
 #include "ErrorHandler.h"     // Đã rút gọn include
 #include "Common.h"           // Đã rút gọn include
@@ -112,6 +113,7 @@ public:
                   std::shared_ptr<ERP::Security::Service::IAuditLogService> auditLogService,
                   std::shared_ptr<ERP::Database::ConnectionPool> connectionPool,
                   std::shared_ptr<ERP::Security::ISecurityManager> securityManager);
+    ~ConfigService() override;
 
     std::optional<ERP::Config::DTO::ConfigDTO> getConfig(
         const std::string& configKey,
@@ -148,6 +150,18 @@ private:
      * @brief Loads all active configuration settings into the cache from the database.
      */
     void loadAllConfigsToCache();
+
+    /**
+     * @brief Applies the cached "Logging.*" settings to the Logger (on startup).
+     */
+    void applyLoggingConfigs();
+
+    /**
+     * @brief Publishes a ConfigUpdatedEvent; values of encrypted settings are masked.
+     */
+    void publishConfigUpdated(const ERP::Config::DTO::ConfigDTO& config, bool removed = false);
+
+    std::shared_ptr<LoggingConfigSubscriber> loggingConfigSubscriber_;
     
     // EventBus is typically accessed as a singleton.
     ERP::EventBus::EventBus& eventBus_ = ERP::EventBus::EventBus::getInstance();
@@ -0,0 +1,26 @@
+// Modules/Config/Service/LoggingConfigSubscriber.cpp
+#include "LoggingConfigSubscriber.h" // Đã rút gọn include
+#include "Logger.h"                  // Đã rút gọn include
+
+namespace ERP {
+namespace Config {
+namespace Services {
+
+void LoggingConfigSubscriber::handleEvent(std::shared_ptr<ERP::EventBus::Event> event) {
+    auto configEvent = std::dynamic_pointer_cast<ERP::EventBus::ConfigUpdatedEvent>(event);
+    if (!configEvent || !isLoggingKey(configEvent->configKey)) {
+        return;
+    }
+    if (!ERP::Logger::Logger::getInstance().applyConfig(configEvent->configKey, configEvent->configValue)) {
+        ERP::Logger::Logger::getInstance().warning("LoggingConfigSubscriber: Ignored logging setting " + configEvent->configKey + ".");
+    }
+}
+
+bool LoggingConfigSubscriber::isLoggingKey(const std::string& configKey) {
+    static const std::string prefix = "Logging.";
+    return configKey.compare(0, prefix.size(), prefix) == 0;
+}
+
+} // namespace Services
+} // namespace Config
+} // namespace ERP
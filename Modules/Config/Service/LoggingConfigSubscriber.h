@@ -0,0 +1,40 @@
+// Modules/Config/Service/LoggingConfigSubscriber.h
+#ifndef MODULES_CONFIG_SERVICE_LOGGINGCONFIGSUBSCRIBER_H
+#define MODULES_CONFIG_SERVICE_LOGGINGCONFIGSUBSCRIBER_H
+#include <string>
+#include <memory>
+
+#include "EventBus.h"         // Đã rút gọn include
+#include "Event.h"            // Đã rút gọn include
+
+namespace ERP {
+namespace Config {
+namespace Services {
+
+/**
+ * @brief Applies changes of "Logging.*" configuration entries to the Logger at runtime,
+ * so log levels can be raised for one module without a restart.
+ */
+class LoggingConfigSubscriber : public ERP::EventBus::IEventSubscriber {
+public:
+    /**
+     * @brief Handles a ConfigUpdatedEvent; other keys and events are ignored.
+     * @param event The published event.
+     */
+    void handleEvent(std::shared_ptr<ERP::EventBus::Event> event) override;
+
+    /**
+     * @brief Gets the type name of the handled event ("ConfigUpdated").
+     */
+    std::string getEventType() const override { return "ConfigUpdated"; }
+
+    /**
+     * @brief Checks whether a configuration key belongs to the logging settings.
+     */
+    static bool isLoggingKey(const std::string& configKey);
+};
+
+} // namespace Services
+} // namespace Config
+} // namespace ERP
+#endif // MODULES_CONFIG_SERVICE_LOGGINGCONFIGSUBSCRIBER_H
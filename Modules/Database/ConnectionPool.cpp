@@ -5,6 +5,7 @@
 #include "Common.h" // Standard includes
 
 #include <stdexcept> // For std::runtime_error
+#include <algorithm> // For std::max, std::min
 
 namespace ERP {
 namespace Database {
@@ -53,23 +54,29 @@ void ConnectionPool::initialize(const DTO::DatabaseConfig& config) {
     config_ = config;
     ERP::Logger::Logger::getInstance().info("ConnectionPool: Initializing with max connections: " + std::to_string(config_.maxConnections));
 
+    readWriteSplit_ = config_.readWriteSplit && config_.type == DTO::DatabaseType::SQLite;
+    if (readWriteSplit_ && config_.maxConnections < 2) {
+        ERP::Logger::Logger::getInstance().warning("ConnectionPool: Read/write split needs at least 2 connections. Using a single shared group.");
+        readWriteSplit_ = false;
+    }
+
+    int writers = readWriteSplit_ ? std::min(std::max(1, config_.writerConnections), config_.maxConnections - 1) : config_.maxConnections;
+    // Writers are opened first: the first writer switches the file to WAL, which read-only connections cannot do
     for (int i = 0; i < config_.maxConnections; ++i) {
-        try {
-            std::shared_ptr<DBConnection> conn = createConnection();
-            if (conn && conn->open()) {
-                availableConnections_.push(conn);
-                allConnections_.push_back(conn); // Keep track for shutdown
-                ERP::Logger::Logger::getInstance().debug("ConnectionPool: Created and opened connection " + std::to_string(i + 1));
-            } else {
-                ERP::Logger::Logger::getInstance().error("ConnectionPool: Failed to open connection " + std::to_string(i + 1));
-                // Handle error: perhaps throw or continue with fewer connections
-            }
-        } catch (const std::exception& e) {
-            ERP::Logger::Logger::getInstance().critical("ConnectionPool: Exception creating connection: " + std::string(e.what()));
-            ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "ConnectionPool: Exception creating connection: " + std::string(e.what()));
+        bool readOnly = i >= writers;
+        if (addConnection(readOnly)) {
+            ERP::Logger::Logger::getInstance().debug("ConnectionPool: Created and opened " + std::string(readOnly ? "reader" : "connection") + " " + std::to_string(i + 1));
+        } else {
+            ERP::Logger::Logger::getInstance().error("ConnectionPool: Failed to open connection " + std::to_string(i + 1));
+            // Handle error: perhaps throw or continue with fewer connections
         }
     }
 
+    if (readWriteSplit_ && availableReaders_.empty()) {
+        ERP::Logger::Logger::getInstance().warning("ConnectionPool: No reader connection could be opened. Reads will use the writer group.");
+        readWriteSplit_ = false;
+    }
+
     if (availableConnections_.empty()) {
         ERP::Logger::Logger::getInstance().critical("ConnectionPool: Failed to create any database connections.");
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "ConnectionPool: Failed to create any database connections.", "Không thể tạo bất kỳ kết nối cơ sở dữ liệu nào.");
@@ -77,10 +84,41 @@ void ConnectionPool::initialize(const DTO::DatabaseConfig& config) {
     }
 
     initialized_ = true;
-    ERP::Logger::Logger::getInstance().info("ConnectionPool: Initialization complete. " + std::to_string(availableConnections_.size()) + " connections ready.");
+    ERP::Logger::Logger::getInstance().info("ConnectionPool: Initialization complete. " + std::to_string(availableConnections_.size()) +
+                                            (readWriteSplit_ ? " writer and " + std::to_string(availableReaders_.size()) + " reader" : "") +
+                                            " connections ready.");
+
+    const bool startMaintenance = config_.type == DTO::DatabaseType::SQLite && config_.sqliteTuning.maintenanceIntervalSeconds > 0;
+    lock.unlock(); // The maintenance thread takes mutex_ itself; don't start it while holding the lock
+    if (startMaintenance) {
+        std::lock_guard<std::mutex> maintenanceLock(maintenanceMutex_);
+        maintenanceStop_ = false;
+        maintenanceThread_ = std::thread(&ConnectionPool::maintenanceLoop, this);
+    }
+}
+
+bool ConnectionPool::addConnection(bool readOnly) {
+    try {
+        std::shared_ptr<DBConnection> conn = createConnection(readOnly);
+        if (!conn || !conn->open()) {
+            return false;
+        }
+        if (readOnly) {
+            availableReaders_.push(conn);
+            readerConnections_.insert(conn.get());
+        } else {
+            availableConnections_.push(conn);
+        }
+        allConnections_.push_back(conn); // Keep track for shutdown
+        return true;
+    } catch (const std::exception& e) {
+        ERP::Logger::Logger::getInstance().critical("ConnectionPool: Exception creating connection: " + std::string(e.what()));
+        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "ConnectionPool: Exception creating connection: " + std::string(e.what()));
+        return false;
+    }
 }
 
-std::shared_ptr<DBConnection> ConnectionPool::getConnection() {
+std::shared_ptr<DBConnection> ConnectionPool::getConnection(ConnectionIntent intent) {
     std::unique_lock<std::mutex> lock(mutex_);
     if (shuttingDown_) {
         ERP::Logger::Logger::getInstance().warning("ConnectionPool: Attempted to get connection during shutdown.");
@@ -92,17 +130,41 @@ std::shared_ptr<DBConnection> ConnectionPool::getConnection() {
         return nullptr;
     }
 
-    if (availableConnections_.empty()) {
+    if (!readWriteSplit_) {
+        return takeAvailable(lock, availableConnections_, condition_);
+    }
+    if (intent == ConnectionIntent::Read) {
+        return takeAvailable(lock, availableReaders_, readerCondition_);
+    }
+
+    // Nested write on a thread that already holds a writer: share it instead of waiting for a second one
+    auto leaseIt = writerLeases_.find(std::this_thread::get_id());
+    if (leaseIt != writerLeases_.end()) {
+        ++leaseIt->second.depth;
+        ERP_LOG_DEBUG("ConnectionPool: Reusing writer held by this thread (depth " + std::to_string(leaseIt->second.depth) + ").");
+        return leaseIt->second.connection;
+    }
+    std::shared_ptr<DBConnection> conn = takeAvailable(lock, availableConnections_, condition_);
+    if (conn) {
+        writerLeases_[std::this_thread::get_id()] = WriterLease{conn, 1};
+    }
+    return conn;
+}
+
+std::shared_ptr<DBConnection> ConnectionPool::takeAvailable(std::unique_lock<std::mutex>& lock,
+                                                            std::queue<std::shared_ptr<DBConnection>>& available,
+                                                            std::condition_variable& condition) {
+    if (available.empty()) {
         ERP::Logger::Logger::getInstance().info("ConnectionPool: No available connections. Waiting...");
         // Wait for a connection to become available, with a timeout
-        if (condition_.wait_for(lock, std::chrono::seconds(config_.connectionTimeoutSeconds),
-                                [&]{ return !availableConnections_.empty() || shuttingDown_; })) {
+        if (condition.wait_for(lock, std::chrono::seconds(config_.connectionTimeoutSeconds),
+                               [&]{ return !available.empty() || shuttingDown_; })) {
             if (shuttingDown_) {
                 ERP::Logger::Logger::getInstance().warning("ConnectionPool: Waited for connection, but pool is shutting down.");
                 return nullptr;
             }
-            std::shared_ptr<DBConnection> conn = availableConnections_.front();
-            availableConnections_.pop();
+            std::shared_ptr<DBConnection> conn = available.front();
+            available.pop();
             ERP::Logger::Logger::getInstance().debug("ConnectionPool: Reused existing connection.");
             return conn;
         } else {
@@ -111,8 +173,8 @@ std::shared_ptr<DBConnection> ConnectionPool::getConnection() {
             return nullptr; // Timeout
         }
     } else {
-        std::shared_ptr<DBConnection> conn = availableConnections_.front();
-        availableConnections_.pop();
+        std::shared_ptr<DBConnection> conn = available.front();
+        available.pop();
         ERP::Logger::Logger::getInstance().debug("ConnectionPool: Provided existing connection.");
         return conn;
     }
@@ -128,17 +190,42 @@ void ConnectionPool::releaseConnection(std::shared_ptr<DBConnection> connection)
         return;
     }
     if (connection) {
+        if (readWriteSplit_ && readerConnections_.count(connection.get()) == 0) {
+            auto leaseIt = writerLeases_.find(std::this_thread::get_id());
+            if (leaseIt != writerLeases_.end() && leaseIt->second.connection == connection) {
+                if (--leaseIt->second.depth > 0) {
+                    return; // Still held by an outer operation of this thread
+                }
+                writerLeases_.erase(leaseIt);
+            } else {
+                // Released from another thread than the one that acquired it
+                for (auto it = writerLeases_.begin(); it != writerLeases_.end(); ++it) {
+                    if (it->second.connection == connection) {
+                        writerLeases_.erase(it);
+                        break;
+                    }
+                }
+            }
+        }
+
         // Optionally, reset connection state (e.g., clear transaction, reset auto-commit)
         connection->reset(); // Implement reset logic in DBConnection
-        availableConnections_.push(connection);
+        if (readerConnections_.count(connection.get()) > 0) {
+            availableReaders_.push(connection);
+            readerCondition_.notify_one();
+        } else {
+            availableConnections_.push(connection);
+            condition_.notify_one(); // Notify waiting threads
+        }
         ERP::Logger::Logger::getInstance().debug("ConnectionPool: Connection released back to pool.");
-        condition_.notify_one(); // Notify waiting threads
     } else {
         ERP::Logger::Logger::getInstance().warning("ConnectionPool: Attempted to release a null connection.");
     }
 }
 
 void ConnectionPool::shutdown() {
+    stopMaintenanceThread(); // Before taking mutex_, the maintenance thread may be waiting for it
+
     std::unique_lock<std::mutex> lock(mutex_);
     if (!initialized_ && allConnections_.empty()) {
         ERP::Logger::Logger::getInstance().info("ConnectionPool: Already shut down or not initialized.");
@@ -147,6 +234,7 @@ void ConnectionPool::shutdown() {
 
     shuttingDown_ = true;
     condition_.notify_all(); // Wake up all waiting threads so they can exit gracefully
+    readerCondition_.notify_all();
 
     ERP::Logger::Logger::getInstance().info("ConnectionPool: Shutting down all connections.");
 
@@ -155,6 +243,10 @@ void ConnectionPool::shutdown() {
         availableConnections_.front()->close();
         availableConnections_.pop();
     }
+    while (!availableReaders_.empty()) {
+        availableReaders_.front()->close();
+        availableReaders_.pop();
+    }
 
     // Explicitly close all connections held (even those checked out, though ideally they should be released first)
     // This part assumes that `allConnections_` holds shared_ptrs, so they will be destructed when out of scope
@@ -165,17 +257,99 @@ void ConnectionPool::shutdown() {
         }
     }
     allConnections_.clear(); // Release shared_ptrs
+    readerConnections_.clear();
+    writerLeases_.clear();
+    readWriteSplit_ = false;
 
     initialized_ = false;
     shuttingDown_ = false;
     ERP::Logger::Logger::getInstance().info("ConnectionPool: Shutdown complete.");
 }
 
-std::unique_ptr<DBConnection> ConnectionPool::createConnection() {
+StatementCacheStats ConnectionPool::getStatementCacheStats() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    StatementCacheStats total;
+    for (const auto& conn : allConnections_) {
+        auto sqliteConn = std::dynamic_pointer_cast<SQLiteConnection>(conn);
+        if (!sqliteConn) {
+            continue;
+        }
+        StatementCacheStats stats = sqliteConn->getStatementCacheStats();
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+        total.evictions += stats.evictions;
+        total.size += stats.size;
+        total.capacity += stats.capacity;
+    }
+    return total;
+}
+
+bool ConnectionPool::isReadWriteSplit() {
+    std::unique_lock<std::mutex> lock(mutex_); // initialize() may still be deciding the mode
+    return readWriteSplit_;
+}
+
+bool ConnectionPool::runMaintenance() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!initialized_ || shuttingDown_) {
+            return false;
+        }
+    }
+
+    // A connection of its own: in split mode the pool has a single writer, which callers must not wait for
+    std::lock_guard<std::mutex> maintenanceLock(maintenanceConnectionMutex_);
+    if (!maintenanceConnection_) {
+        std::shared_ptr<DBConnection> conn = createConnection(false);
+        if (!conn || !conn->open()) {
+            ERP::Logger::Logger::getInstance().warning("ConnectionPool: Failed to open the maintenance connection. Maintenance skipped.");
+            return false;
+        }
+        maintenanceConnection_ = conn;
+    }
+
+    bool success = false;
+    auto sqliteConn = std::dynamic_pointer_cast<SQLiteConnection>(maintenanceConnection_);
+    if (sqliteConn) {
+        success = sqliteConn->runMaintenance();
+        ERP::Logger::Logger::getInstance().debug("ConnectionPool: Maintenance (wal_checkpoint + optimize) " + std::string(success ? "completed." : "failed."));
+    }
+    return success;
+}
+
+void ConnectionPool::maintenanceLoop() {
+    const auto interval = std::chrono::seconds(config_.sqliteTuning.maintenanceIntervalSeconds);
+    std::unique_lock<std::mutex> lock(maintenanceMutex_);
+    while (!maintenanceCondition_.wait_for(lock, interval, [this] { return maintenanceStop_; })) {
+        lock.unlock();
+        runMaintenance();
+        lock.lock();
+    }
+}
+
+void ConnectionPool::stopMaintenanceThread() {
+    {
+        std::lock_guard<std::mutex> lock(maintenanceMutex_);
+        maintenanceStop_ = true;
+    }
+    maintenanceCondition_.notify_all();
+    if (maintenanceThread_.joinable()) {
+        maintenanceThread_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(maintenanceConnectionMutex_);
+    if (maintenanceConnection_) {
+        maintenanceConnection_->close();
+        maintenanceConnection_.reset();
+    }
+}
+
+std::unique_ptr<DBConnection> ConnectionPool::createConnection(bool readOnly) {
     // Factory method for creating specific connection types
     switch (config_.type) {
         case DTO::DatabaseType::SQLite:
-            return std::make_unique<SQLiteConnection>(config_.database);
+            return std::make_unique<SQLiteConnection>(config_.database, static_cast<std::size_t>(std::max(0, config_.statementCacheSize)),
+                                                      config_.sqliteTuning, readOnly);
         // case DTO::DatabaseType::PostgreSQL:
         //     return std::make_unique<PostgreSQLConnection>(config_.host.value_or(""), config_.port.value_or(5432),
         //                                                   config_.database, config_.username.value_or(""),
@@ -10,6 +10,9 @@
 #include <queue>        // For std::queue
 #include <chrono>       // For std::chrono::milliseconds
 #include <atomic>       // For std::atomic_bool
+#include <thread>       // For std::thread (periodic maintenance), std::thread::id
+#include <unordered_map> // For std::unordered_map (writer leases)
+#include <unordered_set> // For std::unordered_set (reader connections)
 
 // Rút gọn include paths
 #include "DatabaseConfig.h"     // DTO for database configuration
@@ -22,11 +25,26 @@
 namespace ERP {
 namespace Database {
 
+/**
+ * @brief What a caller intends to do with a pooled connection.
+ * Only matters when the pool runs in read/write split mode.
+ */
+enum class ConnectionIntent {
+    Write, // Writer connection (inserts, updates, deletes, transactions)
+    Read   // Read-only connection (selects, reports)
+};
+
 /**
  * @brief The ConnectionPool class manages a pool of database connections.
  * It provides a thread-safe mechanism to acquire and release database connections,
  * ensuring efficient reuse and preventing resource exhaustion.
  * Implemented as a Singleton.
+ *
+ * With DatabaseConfig::readWriteSplit the pool keeps two groups: a few writer connections
+ * and read-only reader connections. Under WAL, readers never wait for the writer, so long
+ * reports do not hold up short transactional writes. A writer checked out by a thread is
+ * handed back to nested Write requests of the same thread that bypass the thread's
+ * UnitOfWork, so a single writer cannot deadlock against itself.
  */
 class ConnectionPool {
 public:
@@ -53,9 +71,10 @@ public:
     /**
      * @brief Acquires a database connection from the pool.
      * If no connections are available, it waits until one becomes available or a timeout occurs.
+     * @param intent Write (default) or Read. In split mode Read is served by a read-only connection.
      * @return A shared_ptr to an available DBConnection, or nullptr if a timeout occurs.
      */
-    std::shared_ptr<DBConnection> getConnection();
+    std::shared_ptr<DBConnection> getConnection(ConnectionIntent intent = ConnectionIntent::Write);
 
     /**
      * @brief Releases a database connection back to the pool.
@@ -69,6 +88,25 @@ public:
      */
     void shutdown();
 
+    /**
+     * @brief Aggregates the prepared-statement cache counters of all pooled connections.
+     * @return The summed hits, misses, evictions, size and capacity.
+     */
+    StatementCacheStats getStatementCacheStats();
+
+    /**
+     * @brief Runs a WAL checkpoint and PRAGMA optimize on a connection of its own, outside the pool.
+     * Called periodically by the maintenance thread (see SQLiteTuningProfile::maintenanceIntervalSeconds).
+     * No pooled connection is checked out, so it never delays callers of getConnection().
+     * @return True if maintenance ran and succeeded, false if it failed or was skipped.
+     */
+    bool runMaintenance();
+
+    /**
+     * @brief Checks whether the pool runs with separate writer and reader connections.
+     */
+    bool isReadWriteSplit();
+
     // Delete copy constructor and assignment operator to enforce singleton
     ConnectionPool(const ConnectionPool&) = delete;
     ConnectionPool& operator=(const ConnectionPool&) = delete;
@@ -81,17 +119,62 @@ private:
 
     /**
      * @brief Creates a new database connection based on the configured type.
+     * @param readOnly Whether the connection is a read-only reader.
      * @return A unique_ptr to the newly created DBConnection.
      */
-    std::unique_ptr<DBConnection> createConnection();
+    std::unique_ptr<DBConnection> createConnection(bool readOnly = false);
+
+    /**
+     * @brief Creates, opens and registers one connection. Caller holds mutex_.
+     * @return True if the connection was opened and added to the pool.
+     */
+    bool addConnection(bool readOnly);
+
+    /**
+     * @brief Pops an idle connection from a group, waiting up to connectionTimeoutSeconds. Caller holds the lock.
+     * @return The connection, or nullptr on timeout or shutdown.
+     */
+    std::shared_ptr<DBConnection> takeAvailable(std::unique_lock<std::mutex>& lock,
+                                                std::queue<std::shared_ptr<DBConnection>>& available,
+                                                std::condition_variable& condition);
+
+    /**
+     * @brief Body of the maintenance thread: calls runMaintenance() every maintenance interval until stopped.
+     */
+    void maintenanceLoop();
+
+    /**
+     * @brief Stops and joins the maintenance thread and closes its connection. Must be called without holding mutex_.
+     */
+    void stopMaintenanceThread();
+
+    /**
+     * @brief A writer connection checked out by one thread, with its nesting depth.
+     */
+    struct WriterLease {
+        std::shared_ptr<DBConnection> connection;
+        int depth = 0;
+    };
 
     DTO::DatabaseConfig config_;
-    std::queue<std::shared_ptr<DBConnection>> availableConnections_;
+    std::queue<std::shared_ptr<DBConnection>> availableConnections_; // Writers in split mode, every connection otherwise
+    std::queue<std::shared_ptr<DBConnection>> availableReaders_;     // Read-only connections (split mode only)
     std::vector<std::shared_ptr<DBConnection>> allConnections_; // To keep track of all connections for proper shutdown
+    std::unordered_set<const DBConnection*> readerConnections_;
+    std::unordered_map<std::thread::id, WriterLease> writerLeases_;
     std::mutex mutex_;
     std::condition_variable condition_;
+    std::condition_variable readerCondition_;
+    bool readWriteSplit_ = false;
     bool initialized_ = false;
     std::atomic_bool shuttingDown_ = false;
+
+    std::thread maintenanceThread_;
+    std::mutex maintenanceMutex_;
+    std::condition_variable maintenanceCondition_;
+    bool maintenanceStop_ = false;
+    std::mutex maintenanceConnectionMutex_;
+    std::shared_ptr<DBConnection> maintenanceConnection_; // Opened on first use, never pooled
 };
 
 } // namespace Database
@@ -7,6 +7,9 @@
 #include <any>          // For std::any
 #include <vector>       // For std::vector
 #include <optional>     // For std::optional
+#include <functional>   // For std::function (row visitors)
+
+#include "ResultSet.h"  // Typed columnar query results
 
 namespace ERP {
 namespace Database {
@@ -88,6 +91,26 @@ public:
      */
     virtual std::vector<std::map<std::string, std::any>> query(const std::string& sql, const std::map<std::string, std::any>& params = {}) = 0;
 
+    /**
+     * @brief Executes a query SQL statement and decodes it into typed column buffers.
+     * Column names are resolved once per statement instead of being copied into every row.
+     * @param sql The SQL query to execute.
+     * @param params Optional map of parameters for prepared statements.
+     * @return The decoded ResultSet. Returns an empty ResultSet on error or no results.
+     */
+    virtual ResultSet queryResultSet(const std::string& sql, const std::map<std::string, std::any>& params = {}) = 0;
+
+    /**
+     * @brief Executes a query and hands the rows to a visitor one at a time, without buffering the result.
+     * The ResultSet passed to the visitor holds exactly one row (row 0) and is reused for the next row.
+     * @param sql The SQL query to execute.
+     * @param params Parameters for prepared statements.
+     * @param rowVisitor Called once per row; return false to stop early.
+     * @return True if the query ran to completion or was stopped by the visitor, false on error.
+     */
+    virtual bool queryEach(const std::string& sql, const std::map<std::string, std::any>& params,
+                           const std::function<bool(const ResultSet& row)>& rowVisitor) = 0;
+
     /**
      * @brief Starts a database transaction.
      * @return True if the transaction was successfully started, false otherwise.
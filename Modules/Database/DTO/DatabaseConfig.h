@@ -15,6 +15,40 @@ enum class DatabaseType {
     PostgreSQL, // Example for future expansion
     MySQL       // Example for future expansion
 };
+/**
+ * @brief SQLite "PRAGMA synchronous" levels.
+ */
+enum class SQLiteSynchronous {
+    OFF,
+    NORMAL, // Safe with WAL: only a power loss can drop the last commits, never corrupt
+    FULL,
+    EXTRA
+};
+/**
+ * @brief SQLite "PRAGMA temp_store" locations for temporary tables and indices.
+ */
+enum class SQLiteTempStore {
+    DEFAULT,
+    FILE,
+    MEMORY
+};
+/**
+ * @brief Per-connection SQLite tuning applied every time a connection is opened.
+ * The defaults are the production profile: WAL journal, synchronous=NORMAL, a 64 MiB page
+ * cache, 256 MiB of memory-mapped I/O, in-memory temp store, a 5 s busy timeout so writers
+ * wait for each other instead of failing with SQLITE_BUSY. Foreign keys are left unenforced, as
+ * before; turn them on only for a database that passes PRAGMA foreign_key_check.
+ */
+struct SQLiteTuningProfile {
+    bool walMode = true;                                        /**< PRAGMA journal_mode=WAL (otherwise the rollback journal is kept). */
+    SQLiteSynchronous synchronous = SQLiteSynchronous::NORMAL;  /**< PRAGMA synchronous. */
+    int cacheSizeKiB = 64 * 1024;                               /**< PRAGMA cache_size, in KiB (applied as a negative value). */
+    long long mmapSizeBytes = 256LL * 1024 * 1024;              /**< PRAGMA mmap_size. 0 disables memory-mapped I/O. */
+    SQLiteTempStore tempStore = SQLiteTempStore::MEMORY;        /**< PRAGMA temp_store. */
+    int busyTimeoutMs = 5000;                                   /**< sqlite3_busy_timeout. 0 fails immediately on lock contention. */
+    bool foreignKeys = false;                                   /**< PRAGMA foreign_keys. Off by default: existing data was never checked. */
+    int maintenanceIntervalSeconds = 300;                       /**< Interval of the pool's wal_checkpoint(PASSIVE) + PRAGMA optimize run. 0 disables it. */
+};
 /**
  * @brief DTO for Database Configuration.
  * Contains all necessary parameters to establish a database connection.
@@ -28,6 +62,10 @@ struct DatabaseConfig {
     std::optional<std::string> password; /**< Password for database authentication. */
     int maxConnections = 10;    /**< MỚI: Maximum number of connections in the pool. */
     int connectionTimeoutSeconds = 30; /**< MỚI: Timeout for acquiring a connection from the pool. */
+    int statementCacheSize = 64; /**< Prepared statements cached per connection (LRU). 0 disables the cache. */
+    SQLiteTuningProfile sqliteTuning; /**< PRAGMAs applied to every SQLite connection on open. */
+    bool readWriteSplit = false; /**< Splits the pool into dedicated writer(s) and SQLITE_OPEN_READONLY readers (needs WAL). */
+    int writerConnections = 1;   /**< Writers when readWriteSplit is on; the rest of maxConnections are readers. */
     // Default constructor
     DatabaseConfig() : type(DatabaseType::SQLite) {}
 };
@@ -10,7 +10,7 @@ namespace Database {
 DatabaseConnectionManager::DatabaseConnectionManager(std::shared_ptr<ConnectionPool> connectionPool)
     : connectionPool_(connectionPool) {
     if (!connectionPool_) {
-        ERP::Logger::Logger::getInstance().critical("DatabaseConnectionManager", "ConnectionPool is null during initialization.");
+        ERP::Logger::Logger::getInstance().critical("ConnectionPool is null during initialization.", "DatabaseConnectionManager");
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::ServerError, "ConnectionPool is null.", "Lỗi hệ thống: Dịch vụ quản lý kết nối cơ sở dữ liệu không khả dụng.");
         throw std::runtime_error("DatabaseConnectionManager: Null ConnectionPool.");
     }
@@ -19,13 +19,13 @@ DatabaseConnectionManager::DatabaseConnectionManager(std::shared_ptr<ConnectionP
 
 std::shared_ptr<DBConnection> DatabaseConnectionManager::acquireConnection() {
     if (!connectionPool_) {
-        ERP::Logger::Logger::getInstance().error("DatabaseConnectionManager", "Cannot acquire connection: ConnectionPool is null.");
+        ERP::Logger::Logger::getInstance().error("Cannot acquire connection: ConnectionPool is null.", "DatabaseConnectionManager");
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::ServerError, "ConnectionPool is null.", "Lỗi hệ thống: Dịch vụ quản lý kết nối cơ sở dữ liệu không khả dụng.");
         return nullptr;
     }
     std::shared_ptr<DBConnection> conn = connectionPool_->getConnection();
     if (!conn) {
-        ERP::Logger::Logger::getInstance().error("DatabaseConnectionManager", "Failed to acquire database connection from pool.");
+        ERP::Logger::Logger::getInstance().error("Failed to acquire database connection from pool.", "DatabaseConnectionManager");
         // Error already handled by ConnectionPool, so just return nullptr
     }
     return conn;
@@ -33,7 +33,7 @@ std::shared_ptr<DBConnection> DatabaseConnectionManager::acquireConnection() {
 
 void DatabaseConnectionManager::releaseConnection(std::shared_ptr<DBConnection> connection) {
     if (!connectionPool_) {
-        ERP::Logger::Logger::getInstance().warning("DatabaseConnectionManager", "Cannot release connection: ConnectionPool is null. Connection might leak.");
+        ERP::Logger::Logger::getInstance().warning("Cannot release connection: ConnectionPool is null. Connection might leak.", "DatabaseConnectionManager");
         // Cannot handle, connection might be leaked. Log critical error perhaps.
         return;
     }
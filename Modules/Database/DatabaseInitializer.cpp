@@ -21,15 +21,16 @@ DatabaseInitializer::DatabaseInitializer(const DTO::DatabaseConfig& config)
     try {
         // Direct connection for schema initialization (not from pool yet)
         if (config_.type == DTO::DatabaseType::SQLite) {
-            dbConnection_ = std::make_shared<SQLiteConnection>(config_.database);
+            dbConnection_ = std::make_shared<SQLiteConnection>(config_.database, SQLiteConnection::DEFAULT_STATEMENT_CACHE_CAPACITY,
+                                                               config_.sqliteTuning);
         } else {
-            ERP::Logger::Logger::getInstance().critical("DatabaseInitializer", "Unsupported database type for direct initialization.");
+            ERP::Logger::Logger::getInstance().critical("Unsupported database type for direct initialization.", "DatabaseInitializer");
             ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Unsupported database type for initialization.", "Kiểu cơ sở dữ liệu không được hỗ trợ.");
             throw std::runtime_error("Unsupported database type.");
         }
 
         if (!dbConnection_->open()) {
-            ERP::Logger::Logger::getInstance().critical("DatabaseInitializer", "Failed to open database connection for initialization.");
+            ERP::Logger::Logger::getInstance().critical("Failed to open database connection for initialization.", "DatabaseInitializer");
             ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "Failed to open database connection.", "Không thể mở kết nối cơ sở dữ liệu.");
             throw std::runtime_error("Failed to open database connection for initialization.");
         }
@@ -63,7 +64,7 @@ DatabaseInitializer::DatabaseInitializer(const DTO::DatabaseConfig& config)
         pickingDetailDAO_ = std::make_shared<Warehouse::DAOs::PickingDetailDAO>(dbConnection_);
 
     } catch (const std::exception& e) {
-        ERP::Logger::Logger::getInstance().critical("DatabaseInitializer", "Initialization failed: " + std::string(e.what()));
+        ERP::Logger::Logger::getInstance().critical("Initialization failed: " + std::string(e.what()), "DatabaseInitializer");
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::ServerError, "DatabaseInitializer: Initialization failed.", "Khởi tạo cơ sở dữ liệu thất bại.");
         throw;
     }
@@ -74,6 +75,10 @@ bool DatabaseInitializer::initializeDatabase() {
         ERP::Logger::Logger::getInstance().error("DatabaseInitializer: Schema initialization failed.");
         return false;
     }
+    if (!applyMigrations()) {
+        ERP::Logger::Logger::getInstance().error("DatabaseInitializer: Schema migration failed.");
+        return false;
+    }
     if (!populateInitialData()) {
         ERP::Logger::Logger::getInstance().warning("DatabaseInitializer: Initial data population failed or skipped.");
         // This might not be a critical error, depending on if data is truly optional.
@@ -163,6 +168,17 @@ bool DatabaseInitializer::initializeSchema() {
     return success;
 }
 
+bool DatabaseInitializer::applyMigrations() {
+    ERP::Logger::Logger::getInstance().info("DatabaseInitializer: Applying schema migrations...");
+    SchemaMigrator migrator(dbConnection_);
+    return migrator.migrate();
+}
+
+std::vector<QueryPlanReport> DatabaseInitializer::runIndexDiagnostics() {
+    SchemaMigrator migrator(dbConnection_);
+    return migrator.runIndexDiagnostics();
+}
+
 bool DatabaseInitializer::populateInitialData() {
     ERP::Logger::Logger::getInstance().info("DatabaseInitializer: Populating initial data...");
 
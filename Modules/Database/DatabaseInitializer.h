@@ -9,6 +9,7 @@
 #include "DatabaseConfig.h"     // DTO for database configuration
 #include "DBConnection.h"       // Base DB connection interface
 #include "SQLiteConnection.h"   // SQLite implementation
+#include "SchemaMigrator.h"     // Versioned schema migrations (index set)
 #include "Logger.h"             // For logging
 #include "ErrorHandler.h"       // For error handling
 #include "Common.h"             // For ErrorCode, DATETIME_FORMAT
@@ -101,8 +102,21 @@ public:
     bool populateInitialData();
 
     /**
-     * @brief Combines schema initialization and initial data population.
-     * @return True if both steps are successful, false otherwise.
+     * @brief Applies pending versioned schema migrations (e.g. the secondary index set).
+     * Must run after initializeSchema() so that all tables exist.
+     * @return True if the schema is at the latest version, false otherwise.
+     */
+    bool applyMigrations();
+
+    /**
+     * @brief Runs EXPLAIN QUERY PLAN over the application's hot queries and logs which use an index.
+     * @return One report per probed query.
+     */
+    std::vector<QueryPlanReport> runIndexDiagnostics();
+
+    /**
+     * @brief Combines schema initialization, migrations and initial data population.
+     * @return True if schema and migrations succeed, false otherwise.
      */
     bool initializeDatabase();
 
@@ -0,0 +1,93 @@
+// Modules/Database/ResultSet.cpp
+#include "ResultSet.h"
+
+#include <utility> // For std::move
+
+namespace ERP {
+namespace Database {
+
+ResultSet::ResultSet(std::vector<std::string> columnNames)
+    : columnNames_(std::move(columnNames)), columns_(columnNames_.size()), rowCount_(0) {}
+
+int ResultSet::columnIndex(const std::string& columnName) const {
+    // Result sets are narrow (tens of columns), so a linear scan done once per query beats hashing.
+    for (std::size_t i = 0; i < columnNames_.size(); ++i) {
+        if (columnNames_[i] == columnName) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool ResultSet::isNull(std::size_t row, std::size_t column) const {
+    return std::holds_alternative<std::monostate>(columns_[column][row]);
+}
+
+std::optional<long long> ResultSet::getInt64(std::size_t row, std::size_t column) const {
+    const Cell& value = columns_[column][row];
+    if (const auto* i = std::get_if<long long>(&value)) {
+        return *i;
+    }
+    if (const auto* d = std::get_if<double>(&value)) {
+        return static_cast<long long>(*d);
+    }
+    return std::nullopt;
+}
+
+std::optional<double> ResultSet::getDouble(std::size_t row, std::size_t column) const {
+    const Cell& value = columns_[column][row];
+    if (const auto* d = std::get_if<double>(&value)) {
+        return *d;
+    }
+    if (const auto* i = std::get_if<long long>(&value)) {
+        return static_cast<double>(*i);
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> ResultSet::getString(std::size_t row, std::size_t column) const {
+    const Cell& value = columns_[column][row];
+    if (const auto* s = std::get_if<std::string>(&value)) {
+        return *s;
+    }
+    if (const auto* i = std::get_if<long long>(&value)) {
+        return std::to_string(*i);
+    }
+    if (const auto* d = std::get_if<double>(&value)) {
+        return std::to_string(*d);
+    }
+    return std::nullopt;
+}
+
+void ResultSet::reserve(std::size_t rows) {
+    for (auto& column : columns_) {
+        column.reserve(rows);
+    }
+}
+
+void ResultSet::clearRows() {
+    for (auto& column : columns_) {
+        column.clear();
+    }
+    rowCount_ = 0;
+}
+
+std::map<std::string, std::any> ResultSet::rowToMap(std::size_t row) const {
+    std::map<std::string, std::any> data;
+    for (std::size_t c = 0; c < columns_.size(); ++c) {
+        const Cell& value = columns_[c][row];
+        if (const auto* i = std::get_if<long long>(&value)) {
+            data[columnNames_[c]] = *i;
+        } else if (const auto* d = std::get_if<double>(&value)) {
+            data[columnNames_[c]] = *d;
+        } else if (const auto* s = std::get_if<std::string>(&value)) {
+            data[columnNames_[c]] = *s;
+        } else {
+            data[columnNames_[c]] = std::any(); // SQL NULL
+        }
+    }
+    return data;
+}
+
+} // namespace Database
+} // namespace ERP
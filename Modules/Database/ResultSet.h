@@ -0,0 +1,140 @@
+// Modules/Database/ResultSet.h
+#ifndef MODULES_DATABASE_RESULTSET_H
+#define MODULES_DATABASE_RESULTSET_H
+
+#include <string>       // For std::string
+#include <vector>       // For std::vector
+#include <map>          // For std::map (compatibility conversion)
+#include <any>          // For std::any (compatibility conversion)
+#include <optional>     // For std::optional
+#include <variant>      // For std::variant
+#include <cstddef>      // For std::size_t
+#include <utility>      // For std::move
+
+namespace ERP {
+namespace Database {
+
+/**
+ * @brief ResultSet holds the rows of a query in column-major, typed storage.
+ *
+ * Column names are stored once per result set (not once per cell) and each column is a
+ * contiguous vector of typed cells, so decoding a large table does not allocate a map
+ * node and a key string per value. Callers resolve a column name to an index once with
+ * columnIndex() and then read cells by (row, column) index.
+ */
+class ResultSet {
+public:
+    /**
+     * @brief A single typed cell. std::monostate represents SQL NULL.
+     */
+    using Cell = std::variant<std::monostate, long long, double, std::string>;
+
+    ResultSet() = default;
+
+    /**
+     * @brief Constructs an empty result set with the given columns.
+     * @param columnNames Column names in statement order.
+     */
+    explicit ResultSet(std::vector<std::string> columnNames);
+
+    /**
+     * @brief Gets the number of rows.
+     */
+    std::size_t rowCount() const { return rowCount_; }
+
+    /**
+     * @brief Gets the number of columns.
+     */
+    std::size_t columnCount() const { return columnNames_.size(); }
+
+    /**
+     * @brief Checks whether the result set has no rows.
+     */
+    bool empty() const { return rowCount_ == 0; }
+
+    /**
+     * @brief Gets the column names in statement order.
+     */
+    const std::vector<std::string>& columnNames() const { return columnNames_; }
+
+    /**
+     * @brief Resolves a column name to its index.
+     * @param columnName The column name.
+     * @return The column index, or -1 if the result set has no such column.
+     */
+    int columnIndex(const std::string& columnName) const;
+
+    /**
+     * @brief Gets a whole column as a contiguous vector of cells.
+     * @param column The column index.
+     */
+    const std::vector<Cell>& column(std::size_t column) const { return columns_[column]; }
+
+    /**
+     * @brief Gets a single cell.
+     * @param row The row index.
+     * @param column The column index.
+     */
+    const Cell& cell(std::size_t row, std::size_t column) const { return columns_[column][row]; }
+
+    /**
+     * @brief Checks whether a cell is SQL NULL.
+     */
+    bool isNull(std::size_t row, std::size_t column) const;
+
+    /**
+     * @brief Reads a cell as an integer. Real values are truncated, text and NULL yield std::nullopt.
+     */
+    std::optional<long long> getInt64(std::size_t row, std::size_t column) const;
+
+    /**
+     * @brief Reads a cell as a double. Integer values are widened, text and NULL yield std::nullopt.
+     */
+    std::optional<double> getDouble(std::size_t row, std::size_t column) const;
+
+    /**
+     * @brief Reads a cell as text. Numeric values are formatted, NULL yields std::nullopt.
+     */
+    std::optional<std::string> getString(std::size_t row, std::size_t column) const;
+
+    /**
+     * @brief Reserves storage for the expected number of rows in every column.
+     * @param rows Expected row count.
+     */
+    void reserve(std::size_t rows);
+
+    /**
+     * @brief Appends a cell to a column. Used by DBConnection implementations while stepping a statement.
+     * All columns must receive exactly one cell before commitRow() is called.
+     * @param column The column index.
+     * @param value The cell value.
+     */
+    void append(std::size_t column, Cell value) { columns_[column].push_back(std::move(value)); }
+
+    /**
+     * @brief Marks the current row as complete after all of its cells have been appended.
+     */
+    void commitRow() { ++rowCount_; }
+
+    /**
+     * @brief Drops all rows but keeps the columns and their allocated storage (used when streaming).
+     */
+    void clearRows();
+
+    /**
+     * @brief Converts one row to the legacy map representation (for DAOs without a column binding).
+     * @param row The row index.
+     * @return A map of column name to std::any, with NULL represented as an empty std::any.
+     */
+    std::map<std::string, std::any> rowToMap(std::size_t row) const;
+
+private:
+    std::vector<std::string> columnNames_;
+    std::vector<std::vector<Cell>> columns_;
+    std::size_t rowCount_ = 0;
+};
+
+} // namespace Database
+} // namespace ERP
+
+#endif // MODULES_DATABASE_RESULTSET_H
@@ -3,11 +3,14 @@
 #include "Logger.h" // Standard includes
 #include "ErrorHandler.h" // Standard includes
 #include "Common.h" // Standard includes
+#include "AutoRelease.h" // RAII helper
+#include <algorithm> // For std::find_if
 
 namespace ERP {
 namespace Database {
 
-SQLiteConnection::SQLiteConnection(const std::string& dbPath) : dbPath_(dbPath), db_(nullptr) {
+SQLiteConnection::SQLiteConnection(const std::string& dbPath, std::size_t statementCacheCapacity, const DTO::SQLiteTuningProfile& tuning, bool readOnly)
+    : dbPath_(dbPath), db_(nullptr), tuning_(tuning), readOnly_(readOnly), statementCacheCapacity_(statementCacheCapacity) {
     ERP::Logger::Logger::getInstance().debug("SQLiteConnection: Constructing for DB: " + dbPath_);
 }
 
@@ -22,22 +25,80 @@ bool SQLiteConnection::open() {
         return true; // Already open
     }
 
-    ERP::Logger::Logger::getInstance().info("SQLiteConnection: Opening connection to DB: " + dbPath_);
-    int rc = sqlite3_open(dbPath_.c_str(), &db_);
+    ERP::Logger::Logger::getInstance().info("SQLiteConnection: Opening " + std::string(readOnly_ ? "read-only " : "") + "connection to DB: " + dbPath_);
+    int flags = readOnly_ ? SQLITE_OPEN_READONLY : (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    int rc = sqlite3_open_v2(dbPath_.c_str(), &db_, flags, nullptr);
     if (rc != SQLITE_OK) {
         lastError_ = sqlite3_errmsg(db_);
         ERP::Logger::Logger::getInstance().error("SQLiteConnection: Failed to open database: " + lastError_);
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "SQLiteConnection: Failed to open database.", "Không thể mở cơ sở dữ liệu.");
+        sqlite3_close(db_); // sqlite3_open allocates a handle even on failure
         db_ = nullptr; // Ensure db_ is null if open fails
         return false;
     }
+    applyTuningProfile();
     ERP::Logger::Logger::getInstance().info("SQLiteConnection: Database connection opened successfully.");
     return true;
 }
 
+void SQLiteConnection::applyTuningProfile() {
+    static const char* const synchronousNames[] = {"OFF", "NORMAL", "FULL", "EXTRA"};
+    static const char* const tempStoreNames[] = {"DEFAULT", "FILE", "MEMORY"};
+
+    // Set first so that the journal_mode switch below already waits on a locked database
+    sqlite3_busy_timeout(db_, tuning_.busyTimeoutMs > 0 ? tuning_.busyTimeoutMs : 0);
+
+    std::vector<std::string> pragmas;
+    if (tuning_.walMode && !readOnly_) {
+        // journal_mode is persistent in the file; read-only connections inherit it from the writer
+        pragmas.push_back("PRAGMA journal_mode=WAL;");
+    }
+    pragmas.push_back(std::string("PRAGMA synchronous=") + synchronousNames[static_cast<int>(tuning_.synchronous)] + ";");
+    pragmas.push_back("PRAGMA cache_size=" + std::to_string(-static_cast<long long>(tuning_.cacheSizeKiB)) + ";");
+    pragmas.push_back("PRAGMA mmap_size=" + std::to_string(tuning_.mmapSizeBytes) + ";");
+    pragmas.push_back(std::string("PRAGMA temp_store=") + tempStoreNames[static_cast<int>(tuning_.tempStore)] + ";");
+    pragmas.push_back(std::string("PRAGMA foreign_keys=") + (tuning_.foreignKeys ? "ON" : "OFF") + ";");
+
+    for (const auto& pragma : pragmas) {
+        char* errMsg = nullptr;
+        int rc = sqlite3_exec(db_, pragma.c_str(), nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            // A connection with default settings is still usable, so this is not fatal
+            ERP::Logger::Logger::getInstance().warning("SQLiteConnection: Failed to apply '" + pragma + "': " + (errMsg ? errMsg : sqlite3_errmsg(db_)));
+            sqlite3_free(errMsg);
+        }
+    }
+    ERP::Logger::Logger::getInstance().debug("SQLiteConnection: Tuning profile applied (" + std::to_string(pragmas.size()) + " pragmas).");
+}
+
+bool SQLiteConnection::runMaintenance() {
+    if (!isOpen() || readOnly_) {
+        return false;
+    }
+    bool success = true;
+    std::vector<std::string> statements;
+    if (tuning_.walMode) {
+        // PASSIVE never blocks readers or writers; it copies what it can and leaves the rest for next time
+        statements.push_back("PRAGMA wal_checkpoint(PASSIVE);");
+    }
+    statements.push_back("PRAGMA optimize;");
+    for (const auto& statement : statements) {
+        char* errMsg = nullptr;
+        int rc = sqlite3_exec(db_, statement.c_str(), nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            lastError_ = errMsg ? errMsg : sqlite3_errmsg(db_);
+            ERP::Logger::Logger::getInstance().warning("SQLiteConnection: Maintenance statement '" + statement + "' failed: " + lastError_);
+            sqlite3_free(errMsg);
+            success = false;
+        }
+    }
+    return success;
+}
+
 void SQLiteConnection::close() {
     if (db_ != nullptr) {
         ERP::Logger::Logger::getInstance().info("SQLiteConnection: Closing connection to DB: " + dbPath_);
+        clearStatementCache(); // Outstanding statements would make sqlite3_close fail with SQLITE_BUSY
         int rc = sqlite3_close(db_);
         if (rc != SQLITE_OK) {
             lastError_ = sqlite3_errmsg(db_);
@@ -61,30 +122,28 @@ bool SQLiteConnection::execute(const std::string& sql, const std::map<std::strin
         return false;
     }
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        lastError_ = sqlite3_errmsg(db_);
+    sqlite3_stmt* stmt = acquireStatement(sql);
+    if (stmt == nullptr) {
         ERP::Logger::Logger::getInstance().error("SQLiteConnection: Failed to prepare statement '" + sql + "': " + lastError_);
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "SQLiteConnection: Failed to prepare statement.", "Lỗi chuẩn bị câu lệnh SQL.");
         return false;
     }
 
     if (!bindParameters(stmt, params)) {
-        sqlite3_finalize(stmt);
+        releaseStatement(sql, stmt);
         return false; // Error binding parameters
     }
 
-    rc = sqlite3_step(stmt);
+    int rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE) {
         lastError_ = sqlite3_errmsg(db_);
         ERP::Logger::Logger::getInstance().error("SQLiteConnection: Failed to execute statement '" + sql + "': " + lastError_);
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "SQLiteConnection: Failed to execute statement.", "Lỗi thực thi câu lệnh SQL.");
-        sqlite3_finalize(stmt);
+        releaseStatement(sql, stmt);
         return false;
     }
 
-    sqlite3_finalize(stmt);
+    releaseStatement(sql, stmt);
     return true;
 }
 
@@ -97,20 +156,19 @@ std::vector<std::map<std::string, std::any>> SQLiteConnection::query(const std::
         return results;
     }
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
-        lastError_ = sqlite3_errmsg(db_);
+    sqlite3_stmt* stmt = acquireStatement(sql);
+    if (stmt == nullptr) {
         ERP::Logger::Logger::getInstance().error("SQLiteConnection: Failed to prepare query '" + sql + "': " + lastError_);
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "SQLiteConnection: Failed to prepare query.", "Lỗi chuẩn bị câu truy vấn SQL.");
         return results;
     }
 
     if (!bindParameters(stmt, params)) {
-        sqlite3_finalize(stmt);
+        releaseStatement(sql, stmt);
         return results; // Error binding parameters
     }
 
+    int rc;
     while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
         std::map<std::string, std::any> row;
         int colCount = sqlite3_column_count(stmt);
@@ -129,10 +187,111 @@ std::vector<std::map<std::string, std::any>> SQLiteConnection::query(const std::
         results.clear(); // Clear partial results on error
     }
 
-    sqlite3_finalize(stmt);
+    releaseStatement(sql, stmt);
+    return results;
+}
+
+ResultSet SQLiteConnection::queryResultSet(const std::string& sql, const std::map<std::string, std::any>& params) {
+    if (!isOpen()) {
+        lastError_ = "Database connection is not open.";
+        ERP::Logger::Logger::getInstance().error("SQLiteConnection: " + lastError_ + " SQL: " + sql);
+        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "Database not open.", "Kết nối cơ sở dữ liệu chưa được mở.");
+        return ResultSet();
+    }
+
+    sqlite3_stmt* stmt = acquireStatement(sql);
+    if (stmt == nullptr) {
+        ERP::Logger::Logger::getInstance().error("SQLiteConnection: Failed to prepare query '" + sql + "': " + lastError_);
+        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "SQLiteConnection: Failed to prepare query.", "Lỗi chuẩn bị câu truy vấn SQL.");
+        return ResultSet();
+    }
+
+    if (!bindParameters(stmt, params)) {
+        releaseStatement(sql, stmt);
+        return ResultSet(); // Error binding parameters
+    }
+
+    // Column names are read once per statement, not once per row
+    int colCount = sqlite3_column_count(stmt);
+    std::vector<std::string> columnNames;
+    columnNames.reserve(static_cast<std::size_t>(colCount));
+    for (int i = 0; i < colCount; ++i) {
+        columnNames.emplace_back(sqlite3_column_name(stmt, i));
+    }
+    ResultSet results(std::move(columnNames));
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        for (int i = 0; i < colCount; ++i) {
+            results.append(static_cast<std::size_t>(i), getColumnCell(stmt, i));
+        }
+        results.commitRow();
+    }
+
+    if (rc != SQLITE_DONE) {
+        lastError_ = sqlite3_errmsg(db_);
+        ERP::Logger::Logger::getInstance().error("SQLiteConnection: Query execution failed for '" + sql + "': " + lastError_);
+        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "SQLiteConnection: Query execution failed.", "Lỗi thực thi câu truy vấn SQL.");
+        releaseStatement(sql, stmt);
+        return ResultSet(); // Discard partial results on error
+    }
+
+    releaseStatement(sql, stmt);
     return results;
 }
 
+bool SQLiteConnection::queryEach(const std::string& sql, const std::map<std::string, std::any>& params,
+                                 const std::function<bool(const ResultSet& row)>& rowVisitor) {
+    if (!isOpen()) {
+        lastError_ = "Database connection is not open.";
+        ERP::Logger::Logger::getInstance().error("SQLiteConnection: " + lastError_ + " SQL: " + sql);
+        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "Database not open.", "Kết nối cơ sở dữ liệu chưa được mở.");
+        return false;
+    }
+
+    sqlite3_stmt* stmt = acquireStatement(sql);
+    if (stmt == nullptr) {
+        ERP::Logger::Logger::getInstance().error("SQLiteConnection: Failed to prepare query '" + sql + "': " + lastError_);
+        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "SQLiteConnection: Failed to prepare query.", "Lỗi chuẩn bị câu truy vấn SQL.");
+        return false;
+    }
+
+    // The visitor may throw; the statement must still go back to the cache (or be finalized)
+    AutoRelease statementGuard([&]() { releaseStatement(sql, stmt); });
+    if (!bindParameters(stmt, params)) {
+        return false; // Error binding parameters
+    }
+
+    int colCount = sqlite3_column_count(stmt);
+    std::vector<std::string> columnNames;
+    columnNames.reserve(static_cast<std::size_t>(colCount));
+    for (int i = 0; i < colCount; ++i) {
+        columnNames.emplace_back(sqlite3_column_name(stmt, i));
+    }
+    ResultSet row(std::move(columnNames)); // One row buffer, reused for every step
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        row.clearRows();
+        for (int i = 0; i < colCount; ++i) {
+            row.append(static_cast<std::size_t>(i), getColumnCell(stmt, i));
+        }
+        row.commitRow();
+        if (!rowVisitor(row)) {
+            rc = SQLITE_DONE; // Stopped by the visitor
+            break;
+        }
+    }
+
+    if (rc != SQLITE_DONE) {
+        lastError_ = sqlite3_errmsg(db_);
+        ERP::Logger::Logger::getInstance().error("SQLiteConnection: Query execution failed for '" + sql + "': " + lastError_);
+        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "SQLiteConnection: Query execution failed.", "Lỗi thực thi câu truy vấn SQL.");
+        return false;
+    }
+    return true;
+}
+
 bool SQLiteConnection::beginTransaction() {
     if (!isOpen()) {
         lastError_ = "Database connection is not open.";
@@ -192,14 +351,96 @@ std::string SQLiteConnection::getLastError() const {
 }
 
 void SQLiteConnection::reset() {
-    if (isOpen()) {
-        // Ensure any active transaction is rolled back
+    if (isOpen() && sqlite3_get_autocommit(db_) == 0) {
+        // Roll back a transaction left open by the previous user. Without this check every
+        // release would issue ROLLBACK on an idle connection and report "no transaction is active".
         rollbackTransaction(); // Attempt rollback, ignoring success result here
         // No other specific state to reset for a basic SQLite connection managed by API
     }
     ERP::Logger::Logger::getInstance().debug("SQLiteConnection: Connection state reset.");
 }
 
+StatementCacheStats SQLiteConnection::getStatementCacheStats() const {
+    StatementCacheStats stats;
+    stats.hits = statementCacheHits_.load();
+    stats.misses = statementCacheMisses_.load();
+    stats.evictions = statementCacheEvictions_.load();
+    stats.size = statementCacheSize_.load();
+    stats.capacity = statementCacheCapacity_;
+    return stats;
+}
+
+void SQLiteConnection::clearStatementCache() {
+    for (auto& entry : statementLru_) {
+        sqlite3_finalize(entry.second.stmt);
+    }
+    statementLru_.clear();
+    statementIndex_.clear();
+    statementCacheSize_ = 0;
+}
+
+sqlite3_stmt* SQLiteConnection::acquireStatement(const std::string& sql) {
+    auto cached = statementIndex_.find(sql);
+    if (cached != statementIndex_.end() && !cached->second->second.inUse) {
+        // Move to the front (most recently used) and hand out a clean statement
+        statementLru_.splice(statementLru_.begin(), statementLru_, cached->second);
+        CachedStatement& entry = cached->second->second;
+        sqlite3_reset(entry.stmt);
+        sqlite3_clear_bindings(entry.stmt);
+        entry.inUse = true;
+        ++statementCacheHits_;
+        return entry.stmt;
+    }
+
+    // Nested use of a statement that is still stepping: compile a private copy, finalized on release
+    const bool cacheable = statementCacheCapacity_ > 0 && cached == statementIndex_.end();
+    ++statementCacheMisses_;
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v3(db_, sql.c_str(), static_cast<int>(sql.size()),
+                                cacheable ? SQLITE_PREPARE_PERSISTENT : 0, &stmt, nullptr);
+    if (rc != SQLITE_OK) {
+        lastError_ = sqlite3_errmsg(db_);
+        if (stmt != nullptr) {
+            sqlite3_finalize(stmt);
+        }
+        return nullptr;
+    }
+    if (!cacheable) {
+        return stmt;
+    }
+
+    if (statementIndex_.size() >= statementCacheCapacity_) {
+        // Evict the least recently used statement that nobody is stepping
+        auto victim = std::find_if(statementLru_.rbegin(), statementLru_.rend(),
+                                   [](const auto& entry) { return !entry.second.inUse; });
+        if (victim == statementLru_.rend()) {
+            return stmt; // Every cached statement is in use; this one stays uncached
+        }
+        sqlite3_finalize(victim->second.stmt);
+        statementIndex_.erase(victim->first);
+        statementLru_.erase(std::next(victim).base());
+        ++statementCacheEvictions_;
+    }
+    statementLru_.emplace_front(sql, CachedStatement{ stmt, true });
+    statementIndex_[sql] = statementLru_.begin();
+    statementCacheSize_ = statementIndex_.size();
+    return stmt;
+}
+
+void SQLiteConnection::releaseStatement(const std::string& sql, sqlite3_stmt* stmt) {
+    if (stmt == nullptr) {
+        return;
+    }
+    auto cached = statementIndex_.find(sql);
+    if (cached == statementIndex_.end() || cached->second->second.stmt != stmt) {
+        sqlite3_finalize(stmt); // Uncached: caching disabled, cache full of busy statements, or a nested copy
+        return;
+    }
+    // Resetting ends the implicit read transaction of a SELECT; bindings are cleared on next acquire
+    sqlite3_reset(stmt);
+    cached->second->second.inUse = false;
+}
+
 bool SQLiteConnection::bindParameters(sqlite3_stmt* stmt, const std::map<std::string, std::any>& params) {
     for (const auto& pair : params) {
         std::string paramName = ":" + pair.first; // SQLite named parameters start with :
@@ -211,7 +452,9 @@ bool SQLiteConnection::bindParameters(sqlite3_stmt* stmt, const std::map<std::st
         }
 
         int rc = SQLITE_OK;
-        if (pair.second.type() == typeid(int)) {
+        if (!pair.second.has_value()) { // Empty std::any (putOptional* with no value): NULL
+            rc = sqlite3_bind_null(stmt, paramIndex);
+        } else if (pair.second.type() == typeid(int)) {
             rc = sqlite3_bind_int(stmt, paramIndex, std::any_cast<int>(pair.second));
         } else if (pair.second.type() == typeid(long long)) { // Handle long long if used for IDs/timestamps
             rc = sqlite3_bind_int64(stmt, paramIndex, std::any_cast<long long>(pair.second));
@@ -261,5 +504,24 @@ std::any SQLiteConnection::getColumnValue(sqlite3_stmt* stmt, int colType, int c
     }
 }
 
+ResultSet::Cell SQLiteConnection::getColumnCell(sqlite3_stmt* stmt, int colIndex) {
+    switch (sqlite3_column_type(stmt, colIndex)) {
+        case SQLITE_INTEGER:
+            return static_cast<long long>(sqlite3_column_int64(stmt, colIndex));
+        case SQLITE_FLOAT:
+            return sqlite3_column_double(stmt, colIndex);
+        case SQLITE_TEXT: {
+            const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, colIndex));
+            return std::string(text, static_cast<std::size_t>(sqlite3_column_bytes(stmt, colIndex)));
+        }
+        case SQLITE_BLOB:
+            // Same policy as getColumnValue: BLOBs are not decoded
+            return std::monostate();
+        case SQLITE_NULL:
+        default:
+            return std::monostate();
+    }
+}
+
 } // namespace Database
 } // namespace ERP
\ No newline at end of file
@@ -6,29 +6,53 @@
 #include "Logger.h"             // For logging
 #include "ErrorHandler.h"       // For error handling
 #include "Common.h"             // For ErrorCode
+#include "DatabaseConfig.h"     // For DTO::SQLiteTuningProfile
 
 #include <sqlite3.h>            // SQLite C API
 #include <string>               // For std::string
 #include <map>                  // For std::map
 #include <any>                  // For std::any
 #include <vector>               // For std::vector
+#include <list>                 // For std::list (statement cache LRU order)
+#include <unordered_map>        // For std::unordered_map (statement cache index)
+#include <atomic>               // For std::atomic (statement cache counters)
+#include <cstddef>              // For std::size_t
+#include <cstdint>              // For std::uint64_t
 #include <stdexcept>            // For std::runtime_error
 #include <utility>              // For std::move
+#include <functional>           // For std::function
 
 namespace ERP {
 namespace Database {
 
+/**
+ * @brief Snapshot of the prepared-statement cache counters of a connection.
+ */
+struct StatementCacheStats {
+    std::uint64_t hits = 0;      /**< Number of statements served from the cache. */
+    std::uint64_t misses = 0;    /**< Number of statements that had to be compiled. */
+    std::uint64_t evictions = 0; /**< Number of statements finalized to make room for new ones. */
+    std::size_t size = 0;        /**< Number of statements currently cached. */
+    std::size_t capacity = 0;    /**< Maximum number of cached statements. */
+};
+
 /**
  * @brief The SQLiteConnection class provides a concrete implementation of DBConnection
  * for SQLite databases.
  */
 class SQLiteConnection : public DBConnection {
 public:
+    static constexpr std::size_t DEFAULT_STATEMENT_CACHE_CAPACITY = 64; /**< Default LRU size of the statement cache. */
+
     /**
      * @brief Constructs a SQLiteConnection object.
      * @param dbPath The file path to the SQLite database.
+     * @param statementCacheCapacity Maximum number of prepared statements kept per connection (0 disables caching).
+     * @param tuning PRAGMAs applied every time the connection is opened.
+     * @param readOnly Opens the database with SQLITE_OPEN_READONLY (reader connections of a read/write split pool).
      */
-    explicit SQLiteConnection(const std::string& dbPath);
+    explicit SQLiteConnection(const std::string& dbPath, std::size_t statementCacheCapacity = DEFAULT_STATEMENT_CACHE_CAPACITY,
+                              const DTO::SQLiteTuningProfile& tuning = DTO::SQLiteTuningProfile(), bool readOnly = false);
 
     /**
      * @brief Destructor. Closes the database connection if it's still open.
@@ -69,6 +93,24 @@ public:
      */
     std::vector<std::map<std::string, std::any>> query(const std::string& sql, const std::map<std::string, std::any>& params = {}) override;
 
+    /**
+     * @brief Executes a query SQL statement and decodes it into typed column buffers.
+     * @param sql The SQL query to execute.
+     * @param params Optional map of parameters for prepared statements.
+     * @return The decoded ResultSet, empty on error.
+     */
+    ResultSet queryResultSet(const std::string& sql, const std::map<std::string, std::any>& params = {}) override;
+
+    /**
+     * @brief Steps a query and hands each row to a visitor without buffering the result.
+     * @param sql The SQL query to execute.
+     * @param params Parameters for prepared statements.
+     * @param rowVisitor Called once per row with a single-row ResultSet; return false to stop.
+     * @return True on completion or early stop, false on error.
+     */
+    bool queryEach(const std::string& sql, const std::map<std::string, std::any>& params,
+                   const std::function<bool(const ResultSet& row)>& rowVisitor) override;
+
     /**
      * @brief Starts a database transaction.
      * @return True if the transaction was successfully started, false otherwise.
@@ -99,16 +141,83 @@ public:
      */
     void reset() override;
 
+    /**
+     * @brief Gets the prepared-statement cache counters of this connection.
+     * @return A snapshot of hits, misses, evictions and current size.
+     */
+    StatementCacheStats getStatementCacheStats() const;
+
+    /**
+     * @brief Finalizes every cached prepared statement. Counters are kept.
+     */
+    void clearStatementCache();
+
+    /**
+     * @brief Runs the periodic maintenance of a long-lived connection:
+     * a passive WAL checkpoint (when in WAL mode) followed by PRAGMA optimize.
+     * @return True if both statements succeeded, false otherwise.
+     */
+    bool runMaintenance();
+
+    /**
+     * @brief Checks whether the connection was opened read-only.
+     */
+    bool isReadOnly() const { return readOnly_; }
+
 private:
+    struct CachedStatement {
+        sqlite3_stmt* stmt = nullptr;
+        bool inUse = false; // Handed out by acquireStatement and not yet released
+    };
+    using StatementLruList = std::list<std::pair<std::string, CachedStatement>>;
+
     std::string dbPath_; /**< The path to the SQLite database file. */
     sqlite3* db_ = nullptr; /**< Pointer to the SQLite database handle. */
     mutable std::string lastError_; /**< Stores the last error message. */
+    DTO::SQLiteTuningProfile tuning_; /**< PRAGMAs applied on open. */
+    bool readOnly_; /**< Opened with SQLITE_OPEN_READONLY. */
+
+    // Prepared-statement cache, keyed by SQL text. Front of the list is the most recently used.
+    std::size_t statementCacheCapacity_;
+    StatementLruList statementLru_;
+    std::unordered_map<std::string, StatementLruList::iterator> statementIndex_;
+    std::atomic<std::uint64_t> statementCacheHits_{0};
+    std::atomic<std::uint64_t> statementCacheMisses_{0};
+    std::atomic<std::uint64_t> statementCacheEvictions_{0};
+    std::atomic<std::size_t> statementCacheSize_{0}; // Mirrors statementIndex_.size() for lock-free stats reads
+
+    /**
+     * @brief Returns a ready-to-bind statement for the SQL text, from the cache if possible.
+     * Cached statements are reset and have their bindings cleared before being returned.
+     * A cached statement still in use (e.g. an outer queryEach over the same SQL) is never reset or
+     * evicted; the nested caller gets a fresh uncached statement instead.
+     * @param sql The SQL text.
+     * @return The statement, or nullptr if compilation failed (lastError_ is set).
+     */
+    sqlite3_stmt* acquireStatement(const std::string& sql);
+
+    /**
+     * @brief Hands a statement obtained from acquireStatement back to the cache.
+     * Cached statements are reset so they do not hold read locks and become available again;
+     * uncached ones are finalized.
+     * @param sql The SQL text the statement was acquired for.
+     * @param stmt The statement.
+     */
+    void releaseStatement(const std::string& sql, sqlite3_stmt* stmt);
+
+    /**
+     * @brief Applies tuning_ to the freshly opened handle. A PRAGMA that fails is logged and skipped.
+     */
+    void applyTuningProfile();
 
     // Helper to bind parameters to a prepared statement
     bool bindParameters(sqlite3_stmt* stmt, const std::map<std::string, std::any>& params);
 
     // Helper for safe std::any_cast (specific to SQLite column types)
     std::any getColumnValue(sqlite3_stmt* stmt, int colType, int colIndex);
+
+    // Typed counterpart of getColumnValue used by queryResultSet
+    ResultSet::Cell getColumnCell(sqlite3_stmt* stmt, int colIndex);
 };
 
 } // namespace Database
@@ -0,0 +1,297 @@
+// Modules/Database/SchemaMigrator.cpp
+#include "SchemaMigrator.h"
+#include "Logger.h"       // Standard includes
+#include "ErrorHandler.h" // Standard includes
+#include "Common.h"       // Standard includes
+#include "DateUtils.h"    // For applied_at timestamps
+
+#include <map>            // For std::map
+#include <any>            // For std::any
+#include <stdexcept>      // For std::runtime_error
+
+namespace ERP {
+namespace Database {
+
+namespace {
+// Builds "CREATE INDEX IF NOT EXISTS idx_<table>_<suffix> ON <table>(<columns>);"
+std::string createIndex(const std::string& table, const std::string& suffix, const std::string& columns) {
+    return "CREATE INDEX IF NOT EXISTS idx_" + table + "_" + suffix + " ON " + table + "(" + columns + ");";
+}
+} // namespace
+
+SchemaMigrator::SchemaMigrator(std::shared_ptr<DBConnection> connection)
+    : connection_(connection) {
+    if (!connection_) {
+        ERP::Logger::Logger::getInstance().critical("Initialized with null DBConnection.", "SchemaMigrator");
+        throw std::runtime_error("SchemaMigrator: DBConnection is null.");
+    }
+}
+
+const std::vector<SchemaMigration>& SchemaMigrator::getMigrations() {
+    // Append new migrations at the end with the next version number; never edit an applied one.
+    static const std::vector<SchemaMigration> migrations = {
+        {1, "Secondary indexes for hot lookups and detail-by-parent joins", {
+            // Inventory and costing. inventory(product_id, warehouse_id, location_id) is already covered
+            // by its UNIQUE constraint, and sessions(token) likewise.
+            createIndex("inventory", "warehouse_location", "warehouse_id, location_id"),
+            createIndex("inventory_cost_layers", "key_remaining", "product_id, warehouse_id, location_id, remaining_quantity"),
+            createIndex("inventory_transactions", "key_date", "product_id, warehouse_id, location_id, transaction_date"),
+            createIndex("inventory_transactions", "reference", "reference_document_id"),
+            createIndex("locations", "warehouse", "warehouse_id"),
+            createIndex("products", "category", "category_id"),
+            createIndex("product_unit_conversions", "product", "product_id"),
+
+            // Finance
+            createIndex("journal_entries", "posted_date", "is_posted, posting_date"),
+            createIndex("journal_entry_details", "journal_entry", "journal_entry_id"),
+            createIndex("journal_entry_details", "gl_account", "gl_account_id"),
+            createIndex("accounts_receivable_transactions", "customer", "customer_id"),
+
+            // Security
+            createIndex("sessions", "user", "user_id"),
+            createIndex("user_roles", "user", "user_id"),
+            createIndex("role_permissions", "role", "role_id"),
+            createIndex("audit_logs", "created_at", "created_at"),
+            createIndex("audit_logs", "user_created_at", "user_id, created_at"),
+            createIndex("audit_logs", "entity", "entity_type, entity_id"),
+
+            // Document headers by foreign key
+            createIndex("sales_orders", "customer", "customer_id"),
+            createIndex("invoices", "sales_order", "sales_order_id"),
+            createIndex("invoices", "customer", "customer_id"),
+            createIndex("payments", "invoice", "invoice_id"),
+            createIndex("shipments", "sales_order", "sales_order_id"),
+            createIndex("returns", "sales_order", "sales_order_id"),
+            createIndex("picking_requests", "sales_order", "sales_order_id"),
+
+            // *_details(parent_id)
+            createIndex("picking_details", "picking_request", "picking_request_id"),
+            createIndex("stocktake_details", "stocktake_request", "stocktake_request_id"),
+            createIndex("receipt_slip_details", "receipt_slip", "receipt_slip_id"),
+            createIndex("issue_slip_details", "issue_slip", "issue_slip_id"),
+            createIndex("material_request_slip_details", "material_request_slip", "material_request_slip_id"),
+            createIndex("material_issue_slip_details", "material_issue_slip", "material_issue_slip_id"),
+            createIndex("sales_order_details", "sales_order", "sales_order_id"),
+            createIndex("invoice_details", "invoice", "invoice_id"),
+            createIndex("quotation_details", "quotation", "quotation_id"),
+            createIndex("shipment_details", "shipment", "shipment_id"),
+            createIndex("return_details", "return", "return_id"),
+            createIndex("bill_of_material_items", "bom", "bom_id"),
+            createIndex("maintenance_activities", "maintenance_request", "maintenance_request_id"),
+            createIndex("report_execution_logs", "report_request", "report_request_id"),
+            createIndex("task_execution_logs", "scheduled_task", "scheduled_task_id"),
+            createIndex("task_logs", "task", "task_id"),
+            createIndex("notifications", "user", "user_id")
+        }},
+        {2, "Keyset paging indexes on (created_at, id)", {
+            // DAOBase::getPage orders by (created_at, id); the single-column audit_logs index becomes redundant
+            "DROP INDEX IF EXISTS idx_audit_logs_created_at;",
+            createIndex("audit_logs", "created_at_id", "created_at, id"),
+            createIndex("sales_orders", "created_at_id", "created_at, id"),
+            createIndex("inventory", "created_at_id", "created_at, id"),
+            createIndex("inventory_transactions", "created_at_id", "created_at, id")
+        }},
+        {3, "Covering indexes for per-account GL aggregation", {
+            // GeneralLedgerDAO::getPostedAccountActivity joins posted entries of a period to their lines and
+            // groups by account; with id and the amounts in the indexes neither table is visited.
+            "DROP INDEX IF EXISTS idx_journal_entries_posted_date;",
+            createIndex("journal_entries", "posted_date_id", "is_posted, posting_date, id"),
+            "DROP INDEX IF EXISTS idx_journal_entry_details_journal_entry;",
+            createIndex("journal_entry_details", "entry_account_amounts", "journal_entry_id, gl_account_id, debit_amount, credit_amount")
+        }},
+        {4, "GL period balance snapshots", {
+            // One row per (account, fiscal month). Open rows accumulate postings; closing a period rewrites
+            // its rows with opening/closing balances so as-of reports start from the latest closed snapshot.
+            R"(CREATE TABLE IF NOT EXISTS gl_period_balances (
+                gl_account_id TEXT NOT NULL,
+                period_start TEXT NOT NULL,
+                period_end TEXT NOT NULL,
+                opening_balance REAL NOT NULL DEFAULT 0.0,
+                period_debit REAL NOT NULL DEFAULT 0.0,
+                period_credit REAL NOT NULL DEFAULT 0.0,
+                closing_balance REAL NOT NULL DEFAULT 0.0,
+                is_closed INTEGER NOT NULL DEFAULT 0,
+                updated_at TEXT NOT NULL,
+                PRIMARY KEY (gl_account_id, period_start),
+                FOREIGN KEY (gl_account_id) REFERENCES general_ledger_accounts(id)
+            );)",
+            createIndex("gl_period_balances", "closed_end", "is_closed, period_end")
+        }},
+        {5, "Durable job queue columns on task_logs", {
+            // Job rows reuse task_logs (task_id = job type, log_time = enqueue time) and set job_state;
+            // plain log rows leave it NULL, so the partial indexes below only cover jobs.
+            "ALTER TABLE task_logs ADD COLUMN job_state INTEGER;",
+            "ALTER TABLE task_logs ADD COLUMN priority INTEGER NOT NULL DEFAULT 1;",
+            "ALTER TABLE task_logs ADD COLUMN idempotency_key TEXT;",
+            "ALTER TABLE task_logs ADD COLUMN payload TEXT;",
+            "ALTER TABLE task_logs ADD COLUMN attempts INTEGER NOT NULL DEFAULT 0;",
+            "ALTER TABLE task_logs ADD COLUMN max_attempts INTEGER NOT NULL DEFAULT 5;",
+            "ALTER TABLE task_logs ADD COLUMN available_at TEXT;",
+            "ALTER TABLE task_logs ADD COLUMN lease_owner TEXT;",
+            "ALTER TABLE task_logs ADD COLUMN lease_token TEXT;",
+            "ALTER TABLE task_logs ADD COLUMN lease_expires_at TEXT;",
+            "ALTER TABLE task_logs ADD COLUMN last_error TEXT;",
+            "ALTER TABLE task_logs ADD COLUMN completed_at TEXT;",
+            "ALTER TABLE task_logs ADD COLUMN updated_at TEXT;",
+            "CREATE UNIQUE INDEX IF NOT EXISTS idx_task_logs_idempotency_key ON task_logs(idempotency_key) WHERE idempotency_key IS NOT NULL;",
+            "CREATE INDEX IF NOT EXISTS idx_task_logs_job_ready ON task_logs(job_state, priority, available_at) WHERE job_state IS NOT NULL;",
+            "CREATE INDEX IF NOT EXISTS idx_task_logs_job_lease ON task_logs(job_state, lease_expires_at) WHERE job_state IS NOT NULL;",
+            "CREATE INDEX IF NOT EXISTS idx_task_logs_lease_token ON task_logs(lease_token) WHERE lease_token IS NOT NULL;"
+        }}
+    };
+    return migrations;
+}
+
+int SchemaMigrator::getLatestVersion() {
+    const auto& migrations = getMigrations();
+    return migrations.empty() ? 0 : migrations.back().version;
+}
+
+const std::vector<QueryPlanProbe>& SchemaMigrator::getQueryPlanProbes() {
+    static const std::vector<QueryPlanProbe> probes = {
+        {"inventory by product/location",
+         "SELECT * FROM inventory WHERE product_id = :product_id AND warehouse_id = :warehouse_id AND location_id = :location_id;"},
+        {"open cost layers by product/location",
+         "SELECT * FROM inventory_cost_layers WHERE product_id = :product_id AND warehouse_id = :warehouse_id AND location_id = :location_id AND remaining_quantity > 0;"},
+        {"journal entry details by entry",
+         "SELECT * FROM journal_entry_details WHERE journal_entry_id = :journal_entry_id;"},
+        {"posted journal entries by period",
+         "SELECT * FROM journal_entries WHERE is_posted = 1 AND posting_date BETWEEN :from AND :to;"},
+        {"session by token",
+         "SELECT * FROM sessions WHERE token = :token;"},
+        {"audit logs by time range",
+         "SELECT * FROM audit_logs WHERE created_at >= :from ORDER BY created_at DESC;"},
+        {"sales order details by order",
+         "SELECT * FROM sales_order_details WHERE sales_order_id = :sales_order_id;"},
+        {"picking details by request",
+         "SELECT * FROM picking_details WHERE picking_request_id = :picking_request_id;"},
+        {"stocktake details by request",
+         "SELECT * FROM stocktake_details WHERE stocktake_request_id = :stocktake_request_id;"},
+        {"sales orders keyset page",
+         "SELECT * FROM sales_orders WHERE (created_at, id) > (:page_after_created_at, :page_after_id) ORDER BY created_at ASC, id ASC LIMIT :page_limit;"},
+        {"posted account activity by period",
+         "SELECT d.gl_account_id, TOTAL(d.debit_amount), TOTAL(d.credit_amount) FROM journal_entries e JOIN journal_entry_details d ON d.journal_entry_id = e.id "
+         "WHERE e.is_posted = 1 AND e.posting_date >= :from_date AND e.posting_date <= :to_date GROUP BY d.gl_account_id;"},
+        {"ready jobs to lease",
+         "SELECT id FROM task_logs WHERE job_state = 0 AND available_at <= :now ORDER BY priority DESC, available_at ASC LIMIT :limit;"},
+        {"expired job leases",
+         "SELECT id FROM task_logs WHERE job_state = 1 AND lease_expires_at < :now;"}
+    };
+    return probes;
+}
+
+bool SchemaMigrator::ensureVersionTable() {
+    return connection_->execute(R"(
+        CREATE TABLE IF NOT EXISTS schema_migrations (
+            version INTEGER PRIMARY KEY,
+            description TEXT NOT NULL,
+            applied_at TEXT NOT NULL
+        );
+    )");
+}
+
+int SchemaMigrator::getCurrentVersion() {
+    ResultSet rs = connection_->queryResultSet("SELECT MAX(version) AS version FROM schema_migrations;");
+    if (rs.empty()) {
+        return 0;
+    }
+    return static_cast<int>(rs.getInt64(0, 0).value_or(0));
+}
+
+bool SchemaMigrator::migrate() {
+    if (!ensureVersionTable()) {
+        ERP::Logger::Logger::getInstance().error("Failed to create schema_migrations table: " + connection_->getLastError(), "SchemaMigrator");
+        return false;
+    }
+
+    int currentVersion = getCurrentVersion();
+    ERP::Logger::Logger::getInstance().info("Current schema version: " + std::to_string(currentVersion) +
+                                            ", latest: " + std::to_string(getLatestVersion()) + ".", "SchemaMigrator");
+
+    for (const auto& migration : getMigrations()) {
+        if (migration.version <= currentVersion) {
+            continue;
+        }
+        if (!applyMigration(migration)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SchemaMigrator::applyMigration(const SchemaMigration& migration) {
+    ERP::Logger::Logger::getInstance().info("Applying migration " + std::to_string(migration.version) + ": " + migration.description, "SchemaMigrator");
+    if (!connection_->beginTransaction()) {
+        return false;
+    }
+
+    for (const auto& statement : migration.statements) {
+        if (!connection_->execute(statement)) {
+            connection_->rollbackTransaction();
+            ERP::Logger::Logger::getInstance().error("Migration " + std::to_string(migration.version) + " failed at: " + statement, "SchemaMigrator");
+            ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "SchemaMigrator: Migration failed.", "Cập nhật cấu trúc cơ sở dữ liệu thất bại.");
+            return false;
+        }
+    }
+
+    std::map<std::string, std::any> params;
+    params["version"] = migration.version;
+    params["description"] = migration.description;
+    params["applied_at"] = ERP::Utils::DateUtils::formatDateTime(ERP::Utils::DateUtils::now(), ERP::Common::DATETIME_FORMAT);
+    if (!connection_->execute("INSERT INTO schema_migrations (version, description, applied_at) VALUES (:version, :description, :applied_at);", params)) {
+        connection_->rollbackTransaction();
+        ERP::Logger::Logger::getInstance().error("Failed to record migration " + std::to_string(migration.version) + ".", "SchemaMigrator");
+        return false;
+    }
+
+    if (!connection_->commitTransaction()) {
+        return false;
+    }
+    ERP::Logger::Logger::getInstance().info("Migration " + std::to_string(migration.version) + " applied.", "SchemaMigrator");
+    return true;
+}
+
+std::vector<std::string> SchemaMigrator::explainQueryPlan(const std::string& sql) {
+    std::vector<std::string> plan;
+    ResultSet rs = connection_->queryResultSet("EXPLAIN QUERY PLAN " + sql);
+    int detailIndex = rs.columnIndex("detail");
+    if (detailIndex < 0) {
+        return plan;
+    }
+    for (std::size_t row = 0; row < rs.rowCount(); ++row) {
+        plan.push_back(rs.getString(row, static_cast<std::size_t>(detailIndex)).value_or(""));
+    }
+    return plan;
+}
+
+std::vector<QueryPlanReport> SchemaMigrator::runIndexDiagnostics() {
+    std::vector<QueryPlanReport> reports;
+    for (const auto& probe : getQueryPlanProbes()) {
+        QueryPlanReport report;
+        report.name = probe.name;
+        report.sql = probe.sql;
+        report.plan = explainQueryPlan(probe.sql);
+        for (const auto& step : report.plan) {
+            // SQLite reports "SEARCH <table> USING [COVERING] INDEX ..." or "... USING INTEGER PRIMARY KEY"
+            if (step.find("USING INDEX") != std::string::npos || step.find("USING COVERING INDEX") != std::string::npos ||
+                step.find("PRIMARY KEY") != std::string::npos) {
+                report.usesIndex = true;
+            }
+        }
+
+        std::string planText;
+        for (const auto& step : report.plan) {
+            planText += (planText.empty() ? "" : " | ") + step;
+        }
+        if (report.usesIndex) {
+            ERP::Logger::Logger::getInstance().info("[index] " + probe.name + ": " + planText, "SchemaMigrator");
+        } else {
+            ERP::Logger::Logger::getInstance().warning("[scan] " + probe.name + ": " + planText, "SchemaMigrator");
+        }
+        reports.push_back(report);
+    }
+    return reports;
+}
+
+} // namespace Database
+} // namespace ERP
@@ -0,0 +1,109 @@
+// Modules/Database/SchemaMigrator.h
+#ifndef MODULES_DATABASE_SCHEMAMIGRATOR_H
+#define MODULES_DATABASE_SCHEMAMIGRATOR_H
+
+#include <string>       // For std::string
+#include <vector>       // For std::vector
+#include <memory>       // For std::shared_ptr
+
+// Rút gọn include paths
+#include "DBConnection.h"       // Base DB connection interface
+#include "Logger.h"             // For logging
+#include "ErrorHandler.h"       // For error handling
+#include "Common.h"             // For ErrorCode
+
+namespace ERP {
+namespace Database {
+
+/**
+ * @brief A single, versioned schema change. Statements of one migration run in one transaction.
+ */
+struct SchemaMigration {
+    int version;                         /**< Strictly increasing schema version. */
+    std::string description;             /**< Human readable summary, stored in schema_migrations. */
+    std::vector<std::string> statements; /**< DDL statements to apply (must be idempotent, e.g. IF NOT EXISTS). */
+};
+
+/**
+ * @brief A named query whose plan is checked by the index diagnostics.
+ */
+struct QueryPlanProbe {
+    std::string name;        /**< Short label for the report (e.g. "inventory by product/location"). */
+    std::string sql;         /**< The query, with named placeholders left unbound. */
+};
+
+/**
+ * @brief Result of running EXPLAIN QUERY PLAN for one probe.
+ */
+struct QueryPlanReport {
+    std::string name;                 /**< Probe label. */
+    std::string sql;                  /**< Probe SQL. */
+    std::vector<std::string> plan;    /**< The "detail" column of each plan row. */
+    bool usesIndex = false;           /**< True if any step searches with an index instead of scanning. */
+};
+
+/**
+ * @brief The SchemaMigrator class applies versioned schema migrations (currently the
+ * secondary index set) on top of the tables created by DatabaseInitializer, records the
+ * applied versions in the schema_migrations table, and can report whether the hot
+ * queries of the application are served by an index via EXPLAIN QUERY PLAN.
+ */
+class SchemaMigrator {
+public:
+    /**
+     * @brief Constructs a SchemaMigrator working on an already opened connection.
+     * @param connection The connection to migrate (not taken from the pool).
+     */
+    explicit SchemaMigrator(std::shared_ptr<DBConnection> connection);
+
+    /**
+     * @brief Applies every migration newer than the recorded schema version, in order.
+     * @return True if the schema is at the latest version afterwards, false otherwise.
+     */
+    bool migrate();
+
+    /**
+     * @brief Gets the highest applied schema version.
+     * @return The version, or 0 if no migration has been applied.
+     */
+    int getCurrentVersion();
+
+    /**
+     * @brief Gets the latest schema version known to this build.
+     */
+    static int getLatestVersion();
+
+    /**
+     * @brief Gets the ordered list of migrations known to this build.
+     */
+    static const std::vector<SchemaMigration>& getMigrations();
+
+    /**
+     * @brief Gets the hot queries checked by runIndexDiagnostics().
+     */
+    static const std::vector<QueryPlanProbe>& getQueryPlanProbes();
+
+    /**
+     * @brief Runs EXPLAIN QUERY PLAN for a single statement.
+     * @param sql The statement to explain. Named placeholders may stay unbound.
+     * @return The plan detail lines, empty on error.
+     */
+    std::vector<std::string> explainQueryPlan(const std::string& sql);
+
+    /**
+     * @brief Explains every hot query probe and logs whether it uses an index.
+     * @return One report per probe.
+     */
+    std::vector<QueryPlanReport> runIndexDiagnostics();
+
+private:
+    std::shared_ptr<DBConnection> connection_;
+
+    bool ensureVersionTable();
+    bool applyMigration(const SchemaMigration& migration);
+};
+
+} // namespace Database
+} // namespace ERP
+
+#endif // MODULES_DATABASE_SCHEMAMIGRATOR_H
@@ -0,0 +1,172 @@
+// Modules/Database/UnitOfWork.cpp
+#include "UnitOfWork.h"
+#include "Logger.h"       // Standard includes
+#include <exception>      // For std::exception
+
+namespace ERP {
+namespace Database {
+
+thread_local std::shared_ptr<DBConnection> UnitOfWork::currentConnection_;
+thread_local bool UnitOfWork::rollbackOnly_ = false;
+thread_local std::vector<std::function<void()>> UnitOfWork::afterCommit_;
+thread_local std::vector<std::function<bool()>> UnitOfWork::beforeCommit_;
+thread_local std::vector<std::function<void()>> UnitOfWork::afterRollback_;
+
+UnitOfWork::UnitOfWork(std::shared_ptr<ConnectionPool> connectionPool)
+    : connectionPool_(connectionPool) {}
+
+UnitOfWork::~UnitOfWork() {
+    if (joined_) {
+        return; // The enclosing unit of work owns the connection
+    }
+    if (active_) {
+        ERP::Logger::Logger::getInstance().warning("Unit of work left without commit. Rolling back.", "UnitOfWork");
+        rollback();
+    }
+    if (connection_ && connectionPool_) {
+        connectionPool_->releaseConnection(connection_);
+    }
+}
+
+std::shared_ptr<DBConnection> UnitOfWork::current() {
+    return currentConnection_;
+}
+
+bool UnitOfWork::runAfterCommit(std::function<void()> action) {
+    if (!currentConnection_) {
+        return false;
+    }
+    afterCommit_.push_back(std::move(action));
+    return true;
+}
+
+bool UnitOfWork::runBeforeCommit(std::function<bool()> action) {
+    if (!currentConnection_) {
+        return false;
+    }
+    beforeCommit_.push_back(std::move(action));
+    return true;
+}
+
+bool UnitOfWork::runAfterRollback(std::function<void()> action) {
+    if (!currentConnection_) {
+        return false;
+    }
+    afterRollback_.push_back(std::move(action));
+    return true;
+}
+
+bool UnitOfWork::begin() {
+    if (connection_) {
+        return joined_ || active_;
+    }
+    if (currentConnection_) {
+        connection_ = currentConnection_;
+        joined_ = true;
+        return true;
+    }
+    if (!connectionPool_) {
+        ERP::Logger::Logger::getInstance().critical("ConnectionPool is null. Cannot begin unit of work.", "UnitOfWork");
+        return false;
+    }
+    connection_ = connectionPool_->getConnection(ConnectionIntent::Write);
+    if (!connection_) {
+        ERP::Logger::Logger::getInstance().critical("Failed to acquire a writer connection for the unit of work.", "UnitOfWork");
+        return false;
+    }
+    if (!connection_->beginTransaction()) {
+        ERP::Logger::Logger::getInstance().error("Failed to begin transaction.", "UnitOfWork");
+        connectionPool_->releaseConnection(connection_);
+        connection_.reset();
+        return false;
+    }
+    currentConnection_ = connection_;
+    rollbackOnly_ = false;
+    active_ = true;
+    return true;
+}
+
+bool UnitOfWork::commit() {
+    if (joined_) {
+        return true; // The outermost unit of work commits
+    }
+    if (!active_) {
+        ERP::Logger::Logger::getInstance().error("Commit called without an open transaction.", "UnitOfWork");
+        return false;
+    }
+    if (rollbackOnly_) {
+        ERP::Logger::Logger::getInstance().warning("A nested operation failed. Rolling back instead of committing.", "UnitOfWork");
+        rollback();
+        return false;
+    }
+    if (!runBeforeCommitActions()) {
+        rollback();
+        return false;
+    }
+    bool committed = connection_->commitTransaction();
+    if (!committed) {
+        connection_->rollbackTransaction(); // A failed COMMIT leaves the transaction open
+    }
+    active_ = false;
+    std::vector<std::function<void()>> actions;
+    actions.swap(committed ? afterCommit_ : afterRollback_);
+    unbind();
+    // Outside the transaction: an action may open a unit of work of its own
+    runActions(actions, committed ? "After-commit" : "After-rollback");
+    return committed;
+}
+
+bool UnitOfWork::runBeforeCommitActions() {
+    // By index: an action may register further actions
+    for (std::size_t i = 0; i < beforeCommit_.size(); ++i) {
+        std::function<bool()> action = beforeCommit_[i];
+        try {
+            if (!action()) {
+                ERP::Logger::Logger::getInstance().error("Before-commit action failed. Rolling back.", "UnitOfWork");
+                return false;
+            }
+        } catch (const std::exception& e) {
+            ERP::Logger::Logger::getInstance().error("Before-commit action failed: " + std::string(e.what()) + ". Rolling back.", "UnitOfWork");
+            return false;
+        }
+    }
+    beforeCommit_.clear();
+    return true;
+}
+
+void UnitOfWork::runActions(std::vector<std::function<void()>>& actions, const char* phase) {
+    for (auto& action : actions) {
+        try {
+            action();
+        } catch (const std::exception& e) {
+            ERP::Logger::Logger::getInstance().error(std::string(phase) + " action failed: " + std::string(e.what()), "UnitOfWork");
+        }
+    }
+}
+
+void UnitOfWork::rollback() {
+    if (joined_) {
+        rollbackOnly_ = true;
+        return;
+    }
+    if (!active_) {
+        return;
+    }
+    connection_->rollbackTransaction();
+    active_ = false;
+    std::vector<std::function<void()>> actions;
+    actions.swap(afterRollback_);
+    unbind();
+    runActions(actions, "After-rollback");
+}
+
+void UnitOfWork::unbind() {
+    currentConnection_.reset();
+    rollbackOnly_ = false;
+    afterCommit_.clear(); // Rolled back: the deferred actions describe changes that never happened
+    beforeCommit_.clear();
+    afterRollback_.clear();
+}
+
+} // namespace Database
+} // namespace ERP
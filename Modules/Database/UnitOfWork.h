@@ -0,0 +1,117 @@
+// Modules/Database/UnitOfWork.h
+#ifndef MODULES_DATABASE_UNITOFWORK_H
+#define MODULES_DATABASE_UNITOFWORK_H
+
+#include <memory>       // For std::shared_ptr
+#include <functional>   // For std::function (after-commit actions)
+#include <vector>       // For std::vector
+
+// Rút gọn include paths
+#include "ConnectionPool.h"     // Source of the transaction connection
+#include "DBConnection.h"       // Database connection interface
+
+namespace ERP {
+namespace Database {
+
+/**
+ * @brief The UnitOfWork class runs one business operation in one transaction on one connection.
+ *
+ * The outermost UnitOfWork of a thread takes a writer from the pool, begins the transaction and
+ * binds the connection to the thread. While it is bound, DAOBase runs every statement of the
+ * thread (reads included) on that connection, so the DAO calls of an operation share its
+ * transaction instead of checking out connections of their own and committing row by row.
+ * A UnitOfWork created while another one is open on the same thread joins it: begin() and
+ * commit() do nothing, and rollback() marks the enclosing transaction rollback-only.
+ * Only the outermost UnitOfWork commits or rolls back; the destructor rolls back if neither
+ * happened and releases the connection. Actions registered with runAfterCommit() run on the
+ * thread after the outermost commit succeeds and are discarded on rollback; runAfterRollback()
+ * is the reverse. runBeforeCommit() actions run inside the transaction just before COMMIT, so
+ * state buffered in memory during the operation can be written in one go.
+ */
+class UnitOfWork {
+public:
+    /**
+     * @brief Constructs a unit of work. No connection is taken until begin().
+     * @param connectionPool The pool providing the connection of an outermost unit of work.
+     */
+    explicit UnitOfWork(std::shared_ptr<ConnectionPool> connectionPool);
+    ~UnitOfWork();
+
+    UnitOfWork(const UnitOfWork&) = delete;
+    UnitOfWork& operator=(const UnitOfWork&) = delete;
+
+    /**
+     * @brief Joins the unit of work open on this thread, or acquires a writer and begins a transaction.
+     * @return True if a transaction is open afterwards, false otherwise.
+     */
+    bool begin();
+
+    /**
+     * @brief Commits the transaction if this is the outermost unit of work; no-op when joined.
+     * A rollback-only transaction is rolled back instead.
+     * @return True if committed (or joined), false otherwise.
+     */
+    bool commit();
+
+    /**
+     * @brief Rolls back the transaction if this is the outermost unit of work; marks it rollback-only when joined.
+     */
+    void rollback();
+
+    /**
+     * @brief Gets the connection of the transaction (null before begin()).
+     */
+    std::shared_ptr<DBConnection> connection() const { return connection_; }
+
+    /**
+     * @brief Checks whether this unit of work joined an enclosing one.
+     */
+    bool isJoined() const { return joined_; }
+
+    /**
+     * @brief Gets the connection bound to the calling thread, or null if no unit of work is open.
+     */
+    static std::shared_ptr<DBConnection> current();
+
+    /**
+     * @brief Defers an action until the unit of work open on this thread commits, e.g. publishing
+     * an event about rows the transaction writes. The action is dropped if the transaction rolls back.
+     * @return True if deferred, false if no unit of work is open (the caller runs the action itself).
+     */
+    static bool runAfterCommit(std::function<void()> action);
+
+    /**
+     * @brief Runs an action inside the transaction open on this thread, right before the outermost commit.
+     * An action returning false (or throwing) rolls the transaction back.
+     * @return True if deferred, false if no unit of work is open.
+     */
+    static bool runBeforeCommit(std::function<bool()> action);
+
+    /**
+     * @brief Runs an action after the unit of work open on this thread rolls back, e.g. to discard
+     * in-memory state derived from its writes. The action is dropped if the transaction commits.
+     * @return True if deferred, false if no unit of work is open.
+     */
+    static bool runAfterRollback(std::function<void()> action);
+
+private:
+    std::shared_ptr<ConnectionPool> connectionPool_;
+    std::shared_ptr<DBConnection> connection_;
+    bool joined_ = false;
+    bool active_ = false;   // Outermost unit of work with an open transaction
+
+    void unbind();
+    bool runBeforeCommitActions();
+    static void runActions(std::vector<std::function<void()>>& actions, const char* phase);
+
+    static thread_local std::shared_ptr<DBConnection> currentConnection_;
+    static thread_local bool rollbackOnly_;
+    static thread_local std::vector<std::function<void()>> afterCommit_;
+    static thread_local std::vector<std::function<bool()>> beforeCommit_;
+    static thread_local std::vector<std::function<void()>> afterRollback_;
+};
+
+} // namespace Database
+} // namespace ERP
+
+#endif // MODULES_DATABASE_UNITOFWORK_H
@@ -1,12 +1,115 @@
 // Modules/EventBus/EventBus.cpp
 #include "EventBus.h"
 #include "Logger.h" // Standard includes
+#include "UnitOfWork.h" // For after-commit dispatch
 
-#include <algorithm> // For std::remove_if
+#include <algorithm> // For std::remove_if, std::max
+#include <atomic>    // For std::atomic_load, std::atomic_store
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <optional>  // For std::optional
 
 namespace ERP {
 namespace EventBus {
 
+/**
+ * @brief Bounded event queue drained by one worker thread, owned by an ASYNC subscription.
+ * The worker keeps the queue alive, so a handler may unsubscribe itself.
+ */
+class SubscriberQueue : public std::enable_shared_from_this<SubscriberQueue> {
+public:
+    using Delivery = std::function<void(const std::shared_ptr<Event>&)>;
+
+    SubscriberQueue(Delivery deliver, std::string eventType, const SubscribeOptions& options)
+        : deliver_(std::move(deliver)),
+          eventType_(std::move(eventType)),
+          capacity_(std::max<std::size_t>(1, options.queueCapacity)),
+          overflowPolicy_(options.overflowPolicy) {}
+
+    void start() {
+        worker_ = std::thread([self = shared_from_this()]() { self->run(); });
+        workerId_ = worker_.get_id(); // Set before the queue is reachable from publish()
+    }
+
+    void push(const std::shared_ptr<Event>& event) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        // A handler publishing to its own queue must not wait for itself
+        if (queue_.size() >= capacity_ && std::this_thread::get_id() != workerId_) {
+            if (overflowPolicy_ == OverflowPolicy::BLOCK) {
+                notFull_.wait(lock, [this] { return stopping_ || queue_.size() < capacity_; });
+                if (stopping_) {
+                    return;
+                }
+            } else {
+                queue_.pop_front();
+                if (++dropped_ == 1 || dropped_ % 1000 == 0) {
+                    ERP::Logger::Logger::getInstance().warning("Queue of a '" + eventType_ + "' subscriber is full. " +
+                                                               std::to_string(dropped_) + " events dropped so far.", "EventBus");
+                }
+            }
+        }
+        queue_.push_back(event);
+        lock.unlock();
+        notEmpty_.notify_one();
+    }
+
+    // Delivers what is queued, then ends the worker
+    void stop() {
+        bool joinClaimed = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            joinClaimed = joinClaimed_;
+            joinClaimed_ = true;
+        }
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+        if (joinClaimed || !worker_.joinable()) {
+            return; // Another caller joins the worker
+        }
+        if (std::this_thread::get_id() == workerId_) {
+            worker_.detach(); // Unsubscribed from its own handler; run() returns after this event
+        } else {
+            worker_.join();
+        }
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            notEmpty_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return; // Stopping and drained
+            }
+            std::shared_ptr<Event> event = std::move(queue_.front());
+            queue_.pop_front();
+            lock.unlock();
+            notFull_.notify_one();
+            deliver_(event);
+            lock.lock();
+        }
+    }
+
+    Delivery deliver_;
+    std::string eventType_;
+    std::size_t capacity_;
+    OverflowPolicy overflowPolicy_;
+    std::deque<std::shared_ptr<Event>> queue_;
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    bool stopping_ = false;
+    bool joinClaimed_ = false;
+    std::size_t dropped_ = 0;
+    std::thread worker_;
+    std::thread::id workerId_;
+};
+
 // Static member initialization
 EventBus* EventBus::instance_ = nullptr;
 std::once_flag EventBus::onceFlag_;
@@ -19,47 +122,153 @@ EventBus& EventBus::getInstance() {
     return *instance_;
 }
 
-EventBus::EventBus() {
+EventBus::EventBus() : subscribers_(std::make_shared<const SubscriberTable>()) {
     ERP::Logger::Logger::getInstance().info("EventBus: Constructor called. Event bus is ready.");
 }
 
+namespace {
+// Runs one handler; an exception must not reach the publisher or the other handlers
+void deliverTo(const std::function<void(const Event&)>& handler, const std::shared_ptr<IEventSubscriber>& subscriber,
+               const std::shared_ptr<Event>& event) {
+    try {
+        if (handler) {
+            handler(*event);
+        } else {
+            subscriber->handleEvent(event);
+        }
+    } catch (const std::exception& e) {
+        // Log any exceptions thrown by event handlers to prevent them from crashing the EventBus
+        ERP::Logger::Logger::getInstance().error("EventBus: Exception in event handler for " + event->getEventType() + ": " + std::string(e.what()));
+    }
+}
+} // namespace
+
+SubscriptionId EventBus::addSubscription(std::type_index eventType, EventHandler handler, std::shared_ptr<IEventSubscriber> subscriber,
+                                         const SubscribeOptions& options) {
+    Subscription subscription;
+    subscription.handler = std::move(handler);
+    subscription.subscriber = std::move(subscriber);
+    const std::string typeName = subscription.subscriber ? subscription.subscriber->getEventType() : std::string(eventType.name());
+    if (options.mode == DeliveryMode::ASYNC) {
+        subscription.queue = std::make_shared<SubscriberQueue>(
+            [handler = subscription.handler, subscriber = subscription.subscriber](const std::shared_ptr<Event>& event) {
+                deliverTo(handler, subscriber, event);
+            },
+            typeName, options);
+        subscription.queue->start();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscription.id = nextSubscriptionId_++;
+    if (subscription.handler) {
+        subscriptionTypes_.emplace(subscription.id, eventType);
+    }
+    const SubscriptionId id = subscription.id;
+    auto table = std::make_shared<SubscriberTable>(*std::atomic_load(&subscribers_));
+    (*table)[eventType].push_back(std::move(subscription));
+    std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberTable>(std::move(table)));
+    ERP::Logger::Logger::getInstance().debug("EventBus: Subscriber for event type '" + typeName + "' added.");
+    return id;
+}
+
+void EventBus::unsubscribe(SubscriptionId subscriptionId) {
+    std::optional<std::type_index> eventType;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = subscriptionTypes_.find(subscriptionId);
+        if (it == subscriptionTypes_.end()) {
+            return;
+        }
+        eventType = it->second;
+        subscriptionTypes_.erase(it);
+    }
+    removeSubscriptions(*eventType, [subscriptionId](const Subscription& s) { return s.id == subscriptionId; });
+}
+
+void EventBus::removeSubscriptions(std::type_index eventType, const std::function<bool(const Subscription&)>& matches) {
+    std::vector<std::shared_ptr<SubscriberQueue>> stoppedQueues;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto table = std::make_shared<SubscriberTable>(*std::atomic_load(&subscribers_));
+        auto it = table->find(eventType);
+        if (it == table->end()) {
+            return;
+        }
+        auto& subscriberList = it->second;
+        for (const auto& subscription : subscriberList) {
+            if (matches(subscription) && subscription.queue) {
+                stoppedQueues.push_back(subscription.queue);
+            }
+        }
+        subscriberList.erase(std::remove_if(subscriberList.begin(), subscriberList.end(), matches), subscriberList.end());
+        if (subscriberList.empty()) {
+            table->erase(it);
+        }
+        std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberTable>(std::move(table)));
+    }
+    for (const auto& queue : stoppedQueues) {
+        queue->stop(); // Outside mutex_: the worker may still be delivering and publishing
+    }
+    ERP::Logger::Logger::getInstance().debug("EventBus: Subscriber for event type '" + std::string(eventType.name()) + "' removed.");
+}
+
 void EventBus::publish(std::shared_ptr<Event> event) {
     if (!event) {
         ERP::Logger::Logger::getInstance().warning("EventBus: Attempted to publish a null event.");
         return;
     }
 
-    std::string eventType = event->getEventType();
-    ERP::Logger::Logger::getInstance().debug("EventBus: Publishing event of type: " + eventType);
+    // Subscribers must not see changes that may still roll back
+    if (ERP::Database::UnitOfWork::runAfterCommit([this, event]() { dispatch(event); })) {
+        ERP_LOG_DEBUG("Deferred event of type " + event->getEventType() + " until commit.", "EventBus");
+        return;
+    }
+    dispatch(event);
+}
+
+void EventBus::dispatch(const std::shared_ptr<Event>& event) const {
+    // No strings on this path: the key is the event's dynamic type and the log line is built only at DEBUG
+    const Event& eventRef = *event;
+    const std::type_index eventType(typeid(eventRef));
+    ERP_LOG_DEBUG("Publishing event of type: " + event->getEventType(), "EventBus");
 
-    std::unique_lock<std::mutex> lock(mutex_); // Lock during dispatch to prevent changes to subscriber list
-    
-    // Check if there are any subscribers for this event type
-    auto it = subscribers_.find(eventType);
-    if (it == subscribers_.end()) {
-        ERP::Logger::Logger::getInstance().debug("EventBus: No subscribers found for event type: " + eventType);
+    // A snapshot of the table: handlers run without any lock and may (un)subscribe
+    std::shared_ptr<const SubscriberTable> table = std::atomic_load(&subscribers_);
+    auto it = table->find(eventType);
+    if (it == table->end()) {
+        ERP_LOG_DEBUG("No subscribers found for event type: " + event->getEventType(), "EventBus");
         return;
     }
 
-    // Get the list of subscribers for this event type
-    auto& subscriberList = it->second;
-
-    // Dispatch the event to each subscriber.
-    // Important: Iterate over a copy if subscribers might unsubscribe themselves during handling,
-    // or use shared_ptr management carefully to avoid dangling pointers if subscribers are deleted.
-    // For simplicity, we directly iterate the list under lock. If a subscriber unsubscribes itself,
-    // it will be removed in the next `unsubscribe` call.
-    for (const auto& subscriber : subscriberList) {
-        if (subscriber) { // Ensure subscriber is still valid
-            try {
-                subscriber->handleEvent(event);
-            } catch (const std::exception& e) {
-                // Log any exceptions thrown by event handlers to prevent them from crashing the EventBus
-                ERP::Logger::Logger::getInstance().error("EventBus: Exception in event handler for " + eventType + ": " + std::string(e.what()));
+    for (const auto& subscription : it->second) {
+        if (subscription.queue) {
+            subscription.queue->push(event);
+        } else {
+            deliverTo(subscription.handler, subscription.subscriber, event);
+        }
+    }
+}
+
+void EventBus::shutdown() {
+    std::vector<std::shared_ptr<SubscriberQueue>> queues;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto table = std::make_shared<SubscriberTable>(*std::atomic_load(&subscribers_));
+        for (auto& [eventType, subscriberList] : *table) {
+            for (auto& subscription : subscriberList) {
+                if (subscription.queue) {
+                    queues.push_back(subscription.queue);
+                    subscription.queue.reset(); // Delivered synchronously from now on
+                }
             }
         }
+        std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberTable>(std::move(table)));
+    }
+    for (const auto& queue : queues) {
+        queue->stop();
     }
+    ERP::Logger::Logger::getInstance().info("EventBus: Stopped " + std::to_string(queues.size()) + " asynchronous subscriber queues.");
 }
 
 } // namespace EventBus
-} // namespace ERP
\ No newline at end of file
+} // namespace ERP
@@ -3,11 +3,14 @@
 #define MODULES_EVENTBUS_EVENTBUS_H
 #include <string>       // For std::string
 #include <vector>       // For std::vector
-#include <map>          // For std::map
+#include <unordered_map> // For std::unordered_map (dispatch table)
 #include <memory>       // For std::shared_ptr
 #include <functional>   // For std::function
-#include <mutex>        // For std::mutex, std::unique_lock
+#include <mutex>        // For std::mutex, std::once_flag
 #include <typeindex>    // For std::type_index
+#include <type_traits>  // For std::is_base_of
+#include <cstddef>      // For std::size_t
+#include <cstdint>      // For std::uint64_t
 
 // Rút gọn includes
 #include "Event.h"          // Base Event class
@@ -28,23 +31,67 @@ public:
     virtual ~IEventSubscriber() = default;
     /**
      * @brief This method is called when an event that the subscriber is interested in is published.
-     * @param event A shared pointer to the published event. The subscriber should dynamic_cast
-     * this to the specific event type it expects.
+     * @param event A shared pointer to the published event. Its dynamic type is the EventType the
+     * subscriber was registered for, so a static_pointer_cast is enough.
      */
     virtual void handleEvent(std::shared_ptr<Event> event) = 0;
     /**
      * @brief Gets the type name of the event that this subscriber is interested in.
-     * This allows the EventBus to efficiently dispatch events only to relevant subscribers.
+     * Used for logging; routing uses the EventType of subscribe<EventType>().
      * @return The string event type name (e.g., "UserLoggedIn", "ProductCreated").
      */
     virtual std::string getEventType() const = 0; // Đã sửa: xóa khoảng trắng giữa 'get' và 'EventType'
 };
 
 
+/**
+ * @brief How a subscriber receives events.
+ */
+enum class DeliveryMode {
+    SYNC = 0,  /**< On the publishing thread (after commit if published inside a transaction). */
+    ASYNC = 1  /**< On the subscriber's own worker thread, through a bounded queue. */
+};
+
+/**
+ * @brief What publish() does when an ASYNC subscriber's queue is full.
+ */
+enum class OverflowPolicy {
+    BLOCK = 0,       /**< Wait for room (backpressure on the publisher). */
+    DROP_OLDEST = 1  /**< Discard the oldest queued event and log a warning. */
+};
+
+/**
+ * @brief Options of a subscription.
+ */
+struct SubscribeOptions {
+    DeliveryMode mode = DeliveryMode::SYNC;
+    std::size_t queueCapacity = 1024;                 /**< Bound of the ASYNC queue. */
+    OverflowPolicy overflowPolicy = OverflowPolicy::BLOCK;
+};
+
+class SubscriberQueue; // Worker thread and bounded queue of an ASYNC subscriber (EventBus.cpp)
+
+/**
+ * @brief Identifies a subscription made with a typed handler; 0 is never a valid id.
+ */
+using SubscriptionId = std::uint64_t;
+
 /**
  * @brief The EventBus class provides a publish/subscribe mechanism for inter-module communication.
  * It allows different parts of the application to communicate without direct dependencies.
  * Implemented as a Singleton.
+ *
+ * Events are routed by their dynamic C++ type (std::type_index), looked up in a hash table, so
+ * publishing does not build or compare type name strings. Typed handlers receive the concrete
+ * event (const InventoryLevelChangedEvent&) without a dynamic_cast; an event reaches the handlers
+ * of its exact type only, not those of its base classes.
+ *
+ * The subscriber table is copy-on-write: subscribe/unsubscribe build a new table under mutex_,
+ * while publish() only loads the current one, so no lock is held while handlers run and a
+ * handler may (un)subscribe. An event published while a UnitOfWork is open on the thread is
+ * dispatched after the transaction commits and dropped if it rolls back. ASYNC subscribers get
+ * the event through their own bounded queue and worker thread, so a slow handler delays neither
+ * the publisher nor the other subscribers; each ASYNC subscriber sees events in publish order.
  */
 class EventBus {
 public:
@@ -54,45 +101,74 @@ public:
      */
     static EventBus& getInstance();
 
+    /**
+     * @brief Subscribes a typed handler to an event type.
+     * @tparam EventType The concrete event type to receive.
+     * @param handler Called with each published EventType.
+     * @param options Delivery mode and queue bound of the subscription.
+     * @return The id to pass to unsubscribe().
+     */
+    template<typename EventType>
+    SubscriptionId subscribe(std::function<void(const EventType&)> handler, const SubscribeOptions& options = SubscribeOptions()) {
+        static_assert(std::is_base_of<Event, EventType>::value, "EventType must derive from Event");
+        if (!handler) {
+            return 0;
+        }
+        EventHandler eventHandler = [handler = std::move(handler)](const Event& event) {
+            handler(static_cast<const EventType&>(event)); // Routed by exact type, so the cast is safe
+        };
+        return addSubscription(std::type_index(typeid(EventType)), std::move(eventHandler), nullptr, options);
+    }
+
     /**
      * @brief Subscribes an event handler to a specific event type.
      * @tparam EventType The type of event to subscribe to.
      * @param subscriber A shared pointer to the IEventSubscriber instance.
+     * @param options Delivery mode and queue bound of the subscription.
      */
     template<typename EventType>
-    void subscribe(std::shared_ptr<IEventSubscriber> subscriber) {
-        std::unique_lock<std::mutex> lock(mutex_);
-        // Use typeid(EventType).name() as key
-        subscribers_[typeid(EventType).name()].push_back(subscriber);
-        ERP::Logger::Logger::getInstance().debug("EventBus: Subscriber for event type '" + std::string(typeid(EventType).name()) + "' added.");
+    void subscribe(std::shared_ptr<IEventSubscriber> subscriber, const SubscribeOptions& options = SubscribeOptions()) {
+        static_assert(std::is_base_of<Event, EventType>::value, "EventType must derive from Event");
+        if (!subscriber) {
+            return;
+        }
+        addSubscription(std::type_index(typeid(EventType)), nullptr, std::move(subscriber), options);
     }
     
     /**
      * @brief Unsubscribes an event handler from a specific event type.
+     * Events already queued for an ASYNC subscriber are still delivered before its worker stops.
      * @tparam EventType The type of event to unsubscribe from.
      * @param subscriber The shared pointer to the IEventSubscriber instance to remove.
      */
     template<typename EventType>
     void unsubscribe(std::shared_ptr<IEventSubscriber> subscriber) {
-        std::unique_lock<std::mutex> lock(mutex_);
-        auto& subscriberList = subscribers_[typeid(EventType).name()];
-        subscriberList.erase(
-            std::remove_if(subscriberList.begin(), subscriberList.end(),
-                           [&](const std::shared_ptr<IEventSubscriber>& s){
-                               return s == subscriber;
-                           }),
-            subscriberList.end()
-        );
-        ERP::Logger::Logger::getInstance().debug("EventBus: Subscriber for event type '" + std::string(typeid(EventType).name()) + "' removed.");
+        if (!subscriber) {
+            return;
+        }
+        removeSubscriptions(std::type_index(typeid(EventType)), [&subscriber](const Subscription& s) { return s.subscriber == subscriber; });
     }
 
+    /**
+     * @brief Removes a typed handler.
+     * @param subscriptionId The id returned by subscribe().
+     */
+    void unsubscribe(SubscriptionId subscriptionId);
+
     /**
      * @brief Publishes an event to all subscribed handlers.
-     * The event is dispatched to handlers interested in its specific type.
+     * The event is dispatched to handlers interested in its specific type; inside a transaction,
+     * after the transaction commits.
      * @param event A shared pointer to the event object.
      */
     void publish(std::shared_ptr<Event> event);
 
+    /**
+     * @brief Delivers the events queued for ASYNC subscribers and stops their worker threads.
+     * Remaining subscribers are delivered to synchronously afterwards.
+     */
+    void shutdown();
+
     // Delete copy constructor and assignment operator to enforce singleton
     EventBus(const EventBus&) = delete;
     EventBus& operator=(const EventBus&) = delete;
@@ -103,8 +179,28 @@ private:
      */
     EventBus();
 
-    std::map<std::string, std::vector<std::shared_ptr<IEventSubscriber>>> subscribers_;
-    std::mutex mutex_;
+    using EventHandler = std::function<void(const Event&)>;
+
+    struct Subscription {
+        SubscriptionId id = 0;
+        EventHandler handler;                         // Typed handler, or null for an IEventSubscriber
+        std::shared_ptr<IEventSubscriber> subscriber; // Null for a typed handler
+        std::shared_ptr<SubscriberQueue> queue;       // Null for SYNC subscriptions
+    };
+    using SubscriberTable = std::unordered_map<std::type_index, std::vector<Subscription>>;
+
+    SubscriptionId addSubscription(std::type_index eventType, EventHandler handler, std::shared_ptr<IEventSubscriber> subscriber,
+                                   const SubscribeOptions& options);
+    void removeSubscriptions(std::type_index eventType, const std::function<bool(const Subscription&)>& matches);
+    void dispatch(const std::shared_ptr<Event>& event) const;
+
+    static EventBus* instance_;
+    static std::once_flag onceFlag_;
+
+    std::shared_ptr<const SubscriberTable> subscribers_; // Replaced, never modified; read with std::atomic_load
+    std::mutex mutex_;                                   // Serializes writers of subscribers_
+    SubscriptionId nextSubscriptionId_ = 1;              // Guarded by mutex_
+    std::unordered_map<SubscriptionId, std::type_index> subscriptionTypes_; // Typed handlers; guarded by mutex_
 };
 
 } // namespace EventBus
@@ -9,6 +9,9 @@
 #include <sstream>
 #include <stdexcept>
 #include <typeinfo> // For std::bad_any_cast
+#include <cstdio>   // For std::snprintf, std::sscanf (period bounds)
+#include <algorithm> // For std::max, std::min
+#include <iterator>  // For std::make_move_iterator
 
 namespace ERP {
 namespace Finance {
@@ -101,7 +104,7 @@ bool GeneralLedgerDAO::createGLAccount(const ERP::Finance::DTO::GeneralLedgerAcc
     for (const auto& pair : data) {
         if (!first) { columns += ", "; placeholders += ", "; }
         columns += pair.first;
-        placeholders += "?";
+        placeholders += ":" + pair.first;
         params[pair.first] = pair.second;
         first = false;
     }
@@ -117,7 +120,7 @@ bool GeneralLedgerDAO::createGLAccount(const ERP::Finance::DTO::GeneralLedgerAcc
 
 std::optional<ERP::Finance::DTO::GeneralLedgerAccountDTO> GeneralLedgerDAO::getGLAccountById(const std::string& id) {
     ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Attempting to get GL account by ID: " + id);
-    std::string sql = "SELECT * FROM " + glAccountsTableName_ + " WHERE id = ?;";
+    std::string sql = "SELECT * FROM " + glAccountsTableName_ + " WHERE id = :id;";
     std::map<std::string, std::any> params;
     params["id"] = id;
 
@@ -136,7 +139,7 @@ std::optional<ERP::Finance::DTO::GeneralLedgerAccountDTO> GeneralLedgerDAO::getG
 
 std::optional<ERP::Finance::DTO::GeneralLedgerAccountDTO> GeneralLedgerDAO::getGLAccountByNumber(const std::string& accountNumber) {
     ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Attempting to get GL account by number: " + accountNumber);
-    std::string sql = "SELECT * FROM " + glAccountsTableName_ + " WHERE account_number = ?;";
+    std::string sql = "SELECT * FROM " + glAccountsTableName_ + " WHERE account_number = :account_number;";
     std::map<std::string, std::any> params;
     params["account_number"] = accountNumber;
 
@@ -155,22 +158,17 @@ std::optional<ERP::Finance::DTO::GeneralLedgerAccountDTO> GeneralLedgerDAO::getG
 
 
 std::vector<ERP::Finance::DTO::GeneralLedgerAccountDTO> GeneralLedgerDAO::getGLAccounts(const std::map<std::string, std::any>& filter) {
-    ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Attempting to retrieve GL accounts.");
-    std::string sql = "SELECT * FROM " + glAccountsTableName_;
-    std::string whereClause;
-    std::map<std::string, std::any> params;
+    return findGLAccounts(ERP::DAOBase::QueryFilter::fromMap(filter));
+}
 
-    if (!filter.empty()) {
-        whereClause = " WHERE ";
-        bool first = true;
-        for (const auto& pair : filter) {
-            if (!first) { whereClause += " AND "; }
-            whereClause += pair.first + " = ?";
-            params[pair.first] = pair.second;
-            first = false;
-        }
+std::vector<ERP::Finance::DTO::GeneralLedgerAccountDTO> GeneralLedgerDAO::findGLAccounts(const ERP::DAOBase::QueryFilter& filter) {
+    ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Attempting to retrieve GL accounts.");
+    ERP::DAOBase::CompiledFilter compiled = compileFilter(filter);
+    if (!compiled.valid) {
+        return {};
     }
-    sql += whereClause + ";";
+    std::string sql = "SELECT * FROM " + glAccountsTableName_ + compiled.whereClause() + compiled.orderClause + compiled.limitClause + ";";
+    const std::map<std::string, std::any>& params = compiled.params;
 
     std::vector<std::map<std::string, std::any>> resultsMap = queryDbOperation(
         [](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
@@ -202,12 +200,12 @@ bool GeneralLedgerDAO::updateGLAccount(const ERP::Finance::DTO::GeneralLedgerAcc
     for (const auto& pair : data) {
         if (pair.first == "id") continue;
         if (!firstSet) setClause += ", ";
-        setClause += pair.first + " = ?";
+        setClause += pair.first + " = :" + pair.first;
         params[pair.first] = pair.second;
         firstSet = false;
     }
 
-    std::string sql = "UPDATE " + glAccountsTableName_ + " SET " + setClause + " WHERE id = ?;";
+    std::string sql = "UPDATE " + glAccountsTableName_ + " SET " + setClause + " WHERE id = :id_filter;";
     params["id_filter"] = account.id;
 
     return executeDbOperation(
@@ -220,7 +218,7 @@ bool GeneralLedgerDAO::updateGLAccount(const ERP::Finance::DTO::GeneralLedgerAcc
 
 bool GeneralLedgerDAO::removeGLAccount(const std::string& id) {
     ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Attempting to remove GL account with ID: " + id);
-    std::string sql = "DELETE FROM " + glAccountsTableName_ + " WHERE id = ?;";
+    std::string sql = "DELETE FROM " + glAccountsTableName_ + " WHERE id = :id;";
     std::map<std::string, std::any> params;
     params["id"] = id;
 
@@ -234,21 +232,12 @@ bool GeneralLedgerDAO::removeGLAccount(const std::string& id) {
 
 int GeneralLedgerDAO::countGLAccounts(const std::map<std::string, std::any>& filter) {
     ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Counting GL accounts.");
-    std::string sql = "SELECT COUNT(*) FROM " + glAccountsTableName_;
-    std::string whereClause;
-    std::map<std::string, std::any> params;
-
-    if (!filter.empty()) {
-        whereClause = " WHERE ";
-        bool first = true;
-        for (const auto& pair : filter) {
-            if (!first) { whereClause += " AND "; }
-            whereClause += pair.first + " = ?";
-            params[pair.first] = pair.second;
-            first = false;
-        }
+    ERP::DAOBase::CompiledFilter compiled = compileFilter(ERP::DAOBase::QueryFilter::fromMap(filter));
+    if (!compiled.valid) {
+        return 0;
     }
-    sql += whereClause + ";";
+    std::string sql = "SELECT COUNT(*) FROM " + glAccountsTableName_ + compiled.whereClause() + ";";
+    const std::map<std::string, std::any>& params = compiled.params;
 
     std::vector<std::map<std::string, std::any>> results = queryDbOperation(
         [](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
@@ -323,7 +312,7 @@ bool GeneralLedgerDAO::createJournalEntry(const ERP::Finance::DTO::JournalEntryD
     for (const auto& pair : data) {
         if (!first) { columns += ", "; placeholders += ", "; }
         columns += pair.first;
-        placeholders += "?";
+        placeholders += ":" + pair.first;
         params[pair.first] = pair.second;
         first = false;
     }
@@ -339,7 +328,7 @@ bool GeneralLedgerDAO::createJournalEntry(const ERP::Finance::DTO::JournalEntryD
 
 std::optional<ERP::Finance::DTO::JournalEntryDTO> GeneralLedgerDAO::getJournalEntryById(const std::string& id) {
     ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Attempting to get journal entry by ID: " + id);
-    std::string sql = "SELECT * FROM " + journalEntriesTableName_ + " WHERE id = ?;";
+    std::string sql = "SELECT * FROM " + journalEntriesTableName_ + " WHERE id = :id;";
     std::map<std::string, std::any> params;
     params["id"] = id;
 
@@ -357,22 +346,17 @@ std::optional<ERP::Finance::DTO::JournalEntryDTO> GeneralLedgerDAO::getJournalEn
 }
 
 std::vector<ERP::Finance::DTO::JournalEntryDTO> GeneralLedgerDAO::getJournalEntries(const std::map<std::string, std::any>& filter) {
-    ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Attempting to retrieve journal entries.");
-    std::string sql = "SELECT * FROM " + journalEntriesTableName_;
-    std::string whereClause;
-    std::map<std::string, std::any> params;
+    return findJournalEntries(ERP::DAOBase::QueryFilter::fromMap(filter));
+}
 
-    if (!filter.empty()) {
-        whereClause = " WHERE ";
-        bool first = true;
-        for (const auto& pair : filter) {
-            if (!first) { whereClause += " AND "; }
-            whereClause += pair.first + " = ?";
-            params[pair.first] = pair.second;
-            first = false;
-        }
+std::vector<ERP::Finance::DTO::JournalEntryDTO> GeneralLedgerDAO::findJournalEntries(const ERP::DAOBase::QueryFilter& filter) {
+    ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Attempting to retrieve journal entries.");
+    ERP::DAOBase::CompiledFilter compiled = compileFilter(filter);
+    if (!compiled.valid) {
+        return {};
     }
-    sql += whereClause + ";";
+    std::string sql = "SELECT * FROM " + journalEntriesTableName_ + compiled.whereClause() + compiled.orderClause + compiled.limitClause + ";";
+    const std::map<std::string, std::any>& params = compiled.params;
 
     std::vector<std::map<std::string, std::any>> resultsMap = queryDbOperation(
         [](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
@@ -404,12 +388,12 @@ bool GeneralLedgerDAO::updateJournalEntry(const ERP::Finance::DTO::JournalEntryD
     for (const auto& pair : data) {
         if (pair.first == "id") continue;
         if (!firstSet) setClause += ", ";
-        setClause += pair.first + " = ?";
+        setClause += pair.first + " = :" + pair.first;
         params[pair.first] = pair.second;
         firstSet = false;
     }
 
-    std::string sql = "UPDATE " + journalEntriesTableName_ + " SET " + setClause + " WHERE id = ?;";
+    std::string sql = "UPDATE " + journalEntriesTableName_ + " SET " + setClause + " WHERE id = :id_filter;";
     params["id_filter"] = entry.id;
 
     return executeDbOperation(
@@ -422,7 +406,7 @@ bool GeneralLedgerDAO::updateJournalEntry(const ERP::Finance::DTO::JournalEntryD
 
 bool GeneralLedgerDAO::removeJournalEntry(const std::string& id) {
     ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Attempting to remove journal entry with ID: " + id);
-    std::string sql = "DELETE FROM " + journalEntriesTableName_ + " WHERE id = ?;";
+    std::string sql = "DELETE FROM " + journalEntriesTableName_ + " WHERE id = :id;";
     std::map<std::string, std::any> params;
     params["id"] = id;
 
@@ -481,7 +465,7 @@ bool GeneralLedgerDAO::createJournalEntryDetail(const ERP::Finance::DTO::Journal
     for (const auto& pair : data) {
         if (!first) { columns += ", "; placeholders += ", "; }
         columns += pair.first;
-        placeholders += "?";
+        placeholders += ":" + pair.first;
         params[pair.first] = pair.second;
         first = false;
     }
@@ -497,22 +481,261 @@ bool GeneralLedgerDAO::createJournalEntryDetail(const ERP::Finance::DTO::Journal
 
 std::vector<ERP::Finance::DTO::JournalEntryDetailDTO> GeneralLedgerDAO::getJournalEntryDetailsByEntryId(const std::string& journalEntryId) {
     ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Retrieving journal entry details for entry ID: " + journalEntryId);
-    std::string sql = "SELECT * FROM " + journalEntryDetailsTableName_ + " WHERE journal_entry_id = ?;";
+    std::string sql = "SELECT * FROM " + journalEntryDetailsTableName_ + " WHERE journal_entry_id = :journal_entry_id;";
     std::map<std::string, std::any> params;
     params["journal_entry_id"] = journalEntryId;
 
-    std::vector<std::map<std::string, std::any>> resultsMap = queryDbOperation(
+    ERP::Database::ResultSet resultSet = queryResultSetDbOperation("GeneralLedgerDAO", "getJournalEntryDetailsByEntryId", sql, params);
+    return journalEntryDetailBinding().materialize(resultSet);
+}
+
+std::map<std::string, GLAccountActivity> GeneralLedgerDAO::getPostedAccountActivity(
+    const std::optional<std::chrono::system_clock::time_point>& fromDate,
+    const std::chrono::system_clock::time_point& toDate) {
+    ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Aggregating posted account activity up to " + ERP::Utils::DateUtils::formatDateTime(toDate, ERP::Common::DATETIME_FORMAT) + ".");
+    // One grouped pass over the posted entries of the period joined to their lines, instead of
+    // loading every entry and then its details one by one.
+    std::string sql = "SELECT d.gl_account_id AS gl_account_id, TOTAL(d.debit_amount) AS total_debit, TOTAL(d.credit_amount) AS total_credit"
+                      " FROM " + journalEntriesTableName_ + " e"
+                      " JOIN " + journalEntryDetailsTableName_ + " d ON d.journal_entry_id = e.id"
+                      " WHERE e.is_posted = 1 AND e.posting_date <= :to_date";
+    std::map<std::string, std::any> params;
+    params["to_date"] = ERP::Utils::DateUtils::formatDateTime(toDate, ERP::Common::DATETIME_FORMAT);
+    if (fromDate) {
+        sql += " AND e.posting_date >= :from_date";
+        params["from_date"] = ERP::Utils::DateUtils::formatDateTime(*fromDate, ERP::Common::DATETIME_FORMAT);
+    }
+    sql += " GROUP BY d.gl_account_id;";
+
+    std::map<std::string, GLAccountActivity> activity;
+    ERP::Database::ResultSet resultSet = queryResultSetDbOperation("GeneralLedgerDAO", "getPostedAccountActivity", sql, params);
+    int accountIndex = resultSet.columnIndex("gl_account_id");
+    int debitIndex = resultSet.columnIndex("total_debit");
+    int creditIndex = resultSet.columnIndex("total_credit");
+    if (accountIndex < 0 || debitIndex < 0 || creditIndex < 0) {
+        return activity;
+    }
+    for (std::size_t row = 0; row < resultSet.rowCount(); ++row) {
+        GLAccountActivity item;
+        item.glAccountId = resultSet.getString(row, static_cast<std::size_t>(accountIndex)).value_or("");
+        item.totalDebit = resultSet.getDouble(row, static_cast<std::size_t>(debitIndex)).value_or(0.0);
+        item.totalCredit = resultSet.getDouble(row, static_cast<std::size_t>(creditIndex)).value_or(0.0);
+        activity[item.glAccountId] = item;
+    }
+    return activity;
+}
+
+std::unordered_map<std::string, ERP::Finance::DTO::GeneralLedgerAccountDTO> GeneralLedgerDAO::getGLAccountLookup() {
+    std::unordered_map<std::string, ERP::Finance::DTO::GeneralLedgerAccountDTO> lookup;
+    for (auto& account : getGLAccounts()) {
+        std::string id = account.id;
+        lookup.emplace(std::move(id), std::move(account));
+    }
+    return lookup;
+}
+
+GLPeriod GLPeriod::containing(const std::chrono::system_clock::time_point& time) {
+    int year = 0;
+    int month = 0;
+    std::sscanf(ERP::Utils::DateUtils::formatDateTime(time, "%Y-%m").c_str(), "%d-%d", &year, &month);
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-01 00:00:00", year, month);
+    GLPeriod period;
+    period.start = buffer;
+
+    // Last second of the month = first second of the next month - 1s
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-01 00:00:00", month == 12 ? year + 1 : year, month == 12 ? 1 : month + 1);
+    std::optional<std::chrono::system_clock::time_point> nextStart = ERP::Utils::DateUtils::parseDateTime(buffer, ERP::Common::DATETIME_FORMAT);
+    period.end = nextStart ? ERP::Utils::DateUtils::formatDateTime(*nextStart - std::chrono::seconds(1), ERP::Common::DATETIME_FORMAT) : period.start;
+    return period;
+}
+
+GLPeriod GLPeriod::previous() const {
+    std::optional<std::chrono::system_clock::time_point> startTime = ERP::Utils::DateUtils::parseDateTime(start, ERP::Common::DATETIME_FORMAT);
+    return startTime ? containing(*startTime - std::chrono::seconds(1)) : *this;
+}
+
+bool GeneralLedgerDAO::closePeriod(const GLPeriod& period) {
+    ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Closing GL period " + period.start + " - " + period.end + ".");
+    // Opening balance is the closing balance of the latest earlier snapshot; only the very first close
+    // (or an account created since) falls back to summing the earlier history.
+    std::string sql =
+        "INSERT INTO " + glPeriodBalancesTableName_ +
+        " (gl_account_id, period_start, period_end, opening_balance, period_debit, period_credit, closing_balance, is_closed, updated_at)"
+        " SELECT a.id, :period_start, :period_end, o.opening, TOTAL(act.debit), TOTAL(act.credit), o.opening + TOTAL(act.debit) - TOTAL(act.credit), 1, :updated_at"
+        " FROM " + glAccountsTableName_ + " a"
+        " JOIN (SELECT acc.id AS account_id, COALESCE("
+        "     (SELECT p.closing_balance FROM " + glPeriodBalancesTableName_ + " p"
+        "      WHERE p.gl_account_id = acc.id AND p.is_closed = 1 AND p.period_start < :period_start ORDER BY p.period_start DESC LIMIT 1),"
+        "     (SELECT TOTAL(d.debit_amount) - TOTAL(d.credit_amount) FROM " + journalEntryDetailsTableName_ + " d"
+        "      JOIN " + journalEntriesTableName_ + " e ON e.id = d.journal_entry_id"
+        "      WHERE d.gl_account_id = acc.id AND e.is_posted = 1 AND e.posting_date < :period_start)) AS opening"
+        "   FROM " + glAccountsTableName_ + " acc) o ON o.account_id = a.id"
+        " LEFT JOIN (SELECT d.gl_account_id AS gl_account_id, d.debit_amount AS debit, d.credit_amount AS credit"
+        "   FROM " + journalEntriesTableName_ + " e JOIN " + journalEntryDetailsTableName_ + " d ON d.journal_entry_id = e.id"
+        "   WHERE e.is_posted = 1 AND e.posting_date >= :period_start AND e.posting_date <= :period_end) act ON act.gl_account_id = a.id"
+        " WHERE true GROUP BY a.id" // WHERE avoids the INSERT ... SELECT ... ON CONFLICT parsing ambiguity
+        " ON CONFLICT(gl_account_id, period_start) DO UPDATE SET"
+        " opening_balance = excluded.opening_balance, period_debit = excluded.period_debit, period_credit = excluded.period_credit,"
+        " closing_balance = excluded.closing_balance, is_closed = 1, updated_at = excluded.updated_at;";
+    std::map<std::string, std::any> params;
+    params["period_start"] = period.start;
+    params["period_end"] = period.end;
+    params["updated_at"] = ERP::Utils::DateUtils::formatDateTime(ERP::Utils::DateUtils::now(), ERP::Common::DATETIME_FORMAT);
+
+    return executeDbOperation(
         [](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
-            return conn->query(sql_l, p_l);
+            return conn->execute(sql_l, p_l);
         },
-        "GeneralLedgerDAO", "getJournalEntryDetailsByEntryId", sql, params
+        "GeneralLedgerDAO", "closePeriod", sql, params
     );
+}
 
-    std::vector<ERP::Finance::DTO::JournalEntryDetailDTO> resultsDto;
-    for (const auto& rowMap : resultsMap) {
-        resultsDto.push_back(fromMap(rowMap));
+bool GeneralLedgerDAO::applyAccountBalanceDelta(ERP::Database::DBConnection& conn, const std::string& newBalanceId, const GLAccountActivity& delta,
+                                                const std::string& currency, const std::string& postedAt, const std::string& userId) {
+    // gl_account_id is UNIQUE, so insert-or-add is a single statement instead of SELECT then INSERT/UPDATE.
+    std::string sql =
+        "INSERT INTO " + glBalancesTableName_ +
+        " (id, gl_account_id, current_debit_balance, current_credit_balance, currency, last_posted_date, status, created_at, created_by)"
+        " VALUES (:id, :gl_account_id, :debit_amount, :credit_amount, :currency, :posted_at, :status, :posted_at, :user_id)"
+        " ON CONFLICT(gl_account_id) DO UPDATE SET"
+        " current_debit_balance = current_debit_balance + excluded.current_debit_balance,"
+        " current_credit_balance = current_credit_balance + excluded.current_credit_balance,"
+        " last_posted_date = excluded.last_posted_date, updated_at = excluded.last_posted_date, updated_by = excluded.created_by;";
+    std::map<std::string, std::any> params;
+    params["id"] = newBalanceId;
+    params["gl_account_id"] = delta.glAccountId;
+    params["debit_amount"] = delta.totalDebit;
+    params["credit_amount"] = delta.totalCredit;
+    params["currency"] = currency;
+    params["posted_at"] = postedAt;
+    params["status"] = static_cast<int>(ERP::Common::EntityStatus::ACTIVE);
+    params["user_id"] = userId;
+
+    if (!conn.execute(sql, params)) {
+        ERP::Logger::Logger::getInstance().error("Failed to apply balance delta for account " + delta.glAccountId + ": " + conn.getLastError(), "GeneralLedgerDAO");
+        return false;
     }
-    return resultsDto;
+    return true;
+}
+
+bool GeneralLedgerDAO::markJournalEntriesPosted(ERP::Database::DBConnection& conn, const std::vector<std::string>& journalEntryIds,
+                                                const std::string& postedAt, const std::string& userId) {
+    for (std::size_t offset = 0; offset < journalEntryIds.size(); offset += IN_LIST_CHUNK_SIZE) {
+        std::vector<std::string> chunk(journalEntryIds.begin() + offset,
+                                       journalEntryIds.begin() + std::min(offset + IN_LIST_CHUNK_SIZE, journalEntryIds.size()));
+        ERP::DAOBase::CompiledFilter compiled = ERP::DAOBase::QueryFilter().in("id", chunk).equals("is_posted", false).compile();
+        std::map<std::string, std::any> params = compiled.params;
+        params["posted_at"] = postedAt;
+        params["user_id"] = userId;
+        std::string sql = "UPDATE " + journalEntriesTableName_ +
+                          " SET is_posted = 1, posting_date = :posted_at, posted_by_user_id = :user_id, updated_at = :posted_at, updated_by = :user_id" +
+                          compiled.whereClause() + ";";
+        if (!conn.execute(sql, params)) {
+            ERP::Logger::Logger::getInstance().error("Failed to mark journal entries as posted: " + conn.getLastError(), "GeneralLedgerDAO");
+            return false;
+        }
+        ERP::Database::ResultSet changes = conn.queryResultSet("SELECT changes();");
+        if (changes.empty() || changes.getInt64(0, 0).value_or(0) != static_cast<long long>(chunk.size())) {
+            ERP::Logger::Logger::getInstance().warning("Some journal entries were missing or already posted.", "GeneralLedgerDAO");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GeneralLedgerDAO::isPeriodClosed(ERP::Database::DBConnection& conn, const GLPeriod& period) {
+    std::string sql = "SELECT 1 AS closed FROM " + glPeriodBalancesTableName_ + " WHERE period_start = :period_start AND is_closed = 1 LIMIT 1;";
+    std::map<std::string, std::any> params;
+    params["period_start"] = period.start;
+    return !conn.queryResultSet(sql, params).empty();
+}
+
+std::optional<GLPeriod> GeneralLedgerDAO::getLatestClosedPeriod(const std::string& asOf) {
+    std::string sql = "SELECT period_start, period_end FROM " + glPeriodBalancesTableName_ +
+                      " WHERE is_closed = 1 AND period_end <= :as_of ORDER BY period_end DESC LIMIT 1;";
+    std::map<std::string, std::any> params;
+    params["as_of"] = asOf;
+    ERP::Database::ResultSet resultSet = queryResultSetDbOperation("GeneralLedgerDAO", "getLatestClosedPeriod", sql, params);
+    if (resultSet.empty()) {
+        return std::nullopt;
+    }
+    GLPeriod period;
+    period.start = resultSet.getString(0, 0).value_or("");
+    period.end = resultSet.getString(0, 1).value_or("");
+    return period;
+}
+
+std::map<std::string, double> GeneralLedgerDAO::getAccountBalancesAsOf(const std::chrono::system_clock::time_point& asOf) {
+    const std::string asOfText = ERP::Utils::DateUtils::formatDateTime(asOf, ERP::Common::DATETIME_FORMAT);
+    std::map<std::string, double> balances;
+
+    std::optional<GLPeriod> anchor = getLatestClosedPeriod(asOfText);
+    if (!anchor) {
+        // Nothing closed yet: sum the whole history.
+        for (const auto& pair : getPostedAccountActivity(std::nullopt, asOf)) {
+            balances[pair.first] = pair.second.net();
+        }
+        return balances;
+    }
+
+    // Closing balances of the anchor. Closed rows are computed from the posted lines when the period
+    // closes, so they are complete even for periods that were open before the snapshot table existed.
+    std::string sql = "SELECT gl_account_id, closing_balance FROM " + glPeriodBalancesTableName_ +
+                      " WHERE period_start = :anchor_start AND is_closed = 1;";
+    std::map<std::string, std::any> params;
+    params["anchor_start"] = anchor->start;
+    ERP::Database::ResultSet resultSet = queryResultSetDbOperation("GeneralLedgerDAO", "getAccountBalancesAsOf", sql, params);
+    for (std::size_t row = 0; row < resultSet.rowCount(); ++row) {
+        balances[resultSet.getString(row, 0).value_or("")] = resultSet.getDouble(row, 1).value_or(0.0);
+    }
+
+    // Movement after the anchor from the posted lines themselves, not from the open-period rows.
+    std::optional<std::chrono::system_clock::time_point> anchorEnd = ERP::Utils::DateUtils::parseDateTime(anchor->end, ERP::Common::DATETIME_FORMAT);
+    if (anchorEnd && *anchorEnd < asOf) {
+        for (const auto& pair : getPostedAccountActivity(*anchorEnd + std::chrono::seconds(1), asOf)) {
+            balances[pair.first] += pair.second.net();
+        }
+    }
+    return balances;
+}
+
+std::vector<ERP::Finance::DTO::JournalEntryDetailDTO> GeneralLedgerDAO::getJournalEntryDetailsByEntryIds(const std::vector<std::string>& journalEntryIds) {
+    ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Retrieving journal entry details for " + std::to_string(journalEntryIds.size()) + " entries.");
+    std::vector<ERP::Finance::DTO::JournalEntryDetailDTO> details;
+    for (std::size_t offset = 0; offset < journalEntryIds.size(); offset += IN_LIST_CHUNK_SIZE) {
+        std::vector<std::string> chunk(journalEntryIds.begin() + offset,
+                                       journalEntryIds.begin() + std::min(offset + IN_LIST_CHUNK_SIZE, journalEntryIds.size()));
+        ERP::DAOBase::CompiledFilter compiled = ERP::DAOBase::QueryFilter().in("journal_entry_id", chunk).compile();
+        std::string sql = "SELECT * FROM " + journalEntryDetailsTableName_ + compiled.whereClause() + ";";
+        ERP::Database::ResultSet resultSet = queryResultSetDbOperation("GeneralLedgerDAO", "getJournalEntryDetailsByEntryIds", sql, compiled.params);
+        std::vector<ERP::Finance::DTO::JournalEntryDetailDTO> rows = journalEntryDetailBinding().materialize(resultSet);
+        details.insert(details.end(), std::make_move_iterator(rows.begin()), std::make_move_iterator(rows.end()));
+    }
+    return details;
+}
+
+std::vector<ERP::Finance::DTO::JournalEntryDTO> GeneralLedgerDAO::getJournalEntriesByIds(const std::vector<std::string>& journalEntryIds) {
+    std::vector<ERP::Finance::DTO::JournalEntryDTO> entries;
+    for (std::size_t offset = 0; offset < journalEntryIds.size(); offset += IN_LIST_CHUNK_SIZE) {
+        std::vector<std::string> chunk(journalEntryIds.begin() + offset,
+                                       journalEntryIds.begin() + std::min(offset + IN_LIST_CHUNK_SIZE, journalEntryIds.size()));
+        std::vector<ERP::Finance::DTO::JournalEntryDTO> rows = findJournalEntries(ERP::DAOBase::QueryFilter().in("id", chunk));
+        entries.insert(entries.end(), std::make_move_iterator(rows.begin()), std::make_move_iterator(rows.end()));
+    }
+    return entries;
+}
+
+const ERP::DAOBase::ColumnBinding<ERP::Finance::DTO::JournalEntryDetailDTO>& GeneralLedgerDAO::journalEntryDetailBinding() {
+    using ERP::Finance::DTO::JournalEntryDetailDTO;
+    static const ERP::DAOBase::ColumnBinding<JournalEntryDetailDTO> binding = ERP::DAOBase::ColumnBinding<JournalEntryDetailDTO>()
+        .bindBaseFields()
+        .bind("journal_entry_id", &JournalEntryDetailDTO::journalEntryId)
+        .bind("gl_account_id", &JournalEntryDetailDTO::glAccountId)
+        .bind("debit_amount", &JournalEntryDetailDTO::debitAmount)
+        .bind("credit_amount", &JournalEntryDetailDTO::creditAmount)
+        .bind("notes", &JournalEntryDetailDTO::notes);
+    return binding;
 }
 
 bool GeneralLedgerDAO::updateJournalEntryDetail(const ERP::Finance::DTO::JournalEntryDetailDTO& detail) {
@@ -531,12 +754,12 @@ bool GeneralLedgerDAO::updateJournalEntryDetail(const ERP::Finance::DTO::Journal
     for (const auto& pair : data) {
         if (pair.first == "id") continue;
         if (!firstSet) setClause += ", ";
-        setClause += pair.first + " = ?";
+        setClause += pair.first + " = :" + pair.first;
         params[pair.first] = pair.second;
         firstSet = false;
     }
 
-    std::string sql = "UPDATE " + journalEntryDetailsTableName_ + " SET " + setClause + " WHERE id = ?;";
+    std::string sql = "UPDATE " + journalEntryDetailsTableName_ + " SET " + setClause + " WHERE id = :id_filter;";
     params["id_filter"] = detail.id;
 
     return executeDbOperation(
@@ -549,7 +772,7 @@ bool GeneralLedgerDAO::updateJournalEntryDetail(const ERP::Finance::DTO::Journal
 
 bool GeneralLedgerDAO::removeJournalEntryDetail(const std::string& id) {
     ERP::Logger::Logger::getInstance().info("GeneralLedgerDAO: Attempting to remove journal entry detail with ID: " + id);
-    std::string sql = "DELETE FROM " + journalEntryDetailsTableName_ + " WHERE id = ?;";
+    std::string sql = "DELETE FROM " + journalEntryDetailsTableName_ + " WHERE id = :id;";
     std::map<std::string, std::any> params;
     params["id"] = id;
 
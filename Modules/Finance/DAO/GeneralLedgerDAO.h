@@ -17,11 +17,36 @@
 #include <map>
 #include <any>
 #include <optional>
+#include <chrono>
+#include <unordered_map>
 
 namespace ERP {
 namespace Finance {
 namespace DAOs {
 
+/**
+ * @brief Debit and credit totals of the posted journal lines of one GL account over a period.
+ */
+struct GLAccountActivity {
+    std::string glAccountId;
+    double totalDebit = 0.0;
+    double totalCredit = 0.0;
+
+    double net() const { return totalDebit - totalCredit; } // Debit - Credit
+};
+
+/**
+ * @brief A fiscal period of the general ledger. Periods are calendar months; both bounds are
+ * inclusive and stored in DATETIME_FORMAT (first and last second of the month).
+ */
+struct GLPeriod {
+    std::string start;
+    std::string end;
+
+    static GLPeriod containing(const std::chrono::system_clock::time_point& time);
+    GLPeriod previous() const;
+};
+
 // GeneralLedgerDAO will handle multiple DTOs.
 // Similar to AccountReceivableDAO, it will inherit for GLAccountBalance,
 // and have specific methods for JournalEntry and JournalEntryDetail.
@@ -43,6 +68,7 @@ public:
     std::optional<ERP::Finance::DTO::GeneralLedgerAccountDTO> getGLAccountById(const std::string& id);
     std::optional<ERP::Finance::DTO::GeneralLedgerAccountDTO> getGLAccountByNumber(const std::string& accountNumber);
     std::vector<ERP::Finance::DTO::GeneralLedgerAccountDTO> getGLAccounts(const std::map<std::string, std::any>& filter = {});
+    std::vector<ERP::Finance::DTO::GeneralLedgerAccountDTO> findGLAccounts(const ERP::DAOBase::QueryFilter& filter);
     bool updateGLAccount(const ERP::Finance::DTO::GeneralLedgerAccountDTO& account);
     bool removeGLAccount(const std::string& id);
     int countGLAccounts(const std::map<std::string, std::any>& filter = {});
@@ -52,15 +78,70 @@ public:
     bool createJournalEntry(const ERP::Finance::DTO::JournalEntryDTO& entry);
     std::optional<ERP::Finance::DTO::JournalEntryDTO> getJournalEntryById(const std::string& id);
     std::vector<ERP::Finance::DTO::JournalEntryDTO> getJournalEntries(const std::map<std::string, std::any>& filter = {});
+    std::vector<ERP::Finance::DTO::JournalEntryDTO> findJournalEntries(const ERP::DAOBase::QueryFilter& filter); // Ranges, IN lists, order, limit
     bool updateJournalEntry(const ERP::Finance::DTO::JournalEntryDTO& entry);
     bool removeJournalEntry(const std::string& id);
 
     // Specific methods for JournalEntryDetailDTO
     bool createJournalEntryDetail(const ERP::Finance::DTO::JournalEntryDetailDTO& detail);
     std::vector<ERP::Finance::DTO::JournalEntryDetailDTO> getJournalEntryDetailsByEntryId(const std::string& journalEntryId);
+    std::vector<ERP::Finance::DTO::JournalEntryDetailDTO> getJournalEntryDetailsByEntryIds(const std::vector<std::string>& journalEntryIds);
+    std::vector<ERP::Finance::DTO::JournalEntryDTO> getJournalEntriesByIds(const std::vector<std::string>& journalEntryIds);
+
+    // Posting (single statements on the caller's transaction connection)
+    /**
+     * @brief Adds a debit/credit delta to the running balance of an account with one upsert.
+     * @param newBalanceId ID used if the account has no balance row yet.
+     */
+    bool applyAccountBalanceDelta(ERP::Database::DBConnection& conn, const std::string& newBalanceId, const GLAccountActivity& delta,
+                                  const std::string& currency, const std::string& postedAt, const std::string& userId);
+    /**
+     * @brief Marks unposted journal entries as posted. Fails if any of them was not found or already posted,
+     * so a concurrent posting cannot be counted twice.
+     */
+    bool markJournalEntriesPosted(ERP::Database::DBConnection& conn, const std::vector<std::string>& journalEntryIds,
+                                  const std::string& postedAt, const std::string& userId);
     bool updateJournalEntryDetail(const ERP::Finance::DTO::JournalEntryDetailDTO& detail);
     bool removeJournalEntryDetail(const std::string& id);
 
+    // Set-based aggregation for financial reports
+    /**
+     * @brief Sums debit and credit of posted journal lines per GL account in one grouped query.
+     * @param fromDate Inclusive start of the posting period, or std::nullopt for everything up to toDate.
+     * @param toDate Inclusive end of the posting period.
+     * @return Activity keyed by GL account ID. Accounts without posted lines are absent.
+     */
+    std::map<std::string, GLAccountActivity> getPostedAccountActivity(
+        const std::optional<std::chrono::system_clock::time_point>& fromDate,
+        const std::chrono::system_clock::time_point& toDate);
+    /**
+     * @brief Loads every GL account once, keyed by ID, for report lookups.
+     */
+    std::unordered_map<std::string, ERP::Finance::DTO::GeneralLedgerAccountDTO> getGLAccountLookup();
+
+    // Period-close snapshots (gl_period_balances)
+    /**
+     * @brief Writes the closed snapshot of a period for every GL account in one statement:
+     * opening (previous closed closing, or all earlier history for the first close), period debit/credit
+     * and closing. Replaces any open row of the period.
+     */
+    bool closePeriod(const GLPeriod& period);
+    /**
+     * @brief Checks whether a period is closed, on the caller's transaction connection.
+     * Postings check this instead of writing open-period rows; only closed snapshots are stored.
+     */
+    bool isPeriodClosed(ERP::Database::DBConnection& conn, const GLPeriod& period);
+    /**
+     * @brief Gets the latest closed period ending at or before a date.
+     */
+    std::optional<GLPeriod> getLatestClosedPeriod(const std::string& asOf);
+    /**
+     * @brief Gets the net balance (Debit - Credit) of every account as of a date from the latest closed
+     * snapshot plus the posted lines after it. Cost grows with the activity since the last close,
+     * not with the age of the ledger.
+     */
+    std::map<std::string, double> getAccountBalancesAsOf(const std::chrono::system_clock::time_point& asOf);
+
     // Helpers for GeneralLedgerAccountDTO conversion
     static std::map<std::string, std::any> toMap(const ERP::Finance::DTO::GeneralLedgerAccountDTO& dto);
     static ERP::Finance::DTO::GeneralLedgerAccountDTO fromMap(const std::map<std::string, std::any>& data);
@@ -73,11 +154,17 @@ public:
     static std::map<std::string, std::any> toMap(const ERP::Finance::DTO::JournalEntryDetailDTO& dto);
     static ERP::Finance::DTO::JournalEntryDetailDTO fromMap(const std::map<std::string, std::any>& data);
 
+    // Typed column binding for JournalEntryDetailDTO (used for bulk detail loads)
+    static const ERP::DAOBase::ColumnBinding<ERP::Finance::DTO::JournalEntryDetailDTO>& journalEntryDetailBinding();
+
 private:
     std::string glAccountsTableName_ = "general_ledger_accounts";
     std::string glBalancesTableName_ = "gl_account_balances";
     std::string journalEntriesTableName_ = "journal_entries";
     std::string journalEntryDetailsTableName_ = "journal_entry_details";
+    std::string glPeriodBalancesTableName_ = "gl_period_balances";
+
+    static constexpr std::size_t IN_LIST_CHUNK_SIZE = 500; // Keeps IN (...) lists below SQLite's bound-parameter limit
 };
 
 } // namespace DAOs
@@ -8,6 +8,7 @@
 #include "Event.h"                      // Event DTO
 #include "ConnectionPool.h"             // ConnectionPool
 #include "DBConnection.h"               // DBConnection
+#include "UnitOfWork.h"                 // One transaction per operation
 #include "Common.h"                     // Common Enums/Constants
 #include "Utils.h"                      // Utility functions
 #include "DateUtils.h"                  // Date utility functions
@@ -77,17 +78,14 @@ bool AccountReceivableService::updateCustomerARBalance(
         return false;
     }
 
-    std::shared_ptr<ERP::Database::DBConnection> db_conn = connectionPool_->getConnection();
-    ERP::Utils::AutoRelease releaseGuard([&]() { if (db_conn) connectionPool_->releaseConnection(db_conn); });
-    if (!db_conn) {
+    ERP::Database::UnitOfWork unitOfWork(connectionPool_); // Joins the caller's transaction if one is open on this thread
+    if (!unitOfWork.begin()) {
         ERP::Logger::Logger::getInstance().critical("AccountReceivableService: Database connection is null. Cannot update AR balance.");
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::ServerError, "Database connection is null.", "Lỗi hệ thống: Không có kết nối cơ sở dữ liệu.");
         return false;
     }
 
     try {
-        db_conn->beginTransaction();
-
         std::map<std::string, std::any> filter;
         filter["customer_id"] = customerId;
         std::vector<ERP::Finance::DTO::AccountReceivableBalanceDTO> existingBalances = arBalanceDAO_->getARBalances(filter);
@@ -106,7 +104,7 @@ bool AccountReceivableService::updateCustomerARBalance(
 
             if (!arBalanceDAO_->create(newBalance)) {
                 ERP::Logger::Logger::getInstance().error("AccountReceivableService: Failed to create new AR balance for customer " + customerId + " in DAO.");
-                db_conn->rollbackTransaction();
+                unitOfWork.rollback();
                 return false;
             }
             ERP::Logger::Logger::getInstance().info("AccountReceivableService: Created new AR balance for customer " + customerId + ". Balance: " + std::to_string(newBalance.outstandingBalance));
@@ -120,13 +118,16 @@ bool AccountReceivableService::updateCustomerARBalance(
 
             if (!arBalanceDAO_->update(existingBalance)) {
                 ERP::Logger::Logger::getInstance().error("AccountReceivableService: Failed to update AR balance for customer " + customerId + " in DAO.");
-                db_conn->rollbackTransaction();
+                unitOfWork.rollback();
                 return false;
             }
             ERP::Logger::Logger::getInstance().info("AccountReceivableService: Updated AR balance for customer " + customerId + ". New balance: " + std::to_string(existingBalance.outstandingBalance));
         }
 
-        db_conn->commitTransaction();
+        if (!unitOfWork.commit()) {
+            ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "Không thể lưu thay đổi vào cơ sở dữ liệu.");
+            return false;
+        }
         ERP::Logger::Logger::getInstance().info("AccountReceivableService: AR balance for customer " + customerId + " updated successfully.");
         // Audit log for internal balance update (could be INFO or DEBUG depending on verbosity)
         recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
@@ -136,7 +137,7 @@ bool AccountReceivableService::updateCustomerARBalance(
         return true;
     } catch (const std::exception& e) {
         ERP::Logger::Logger::getInstance().critical("AccountReceivableService: Exception during updateCustomerARBalance: " + std::string(e.what()));
-        db_conn->rollbackTransaction();
+        unitOfWork.rollback();
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::OperationFailed, "Lỗi trong quá trình cập nhật số dư công nợ phải thu: " + std::string(e.what()));
         return false;
     }
@@ -163,21 +164,18 @@ bool AccountReceivableService::adjustARBalance(
         return false;
     }
 
-    std::shared_ptr<ERP::Database::DBConnection> db_conn = connectionPool_->getConnection();
-    ERP::Utils::AutoRelease releaseGuard([&]() { if (db_conn) connectionPool_->releaseConnection(db_conn); });
-    if (!db_conn) {
+    ERP::Database::UnitOfWork unitOfWork(connectionPool_); // Joins the caller's transaction if one is open on this thread
+    if (!unitOfWork.begin()) {
         ERP::Logger::Logger::getInstance().critical("AccountReceivableService: Database connection is null. Cannot adjust AR balance.");
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::ServerError, "Database connection is null.", "Lỗi hệ thống: Không có kết nối cơ sở dữ liệu.");
         return false;
     }
 
     try {
-        db_conn->beginTransaction();
-
         // Step 1: Update the AR Balance
         if (!updateCustomerARBalance(customerId, adjustmentAmount, currency, currentUserId, userRoleIds)) {
             ERP::Logger::Logger::getInstance().error("AccountReceivableService: Failed to update customer AR balance during adjustment.");
-            db_conn->rollbackTransaction();
+            unitOfWork.rollback();
             ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::OperationFailed, "Không thể cập nhật số dư công nợ phải thu.");
             return false;
         }
@@ -197,12 +195,15 @@ bool AccountReceivableService::adjustARBalance(
 
         if (!arTransactionDAO_->save(arTransaction)) { // NEW: Use arTransactionDAO_
             ERP::Logger::Logger::getInstance().error("AccountReceivableService: Failed to record AR adjustment transaction.");
-            db_conn->rollbackTransaction();
+            unitOfWork.rollback();
             ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::OperationFailed, "Không thể ghi nhận giao dịch điều chỉnh công nợ.");
             return false;
         }
         
-        db_conn->commitTransaction();
+        if (!unitOfWork.commit()) {
+            ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::DatabaseError, "Không thể lưu thay đổi vào cơ sở dữ liệu.");
+            return false;
+        }
         ERP::Logger::Logger::getInstance().info("AccountReceivableService: AR balance for customer " + customerId + " adjusted successfully by " + std::to_string(adjustmentAmount) + ".");
         recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
                        ERP::Security::DTO::AuditActionType::UPDATE, ERP::Common::LogSeverity::INFO,
@@ -211,7 +212,7 @@ bool AccountReceivableService::adjustARBalance(
         return true;
     } catch (const std::exception& e) {
         ERP::Logger::Logger::getInstance().critical("AccountReceivableService: Exception during adjustARBalance: " + std::string(e.what()));
-        db_conn->rollbackTransaction();
+        unitOfWork.rollback();
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::OperationFailed, "Lỗi trong quá trình điều chỉnh số dư công nợ phải thu: " + std::string(e.what()));
         return false;
     }
@@ -16,6 +16,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <algorithm> // For std::all_of if needed
+#include <unordered_map> // For the GL account lookup in reports
 // #include "DTOUtils.h" // Not needed here for QJsonObject conversions anymore
 
 namespace ERP {
@@ -40,45 +41,57 @@ GeneralLedgerService::GeneralLedgerService(
 
 // Old checkUserPermission and getUserRoleIds removed as they are now in BaseService
 
-// Helper to update GL account balance
+// Helper to update GL account balance (one upsert on the transaction's connection)
 bool GeneralLedgerService::updateGLAccountBalance(const std::string& glAccountId, double debitAmount, double creditAmount, ERP::Database::DBConnection& db_conn) {
-    std::map<std::string, std::any> filter;
-    filter["gl_account_id"] = glAccountId;
-    std::vector<ERP::Finance::DTO::GLAccountBalanceDTO> existingBalances = glDAO_->getGLAccountBalances(filter); // Using get from DAOBase
-
-    if (existingBalances.empty()) {
-        // Create new balance record
-        ERP::Finance::DTO::GLAccountBalanceDTO newBalance;
-        newBalance.id = ERP::Utils::generateUUID();
-        newBalance.glAccountId = glAccountId;
-        newBalance.currentDebitBalance = debitAmount;
-        newBalance.currentCreditBalance = creditAmount;
-        newBalance.currency = "VND"; // Default currency
-        newBalance.lastPostedDate = ERP::Utils::DateUtils::now();
-        newBalance.createdAt = newBalance.lastPostedDate;
-        newBalance.createdBy = "system"; // Or the currentUserId
-        newBalance.status = ERP::Common::EntityStatus::ACTIVE;
-
-        if (!glDAO_->createGLAccountBalance(newBalance)) { // Using create from DAOBase
-            ERP::Logger::Logger::getInstance().error("GeneralLedgerService: Failed to create new GL account balance for " + glAccountId);
-            return false;
-        }
-        ERP::Logger::Logger::getInstance().info("GeneralLedgerService: Created new GL account balance for " + glAccountId + ". Debit: " + std::to_string(debitAmount) + ", Credit: " + std::to_string(creditAmount));
-    } else {
-        // Update existing balance
-        ERP::Finance::DTO::GLAccountBalanceDTO existingBalance = existingBalances[0];
-        existingBalance.currentDebitBalance += debitAmount;
-        existingBalance.currentCreditBalance += creditAmount;
-        existingBalance.lastPostedDate = ERP::Utils::DateUtils::now();
-        existingBalance.updatedAt = existingBalance.lastPostedDate;
-        existingBalance.updatedBy = "system"; // Or the currentUserId
-
-        if (!glDAO_->updateGLAccountBalance(existingBalance)) { // Using update from DAOBase
-            ERP::Logger::Logger::getInstance().error("GeneralLedgerService: Failed to update GL account balance for " + glAccountId);
+    DAOs::GLAccountActivity delta;
+    delta.glAccountId = glAccountId;
+    delta.totalDebit = debitAmount;
+    delta.totalCredit = creditAmount;
+    const std::string postedAt = ERP::Utils::DateUtils::formatDateTime(ERP::Utils::DateUtils::now(), ERP::Common::DATETIME_FORMAT);
+    if (!glDAO_->applyAccountBalanceDelta(db_conn, ERP::Utils::generateUUID(), delta, "VND", postedAt, "system")) { // Default currency
+        ERP::Logger::Logger::getInstance().error("GeneralLedgerService: Failed to update GL account balance for " + glAccountId);
+        return false;
+    }
+    ERP::Logger::Logger::getInstance().debug("GeneralLedgerService: Applied GL account balance delta for " + glAccountId + ". Debit: " + std::to_string(debitAmount) + ", Credit: " + std::to_string(creditAmount));
+    return true;
+}
+
+// Helper to post journal entries: aggregates the detail lines per account, then applies one balance
+// upsert per account and marks the entries posted, all on db_conn. Period snapshots are written only
+// when a period closes; until then postings into it just have to find it open.
+bool GeneralLedgerService::applyJournalPostings(
+    const std::vector<std::string>& journalEntryIds,
+    const std::vector<ERP::Finance::DTO::JournalEntryDetailDTO>& details,
+    const std::chrono::system_clock::time_point& postingDate,
+    const std::string& currentUserId,
+    ERP::Database::DBConnection& db_conn) {
+    std::map<std::string, DAOs::GLAccountActivity> deltas;
+    for (const auto& detail : details) {
+        DAOs::GLAccountActivity& delta = deltas[detail.glAccountId];
+        delta.glAccountId = detail.glAccountId;
+        delta.totalDebit += detail.debitAmount;
+        delta.totalCredit += detail.creditAmount;
+    }
+
+    const std::string postedAt = ERP::Utils::DateUtils::formatDateTime(postingDate, ERP::Common::DATETIME_FORMAT);
+    const DAOs::GLPeriod postingPeriod = DAOs::GLPeriod::containing(postingDate);
+    // Checked inside the transaction so a concurrent period close cannot slip in between
+    if (glDAO_->isPeriodClosed(db_conn, postingPeriod)) {
+        ERP::Logger::Logger::getInstance().warning("GeneralLedgerService: Cannot post " + std::to_string(journalEntryIds.size()) + " journal entries into closed period " + postingPeriod.start + ".");
+        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::OperationFailed, "Kỳ kế toán đã khóa sổ. Không thể hạch toán.");
+        return false;
+    }
+    for (const auto& pair : deltas) {
+        if (!glDAO_->applyAccountBalanceDelta(db_conn, ERP::Utils::generateUUID(), pair.second, "VND", postedAt, currentUserId)) {
+            ERP::Logger::Logger::getInstance().error("GeneralLedgerService: Failed to update GL account balance for " + pair.first + " during posting.");
             return false;
         }
-        ERP::Logger::Logger::getInstance().info("GeneralLedgerService: Updated GL account balance for " + glAccountId + ". New Debit: " + std::to_string(existingBalance.currentDebitBalance) + ", New Credit: " + std::to_string(existingBalance.currentCreditBalance));
     }
+    if (!glDAO_->markJournalEntriesPosted(db_conn, journalEntryIds, postedAt, currentUserId)) {
+        ERP::Logger::Logger::getInstance().error("GeneralLedgerService: Failed to mark journal entries as posted.");
+        return false;
+    }
+    ERP::Logger::Logger::getInstance().info("GeneralLedgerService: Posted " + std::to_string(journalEntryIds.size()) + " journal entries touching " + std::to_string(deltas.size()) + " GL accounts.");
     return true;
 }
 
@@ -490,31 +503,20 @@ bool GeneralLedgerService::postJournalEntry(
         return false;
     }
 
+    const std::chrono::system_clock::time_point postingDate = ERP::Utils::DateUtils::now();
     bool success = executeTransaction(
         [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
-            // Update each GL account balance based on journal entry details
-            for (const auto& detail : details) {
-                if (!updateGLAccountBalance(detail.glAccountId, detail.debitAmount, detail.creditAmount, *db_conn)) {
-                    ERP::Logger::Logger::getInstance().error("GeneralLedgerService: Failed to update GL account balance for detail " + detail.id + " during posting.");
-                    return false;
-                }
-            }
-            // Mark journal entry as posted
-            journalEntry.isPosted = true;
-            journalEntry.postingDate = ERP::Utils::DateUtils::now();
-            journalEntry.postedByUserId = currentUserId;
-            journalEntry.updatedAt = ERP::Utils::DateUtils::now();
-            journalEntry.updatedBy = currentUserId;
-            if (!glDAO_->updateJournalEntry(journalEntry)) { // Specific DAO method
-                ERP::Logger::Logger::getInstance().error("GeneralLedgerService: Failed to update journal entry status to posted in DAO.");
-                return false;
-            }
-            return true;
+            return applyJournalPostings({journalEntryId}, details, postingDate, currentUserId, *db_conn);
         },
         "GeneralLedgerService", "postJournalEntry"
     );
 
     if (success) {
+        journalEntry.isPosted = true;
+        journalEntry.postingDate = postingDate;
+        journalEntry.postedByUserId = currentUserId;
+        journalEntry.updatedAt = postingDate;
+        journalEntry.updatedBy = currentUserId;
         ERP::Logger::Logger::getInstance().info("GeneralLedgerService: Journal entry " + journalEntryId + " posted successfully.");
         eventBus_.publish(std::make_shared<EventBus::JournalEntryPostedEvent>(journalEntryId));
         recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
@@ -526,6 +528,125 @@ bool GeneralLedgerService::postJournalEntry(
     return false;
 }
 
+bool GeneralLedgerService::postJournalEntries(
+    const std::vector<std::string>& journalEntryIds,
+    const std::string& currentUserId,
+    const std::vector<std::string>& userRoleIds) {
+    ERP::Logger::Logger::getInstance().info("GeneralLedgerService: Attempting to post " + std::to_string(journalEntryIds.size()) + " journal entries by " + currentUserId + ".");
+
+    if (!checkPermission(currentUserId, userRoleIds, "Finance.PostJournalEntry", "Bạn không có quyền hạch toán bút toán nhật ký.")) {
+        return false;
+    }
+
+    std::vector<std::string> ids = journalEntryIds;
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    if (ids.empty()) {
+        return true;
+    }
+
+    // Load the entries and all of their lines with IN queries instead of one lookup per entry.
+    std::vector<ERP::Finance::DTO::JournalEntryDTO> entries = glDAO_->getJournalEntriesByIds(ids);
+    if (entries.size() != ids.size()) {
+        ERP::Logger::Logger::getInstance().warning("GeneralLedgerService: " + std::to_string(ids.size() - entries.size()) + " journal entries of the batch were not found.");
+        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::NotFound, "Không tìm thấy một số bút toán nhật ký cần hạch toán.");
+        return false;
+    }
+    for (const auto& entry : entries) {
+        if (entry.isPosted) {
+            ERP::Logger::Logger::getInstance().warning("GeneralLedgerService: Journal entry " + entry.id + " in the batch is already posted.");
+            ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Bút toán nhật ký " + entry.journalNumber + " đã được hạch toán.");
+            return false;
+        }
+    }
+
+    std::vector<ERP::Finance::DTO::JournalEntryDetailDTO> details = glDAO_->getJournalEntryDetailsByEntryIds(ids);
+    std::map<std::string, double> entryNet; // Journal Entry ID -> Debit - Credit
+    for (const auto& detail : details) {
+        entryNet[detail.journalEntryId] += detail.debitAmount - detail.creditAmount;
+    }
+    for (const auto& pair : entryNet) {
+        if (std::abs(pair.second) > 0.001) {
+            ERP::Logger::Logger::getInstance().error("GeneralLedgerService: Unbalanced journal entry " + pair.first + " in the batch. Cannot post.");
+            ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::OperationFailed, "Bút toán nhật ký không cân bằng. Không thể hạch toán.");
+            return false;
+        }
+    }
+
+    const std::chrono::system_clock::time_point postingDate = ERP::Utils::DateUtils::now();
+    bool success = executeTransaction(
+        [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
+            return applyJournalPostings(ids, details, postingDate, currentUserId, *db_conn);
+        },
+        "GeneralLedgerService", "postJournalEntries"
+    );
+
+    if (success) {
+        ERP::Logger::Logger::getInstance().info("GeneralLedgerService: Posted batch of " + std::to_string(ids.size()) + " journal entries.");
+        for (const auto& id : ids) {
+            eventBus_.publish(std::make_shared<EventBus::JournalEntryPostedEvent>(id));
+        }
+        recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
+                       ERP::Security::DTO::AuditActionType::PROCESS_END, ERP::Common::LogSeverity::INFO,
+                       "Finance", "JournalEntryPosting", std::nullopt, "JournalEntry", std::to_string(ids.size()) + " journal entries");
+        return true;
+    }
+    return false;
+}
+
+bool GeneralLedgerService::closeFiscalPeriod(
+    const std::chrono::system_clock::time_point& periodDate,
+    const std::string& currentUserId,
+    const std::vector<std::string>& userRoleIds) {
+    const DAOs::GLPeriod period = DAOs::GLPeriod::containing(periodDate);
+    ERP::Logger::Logger::getInstance().info("GeneralLedgerService: Attempting to close fiscal period " + period.start + " - " + period.end + " by " + currentUserId + ".");
+
+    if (!checkPermission(currentUserId, userRoleIds, "Finance.CloseFiscalPeriod", "Bạn không có quyền khóa sổ kỳ kế toán.")) {
+        return false;
+    }
+    const std::string now = ERP::Utils::DateUtils::formatDateTime(ERP::Utils::DateUtils::now(), ERP::Common::DATETIME_FORMAT);
+    if (period.end >= now) {
+        ERP::Logger::Logger::getInstance().warning("GeneralLedgerService: Fiscal period " + period.start + " has not ended yet.");
+        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Kỳ kế toán chưa kết thúc. Không thể khóa sổ.");
+        return false;
+    }
+
+    bool success = executeTransaction(
+        [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
+            // Snapshots roll forward from the previous closed period, so periods close strictly in order.
+            // Only ended periods are ever closed, so the latest one ending before now is the latest overall.
+            std::optional<DAOs::GLPeriod> latestClosed = glDAO_->getLatestClosedPeriod(now);
+            if (latestClosed && latestClosed->start == period.start) {
+                ERP::Logger::Logger::getInstance().warning("GeneralLedgerService: Fiscal period " + period.start + " is already closed.");
+                ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Kỳ kế toán đã được khóa sổ.");
+                return false;
+            }
+            if (latestClosed && latestClosed->start > period.start) {
+                // The later snapshot was built on this period while it was open; closing it now would not match it
+                ERP::Logger::Logger::getInstance().warning("GeneralLedgerService: A fiscal period after " + period.start + " (" + latestClosed->start + ") is already closed.");
+                ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Đã khóa sổ kỳ kế toán sau kỳ này. Không thể khóa sổ kỳ trước đó.");
+                return false;
+            }
+            if (latestClosed && latestClosed->start != period.previous().start) {
+                ERP::Logger::Logger::getInstance().warning("GeneralLedgerService: Previous fiscal period of " + period.start + " is not closed.");
+                ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Phải khóa sổ kỳ kế toán trước đó trước.");
+                return false;
+            }
+            return glDAO_->closePeriod(period);
+        },
+        "GeneralLedgerService", "closeFiscalPeriod"
+    );
+
+    if (success) {
+        ERP::Logger::Logger::getInstance().info("GeneralLedgerService: Fiscal period " + period.start + " closed successfully.");
+        recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
+                       ERP::Security::DTO::AuditActionType::PROCESS_END, ERP::Common::LogSeverity::INFO,
+                       "Finance", "FiscalPeriodClose", period.start, "GLPeriod", period.start + " - " + period.end);
+        return true;
+    }
+    return false;
+}
+
 std::vector<ERP::Finance::DTO::JournalEntryDTO> GeneralLedgerService::getAllJournalEntries(
     const std::map<std::string, std::any>& filter,
     const std::vector<std::string>& userRoleIds) {
@@ -561,26 +682,15 @@ std::map<std::string, double> GeneralLedgerService::calculateAccountBalances(
 ) {
     std::map<std::string, double> balances; // Map of GL Account ID to net balance (Debit - Credit)
 
-    // Get all GL Accounts (for account details like type and normal balance)
-    std::vector<ERP::Finance::DTO::GeneralLedgerAccountDTO> allAccounts = glDAO_->getAllGLAccounts({}, userRoleIds);
-
-    // Get all journal entry details within the period (or up to endDate if includeOpeningBalances)
-    std::map<std::string, std::any> journalFilter;
-    // For simplicity, we're fetching all and filtering in memory, but a real system
-    // would filter at DB level or use a specialized balance table for efficiency.
-    std::vector<ERP::Finance::DTO::JournalEntryDTO> allPostedEntries = glDAO_->getAllJournalEntries({{"is_posted", true}}, userRoleIds);
-
-    for (const auto& entry : allPostedEntries) {
-        if ((entry.postingDate >= startDate && entry.postingDate <= endDate) || (includeOpeningBalances && entry.postingDate <= endDate)) {
-            std::vector<ERP::Finance::DTO::JournalEntryDetailDTO> details = glDAO_->getJournalEntryDetails(entry.id, userRoleIds);
-            for (const auto& detail : details) {
-                // Sum up debits and credits per account
-                if (balances.find(detail.glAccountId) == balances.end()) {
-                    balances[detail.glAccountId] = 0.0;
-                }
-                balances[detail.glAccountId] += detail.debitAmount - detail.creditAmount;
-            }
-        }
+    if (includeOpeningBalances) {
+        // Balances as of endDate: latest closed period snapshot plus the movement since.
+        return glDAO_->getAccountBalancesAsOf(endDate);
+    }
+
+    // Per-account sums of the posted lines in the period, computed by one grouped query
+    // instead of loading each entry and its details.
+    for (const auto& pair : glDAO_->getPostedAccountActivity(startDate, endDate)) {
+        balances[pair.first] = pair.second.net();
     }
     return balances;
 }
@@ -598,22 +708,9 @@ std::map<std::string, double> GeneralLedgerService::generateTrialBalance(
     std::map<std::string, double> trialBalanceReport; // Account Name -> Net Balance
 
     // Get all accounts
-    std::vector<ERP::Finance::DTO::GeneralLedgerAccountDTO> allAccounts = glDAO_->getAllGLAccounts({}, userRoleIds);
-    // Get all posted journal entries within the period
-    std::map<std::string, std::any> journalFilter;
-    journalFilter["posting_date_ge"] = ERP::Utils::DateUtils::formatDateTime(startDate, ERP::Common::DATETIME_FORMAT);
-    journalFilter["posting_date_le"] = ERP::Utils::DateUtils::formatDateTime(endDate, ERP::Common::DATETIME_FORMAT);
-    journalFilter["is_posted"] = true;
-    std::vector<ERP::Finance::DTO::JournalEntryDTO> entries = glDAO_->getAllJournalEntries(journalFilter, userRoleIds);
-
-    std::map<std::string, double> accountNetChanges; // GL Account ID -> Net Change in period
-
-    for (const auto& entry : entries) {
-        std::vector<ERP::Finance::DTO::JournalEntryDetailDTO> details = glDAO_->getJournalEntryDetails(entry.id, userRoleIds);
-        for (const auto& detail : details) {
-            accountNetChanges[detail.glAccountId] += detail.debitAmount - detail.creditAmount;
-        }
-    }
+    std::vector<ERP::Finance::DTO::GeneralLedgerAccountDTO> allAccounts = glDAO_->getGLAccounts();
+    // Net change per account over the posted entries of the period
+    std::map<std::string, double> accountNetChanges = calculateAccountBalances(startDate, endDate, false, userRoleIds); // GL Account ID -> Net Change in period
 
     // Now, map account IDs to account names and compile report
     for (const auto& account : allAccounts) {
@@ -646,7 +743,7 @@ std::map<std::string, double> GeneralLedgerService::generateBalanceSheet(
         userRoleIds
     );
 
-    std::vector<ERP::Finance::DTO::GeneralLedgerAccountDTO> allAccounts = glDAO_->getAllGLAccounts({}, userRoleIds);
+    std::vector<ERP::Finance::DTO::GeneralLedgerAccountDTO> allAccounts = glDAO_->getGLAccounts();
 
     for (const auto& account : allAccounts) {
         double balance = accountBalances.count(account.id) ? accountBalances[account.id] : 0.0;
@@ -694,7 +791,7 @@ std::map<std::string, double> GeneralLedgerService::generateIncomeStatement(
     // Calculate net changes for revenue and expense accounts within the period
     std::map<std::string, double> accountNetChanges = calculateAccountBalances(startDate, endDate, false, userRoleIds);
 
-    std::vector<ERP::Finance::DTO::GeneralLedgerAccountDTO> allAccounts = glDAO_->getAllGLAccounts({}, userRoleIds);
+    std::vector<ERP::Finance::DTO::GeneralLedgerAccountDTO> allAccounts = glDAO_->getGLAccounts();
 
     for (const auto& account : allAccounts) {
         double netChange = accountNetChanges.count(account.id) ? accountNetChanges[account.id] : 0.0;
@@ -740,42 +837,35 @@ std::map<std::string, double> GeneralLedgerService::generateCashFlowStatement(
     double cashFromInvestingActivities = 0.0;
     double cashFromFinancingActivities = 0.0;
 
-    // Get all transactions for cash/bank accounts within the period
-    // Assuming you have a way to identify cash/bank GL accounts (e.g., by account type or specific account numbers)
-    std::vector<ERP::Finance::DTO::GeneralLedgerAccountDTO> cashBankAccounts = glDAO_->getAllGLAccounts({{"account_type", static_cast<int>(ERP::Finance::DTO::GLAccountType::ASSET)}}, userRoleIds); // Simplistic filter for assets
-    // Further filter cash/bank type accounts.
-    
-    std::map<std::string, std::any> journalFilter;
-    journalFilter["posting_date_ge"] = ERP::Utils::DateUtils::formatDateTime(startDate, ERP::Common::DATETIME_FORMAT);
-    journalFilter["posting_date_le"] = ERP::Utils::DateUtils::formatDateTime(endDate, ERP::Common::DATETIME_FORMAT);
-    journalFilter["is_posted"] = true;
-    std::vector<ERP::Finance::DTO::JournalEntryDTO> entries = glDAO_->getAllJournalEntries(journalFilter, userRoleIds);
-
-    for (const auto& entry : entries) {
-        std::vector<ERP::Finance::DTO::JournalEntryDetailDTO> details = glDAO_->getJournalEntryDetails(entry.id, userRoleIds);
-        for (const auto& detail : details) {
-            // Very basic classification:
-            // Assuming all cash inflows are "Debit" on cash account, outflows are "Credit".
-            // You'd need more sophisticated logic to classify by operating, investing, financing.
-
-            // Find the GL account for this detail
-            std::optional<ERP::Finance::DTO::GeneralLedgerAccountDTO> glAccount = glDAO_->getGLAccountById(detail.glAccountId, userRoleIds);
-            if (glAccount && (glAccount->accountName.find("Cash") != std::string::npos || glAccount->accountName.find("Bank") != std::string::npos)) {
-                // This is a cash/bank related transaction
-                double cashImpact = detail.debitAmount - detail.creditAmount;
-
-                // Simplistic categorization based on account type and description (needs real rules)
-                if (glAccount->accountType == ERP::Finance::DTO::GLAccountType::REVENUE ||
-                    glAccount->accountType == ERP::Finance::DTO::GLAccountType::EXPENSE) {
-                    cashFromOperatingActivities += cashImpact;
-                } else if (glAccount->accountType == ERP::Finance::DTO::GLAccountType::ASSET && glAccount->accountName.find("Equipment") != std::string::npos) {
-                    cashFromInvestingActivities += cashImpact;
-                } else if (glAccount->accountType == ERP::Finance::DTO::GLAccountType::LIABILITY || glAccount->accountType == ERP::Finance::DTO::GLAccountType::EQUITY) {
-                    cashFromFinancingActivities += cashImpact;
-                } else {
-                    cashFromOperatingActivities += cashImpact; // Default to operating
-                }
-            }
+    // Net movement per account within the period, and the account metadata loaded once for classification
+    std::map<std::string, ERP::Finance::DAOs::GLAccountActivity> activity = glDAO_->getPostedAccountActivity(startDate, endDate);
+    std::unordered_map<std::string, ERP::Finance::DTO::GeneralLedgerAccountDTO> accountLookup = glDAO_->getGLAccountLookup();
+
+    for (const auto& pair : activity) {
+        // Very basic classification:
+        // Assuming all cash inflows are "Debit" on cash account, outflows are "Credit".
+        // You'd need more sophisticated logic to classify by operating, investing, financing.
+        auto accountIt = accountLookup.find(pair.first);
+        if (accountIt == accountLookup.end()) {
+            continue;
+        }
+        const ERP::Finance::DTO::GeneralLedgerAccountDTO& glAccount = accountIt->second;
+        if (glAccount.accountName.find("Cash") == std::string::npos && glAccount.accountName.find("Bank") == std::string::npos) {
+            continue;
+        }
+        // This is a cash/bank related account
+        double cashImpact = pair.second.net();
+
+        // Simplistic categorization based on account type and description (needs real rules)
+        if (glAccount.accountType == ERP::Finance::DTO::GLAccountType::REVENUE ||
+            glAccount.accountType == ERP::Finance::DTO::GLAccountType::EXPENSE) {
+            cashFromOperatingActivities += cashImpact;
+        } else if (glAccount.accountType == ERP::Finance::DTO::GLAccountType::ASSET && glAccount.accountName.find("Equipment") != std::string::npos) {
+            cashFromInvestingActivities += cashImpact;
+        } else if (glAccount.accountType == ERP::Finance::DTO::GLAccountType::LIABILITY || glAccount.accountType == ERP::Finance::DTO::GLAccountType::EQUITY) {
+            cashFromFinancingActivities += cashImpact;
+        } else {
+            cashFromOperatingActivities += cashImpact; // Default to operating
         }
     }
 
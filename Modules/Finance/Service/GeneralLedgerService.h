@@ -258,6 +258,15 @@ public:
         const std::string& journalEntryId,
         const std::vector<std::string>& userRoleIds = {}) override;
 
+    bool postJournalEntries(
+        const std::vector<std::string>& journalEntryIds,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds) override;
+    bool closeFiscalPeriod(
+        const std::chrono::system_clock::time_point& periodDate,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds) override;
+
     // NEW: Financial Report Generation Implementations
     std::map<std::string, double> generateTrialBalance(
         const std::chrono::system_clock::time_point& startDate,
@@ -281,6 +290,12 @@ private:
 
     // Helper functions
     bool updateGLAccountBalance(const std::string& glAccountId, double debitAmount, double creditAmount, ERP::Database::DBConnection& db_conn);
+    bool applyJournalPostings(
+        const std::vector<std::string>& journalEntryIds,
+        const std::vector<ERP::Finance::DTO::JournalEntryDetailDTO>& details,
+        const std::chrono::system_clock::time_point& postingDate,
+        const std::string& currentUserId,
+        ERP::Database::DBConnection& db_conn);
     std::map<std::string, double> calculateAccountBalances(
         const std::chrono::system_clock::time_point& startDate,
         const std::chrono::system_clock::time_point& endDate,
@@ -141,6 +141,34 @@ public:
         const std::string& journalEntryId,
         const std::vector<std::string>& userRoleIds = {}) = 0;
 
+    /**
+     * @brief Posts a batch of journal entries in one transaction (all or nothing).
+     * Lines are aggregated per GL account so each account balance is updated once per batch.
+     * @param journalEntryIds IDs of the unposted, balanced journal entries to post.
+     * @param currentUserId ID of the user performing the operation.
+     * @param userRoleIds Roles of the user performing the operation.
+     * @return true if every entry was posted, false otherwise (nothing is posted).
+     */
+    virtual bool postJournalEntries(
+        const std::vector<std::string>& journalEntryIds,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds) = 0;
+
+    /**
+     * @brief Closes the fiscal period (calendar month) containing a date: writes its per-account
+     * opening/debit/credit/closing snapshot, after which postings into it are rejected.
+     * Periods must be closed in order and only after they have ended; once a period is closed,
+     * no earlier period can be closed.
+     * @param periodDate Any date inside the period to close.
+     * @param currentUserId ID of the user performing the operation.
+     * @param userRoleIds Roles of the user performing the operation.
+     * @return true if the period is closed, false otherwise.
+     */
+    virtual bool closeFiscalPeriod(
+        const std::chrono::system_clock::time_point& periodDate,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds) = 0;
+
     // NEW: Financial Report Generation Methods
     /**
      * @brief Generates a Trial Balance report.
@@ -1,6 +1,11 @@
 // Modules/Logger/Logger.cpp
 #include "Logger.h"
 #include "Common.h" // Standard includes
+#include <filesystem> // For log file rotation
+#include <algorithm>  // For std::min
+#include <cctype>     // For std::toupper
+#include <cstdio>     // For std::snprintf
+#include <optional>   // For parsed log levels
 
 namespace ERP {
 namespace Logger {
@@ -9,6 +14,33 @@ namespace Logger {
 Logger* Logger::instance_ = nullptr;
 std::once_flag Logger::onceFlag_;
 
+namespace {
+constexpr auto SINK_IDLE_WAIT = std::chrono::milliseconds(100); // Upper bound on latency if a wake-up is missed
+constexpr int PUSH_RETRIES = 64;                                 // Yields before a message is dropped on a full buffer
+
+void appendJsonString(std::string& out, const std::string& value) {
+    out += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                    out += escaped;
+                } else {
+                    out += c; // UTF-8 bytes pass through unchanged
+                }
+        }
+    }
+    out += '"';
+}
+} // namespace
+
 Logger& Logger::getInstance() {
     // Use std::call_once to ensure thread-safe and one-time initialization
     std::call_once(onceFlag_, []() {
@@ -17,34 +49,176 @@ Logger& Logger::getInstance() {
     return *instance_;
 }
 
-Logger::Logger() : currentLogLevel_(ERP::Common::LogSeverity::INFO) {
-    // Default constructor, log file not set by default.
-    // Console logging is always enabled.
-    ERP::Logger::Logger::getInstance().info("Logger: Constructor called. Default log level set to INFO.", "System");
+Logger::Logger()
+    : currentLogLevel_(static_cast<int>(ERP::Common::LogSeverity::INFO)),
+      minEnabledLevel_(static_cast<int>(ERP::Common::LogSeverity::INFO)),
+      slots_(new Slot[RING_CAPACITY]) {
+    for (std::size_t i = 0; i < RING_CAPACITY; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    // Console logging is always enabled; log file not set by default.
+    running_.store(true, std::memory_order_release);
+    sinkThread_ = std::thread(&Logger::sinkLoop, this);
+    log(ERP::Common::LogSeverity::INFO, "Logger: Constructor called. Default log level set to INFO.", "System");
 }
 
 void Logger::setLogLevel(ERP::Common::LogSeverity level) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    currentLogLevel_ = level;
+    currentLogLevel_.store(static_cast<int>(level), std::memory_order_relaxed);
+    updateCategoryLevels(nullptr); // Recompute minEnabledLevel_
     // Log the change in log level
-    log(ERP::Common::LogSeverity::INFO, "Log level set to " + ERP::Common::logSeverityToString(currentLogLevel_), "Logger");
+    log(ERP::Common::LogSeverity::INFO, "Log level set to " + ERP::Common::logSeverityToString(level), "Logger");
+}
+
+void Logger::setCategoryLogLevel(const std::string& categoryPattern, ERP::Common::LogSeverity level) {
+    updateCategoryLevels([&](std::map<std::string, int>& patterns) { patterns[categoryPattern] = static_cast<int>(level); });
+    log(ERP::Common::LogSeverity::INFO, "Log level of '" + categoryPattern + "' set to " + ERP::Common::logSeverityToString(level), "Logger");
+}
+
+void Logger::clearCategoryLogLevel(const std::string& categoryPattern) {
+    updateCategoryLevels([&](std::map<std::string, int>& patterns) { patterns.erase(categoryPattern); });
+}
+
+void Logger::clearCategoryLogLevels() {
+    updateCategoryLevels([](std::map<std::string, int>& patterns) { patterns.clear(); });
+}
+
+void Logger::updateCategoryLevels(const std::function<void(std::map<std::string, int>&)>& change) {
+    std::lock_guard<std::mutex> lock(categoryLevelsMutex_);
+    std::shared_ptr<const CategoryLevels> current = std::atomic_load(&categoryLevels_);
+    std::map<std::string, int> patterns = current ? current->patterns : std::map<std::string, int>();
+    if (change) {
+        change(patterns);
+    }
+
+    auto rebuilt = std::make_shared<CategoryLevels>();
+    int minLevel = currentLogLevel_.load(std::memory_order_relaxed);
+    for (const auto& [pattern, level] : patterns) {
+        if (pattern.size() > 1 && pattern.back() == '*') {
+            rebuilt->prefixes.emplace_back(pattern.substr(0, pattern.size() - 1), level);
+        } else if (pattern.size() > 1 && pattern.front() == '*') {
+            rebuilt->suffixes.emplace_back(pattern.substr(1), level);
+        } else {
+            rebuilt->exact[pattern] = level;
+        }
+        minLevel = std::min(minLevel, level);
+    }
+    rebuilt->patterns = std::move(patterns);
+    std::atomic_store(&categoryLevels_, std::shared_ptr<const CategoryLevels>(rebuilt->patterns.empty() ? nullptr : rebuilt));
+    minEnabledLevel_.store(minLevel, std::memory_order_relaxed);
+}
+
+ERP::Common::LogSeverity Logger::getLogLevel(const std::string& category) const {
+    return static_cast<ERP::Common::LogSeverity>(levelFor(category));
+}
+
+int Logger::levelFor(const std::string& category) const {
+    std::shared_ptr<const CategoryLevels> levels = std::atomic_load(&categoryLevels_);
+    if (!levels) {
+        return currentLogLevel_.load(std::memory_order_relaxed);
+    }
+    auto exact = levels->exact.find(category);
+    if (exact != levels->exact.end()) {
+        return exact->second;
+    }
+    std::size_t bestLength = 0;
+    int level = currentLogLevel_.load(std::memory_order_relaxed);
+    for (const auto& [prefix, prefixLevel] : levels->prefixes) {
+        if (prefix.size() > bestLength && category.compare(0, prefix.size(), prefix) == 0) {
+            bestLength = prefix.size();
+            level = prefixLevel;
+        }
+    }
+    for (const auto& [suffix, suffixLevel] : levels->suffixes) {
+        if (suffix.size() > bestLength && category.size() >= suffix.size() &&
+            category.compare(category.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            bestLength = suffix.size();
+            level = suffixLevel;
+        }
+    }
+    return level;
 }
 
-bool Logger::setLogFile(const std::string& filePath) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (logFile_.is_open()) {
-        logFile_.close();
+bool Logger::applyConfig(const std::string& key, const std::string& value) {
+    static const std::string levelKey = "Logging.Level";
+    static const std::string jsonFileKey = "Logging.JsonFile";
+    if (key == jsonFileKey) {
+        return setJsonLogFile(value);
     }
-    logFile_.open(filePath, std::ios::app); // Open in append mode
-    if (logFile_.is_open()) {
-        log(ERP::Common::LogSeverity::INFO, "Log file set to: " + filePath, "Logger");
+    if (key.compare(0, levelKey.size(), levelKey) != 0) {
+        return false;
+    }
+
+    std::string upper;
+    for (char c : value) {
+        upper += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    std::optional<ERP::Common::LogSeverity> level;
+    for (ERP::Common::LogSeverity candidate : { ERP::Common::LogSeverity::DEBUG, ERP::Common::LogSeverity::INFO, ERP::Common::LogSeverity::WARNING,
+                                                ERP::Common::LogSeverity::ERROR, ERP::Common::LogSeverity::CRITICAL }) {
+        if (ERP::Common::logSeverityToString(candidate) == upper) {
+            level = candidate;
+        }
+    }
+
+    if (key == levelKey) {
+        if (value.empty()) {
+            setLogLevel(ERP::Common::LogSeverity::INFO); // Setting removed: back to the default level
+            return true;
+        }
+        if (!level) {
+            log(ERP::Common::LogSeverity::WARNING, "Invalid log level '" + value + "' for " + key + ".", "Logger");
+            return false;
+        }
+        setLogLevel(*level);
         return true;
-    } else {
-        std::cerr << "ERROR: Failed to open log file: " << filePath << std::endl;
-        // Cannot use internal logging if log file fails and console output is suppressed.
-        // For now, write to cerr.
+    }
+    if (key.size() <= levelKey.size() + 1 || key[levelKey.size()] != '.') {
+        return false;
+    }
+    const std::string pattern = key.substr(levelKey.size() + 1);
+    if (value.empty()) {
+        clearCategoryLogLevel(pattern);
+        return true;
+    }
+    if (!level) {
+        log(ERP::Common::LogSeverity::WARNING, "Invalid log level '" + value + "' for " + key + ".", "Logger");
         return false;
     }
+    setCategoryLogLevel(pattern, *level);
+    return true;
+}
+
+bool Logger::setLogFile(const std::string& filePath, std::size_t maxFileBytes, int maxBackupFiles) {
+    {
+        std::lock_guard<std::mutex> lock(fileMutex_);
+        if (!logFile_.open(filePath, maxFileBytes, maxBackupFiles)) {
+            std::cerr << "ERROR: Failed to open log file: " << filePath << std::endl;
+            // Cannot use internal logging if log file fails and console output is suppressed.
+            // For now, write to cerr.
+            return false;
+        }
+    }
+    log(ERP::Common::LogSeverity::INFO, "Log file set to: " + filePath, "Logger");
+    return true;
+}
+
+bool Logger::setJsonLogFile(const std::string& filePath, std::size_t maxFileBytes, int maxBackupFiles) {
+    {
+        std::lock_guard<std::mutex> lock(fileMutex_);
+        if (filePath.empty()) {
+            jsonLogFile_.close();
+            return true;
+        }
+        if (jsonLogFile_.isOpen() && jsonLogFile_.path == filePath) {
+            return true;
+        }
+        if (!jsonLogFile_.open(filePath, maxFileBytes, maxBackupFiles)) {
+            std::cerr << "ERROR: Failed to open JSON log file: " << filePath << std::endl;
+            return false;
+        }
+    }
+    log(ERP::Common::LogSeverity::INFO, "JSON log file set to: " + filePath, "Logger");
+    return true;
 }
 
 void Logger::debug(const std::string& message, const std::string& category) {
@@ -68,34 +242,296 @@ void Logger::critical(const std::string& message, const std::string& category) {
 }
 
 void Logger::log(ERP::Common::LogSeverity level, const std::string& message, const std::string& category) {
-    if (level < currentLogLevel_) {
-        return; // Message severity is below the set log level, so don't log.
+    if (!isEnabled(level)) {
+        return; // Message severity is below every configured log level, so don't log.
     }
 
-    // Get current time
-    auto now = std::chrono::system_clock::now();
-    auto in_time_t = std::chrono::system_clock::to_time_t(now);
-    
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&in_time_t), "%Y-%m-%d %H:%M:%S");
+    // Most callers put the category in the message ("DAOBase: ...") and leave "General".
+    // Resolve the real category before filtering.
+    std::string resolvedCategory = category;
+    if (category == "General") {
+        const std::size_t colon = message.find(": ");
+        if (colon != std::string::npos && colon > 0 && colon < 64 && message.find(' ') > colon) {
+            resolvedCategory = message.substr(0, colon);
+        }
+    }
+    if (static_cast<int>(level) < levelFor(resolvedCategory)) {
+        return;
+    }
 
-    std::string formattedMessage = ss.str() + " [" + ERP::Common::logSeverityToString(level) + "] [" + category + "] " + message;
+    LogRecord record;
+    record.level = level;
+    record.time = std::chrono::system_clock::now();
+    record.category = std::move(resolvedCategory);
+    record.message = message;
 
-    std::lock_guard<std::mutex> lock(mutex_); // Lock for thread safety
+    if (!running_.load(std::memory_order_acquire)) {
+        writeBatch({ std::move(record) }); // Sink stopped (shutdown): write on the caller's thread
+        return;
+    }
 
-    // Output to console
-    if (level >= ERP::Common::LogSeverity::ERROR) {
-        std::cerr << formattedMessage << std::endl;
-    } else {
-        std::cout << formattedMessage << std::endl;
+    for (int attempt = 0; !tryPush(record); ++attempt) {
+        if (attempt >= PUSH_RETRIES) {
+            droppedSinceReport_.fetch_add(1, std::memory_order_relaxed);
+            totalDropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::this_thread::yield();
+    }
+    acceptedCount_.fetch_add(1, std::memory_order_release);
+    // Pairs with the fence in shutdown(): either shutdown's final drain sees this record, or this
+    // thread sees running_ == false and drains it itself.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!running_.load(std::memory_order_relaxed)) {
+        drainAfterShutdown();
+        return;
+    }
+    if (sinkSleeping_.load(std::memory_order_acquire)) {
+        sinkWake_.notify_one();
     }
+}
+
+void Logger::flush() {
+    const std::uint64_t target = acceptedCount_.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(sinkMutex_);
+    sinkWake_.notify_one();
+    drained_.wait(lock, [&] { return writtenCount_ >= target || !running_.load(std::memory_order_acquire); });
+}
+
+void Logger::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(sinkMutex_);
+        if (!running_.load(std::memory_order_acquire)) {
+            return;
+        }
+        stopping_ = true;
+    }
+    sinkWake_.notify_one();
+    if (sinkThread_.joinable()) {
+        sinkThread_.join();
+    }
+    running_.store(false, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst); // See log()
+    drained_.notify_all();
+
+    // Messages pushed while the sink was exiting
+    drainAfterShutdown();
+}
+
+void Logger::drainAfterShutdown() {
+    // The sink is gone; producers that raced with shutdown() and shutdown() itself take turns as consumer
+    std::lock_guard<std::mutex> lock(shutdownDrainMutex_);
+    std::vector<LogRecord> rest;
+    LogRecord record;
+    while (tryPop(record)) {
+        rest.push_back(std::move(record));
+    }
+    if (!rest.empty()) {
+        writeBatch(rest);
+    }
+}
 
-    // Output to file if open
-    if (logFile_.is_open()) {
-        logFile_ << formattedMessage << std::endl;
-        logFile_.flush(); // Ensure message is written immediately
+bool Logger::tryPush(LogRecord& record) {
+    // Bounded MPMC queue (Vyukov): a slot is free for position pos when its sequence equals pos
+    std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    while (true) {
+        slot = &slots_[pos & (RING_CAPACITY - 1)];
+        const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false; // Full
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+    slot->record = std::move(record);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool Logger::tryPop(LogRecord& record) {
+    Slot& slot = slots_[dequeuePos_ & (RING_CAPACITY - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+        return false; // Empty (or the producer of this slot has not finished writing it)
+    }
+    record = std::move(slot.record);
+    slot.sequence.store(dequeuePos_ + RING_CAPACITY, std::memory_order_release);
+    ++dequeuePos_;
+    return true;
+}
+
+void Logger::sinkLoop() {
+    std::vector<LogRecord> batch;
+    batch.reserve(MAX_SINK_BATCH);
+    LogRecord record;
+    while (true) {
+        while (batch.size() < MAX_SINK_BATCH && tryPop(record)) {
+            batch.push_back(std::move(record));
+        }
+        if (!batch.empty() || droppedSinceReport_.load(std::memory_order_relaxed) > 0) {
+            writeBatch(batch);
+            {
+                std::lock_guard<std::mutex> lock(sinkMutex_);
+                writtenCount_ += batch.size();
+            }
+            drained_.notify_all();
+            batch.clear();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sinkMutex_);
+        if (stopping_) {
+            break;
+        }
+        sinkSleeping_.store(true, std::memory_order_release);
+        sinkWake_.wait_for(lock, SINK_IDLE_WAIT);
+        sinkSleeping_.store(false, std::memory_order_release);
+    }
+}
+
+void Logger::writeBatch(const std::vector<LogRecord>& batch) {
+    std::lock_guard<std::mutex> lock(fileMutex_);
+    std::string consoleOut;
+    std::string consoleErr;
+    std::string fileOut;
+    std::string jsonOut;
+
+    auto append = [&](ERP::Common::LogSeverity level, std::chrono::system_clock::time_point time,
+                      const std::string& category, const std::string& message) {
+        const std::string& timestamp = formatTimestamp(time);
+        const std::string levelName = ERP::Common::logSeverityToString(level);
+        std::string line;
+        line.reserve(32 + category.size() + message.size());
+        line += timestamp;
+        line += " [";
+        line += levelName;
+        line += "] [";
+        line += category;
+        line += "] ";
+        line += message;
+        line += '\n';
+        if (level >= ERP::Common::LogSeverity::ERROR) {
+            consoleErr += line;
+        } else {
+            consoleOut += line;
+        }
+        if (logFile_.isOpen()) {
+            fileOut += line;
+        }
+        if (jsonLogFile_.isOpen()) {
+            const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+            char fraction[8];
+            std::snprintf(fraction, sizeof(fraction), ".%03d", static_cast<int>(millis));
+            jsonOut += "{\"time\":\"";
+            jsonOut += timestamp;
+            jsonOut += fraction;
+            jsonOut += "\",\"level\":\"";
+            jsonOut += levelName;
+            jsonOut += "\",\"category\":";
+            appendJsonString(jsonOut, category);
+            jsonOut += ",\"message\":";
+            appendJsonString(jsonOut, message);
+            jsonOut += "}\n";
+        }
+    };
+
+    const std::uint64_t dropped = droppedSinceReport_.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        append(ERP::Common::LogSeverity::WARNING, std::chrono::system_clock::now(), "Logger",
+               std::to_string(dropped) + " log messages dropped (buffer full).");
+    }
+    for (const auto& record : batch) {
+        append(record.level, record.time, record.category, record.message);
+    }
+
+    // One write (and one flush) per output per batch
+    if (!consoleOut.empty()) {
+        std::cout << consoleOut << std::flush;
+    }
+    if (!consoleErr.empty()) {
+        std::cerr << consoleErr << std::flush;
+    }
+    if (!fileOut.empty()) {
+        logFile_.write(fileOut);
+    }
+    if (!jsonOut.empty()) {
+        jsonLogFile_.write(jsonOut);
+    }
+}
+
+const std::string& Logger::formatTimestamp(std::chrono::system_clock::time_point time) {
+    const std::time_t second = std::chrono::system_clock::to_time_t(time);
+    if (second != cachedSecond_) {
+        std::tm localTime{};
+#ifdef _WIN32
+        localtime_s(&localTime, &second);
+#else
+        localtime_r(&second, &localTime);
+#endif
+        char buffer[32];
+        const std::size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &localTime);
+        cachedTimestamp_.assign(buffer, length);
+        cachedSecond_ = second;
+    }
+    return cachedTimestamp_;
+}
+
+bool Logger::FileOutput::open(const std::string& filePath, std::size_t maxFileBytes, int maxBackupFiles) {
+    close();
+    stream.open(filePath, std::ios::app); // Open in append mode
+    if (!stream.is_open()) {
+        return false;
+    }
+    std::error_code ec;
+    const auto existingSize = std::filesystem::file_size(filePath, ec);
+    path = filePath;
+    bytes = ec ? 0 : static_cast<std::size_t>(existingSize);
+    maxBytes = maxFileBytes;
+    maxBackups = maxBackupFiles;
+    return true;
+}
+
+void Logger::FileOutput::close() {
+    if (stream.is_open()) {
+        stream.close();
+    }
+}
+
+void Logger::FileOutput::write(const std::string& data) {
+    stream << data;
+    stream.flush();
+    bytes += data.size();
+    if (maxBytes > 0 && bytes >= maxBytes) {
+        rotate();
+    }
+}
+
+void Logger::FileOutput::rotate() {
+    // file -> file.1 -> file.2 ... ; the oldest backup is removed
+    stream.close();
+    std::error_code ec;
+    if (maxBackups > 0) {
+        std::filesystem::remove(path + "." + std::to_string(maxBackups), ec);
+        for (int index = maxBackups - 1; index >= 1; --index) {
+            const std::string from = path + "." + std::to_string(index);
+            if (std::filesystem::exists(from, ec)) {
+                std::filesystem::rename(from, path + "." + std::to_string(index + 1), ec);
+            }
+        }
+        std::filesystem::rename(path, path + ".1", ec);
+    } else {
+        std::filesystem::remove(path, ec);
+    }
+    stream.open(path, std::ios::app);
+    bytes = 0;
+    if (!stream.is_open()) {
+        std::cerr << "ERROR: Failed to reopen log file after rotation: " << path << std::endl;
     }
 }
 
 } // namespace Logger
-} // namespace ERP
\ No newline at end of file
+} // namespace ERP
@@ -5,12 +5,18 @@
 #include <fstream>      // For std::ofstream (file output)
 #include <iostream>     // For std::cout, std::cerr (console output)
 #include <chrono>       // For std::chrono::system_clock (timestamps)
-#include <ctime>        // For std::time_t, std::localtime (time formatting)
+#include <ctime>        // For std::time_t, std::tm (time formatting)
 #include <iomanip>      // For std::put_time (time formatting)
 #include <sstream>      // For std::stringstream (building log messages)
-#include <memory>       // For std::shared_ptr (managing Logger instance)
-#include <mutex>        // For std::mutex (thread safety for logging)
-#include <map>          // For string conversions
+#include <memory>       // For std::shared_ptr (managing Logger instance), std::unique_ptr (ring buffer slots)
+#include <mutex>        // For std::mutex, std::once_flag
+#include <condition_variable> // For std::condition_variable (sink wake-up, flush)
+#include <atomic>       // For lock-free ring buffer positions and the log level
+#include <thread>       // For std::thread (sink thread)
+#include <vector>       // For std::vector (sink batches)
+#include <cstdint>      // For std::uint64_t
+#include <map>          // For string conversions, category levels
+#include <functional>   // For std::function (category level updates)
 
 // Rút gọn include paths
 #include "Common.h" // For LogSeverity enum (from Common module)
@@ -23,6 +29,12 @@ namespace Logger {
  * It allows logging messages at different severity levels (debug, info, warning, error, critical)
  * to various outputs (console, file, and potentially a remote service).
  * Implemented as a Singleton.
+ *
+ * Callers only move the message into a bounded lock-free ring buffer; a background sink thread
+ * formats the lines (timestamp cached per second), writes them to the console and the log file
+ * in batches and rotates the file by size. When the buffer is full, messages are dropped and
+ * counted instead of blocking the caller. Use the ERP_LOG_* macros where building the message
+ * is costly: they skip the formatting when the level is disabled.
  */
 class Logger {
 public:
@@ -42,12 +54,65 @@ public:
      */
     void setLogLevel(ERP::Common::LogSeverity level);
 
+    /**
+     * @brief Sets the minimum log level of a category, overriding the global level.
+     * @param categoryPattern An exact category (e.g. "GeneralLedgerService"), a prefix ending in '*'
+     * (e.g. "GeneralLedger*") or a suffix starting with '*' (e.g. "*DAO"). Exact names win, then the
+     * longest matching pattern.
+     * @param level The minimum log level for matching categories.
+     */
+    void setCategoryLogLevel(const std::string& categoryPattern, ERP::Common::LogSeverity level);
+
+    /**
+     * @brief Removes the level override of a category pattern.
+     */
+    void clearCategoryLogLevel(const std::string& categoryPattern);
+
+    /**
+     * @brief Removes every category level override.
+     */
+    void clearCategoryLogLevels();
+
+    /**
+     * @brief Applies a "Logging.*" configuration entry (see ConfigService).
+     * "Logging.Level" sets the global level (an empty value restores INFO), "Logging.Level.<pattern>" a
+     * category level (an empty value removes it) and "Logging.JsonFile" the JSON-lines output (an empty
+     * value closes it).
+     * @return True if the key is a logging key and the value is valid, false otherwise.
+     */
+    bool applyConfig(const std::string& key, const std::string& value);
+
+    /**
+     * @brief Checks whether messages of a level may be written for some category. Cheap enough to
+     * guard message formatting; the exact per-category check happens when the message is logged.
+     * @param level The severity to check.
+     * @return True if the level is at or above the lowest global or category level.
+     */
+    bool isEnabled(ERP::Common::LogSeverity level) const {
+        return static_cast<int>(level) >= minEnabledLevel_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the minimum log level that applies to a category.
+     */
+    ERP::Common::LogSeverity getLogLevel(const std::string& category) const;
+
     /**
      * @brief Sets the output file for logging.
      * @param filePath The path to the log file.
+     * @param maxFileBytes Size at which the file is rotated (0 disables rotation).
+     * @param maxBackupFiles Number of rotated files kept (filePath.1 is the newest).
      * @return True if the file was successfully opened, false otherwise.
      */
-    bool setLogFile(const std::string& filePath);
+    bool setLogFile(const std::string& filePath, std::size_t maxFileBytes = DEFAULT_MAX_FILE_BYTES, int maxBackupFiles = DEFAULT_MAX_BACKUP_FILES);
+
+    /**
+     * @brief Sets an additional JSON-lines output for log ingestion: one object per line with
+     * "time", "level", "category" and "message". Rotated like the text log file.
+     * @param filePath The path to the JSON-lines file, or an empty string to close it.
+     * @return True if the file was opened (or closed), false otherwise.
+     */
+    bool setJsonLogFile(const std::string& filePath, std::size_t maxFileBytes = DEFAULT_MAX_FILE_BYTES, int maxBackupFiles = DEFAULT_MAX_BACKUP_FILES);
 
     /**
      * @brief Logs a debug message.
@@ -84,25 +149,139 @@ public:
      */
     void critical(const std::string& message, const std::string& category = "General");
 
+    /**
+     * @brief Blocks until every message logged before the call has been written.
+     */
+    void flush();
+
+    /**
+     * @brief Writes the pending messages and stops the sink thread. Later messages are written synchronously.
+     */
+    void shutdown();
+
+    /**
+     * @brief Gets the number of messages dropped because the ring buffer was full.
+     */
+    std::uint64_t getDroppedCount() const { return totalDropped_.load(std::memory_order_relaxed); }
+
+    static constexpr std::size_t DEFAULT_MAX_FILE_BYTES = 10 * 1024 * 1024;
+    static constexpr int DEFAULT_MAX_BACKUP_FILES = 5;
+
 private:
     /**
      * @brief Private constructor to enforce singleton pattern.
      */
     Logger();
 
+    struct LogRecord {
+        ERP::Common::LogSeverity level = ERP::Common::LogSeverity::INFO;
+        std::chrono::system_clock::time_point time;
+        std::string category;
+        std::string message;
+    };
+
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        LogRecord record;
+    };
+
+    // Category level overrides; replaced as a whole (copy-on-write) so producers read them without locking
+    struct CategoryLevels {
+        std::map<std::string, int> exact;
+        std::vector<std::pair<std::string, int>> prefixes; // Pattern "Name*", stored without '*'
+        std::vector<std::pair<std::string, int>> suffixes; // Pattern "*Name", stored without '*'
+        std::map<std::string, int> patterns;               // All patterns as configured
+    };
+
+    // A log file with size-based rotation (file -> file.1 -> file.2 ...)
+    struct FileOutput {
+        std::ofstream stream;
+        std::string path;
+        std::size_t bytes = 0;
+        std::size_t maxBytes = DEFAULT_MAX_FILE_BYTES;
+        int maxBackups = DEFAULT_MAX_BACKUP_FILES;
+
+        bool open(const std::string& filePath, std::size_t maxFileBytes, int maxBackupFiles);
+        void close();
+        bool isOpen() const { return stream.is_open(); }
+        void write(const std::string& data);
+        void rotate();
+    };
+
     /**
-     * @brief Helper method to format and write the log message to various outputs.
+     * @brief Helper method to hand the log message to the sink (or write it directly after shutdown).
      * @param level The severity level of the message.
      * @param message The log message.
      * @param category The category for the log message.
      */
     void log(ERP::Common::LogSeverity level, const std::string& message, const std::string& category);
 
-    ERP::Common::LogSeverity currentLogLevel_;
-    std::ofstream logFile_;
-    std::mutex mutex_; // Mutex for thread-safe logging
+    bool tryPush(LogRecord& record);   // Any thread
+    bool tryPop(LogRecord& record);    // Sink thread, or drainAfterShutdown once it has exited
+    void sinkLoop();
+    void drainAfterShutdown();
+    void writeBatch(const std::vector<LogRecord>& batch);
+    const std::string& formatTimestamp(std::chrono::system_clock::time_point time); // Under fileMutex_
+    int levelFor(const std::string& category) const;
+    void updateCategoryLevels(const std::function<void(std::map<std::string, int>&)>& change);
+
+    static Logger* instance_;
+    static std::once_flag onceFlag_;
+
+    static constexpr std::size_t RING_CAPACITY = 8192; // Power of two
+    static constexpr std::size_t MAX_SINK_BATCH = 512;
+
+    std::atomic<int> currentLogLevel_;
+    std::atomic<int> minEnabledLevel_;                           // min(global level, category levels)
+    std::shared_ptr<const CategoryLevels> categoryLevels_;       // Accessed with std::atomic_load/atomic_store
+    std::mutex categoryLevelsMutex_;                             // Serializes writers
+
+    // Ring buffer (multi-producer, single consumer)
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<std::size_t> enqueuePos_{0};
+    std::size_t dequeuePos_ = 0;
+    std::atomic<std::uint64_t> droppedSinceReport_{0};
+    std::atomic<std::uint64_t> totalDropped_{0};
+    std::atomic<std::uint64_t> acceptedCount_{0};
+
+    // Sink thread
+    std::thread sinkThread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> sinkSleeping_{false};
+    bool stopping_ = false;
+    std::uint64_t writtenCount_ = 0;
+    std::mutex sinkMutex_;
+    std::condition_variable sinkWake_;
+    std::condition_variable drained_;
+    std::mutex shutdownDrainMutex_;                              // Serializes consumers once the sink has exited
+
+    // Outputs
+    std::mutex fileMutex_;
+    FileOutput logFile_;
+    FileOutput jsonLogFile_;
+    std::time_t cachedSecond_ = -1;
+    std::string cachedTimestamp_;
 };
 
 } // namespace Logger
 } // namespace ERP
-#endif // MODULES_LOGGER_LOGGER_H
\ No newline at end of file
+
+/**
+ * @brief Level-checked logging: the arguments (and any string building in them) are only
+ * evaluated when the level is enabled. Arguments are the same as for the Logger methods.
+ */
+#define ERP_LOG_AT(LEVEL, METHOD, ...) \
+    do { \
+        ::ERP::Logger::Logger& erpLogger_ = ::ERP::Logger::Logger::getInstance(); \
+        if (erpLogger_.isEnabled(::ERP::Common::LogSeverity::LEVEL)) { \
+            erpLogger_.METHOD(__VA_ARGS__); \
+        } \
+    } while (false)
+
+#define ERP_LOG_DEBUG(...)    ERP_LOG_AT(DEBUG, debug, __VA_ARGS__)
+#define ERP_LOG_INFO(...)     ERP_LOG_AT(INFO, info, __VA_ARGS__)
+#define ERP_LOG_WARNING(...)  ERP_LOG_AT(WARNING, warning, __VA_ARGS__)
+#define ERP_LOG_ERROR(...)    ERP_LOG_AT(ERROR, error, __VA_ARGS__)
+#define ERP_LOG_CRITICAL(...) ERP_LOG_AT(CRITICAL, critical, __VA_ARGS__)
+
+#endif // MODULES_LOGGER_LOGGER_H
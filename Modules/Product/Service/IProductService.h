@@ -42,6 +42,17 @@ namespace ERP {
                 virtual std::optional<ERP::Product::DTO::ProductDTO> getProductById(
                     const std::string& productId,
                     const std::vector<std::string>& userRoleIds = {}) = 0;
+                /**
+                 * @brief Retrieves many products by ID with one permission check and one IN (...) query per chunk of IDs.
+                 * @param productIds IDs of the products to retrieve (duplicates allowed).
+                 * @param currentUserId ID of the user performing the operation.
+                 * @param userRoleIds Roles of the user performing the operation.
+                 * @return The products found, in no particular order; IDs without a product are skipped.
+                 */
+                virtual std::vector<ERP::Product::DTO::ProductDTO> getProductsByIds(
+                    const std::vector<std::string>& productIds,
+                    const std::string& currentUserId,
+                    const std::vector<std::string>& userRoleIds) = 0;
                 /**
                  * @brief Retrieves product information by product code.
                  * @param productCode Product code to retrieve.
@@ -137,6 +137,19 @@ namespace ERP {
                 return productDAO_->getProductById(productId); // Specific DAO method
             }
 
+            std::vector<ERP::Product::DTO::ProductDTO> ProductService::getProductsByIds(
+                const std::vector<std::string>& productIds,
+                const std::string& currentUserId,
+                const std::vector<std::string>& userRoleIds) {
+                ERP::Logger::Logger::getInstance().debug("ProductService: Retrieving " + std::to_string(productIds.size()) + " products by ID.");
+
+                if (!checkPermission(currentUserId, userRoleIds, "Product.ViewProducts", "Bạn không có quyền xem sản phẩm.")) {
+                    return {};
+                }
+
+                return productDAO_->findByIds(productIds); // One IN (...) query per chunk
+            }
+
             std::optional<ERP::Product::DTO::ProductDTO> ProductService::getProductByCode(
                 const std::string& productCode,
                 const std::vector<std::string>& userRoleIds) {
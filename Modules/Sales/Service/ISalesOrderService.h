@@ -10,6 +10,7 @@
 // Rút gọn các include paths
 #include "SalesOrder.h"         // DTO
 #include "SalesOrderDetail.h"   // DTO
+#include "DAOBase/Paging.h"     // PageRequest, Page
 #include "Common.h"             // Enum Common
 #include "BaseService.h"        // Base Service
 
@@ -61,6 +62,19 @@ public:
     virtual std::vector<ERP::Sales::DTO::SalesOrderDTO> getAllSalesOrders(
         const std::map<std::string, std::any>& filter = {},
         const std::vector<std::string>& userRoleIds = {}) = 0;
+    /**
+     * @brief Retrieves one page of sales orders (keyset pagination on created_at, id).
+     * @param filter Map of filter conditions.
+     * @param pageRequest Page size, cursor and optional column projection.
+     * @param currentUserId ID of the user performing the operation.
+     * @param userRoleIds Roles of the user performing the operation.
+     * @return The page of SalesOrderDTOs and the cursor for the next one.
+     */
+    virtual ERP::DAOBase::Page<ERP::Sales::DTO::SalesOrderDTO> getSalesOrdersPage(
+        const std::map<std::string, std::any>& filter,
+        const ERP::DAOBase::PageRequest& pageRequest,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds = {}) = 0;
     /**
      * @brief Updates sales order information.
      * @param salesOrderDTO DTO containing updated sales order information (must have ID).
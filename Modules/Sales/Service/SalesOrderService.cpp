@@ -163,6 +163,20 @@ std::vector<ERP::Sales::DTO::SalesOrderDTO> SalesOrderService::getAllSalesOrders
     return salesOrderDAO_->get(filter); // Using get from DAOBase template
 }
 
+ERP::DAOBase::Page<ERP::Sales::DTO::SalesOrderDTO> SalesOrderService::getSalesOrdersPage(
+    const std::map<std::string, std::any>& filter,
+    const ERP::DAOBase::PageRequest& pageRequest,
+    const std::string& currentUserId,
+    const std::vector<std::string>& userRoleIds) {
+    ERP::Logger::Logger::getInstance().info("SalesOrderService: Retrieving a page of sales orders.");
+
+    if (!checkPermission(currentUserId, userRoleIds, "Sales.ViewSalesOrders", "Bạn không có quyền xem tất cả đơn hàng bán.")) {
+        return {};
+    }
+
+    return salesOrderDAO_->getPage(filter, pageRequest);
+}
+
 bool SalesOrderService::updateSalesOrder(
     const ERP::Sales::DTO::SalesOrderDTO& salesOrderDTO,
     const std::string& currentUserId,
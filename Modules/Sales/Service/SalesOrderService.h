@@ -150,6 +150,11 @@ public:
     std::vector<ERP::Sales::DTO::SalesOrderDTO> getAllSalesOrders(
         const std::map<std::string, std::any>& filter = {},
         const std::vector<std::string>& userRoleIds = {}) override;
+    ERP::DAOBase::Page<ERP::Sales::DTO::SalesOrderDTO> getSalesOrdersPage(
+        const std::map<std::string, std::any>& filter,
+        const ERP::DAOBase::PageRequest& pageRequest,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds = {}) override;
     bool updateSalesOrder(
         const ERP::Sales::DTO::SalesOrderDTO& salesOrderDTO,
         const std::string& currentUserId,
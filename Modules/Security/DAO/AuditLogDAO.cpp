@@ -8,6 +8,7 @@
 #include "Modules/Utils/DTOUtils.h" // For common DTO to map conversions
 #include <nlohmann/json.hpp> // For JSON serialization/deserialization of std::map<string, any>
 #include <sstream>
+#include <algorithm> // For std::min, std::max
 #include <stdexcept>
 #include <typeinfo> // For std::bad_any_cast
 
@@ -163,6 +164,54 @@ ERP::Security::DTO::AuditLogDTO AuditLogDAO::fromMap(const std::map<std::string,
     return dto;
 }
 
+std::map<std::string, std::any> AuditLogDAO::toRow(const ERP::Security::DTO::AuditLogDTO& dto) const {
+    return toMap(dto);
+}
+
+const std::vector<std::string>& AuditLogDAO::insertColumns() {
+    static const std::vector<std::string> columns = {
+        "id", "user_id", "user_name", "session_id", "action_type", "severity", "module", "sub_module",
+        "entity_id", "entity_type", "entity_name", "ip_address", "user_agent", "workstation_id",
+        "production_line_id", "shift_id", "batch_number", "part_number",
+        "before_data_json", "after_data_json", "change_reason", "metadata_json",
+        "comments", "approval_id", "is_compliant", "compliance_note", "created_at", "created_by"
+    };
+    return columns;
+}
+
+bool AuditLogDAO::insertBatch(ERP::Database::DBConnection& conn, const std::vector<std::map<std::string, std::any>>& rows) {
+    const std::vector<std::string>& columns = insertColumns();
+    const std::size_t rowsPerStatement = std::max<std::size_t>(1, MAX_BIND_PARAMETERS / columns.size());
+
+    std::string columnList;
+    for (std::size_t c = 0; c < columns.size(); ++c) {
+        columnList += (c == 0 ? "" : ", ") + columns[c];
+    }
+
+    for (std::size_t offset = 0; offset < rows.size(); offset += rowsPerStatement) {
+        const std::size_t end = std::min(offset + rowsPerStatement, rows.size());
+        std::string sql = "INSERT INTO " + tableName_ + " (" + columnList + ") VALUES ";
+        std::map<std::string, std::any> params;
+        for (std::size_t r = offset; r < end; ++r) {
+            const std::string prefix = ":r" + std::to_string(r - offset) + "_";
+            sql += (r == offset ? "(" : ", (");
+            for (std::size_t c = 0; c < columns.size(); ++c) {
+                sql += (c == 0 ? "" : ", ") + prefix + columns[c];
+                auto it = rows[r].find(columns[c]);
+                params[prefix.substr(1) + columns[c]] = (it != rows[r].end()) ? it->second : std::any();
+            }
+            sql += ")";
+        }
+        // Only an id already written by an earlier replay is skipped; NOT NULL or CHECK violations still fail
+        sql += " ON CONFLICT(id) DO NOTHING;";
+        if (!conn.execute(sql, params)) {
+            ERP::Logger::Logger::getInstance().error("Failed to insert audit log batch: " + conn.getLastError(), "AuditLogDAO");
+            return false;
+        }
+    }
+    return true;
+}
+
 } // namespace DAOs
 } // namespace Security
 } // namespace ERP
\ No newline at end of file
@@ -29,8 +29,25 @@ protected:
     std::map<std::string, std::any> toMap(const ERP::Security::DTO::AuditLogDTO& dto) const override;
     ERP::Security::DTO::AuditLogDTO fromMap(const std::map<std::string, std::any>& data) const override;
 
+public:
+    /**
+     * @brief Converts an entry to the column/value row written by insertBatch.
+     */
+    std::map<std::string, std::any> toRow(const ERP::Security::DTO::AuditLogDTO& dto) const;
+
+    /**
+     * @brief Inserts rows with multi-row INSERT statements on the caller's transaction connection.
+     * Rows whose id already exists are skipped, so a replayed batch is not written twice.
+     * @param rows Rows built by toRow (keys outside the audit_logs columns are ignored).
+     * @return True if every statement succeeded, false otherwise.
+     */
+    bool insertBatch(ERP::Database::DBConnection& conn, const std::vector<std::map<std::string, std::any>>& rows);
+
 private:
     // tableName_ is now a member of DAOBase
+    static const std::vector<std::string>& insertColumns();
+
+    static constexpr std::size_t MAX_BIND_PARAMETERS = 999; // SQLite's default bound-parameter limit per statement
 };
 
 } // namespace DAOs
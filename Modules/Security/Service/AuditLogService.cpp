@@ -7,7 +7,6 @@
 #include "ErrorHandler.h" // Đã rút gọn include
 #include "Common.h" // Đã rút gọn include
 #include "DateUtils.h" // Đã rút gọn include
-#include "AutoRelease.h" // Đã rút gọn include
 #include "DTOUtils.h" // For mapToJsonString (now internal)
 #include <nlohmann/json.hpp> // For JSON serialization/deserialization
 
@@ -19,49 +18,29 @@ namespace ERP {
 namespace Security {
 namespace Services {
 
-// Template method implementation for executeTransactionInternal
-template<typename Func>
-bool AuditLogService::executeTransactionInternal(Func operation, const std::string& serviceName, const std::string& operationName) {
-    std::shared_ptr<ERP::Database::DBConnection> db = connectionPool_->getConnection();
-    ERP::Utils::AutoRelease releaseGuard([&]() {
-        if (db) connectionPool_->releaseConnection(db);
-    });
-    if (!db) {
-        ERP::Logger::Logger::getInstance().critical(serviceName, "Database connection is null. Cannot perform " + operationName + ".");
-        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::ServerError, "Database connection is null.", "Lỗi hệ thống: Không có kết nối cơ sở dữ liệu.");
-        return false;
-    }
-    try {
-        db->beginTransaction();
-        bool success = operation(db);
-        if (success) {
-            db->commitTransaction();
-            ERP::Logger::Logger::getInstance().info(serviceName, operationName + " completed successfully.");
-        } else {
-            db->rollbackTransaction();
-            ERP::Logger::Logger::getInstance().error(serviceName, operationName + " failed. Transaction rolled back.");
-        }
-        return success;
-    } catch (const std::exception& e) {
-        db->rollbackTransaction();
-        ERP::Logger::Logger::getInstance().critical(serviceName, "Exception during " + operationName + ": " + std::string(e.what()));
-        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::OperationFailed, "Lỗi trong quá trình " + operationName + ": " + std::string(e.what()));
-        return false;
-    }
-}
-
 AuditLogService::AuditLogService(
     std::shared_ptr<DAOs::AuditLogDAO> auditLogDAO,
-    std::shared_ptr<ERP::Database::ConnectionPool> connectionPool)
+    std::shared_ptr<ERP::Database::ConnectionPool> connectionPool,
+    AuditLogWriterConfig writerConfig)
     : auditLogDAO_(auditLogDAO), connectionPool_(connectionPool) {
     if (!auditLogDAO_ || !connectionPool_) {
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::ServerError, "AuditLogService: Initialized with null dependencies.", "Lỗi hệ thống trong quá trình khởi tạo dịch vụ nhật ký kiểm toán.");
         ERP::Logger::Logger::getInstance().critical("AuditLogService: Injected AuditLogDAO or ConnectionPool is null.");
         throw std::runtime_error("AuditLogService: Null dependencies.");
     }
+    writer_ = std::make_unique<AuditLogWriter>(auditLogDAO_, connectionPool_, std::move(writerConfig));
+    writer_->start();
     ERP::Logger::Logger::getInstance().info("AuditLogService: Initialized.");
 }
 
+AuditLogService::~AuditLogService() {
+    writer_->stop(); // Writes what is still queued (or spills it to disk)
+}
+
+bool AuditLogService::flush() {
+    return writer_->flush();
+}
+
 // recordLog signature updated to accept std::map<string, any>
 bool AuditLogService::recordLog(
     const std::string& userId, const std::string& userName, const std::string& sessionId,
@@ -110,16 +89,10 @@ bool AuditLogService::recordLog(
 
     ERP::Logger::Logger::getInstance().debug("AuditLogService: Recording log for action: " + logEntry.getActionTypeString() + " by " + logEntry.userName);
 
-    bool success = executeTransactionInternal(
-        [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
-            // AuditLogDAO uses templated DAOBase::create method
-            return auditLogDAO_->create(logEntry);
-        },
-        "AuditLogService", "recordLog"
-    );
-
-    if (!success) {
-        ERP::Logger::Logger::getInstance().error("AuditLogService: Failed to persist audit log for action: " + logEntry.getActionTypeString());
+    // Persisted in batches by the background writer, outside the caller's transaction
+    const std::string actionTypeString = logEntry.getActionTypeString();
+    if (!writer_->enqueue(std::move(logEntry))) {
+        ERP::Logger::Logger::getInstance().error("AuditLogService: Failed to queue audit log for action: " + actionTypeString);
         return false;
     }
     return true;
@@ -10,6 +10,7 @@
 #include <any> // For std::any if AuditLogDTO uses it directly
 #include "AuditLog.h"     // Đã rút gọn include
 #include "AuditLogDAO.h"  // Đã rút gọn include
+#include "AuditLogWriter.h" // Đã rút gọn include
 #include "ConnectionPool.h" // Đã rút gọn include
 #include "Logger.h"       // Đã rút gọn include
 #include "ErrorHandler.h" // Đã rút gọn include
@@ -71,10 +72,17 @@ public:
         const std::optional<std::string>& changeReason = std::nullopt, const QJsonObject& metadata = QJsonObject(),
         const std::optional<std::string>& comments = std::nullopt, const std::optional<std::string>& approvalId = std::nullopt,
         bool isCompliant = true, const std::optional<std::string>& complianceNote = std::nullopt) = 0;
+
+    /**
+     * @brief Writes every audit log entry still pending in memory. Call before shutting down the connection pool.
+     * @return true if nothing is left pending, false otherwise.
+     */
+    virtual bool flush() = 0;
 };
 /**
  * @brief Default implementation of IAuditLogService.
- * This class handles the persistence of audit log entries.
+ * This class handles the persistence of audit log entries. Entries are written asynchronously
+ * in batches by an AuditLogWriter, so recordLog does not wait for the database.
  */
 class AuditLogService : public IAuditLogService {
 public:
@@ -82,9 +90,12 @@ public:
      * @brief Constructor for AuditLogService.
      * @param auditLogDAO Shared pointer to AuditLogDAO.
      * @param connectionPool Shared pointer to ConnectionPool.
+     * @param writerConfig Batch size, flush interval, queue bound and spill file of the background writer.
      */
     AuditLogService(std::shared_ptr<DAOs::AuditLogDAO> auditLogDAO,
-                    std::shared_ptr<ERP::Database::ConnectionPool> connectionPool);
+                    std::shared_ptr<ERP::Database::ConnectionPool> connectionPool,
+                    AuditLogWriterConfig writerConfig = AuditLogWriterConfig());
+    ~AuditLogService() override;
 
     bool recordLog(
         const std::string& userId, const std::string& userName, const std::string& sessionId,
@@ -98,13 +109,12 @@ public:
         const std::optional<std::string>& comments = std::nullopt, const std::optional<std::string>& approvalId = std::nullopt,
         bool isCompliant = true, const std::optional<std::string>& complianceNote = std::nullopt) override;
 
+    bool flush() override;
+
 private:
     std::shared_ptr<DAOs::AuditLogDAO> auditLogDAO_;
     std::shared_ptr<ERP::Database::ConnectionPool> connectionPool_;
-
-    // Helper for transaction management (replicated for foundational services)
-    template<typename Func>
-    bool executeTransactionInternal(Func operation, const std::string& serviceName, const std::string& operationName);
+    std::unique_ptr<AuditLogWriter> writer_;
 };
 } // namespace Services
 } // namespace Security
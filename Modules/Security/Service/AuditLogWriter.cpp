@@ -0,0 +1,286 @@
+// Modules/Security/Service/AuditLogWriter.cpp
+#include "AuditLogWriter.h" // Đã rút gọn include
+#include "UnitOfWork.h"     // One transaction per batch
+#include "Logger.h"         // Đã rút gọn include
+#include "ErrorHandler.h"   // Đã rút gọn include
+#include "Common.h"         // Đã rút gọn include
+#include <nlohmann/json.hpp> // For spill file rows
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+
+namespace ERP {
+namespace Security {
+namespace Services {
+
+using json = nlohmann::json;
+
+namespace {
+// Spill rows hold the plain column values produced by AuditLogDAO::toRow
+json rowToJson(const std::map<std::string, std::any>& row) {
+    json object = json::object();
+    for (const auto& [column, value] : row) {
+        if (!value.has_value()) {
+            object[column] = nullptr;
+        } else if (value.type() == typeid(std::string)) {
+            object[column] = std::any_cast<std::string>(value);
+        } else if (value.type() == typeid(int)) {
+            object[column] = std::any_cast<int>(value);
+        } else if (value.type() == typeid(long long)) {
+            object[column] = std::any_cast<long long>(value);
+        } else if (value.type() == typeid(double)) {
+            object[column] = std::any_cast<double>(value);
+        } else if (value.type() == typeid(bool)) {
+            object[column] = std::any_cast<bool>(value);
+        }
+    }
+    return object;
+}
+
+std::map<std::string, std::any> rowFromJson(const json& object) {
+    std::map<std::string, std::any> row;
+    for (auto it = object.begin(); it != object.end(); ++it) {
+        const json& value = it.value();
+        if (value.is_string()) {
+            row[it.key()] = value.get<std::string>();
+        } else if (value.is_boolean()) {
+            row[it.key()] = value.get<bool>();
+        } else if (value.is_number_integer()) {
+            row[it.key()] = value.get<long long>();
+        } else if (value.is_number_float()) {
+            row[it.key()] = value.get<double>();
+        } else {
+            row[it.key()] = std::any();
+        }
+    }
+    return row;
+}
+} // namespace
+
+AuditLogWriter::AuditLogWriter(std::shared_ptr<DAOs::AuditLogDAO> auditLogDAO,
+                               std::shared_ptr<ERP::Database::ConnectionPool> connectionPool,
+                               AuditLogWriterConfig config)
+    : auditLogDAO_(auditLogDAO), connectionPool_(connectionPool), config_(std::move(config)) {
+    config_.maxBatchSize = std::max<std::size_t>(1, config_.maxBatchSize);
+    config_.queueCapacity = std::max(config_.queueCapacity, config_.maxBatchSize);
+}
+
+AuditLogWriter::~AuditLogWriter() {
+    stop();
+}
+
+void AuditLogWriter::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (worker_.joinable()) {
+        return;
+    }
+    stopping_ = false;
+    worker_ = std::thread(&AuditLogWriter::run, this); // Replays the spill file first
+}
+
+void AuditLogWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    spaceAvailable_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    flush(); // Entries queued after the worker's last batch
+}
+
+bool AuditLogWriter::enqueue(ERP::Security::DTO::AuditLogDTO entry) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!stopping_ && worker_.joinable()) {
+        // Backpressure: wait briefly for room, then fall back to the spill file instead of blocking the caller
+        if (spaceAvailable_.wait_for(lock, config_.enqueueTimeout,
+                                     [this] { return stopping_ || queue_.size() < config_.queueCapacity; })
+            && !stopping_) {
+            queue_.push_back(std::move(entry));
+            const bool batchReady = queue_.size() >= config_.maxBatchSize;
+            lock.unlock();
+            if (batchReady) {
+                workAvailable_.notify_one();
+            }
+            return true;
+        }
+    }
+    lock.unlock();
+    ERP::Logger::Logger::getInstance().warning("Audit queue full or writer stopped. Spilling entry " + entry.id + " to disk.", "AuditLogWriter");
+    return spill({ auditLogDAO_->toRow(entry) });
+}
+
+bool AuditLogWriter::flush() {
+    bool success = drainQueue();
+    std::lock_guard<std::mutex> writeLock(writeMutex_);
+    return replaySpillFile() && success;
+}
+
+std::size_t AuditLogWriter::pendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+void AuditLogWriter::run() {
+    {
+        std::lock_guard<std::mutex> writeLock(writeMutex_);
+        replaySpillFile();
+    }
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workAvailable_.wait_for(lock, config_.flushInterval,
+                                    [this] { return stopping_ || queue_.size() >= config_.maxBatchSize; });
+            if (stopping_) {
+                break; // stop() flushes what is left
+            }
+        }
+        drainQueue();
+    }
+}
+
+bool AuditLogWriter::drainQueue() {
+    bool success = true;
+    while (true) {
+        // Taking and writing a batch under writeMutex_ lets flush() wait for a batch the worker already took
+        std::lock_guard<std::mutex> writeLock(writeMutex_);
+        std::vector<ERP::Security::DTO::AuditLogDTO> batch = takeBatch();
+        if (batch.empty()) {
+            return success;
+        }
+        success = writeBatch(batch) && success;
+    }
+}
+
+std::vector<ERP::Security::DTO::AuditLogDTO> AuditLogWriter::takeBatch() {
+    std::vector<ERP::Security::DTO::AuditLogDTO> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::size_t count = std::min(queue_.size(), config_.maxBatchSize);
+        batch.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            batch.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+        }
+    }
+    if (!batch.empty()) {
+        spaceAvailable_.notify_all();
+    }
+    return batch;
+}
+
+bool AuditLogWriter::writeBatch(const std::vector<ERP::Security::DTO::AuditLogDTO>& batch) {
+    // Caller holds writeMutex_. Serialization of before/after data happens here, off the caller's thread.
+    std::vector<std::map<std::string, std::any>> rows;
+    rows.reserve(batch.size());
+    for (const auto& entry : batch) {
+        rows.push_back(auditLogDAO_->toRow(entry));
+    }
+    if (!writeRows(rows)) {
+        ERP::Logger::Logger::getInstance().error("Failed to write " + std::to_string(rows.size()) + " audit log entries. Spilling them to disk.", "AuditLogWriter");
+        return spill(rows);
+    }
+    ERP::Logger::Logger::getInstance().debug("Wrote " + std::to_string(rows.size()) + " audit log entries.", "AuditLogWriter");
+    replaySpillFile();
+    return true;
+}
+
+bool AuditLogWriter::writeRows(const std::vector<std::map<std::string, std::any>>& rows) {
+    ERP::Database::UnitOfWork unitOfWork(connectionPool_);
+    if (!unitOfWork.begin()) {
+        return false;
+    }
+    if (!auditLogDAO_->insertBatch(*unitOfWork.connection(), rows)) {
+        unitOfWork.rollback();
+        return false;
+    }
+    return unitOfWork.commit();
+}
+
+bool AuditLogWriter::spill(const std::vector<std::map<std::string, std::any>>& rows) {
+    std::lock_guard<std::mutex> spillLock(spillMutex_);
+    return appendRows(config_.spillFilePath, rows);
+}
+
+bool AuditLogWriter::appendRows(const std::string& path, const std::vector<std::map<std::string, std::any>>& rows) {
+    std::ofstream file(path, std::ios::app);
+    if (!file) {
+        ERP::Logger::Logger::getInstance().critical("Cannot open audit spill file " + path + ". " +
+                                                    std::to_string(rows.size()) + " audit log entries lost.", "AuditLogWriter");
+        ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::OperationFailed, "AuditLogWriter: Cannot open spill file.");
+        return false;
+    }
+    for (const auto& row : rows) {
+        file << rowToJson(row).dump() << '\n';
+    }
+    file.flush();
+    return static_cast<bool>(file);
+}
+
+bool AuditLogWriter::replaySpillFile() {
+    // Caller holds writeMutex_. The spill file is moved aside first, so entries spilled meanwhile go to a new file.
+    const std::string replayPath = config_.spillFilePath + ".replay";
+    std::error_code ec;
+    {
+        std::lock_guard<std::mutex> spillLock(spillMutex_);
+        if (!std::filesystem::exists(replayPath, ec)) { // A leftover .replay file is from an interrupted replay
+            if (!std::filesystem::exists(config_.spillFilePath, ec)) {
+                return true;
+            }
+            std::filesystem::rename(config_.spillFilePath, replayPath, ec);
+            if (ec) {
+                ERP::Logger::Logger::getInstance().error("Cannot move audit spill file aside: " + ec.message(), "AuditLogWriter");
+                return false;
+            }
+        }
+    }
+
+    std::vector<std::map<std::string, std::any>> rows;
+    {
+        std::ifstream file(replayPath);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            try {
+                rows.push_back(rowFromJson(json::parse(line)));
+            } catch (const std::exception& e) {
+                ERP::Logger::Logger::getInstance().error("Skipping unreadable audit spill line: " + std::string(e.what()), "AuditLogWriter");
+            }
+        }
+    }
+    // A failed batch is retried row by row, so one row the database rejects cannot block the others forever
+    std::vector<std::map<std::string, std::any>> rejected;
+    for (std::size_t offset = 0; offset < rows.size(); offset += config_.maxBatchSize) {
+        std::vector<std::map<std::string, std::any>> batch(rows.begin() + offset,
+                                                           rows.begin() + std::min(offset + config_.maxBatchSize, rows.size()));
+        if (writeRows(batch)) {
+            continue;
+        }
+        ERP::Logger::Logger::getInstance().warning("Audit spill replay batch failed. Retrying its " + std::to_string(batch.size()) + " entries one by one.", "AuditLogWriter");
+        for (const auto& row : batch) {
+            if (!writeRows({ row })) {
+                rejected.push_back(row);
+            }
+        }
+    }
+    if (!rejected.empty()) {
+        ERP::Logger::Logger::getInstance().error("Moving " + std::to_string(rejected.size()) + " spilled audit log entries that failed to replay to " +
+                                                 config_.deadLetterFilePath + ".", "AuditLogWriter");
+        if (!appendRows(config_.deadLetterFilePath, rejected)) {
+            return false; // Keep the replay file rather than lose the rejected rows
+        }
+    }
+    std::filesystem::remove(replayPath, ec);
+    if (rows.size() > rejected.size()) {
+        ERP::Logger::Logger::getInstance().info("Replayed " + std::to_string(rows.size() - rejected.size()) + " spilled audit log entries.", "AuditLogWriter");
+    }
+    return rejected.empty();
+}
+
+} // namespace Services
+} // namespace Security
+} // namespace ERP
@@ -0,0 +1,109 @@
+// Modules/Security/Service/AuditLogWriter.h
+#ifndef MODULES_SECURITY_SERVICE_AUDITLOGWRITER_H
+#define MODULES_SECURITY_SERVICE_AUDITLOGWRITER_H
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <any>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include "AuditLog.h"       // Đã rút gọn include
+#include "AuditLogDAO.h"    // Đã rút gọn include
+#include "ConnectionPool.h" // Đã rút gọn include
+
+namespace ERP {
+namespace Security {
+namespace Services {
+
+/**
+ * @brief Tuning of the asynchronous audit log writer.
+ */
+struct AuditLogWriterConfig {
+    std::size_t maxBatchSize = 200;                        /**< Rows written per transaction. */
+    std::chrono::milliseconds flushInterval{500};          /**< Longest time an entry waits in the queue. */
+    std::size_t queueCapacity = 10000;                     /**< Bound of the in-memory queue. */
+    std::chrono::milliseconds enqueueTimeout{50};          /**< Longest time a caller waits for room before spilling. */
+    std::string spillFilePath = "audit_log_spill.jsonl";   /**< Entries that could not be queued or written, one JSON row per line. */
+    std::string deadLetterFilePath = "audit_log_dead.jsonl"; /**< Spilled entries the database rejected on replay, same format. */
+};
+
+/**
+ * @brief The AuditLogWriter class takes audit log entries off the caller's thread.
+ *
+ * Entries go into a bounded queue drained by a background thread, which inserts them in
+ * multi-row batches, one transaction per batch. When the queue is full a caller waits at most
+ * enqueueTimeout and then appends the entry to the spill file; batches that fail to insert
+ * are spilled as well. The spill file is replayed on start and after every successful batch,
+ * and replays are idempotent (rows are keyed by their id). A replay batch that fails is retried
+ * row by row; rows that still fail go to the dead-letter file so they cannot block the replay.
+ */
+class AuditLogWriter {
+public:
+    AuditLogWriter(std::shared_ptr<DAOs::AuditLogDAO> auditLogDAO,
+                   std::shared_ptr<ERP::Database::ConnectionPool> connectionPool,
+                   AuditLogWriterConfig config = AuditLogWriterConfig());
+    ~AuditLogWriter();
+
+    AuditLogWriter(const AuditLogWriter&) = delete;
+    AuditLogWriter& operator=(const AuditLogWriter&) = delete;
+
+    /**
+     * @brief Replays the spill file and starts the background thread.
+     */
+    void start();
+
+    /**
+     * @brief Writes the queued entries and stops the background thread.
+     */
+    void stop();
+
+    /**
+     * @brief Queues an entry for the background thread.
+     * @return True if queued or spilled to disk, false if the entry was lost.
+     */
+    bool enqueue(ERP::Security::DTO::AuditLogDTO entry);
+
+    /**
+     * @brief Writes every queued entry and replays the spill file on the calling thread.
+     * @return True if nothing is left pending, false otherwise.
+     */
+    bool flush();
+
+    /**
+     * @brief Gets the number of entries waiting in the queue.
+     */
+    std::size_t pendingCount() const;
+
+private:
+    std::shared_ptr<DAOs::AuditLogDAO> auditLogDAO_;
+    std::shared_ptr<ERP::Database::ConnectionPool> connectionPool_;
+    AuditLogWriterConfig config_;
+
+    std::deque<ERP::Security::DTO::AuditLogDTO> queue_;
+    mutable std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable spaceAvailable_;
+    bool stopping_ = false;
+    std::thread worker_;
+
+    std::mutex writeMutex_;  // One batch writer at a time (background thread or flush())
+    std::mutex spillMutex_;  // Serializes access to the spill file
+
+    void run();
+    bool drainQueue();
+    std::vector<ERP::Security::DTO::AuditLogDTO> takeBatch();
+    bool writeRows(const std::vector<std::map<std::string, std::any>>& rows);
+    bool writeBatch(const std::vector<ERP::Security::DTO::AuditLogDTO>& batch);
+    bool spill(const std::vector<std::map<std::string, std::any>>& rows);
+    bool appendRows(const std::string& path, const std::vector<std::map<std::string, std::any>>& rows);
+    bool replaySpillFile();
+};
+
+} // namespace Services
+} // namespace Security
+} // namespace ERP
+#endif // MODULES_SECURITY_SERVICE_AUDITLOGWRITER_H
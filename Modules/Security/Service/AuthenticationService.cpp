@@ -4,6 +4,7 @@
 #include "Event.h"
 #include "ConnectionPool.h"
 #include "DBConnection.h"
+#include "UnitOfWork.h"
 #include "Common.h"
 #include "Utils.h"
 #include "DateUtils.h"
@@ -24,29 +25,29 @@ namespace Services {
 // Template method implementation for executeTransactionInternal
 template<typename Func>
 bool AuthenticationService::executeTransactionInternal(Func operation, const std::string& serviceName, const std::string& operationName) {
-    std::shared_ptr<ERP::Database::DBConnection> db = connectionPool_->getConnection();
-    ERP::Utils::AutoRelease releaseGuard([&]() {
-        if (db) connectionPool_->releaseConnection(db);
-    });
-    if (!db) {
-        ERP::Logger::Logger::getInstance().critical(serviceName, "Database connection is null. Cannot perform " + operationName + ".");
+    ERP::Database::UnitOfWork unitOfWork(connectionPool_); // Joins the caller's transaction if one is open on this thread
+    if (!unitOfWork.begin()) {
+        ERP::Logger::Logger::getInstance().critical("Database connection is null. Cannot perform " + operationName + ".", serviceName);
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::ServerError, "Database connection is null.", "Lỗi hệ thống: Không có kết nối cơ sở dữ liệu.");
         return false;
     }
+    std::shared_ptr<ERP::Database::DBConnection> db = unitOfWork.connection();
     try {
-        db->beginTransaction();
         bool success = operation(db);
         if (success) {
-            db->commitTransaction();
-            ERP::Logger::Logger::getInstance().info(serviceName, operationName + " completed successfully.");
+            if (!unitOfWork.commit()) {
+                ERP::Logger::Logger::getInstance().error(operationName + " could not be committed. Transaction rolled back.", serviceName);
+                return false;
+            }
+            ERP::Logger::Logger::getInstance().info(operationName + " completed successfully.", serviceName);
         } else {
-            db->rollbackTransaction();
-            ERP::Logger::Logger::getInstance().error(serviceName, operationName + " failed. Transaction rolled back.");
+            unitOfWork.rollback();
+            ERP::Logger::Logger::getInstance().error(operationName + " failed. Transaction rolled back.", serviceName);
         }
         return success;
     } catch (const std::exception& e) {
-        db->rollbackTransaction();
-        ERP::Logger::Logger::getInstance().critical(serviceName, "Exception during " + operationName + ": " + std::string(e.what()));
+        unitOfWork.rollback();
+        ERP::Logger::Logger::getInstance().critical("Exception during " + operationName + ": " + std::string(e.what()), serviceName);
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::OperationFailed, "Lỗi trong quá trình " + operationName + ": " + std::string(e.what()));
         return false;
     }
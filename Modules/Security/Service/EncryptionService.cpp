@@ -31,7 +31,7 @@ EncryptionService::EncryptionService() {
     // In a real application, the key would be loaded securely, not hardcoded.
     // The fixed key string should be exactly 32 bytes for AES-256, so I will adjust for that.
     if (FIXED_AES_KEY_STRING.length() != AES_KEY_SIZE) {
-        ERP::Logger::Logger::getInstance().critical("EncryptionService", "Fixed AES key string length is incorrect. Expected " + std::to_string(AES_KEY_SIZE) + " bytes.");
+        ERP::Logger::Logger::getInstance().critical("Fixed AES key string length is incorrect. Expected " + std::to_string(AES_KEY_SIZE) + " bytes.", "EncryptionService");
         throw std::runtime_error("EncryptionService: Invalid AES key length.");
     }
     key_ = CryptoPP::SecByteBlock(reinterpret_cast<const CryptoPP::byte*>(FIXED_AES_KEY_STRING.data()), AES_KEY_SIZE);
@@ -68,6 +68,12 @@ public:
         const std::optional<std::string>& changeReason = std::nullopt, const std::map<std::string, std::any>& metadata = {}, // Changed from QJsonObject to std::map
         const std::optional<std::string>& comments = std::nullopt, const std::optional<std::string>& approvalId = std::nullopt,
         bool isCompliant = true, const std::optional<std::string>& complianceNote = std::nullopt) = 0;
+
+    /**
+     * @brief Writes every audit log entry still pending in memory. Call before shutting down the connection pool.
+     * @return true if nothing is left pending, false otherwise.
+     */
+    virtual bool flush() = 0;
 };
 
 } // namespace Services
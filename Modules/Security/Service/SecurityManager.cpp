@@ -142,7 +142,7 @@ SecurityManager::SecurityManager(
 {
     // Basic null checks for the most critical services
     if (!authenticationService_ || !authorizationService_ || !auditLogService_) {
-        ERP::Logger::Logger::getInstance().critical("SecurityManager", "One or more core security services are null.");
+        ERP::Logger::Logger::getInstance().critical("One or more core security services are null.", "SecurityManager");
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::ServerError, "SecurityManager: Null core security services.", "Lỗi hệ thống: Dịch vụ bảo mật không khả dụng.");
         throw std::runtime_error("SecurityManager: Null core security services.");
     }
@@ -170,7 +170,7 @@ bool SecurityManager::hasPermission(
     const std::vector<std::string>& userRoleIds,
     const std::string& permissionName) const {
     if (!authorizationService_) {
-        ERP::Logger::Logger::getInstance().critical("SecurityManager", "AuthorizationService is null. Cannot perform permission check.");
+        ERP::Logger::Logger::getInstance().critical("AuthorizationService is null. Cannot perform permission check.", "SecurityManager");
         return false;
     }
     // Record audit log for permission check (optional, can be very verbose)
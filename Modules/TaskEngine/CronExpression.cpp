@@ -0,0 +1,181 @@
+// Modules/TaskEngine/CronExpression.cpp
+#include "CronExpression.h" // Đã rút gọn include
+#include <algorithm> // For std::transform
+#include <cctype>    // For std::toupper, std::isdigit
+#include <ctime>     // For std::tm, std::mktime
+#include <sstream>   // For splitting fields
+#include <vector>
+
+namespace ERP {
+namespace TaskEngine {
+
+namespace {
+const char* const MONTH_NAMES[] = { "JAN", "FEB", "MAR", "APR", "MAY", "JUN", "JUL", "AUG", "SEP", "OCT", "NOV", "DEC", nullptr };
+const char* const WEEKDAY_NAMES[] = { "SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT", nullptr };
+
+// Parses a number or a name (names map to minValue + index)
+bool parseValue(const std::string& text, int minValue, const char* const* names, int& value) {
+    if (text.empty()) {
+        return false;
+    }
+    if (std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        if (text.size() > 4) {
+            return false;
+        }
+        value = std::stoi(text);
+        return true;
+    }
+    if (names) {
+        for (int index = 0; names[index]; ++index) {
+            if (text == names[index]) {
+                value = minValue + index;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+std::tm toLocalTime(std::time_t time) {
+    std::tm localTime{};
+#ifdef _WIN32
+    localtime_s(&localTime, &time);
+#else
+    localtime_r(&time, &localTime);
+#endif
+    return localTime;
+}
+
+// Normalizes the fields after a change (e.g. minute 60, day 32, or a time in a DST gap)
+std::time_t normalize(std::tm& localTime) {
+    localTime.tm_isdst = -1;
+    const std::time_t time = std::mktime(&localTime);
+    localTime = toLocalTime(time);
+    return time;
+}
+} // namespace
+
+std::optional<CronExpression> CronExpression::parse(const std::string& expression) {
+    std::string text = expression;
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    const std::size_t first = text.find_first_not_of(" \t");
+    const std::size_t last = text.find_last_not_of(" \t");
+    text = first == std::string::npos ? std::string() : text.substr(first, last - first + 1);
+
+    if (text == "@YEARLY" || text == "@ANNUALLY") text = "0 0 1 1 *";
+    else if (text == "@MONTHLY") text = "0 0 1 * *";
+    else if (text == "@WEEKLY") text = "0 0 * * 0";
+    else if (text == "@DAILY" || text == "@MIDNIGHT") text = "0 0 * * *";
+    else if (text == "@HOURLY") text = "0 * * * *";
+
+    std::istringstream stream(text);
+    std::vector<std::string> fields;
+    std::string field;
+    while (stream >> field) {
+        fields.push_back(field);
+    }
+    if (fields.size() != 5) {
+        return std::nullopt;
+    }
+
+    CronExpression cron;
+    cron.expression_ = expression;
+    if (!parseField(fields[0], 0, 59, nullptr, cron.minutes_) ||
+        !parseField(fields[1], 0, 23, nullptr, cron.hours_) ||
+        !parseField(fields[2], 1, 31, nullptr, cron.daysOfMonth_) ||
+        !parseField(fields[3], 1, 12, MONTH_NAMES, cron.months_) ||
+        !parseField(fields[4], 0, 7, WEEKDAY_NAMES, cron.daysOfWeek_)) {
+        return std::nullopt;
+    }
+    if (cron.daysOfWeek_.test(7)) {
+        cron.daysOfWeek_.set(0); // 7 is Sunday too
+    }
+    cron.dayOfMonthRestricted_ = fields[2] != "*" && fields[2] != "?";
+    cron.dayOfWeekRestricted_ = fields[4] != "*" && fields[4] != "?";
+    return cron;
+}
+
+bool CronExpression::parseField(const std::string& field, int minValue, int maxValue, const char* const* names, std::bitset<61>& allowed) {
+    std::istringstream stream(field);
+    std::string part;
+    while (std::getline(stream, part, ',')) {
+        int step = 1;
+        const std::size_t slash = part.find('/');
+        if (slash != std::string::npos) {
+            if (!parseValue(part.substr(slash + 1), 0, nullptr, step) || step <= 0) {
+                return false;
+            }
+            part = part.substr(0, slash);
+        }
+
+        int from = minValue;
+        int to = maxValue;
+        if (part != "*" && part != "?") {
+            const std::size_t dash = part.find('-');
+            if (dash == std::string::npos) {
+                if (!parseValue(part, minValue, names, from)) {
+                    return false;
+                }
+                to = slash != std::string::npos ? maxValue : from; // "a/n" runs from a to the maximum
+            } else if (!parseValue(part.substr(0, dash), minValue, names, from) ||
+                       !parseValue(part.substr(dash + 1), minValue, names, to)) {
+                return false;
+            }
+        }
+        if (from < minValue || to > maxValue || from > to) {
+            return false;
+        }
+        for (int value = from; value <= to; value += step) {
+            allowed.set(static_cast<std::size_t>(value));
+        }
+    }
+    return allowed.any();
+}
+
+bool CronExpression::dayMatches(int dayOfMonth, int dayOfWeek) const {
+    const bool dayOfMonthMatches = daysOfMonth_.test(static_cast<std::size_t>(dayOfMonth));
+    const bool dayOfWeekMatches = daysOfWeek_.test(static_cast<std::size_t>(dayOfWeek));
+    if (dayOfMonthRestricted_ && dayOfWeekRestricted_) {
+        return dayOfMonthMatches || dayOfWeekMatches;
+    }
+    return dayOfMonthMatches && dayOfWeekMatches;
+}
+
+std::optional<CronExpression::TimePoint> CronExpression::next(TimePoint after) const {
+    std::tm localTime = toLocalTime(std::chrono::system_clock::to_time_t(after));
+    localTime.tm_sec = 0;
+    localTime.tm_min += 1; // Strictly after, on a whole minute
+    std::time_t candidate = normalize(localTime);
+    const int lastYear = localTime.tm_year + 5;
+
+    // Skip whole months, days and hours that cannot match instead of testing every minute
+    while (localTime.tm_year <= lastYear) {
+        if (!months_.test(static_cast<std::size_t>(localTime.tm_mon + 1))) {
+            localTime.tm_mon += 1;
+            localTime.tm_mday = 1;
+            localTime.tm_hour = 0;
+            localTime.tm_min = 0;
+        } else if (!dayMatches(localTime.tm_mday, localTime.tm_wday)) {
+            localTime.tm_mday += 1;
+            localTime.tm_hour = 0;
+            localTime.tm_min = 0;
+        } else if (!hours_.test(static_cast<std::size_t>(localTime.tm_hour))) {
+            localTime.tm_hour += 1;
+            localTime.tm_min = 0;
+        } else if (!minutes_.test(static_cast<std::size_t>(localTime.tm_min))) {
+            localTime.tm_min += 1;
+        } else {
+            return std::chrono::system_clock::from_time_t(candidate);
+        }
+        const std::time_t previous = candidate;
+        candidate = normalize(localTime);
+        if (candidate <= previous) { // An ambiguous local time (DST end) resolved backwards
+            candidate = previous + 60;
+            localTime = toLocalTime(candidate);
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace TaskEngine
+} // namespace ERP
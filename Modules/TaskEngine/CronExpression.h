@@ -0,0 +1,60 @@
+// Modules/TaskEngine/CronExpression.h
+#ifndef MODULES_TASKENGINE_CRONEXPRESSION_H
+#define MODULES_TASKENGINE_CRONEXPRESSION_H
+#include <bitset>       // For std::bitset (allowed field values)
+#include <chrono>       // For std::chrono::system_clock
+#include <optional>     // For std::optional
+#include <string>       // For std::string
+
+namespace ERP {
+namespace TaskEngine {
+
+/**
+ * @brief A standard five-field cron expression: minute hour day-of-month month day-of-week.
+ *
+ * Fields accept '*', numbers, ranges "a-b", lists "a,b", steps ("a-b/n", "a/n", or "/n" after '*')
+ * and month and weekday names (JAN..DEC, SUN..SAT; 0 and 7 are Sunday). The macros @yearly, @annually,
+ * @monthly, @weekly, @daily, @midnight and @hourly are supported. As in cron, when both day
+ * fields are restricted a day matches if either does. Times are evaluated in local time.
+ */
+class CronExpression {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    /**
+     * @brief Parses an expression.
+     * @return The expression, or std::nullopt if it is invalid.
+     */
+    static std::optional<CronExpression> parse(const std::string& expression);
+
+    /**
+     * @brief Gets the first matching minute strictly after a time.
+     * @return The time, or std::nullopt if nothing matches within five years (e.g. "0 0 30 2 *").
+     */
+    std::optional<TimePoint> next(TimePoint after) const;
+
+    /**
+     * @brief Gets the expression as parsed.
+     */
+    const std::string& toString() const { return expression_; }
+
+private:
+    CronExpression() = default;
+
+    static bool parseField(const std::string& field, int minValue, int maxValue, const char* const* names, std::bitset<61>& allowed);
+
+    bool dayMatches(int dayOfMonth, int dayOfWeek) const;
+
+    std::string expression_;
+    std::bitset<61> minutes_;
+    std::bitset<61> hours_;
+    std::bitset<61> daysOfMonth_;
+    std::bitset<61> months_;
+    std::bitset<61> daysOfWeek_;
+    bool dayOfMonthRestricted_ = false;
+    bool dayOfWeekRestricted_ = false;
+};
+
+} // namespace TaskEngine
+} // namespace ERP
+#endif // MODULES_TASKENGINE_CRONEXPRESSION_H
@@ -0,0 +1,285 @@
+// Modules/TaskEngine/DAO/JobQueueDAO.cpp
+#include "Modules/TaskEngine/DAO/JobQueueDAO.h"
+#include "Logger.h"
+#include "ErrorHandler.h"
+#include "Common.h"
+#include "DateUtils.h"
+#include "DAOHelpers.h"
+#include "Modules/Utils/Utils.h" // For lease tokens
+#include <stdexcept>
+#include <typeinfo> // For std::bad_any_cast
+
+namespace ERP {
+namespace TaskEngine {
+namespace DAOs {
+
+using ERP::TaskEngine::DTO::JobDTO;
+using ERP::TaskEngine::DTO::JobState;
+
+namespace {
+std::string formatTime(std::chrono::system_clock::time_point time) {
+    return ERP::Utils::DateUtils::formatDateTime(time, ERP::Common::DATETIME_FORMAT);
+}
+
+// Clears the lease and either returns the job to the queue or fails it once it used up its attempts
+const char* const RETURN_LEASED_SET =
+    " SET job_state = CASE WHEN attempts >= max_attempts THEN 3 ELSE 0 END,"
+    " completed_at = CASE WHEN attempts >= max_attempts THEN :now ELSE NULL END,"
+    " message = CASE WHEN attempts >= max_attempts THEN 'Failed' ELSE 'Pending' END,"
+    " available_at = :now, last_error = :reason, lease_owner = NULL, lease_token = NULL, lease_expires_at = NULL, updated_at = :now";
+} // namespace
+
+JobQueueDAO::JobQueueDAO(std::shared_ptr<ERP::Database::ConnectionPool> connectionPool)
+    : DAOBase<JobDTO>(connectionPool, "task_logs") { // Jobs are task_logs rows with job_state set
+    Logger::Logger::getInstance().info("JobQueueDAO: Initialized.");
+}
+
+std::map<std::string, std::any> JobQueueDAO::toMap(const JobDTO& dto) const {
+    // Explicit columns: task_logs has no status/updated_by columns, so the BaseDTO helpers do not apply.
+    std::map<std::string, std::any> data;
+    data["id"] = dto.id;
+    data["task_id"] = dto.jobType;
+    data["log_time"] = formatTime(dto.createdAt);
+    data["log_level"] = static_cast<int>(ERP::Common::LogSeverity::INFO);
+    data["message"] = dto.getStateString();
+    data["created_at"] = formatTime(dto.createdAt);
+    ERP::DAOHelpers::putOptionalString(data, "created_by", dto.createdBy);
+    ERP::DAOHelpers::putOptionalTime(data, "updated_at", dto.updatedAt);
+
+    data["job_state"] = static_cast<int>(dto.state);
+    data["priority"] = dto.priority;
+    ERP::DAOHelpers::putOptionalString(data, "idempotency_key", dto.idempotencyKey);
+    data["payload"] = dto.payload;
+    data["attempts"] = dto.attempts;
+    data["max_attempts"] = dto.maxAttempts;
+    data["available_at"] = formatTime(dto.availableAt);
+    ERP::DAOHelpers::putOptionalString(data, "lease_owner", dto.leaseOwner);
+    ERP::DAOHelpers::putOptionalString(data, "lease_token", dto.leaseToken);
+    ERP::DAOHelpers::putOptionalTime(data, "lease_expires_at", dto.leaseExpiresAt);
+    ERP::DAOHelpers::putOptionalString(data, "last_error", dto.lastError);
+    ERP::DAOHelpers::putOptionalTime(data, "completed_at", dto.completedAt);
+    return data;
+}
+
+JobDTO JobQueueDAO::fromMap(const std::map<std::string, std::any>& data) const {
+    JobDTO dto;
+    try {
+        ERP::DAOHelpers::getPlainValue(data, "id", dto.id);
+        ERP::DAOHelpers::getPlainValue(data, "task_id", dto.jobType);
+        ERP::DAOHelpers::getPlainTimeValue(data, "created_at", dto.createdAt);
+        ERP::DAOHelpers::getOptionalStringValue(data, "created_by", dto.createdBy);
+        ERP::DAOHelpers::getOptionalTimeValue(data, "updated_at", dto.updatedAt);
+
+        int stateInt = static_cast<int>(JobState::PENDING);
+        ERP::DAOHelpers::getPlainValue(data, "job_state", stateInt);
+        dto.state = static_cast<JobState>(stateInt);
+        ERP::DAOHelpers::getPlainValue(data, "priority", dto.priority);
+        ERP::DAOHelpers::getOptionalStringValue(data, "idempotency_key", dto.idempotencyKey);
+        ERP::DAOHelpers::getPlainValue(data, "payload", dto.payload);
+        ERP::DAOHelpers::getPlainValue(data, "attempts", dto.attempts);
+        ERP::DAOHelpers::getPlainValue(data, "max_attempts", dto.maxAttempts);
+        ERP::DAOHelpers::getPlainTimeValue(data, "available_at", dto.availableAt);
+        ERP::DAOHelpers::getOptionalStringValue(data, "lease_owner", dto.leaseOwner);
+        ERP::DAOHelpers::getOptionalStringValue(data, "lease_token", dto.leaseToken);
+        ERP::DAOHelpers::getOptionalTimeValue(data, "lease_expires_at", dto.leaseExpiresAt);
+        ERP::DAOHelpers::getOptionalStringValue(data, "last_error", dto.lastError);
+        ERP::DAOHelpers::getOptionalTimeValue(data, "completed_at", dto.completedAt);
+    } catch (const std::bad_any_cast& e) {
+        Logger::Logger::getInstance().error("JobQueueDAO: fromMap - Data type mismatch: " + std::string(e.what()));
+        ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::InvalidInput, "JobQueueDAO: Data type mismatch in fromMap.");
+    }
+    return dto;
+}
+
+std::size_t JobQueueDAO::executeAndCount(const std::string& operationName, const std::string& sql, const std::map<std::string, std::any>& params) {
+    long long changed = 0;
+    bool success = executeDbOperation(
+        [&changed](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
+            if (!conn->execute(sql_l, p_l)) {
+                return false;
+            }
+            ERP::Database::ResultSet changes = conn->queryResultSet("SELECT changes();");
+            changed = changes.empty() ? 0 : changes.getInt64(0, 0).value_or(0);
+            return true;
+        },
+        "JobQueueDAO", operationName, sql, params);
+    return success ? static_cast<std::size_t>(changed) : 0;
+}
+
+std::optional<std::string> JobQueueDAO::enqueue(const JobDTO& job) {
+    std::map<std::string, std::any> data = toMap(job);
+    std::string columns;
+    std::string placeholders;
+    std::map<std::string, std::any> params;
+    for (const auto& [column, value] : data) {
+        columns += (columns.empty() ? "" : ", ") + column;
+        placeholders += (placeholders.empty() ? ":" : ", :") + column;
+        params[column] = value;
+    }
+    // The partial unique index on idempotency_key turns a repeated enqueue into a no-op. Only that
+    // conflict is ignored: NOT NULL, CHECK and other constraint failures still fail the insert.
+    std::string sql = "INSERT INTO " + tableName_ + " (" + columns + ") VALUES (" + placeholders + ")"
+                      " ON CONFLICT(idempotency_key) WHERE idempotency_key IS NOT NULL DO NOTHING;";
+    long long inserted = -1;
+    bool success = executeDbOperation(
+        [&inserted](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
+            if (!conn->execute(sql_l, p_l)) {
+                return false;
+            }
+            ERP::Database::ResultSet changes = conn->queryResultSet("SELECT changes();");
+            inserted = changes.empty() ? 0 : changes.getInt64(0, 0).value_or(0);
+            return true;
+        },
+        "JobQueueDAO", "enqueue", sql, params);
+    if (!success) {
+        return std::nullopt;
+    }
+    if (inserted > 0) {
+        return job.id;
+    }
+    if (!job.idempotencyKey) {
+        ERP::Logger::Logger::getInstance().error("Job " + job.id + " was not inserted.", "JobQueueDAO");
+        return std::nullopt;
+    }
+
+    std::map<std::string, std::any> keyParams;
+    keyParams["idempotency_key"] = *job.idempotencyKey;
+    ERP::Database::ResultSet existing = queryResultSetDbOperation("JobQueueDAO", "enqueue",
+        "SELECT id FROM " + tableName_ + " WHERE idempotency_key = :idempotency_key;", keyParams);
+    if (existing.empty()) {
+        return std::nullopt;
+    }
+    ERP::Logger::Logger::getInstance().debug("Job with idempotency key " + *job.idempotencyKey + " already queued.", "JobQueueDAO");
+    return existing.getString(0, 0);
+}
+
+std::vector<JobDTO> JobQueueDAO::lease(const std::vector<std::string>& jobTypes, const std::string& owner,
+                                       std::size_t limit, std::chrono::milliseconds leaseDuration, TimePoint now) {
+    std::vector<JobDTO> leased;
+    if (jobTypes.empty() || limit == 0) {
+        return leased;
+    }
+    ERP::DAOBase::CompiledFilter compiled = ERP::DAOBase::QueryFilter().in("task_id", jobTypes).compile();
+    if (!compiled.valid) {
+        return leased;
+    }
+    const std::string token = ERP::Utils::generateUUID();
+    std::map<std::string, std::any> params = compiled.params;
+    params["now"] = formatTime(now);
+    params["owner"] = owner;
+    params["token"] = token;
+    params["expires_at"] = formatTime(now + leaseDuration);
+    params["limit"] = static_cast<long long>(limit);
+
+    // One statement claims the whole batch, so two workers can never lease the same row.
+    std::string sql = "UPDATE " + tableName_ +
+                      " SET job_state = 1, lease_owner = :owner, lease_token = :token, lease_expires_at = :expires_at,"
+                      " attempts = attempts + 1, message = 'Leased', updated_at = :now"
+                      " WHERE id IN (SELECT id FROM " + tableName_ + compiled.whereClause() +
+                      " AND job_state = 0 AND available_at <= :now ORDER BY priority DESC, available_at ASC, id ASC LIMIT :limit);";
+    if (executeAndCount("lease", sql, params) == 0) {
+        return leased;
+    }
+
+    std::map<std::string, std::any> tokenParams;
+    tokenParams["token"] = token;
+    ERP::Database::ResultSet resultSet = queryResultSetDbOperation("JobQueueDAO", "lease",
+        "SELECT * FROM " + tableName_ + " WHERE lease_token = :token ORDER BY priority DESC, available_at ASC, id ASC;", tokenParams);
+    leased.reserve(resultSet.rowCount());
+    for (std::size_t row = 0; row < resultSet.rowCount(); ++row) {
+        leased.push_back(fromMap(resultSet.rowToMap(row)));
+    }
+    ERP_LOG_DEBUG("Leased " + std::to_string(leased.size()) + " jobs to " + owner + ".", "JobQueueDAO");
+    return leased;
+}
+
+bool JobQueueDAO::complete(const std::string& jobId, const std::string& leaseToken, TimePoint now) {
+    std::map<std::string, std::any> params;
+    params["id"] = jobId;
+    params["token"] = leaseToken;
+    params["now"] = formatTime(now);
+    std::string sql = "UPDATE " + tableName_ +
+                      " SET job_state = 2, message = 'Done', completed_at = :now, last_error = NULL,"
+                      " lease_owner = NULL, lease_token = NULL, lease_expires_at = NULL, updated_at = :now"
+                      " WHERE id = :id AND lease_token = :token AND job_state = 1;";
+    if (executeAndCount("complete", sql, params) == 0) {
+        ERP::Logger::Logger::getInstance().warning("Job " + jobId + " is no longer held by this lease; result discarded.", "JobQueueDAO");
+        return false;
+    }
+    return true;
+}
+
+bool JobQueueDAO::fail(const std::string& jobId, const std::string& leaseToken, const std::string& error,
+                       std::optional<TimePoint> retryAt, TimePoint now) {
+    std::map<std::string, std::any> params;
+    params["id"] = jobId;
+    params["token"] = leaseToken;
+    params["now"] = formatTime(now);
+    params["error"] = error;
+    std::string sql;
+    if (retryAt) {
+        params["retry_at"] = formatTime(*retryAt);
+        sql = "UPDATE " + tableName_ +
+              " SET job_state = 0, message = 'Pending', available_at = :retry_at, last_error = :error,"
+              " lease_owner = NULL, lease_token = NULL, lease_expires_at = NULL, updated_at = :now"
+              " WHERE id = :id AND lease_token = :token AND job_state = 1;";
+    } else {
+        sql = "UPDATE " + tableName_ +
+              " SET job_state = 3, message = 'Failed', completed_at = :now, last_error = :error,"
+              " lease_owner = NULL, lease_token = NULL, lease_expires_at = NULL, updated_at = :now"
+              " WHERE id = :id AND lease_token = :token AND job_state = 1;";
+    }
+    if (executeAndCount("fail", sql, params) == 0) {
+        ERP::Logger::Logger::getInstance().warning("Job " + jobId + " is no longer held by this lease; failure discarded.", "JobQueueDAO");
+        return false;
+    }
+    return true;
+}
+
+std::size_t JobQueueDAO::extendLeases(const std::vector<std::string>& leaseTokens, TimePoint expiresAt, TimePoint now) {
+    if (leaseTokens.empty()) {
+        return 0;
+    }
+    ERP::DAOBase::CompiledFilter compiled = ERP::DAOBase::QueryFilter().in("lease_token", leaseTokens).compile();
+    if (!compiled.valid) {
+        return 0;
+    }
+    std::map<std::string, std::any> params = compiled.params;
+    params["expires_at"] = formatTime(expiresAt);
+    params["now"] = formatTime(now);
+    std::string sql = "UPDATE " + tableName_ + " SET lease_expires_at = :expires_at, updated_at = :now" +
+                      compiled.whereClause() + " AND job_state = 1;";
+    return executeAndCount("extendLeases", sql, params);
+}
+
+std::size_t JobQueueDAO::recoverLeases(const std::string& owner, TimePoint now) {
+    std::map<std::string, std::any> params;
+    params["owner"] = owner;
+    params["now"] = formatTime(now);
+    params["reason"] = std::string("Worker restarted while the job was leased.");
+    std::string sql = "UPDATE " + tableName_ + RETURN_LEASED_SET + " WHERE job_state = 1 AND lease_owner = :owner;";
+    return executeAndCount("recoverLeases", sql, params);
+}
+
+std::size_t JobQueueDAO::releaseExpiredLeases(TimePoint now) {
+    std::map<std::string, std::any> params;
+    params["now"] = formatTime(now);
+    params["reason"] = std::string("Lease expired.");
+    std::string sql = "UPDATE " + tableName_ + RETURN_LEASED_SET + " WHERE job_state = 1 AND lease_expires_at < :now;";
+    return executeAndCount("releaseExpiredLeases", sql, params);
+}
+
+std::map<JobState, std::size_t> JobQueueDAO::countByState() {
+    std::map<JobState, std::size_t> counts;
+    ERP::Database::ResultSet resultSet = queryResultSetDbOperation("JobQueueDAO", "countByState",
+        "SELECT job_state, COUNT(*) FROM " + tableName_ + " WHERE job_state IS NOT NULL GROUP BY job_state;", {});
+    for (std::size_t row = 0; row < resultSet.rowCount(); ++row) {
+        counts[static_cast<JobState>(resultSet.getInt64(row, 0).value_or(0))] =
+            static_cast<std::size_t>(resultSet.getInt64(row, 1).value_or(0));
+    }
+    return counts;
+}
+
+} // namespace DAOs
+} // namespace TaskEngine
+} // namespace ERP
@@ -0,0 +1,99 @@
+// Modules/TaskEngine/DAO/JobQueueDAO.h
+#ifndef MODULES_TASKENGINE_DAO_JOBQUEUEDAO_H
+#define MODULES_TASKENGINE_DAO_JOBQUEUEDAO_H
+#include "DAOBase/DAOBase.h" // Include templated DAOBase
+#include "Modules/TaskEngine/DTO/Job.h" // For DTOs
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <any>
+#include <optional>
+#include <chrono>
+
+namespace ERP {
+namespace TaskEngine {
+namespace DAOs {
+
+/**
+ * @brief The JobQueueDAO class stores durable jobs as rows of task_logs.
+ *
+ * A worker leases a batch of ready jobs in one transaction: the rows are stamped with a fresh
+ * lease token and an expiry, then read back by that token. Every later transition (complete,
+ * fail, extend) names the token, so a worker whose lease expired and was handed to another
+ * worker cannot overwrite the new owner's result.
+ */
+class JobQueueDAO : public ERP::DAOBase::DAOBase<ERP::TaskEngine::DTO::JobDTO> {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    explicit JobQueueDAO(std::shared_ptr<ERP::Database::ConnectionPool> connectionPool);
+    ~JobQueueDAO() override = default;
+
+    /**
+     * @brief Inserts a pending job. A job whose idempotency key is already stored is not inserted again.
+     * @return The id of the new job, or of the existing job with the same idempotency key; std::nullopt on error.
+     */
+    std::optional<std::string> enqueue(const ERP::TaskEngine::DTO::JobDTO& job);
+
+    /**
+     * @brief Leases up to limit ready jobs of the given types, highest priority and oldest first.
+     * @param jobTypes The job types the worker handles.
+     * @param owner The id of the leasing worker.
+     * @param limit The largest number of jobs to lease.
+     * @param leaseDuration How long the jobs stay leased unless extended.
+     * @param now The current time.
+     * @return The leased jobs, with attempts already incremented.
+     */
+    std::vector<ERP::TaskEngine::DTO::JobDTO> lease(const std::vector<std::string>& jobTypes, const std::string& owner,
+                                                    std::size_t limit, std::chrono::milliseconds leaseDuration, TimePoint now);
+
+    /**
+     * @brief Marks a leased job as done.
+     * @return True if the job was still held by the lease token, false otherwise.
+     */
+    bool complete(const std::string& jobId, const std::string& leaseToken, TimePoint now);
+
+    /**
+     * @brief Records a failed attempt of a leased job.
+     * @param retryAt When to make the job available again; std::nullopt marks it failed for good.
+     * @return True if the job was still held by the lease token, false otherwise.
+     */
+    bool fail(const std::string& jobId, const std::string& leaseToken, const std::string& error,
+              std::optional<TimePoint> retryAt, TimePoint now);
+
+    /**
+     * @brief Moves the expiry of every job held by the given lease tokens.
+     * @return The number of jobs extended.
+     */
+    std::size_t extendLeases(const std::vector<std::string>& leaseTokens, TimePoint expiresAt, TimePoint now);
+
+    /**
+     * @brief Returns the jobs leased by a worker to the queue, e.g. at startup after a crash of that worker.
+     * @return The number of jobs returned.
+     */
+    std::size_t recoverLeases(const std::string& owner, TimePoint now);
+
+    /**
+     * @brief Returns jobs whose lease expired to the queue, or fails them if they used up their attempts.
+     * @return The number of jobs returned or failed.
+     */
+    std::size_t releaseExpiredLeases(TimePoint now);
+
+    /**
+     * @brief Counts jobs per state.
+     */
+    std::map<ERP::TaskEngine::DTO::JobState, std::size_t> countByState();
+
+protected:
+    std::map<std::string, std::any> toMap(const ERP::TaskEngine::DTO::JobDTO& dto) const override;
+    ERP::TaskEngine::DTO::JobDTO fromMap(const std::map<std::string, std::any>& data) const override;
+
+private:
+    std::size_t executeAndCount(const std::string& operationName, const std::string& sql, const std::map<std::string, std::any>& params);
+};
+
+} // namespace DAOs
+} // namespace TaskEngine
+} // namespace ERP
+#endif // MODULES_TASKENGINE_DAO_JOBQUEUEDAO_H
@@ -0,0 +1,58 @@
+// Modules/TaskEngine/DTO/Job.h
+#ifndef MODULES_TASKENGINE_DTO_JOB_H
+#define MODULES_TASKENGINE_DTO_JOB_H
+#include <string>
+#include <optional>
+#include <chrono>
+#include "DataObjects/BaseDTO.h"   // Updated include path
+#include "Modules/Common/Common.h"    // For EntityStatus (Updated include path)
+namespace ERP {
+    namespace TaskEngine {
+        namespace DTO {
+            /**
+             * @brief Enum định nghĩa trạng thái của một công việc trong hàng đợi bền vững.
+             */
+            enum class JobState {
+                PENDING = 0,    /**< Đang chờ được nhận */
+                LEASED = 1,     /**< Đã được một worker nhận, đang xử lý */
+                DONE = 2,       /**< Đã hoàn thành */
+                FAILED = 3      /**< Thất bại sau khi hết số lần thử */
+            };
+            /**
+             * @brief DTO for a durable job.
+             * Jobs are stored as rows of task_logs with job_state set; task_id holds the job type.
+             */
+            struct JobDTO : public BaseDTO {
+                std::string jobType;                /**< Loại công việc (khóa của handler) */
+                JobState state;                     /**< Trạng thái công việc */
+                int priority;                       /**< Độ ưu tiên (0 = thấp, 1 = bình thường, 2 = cao) */
+                std::optional<std::string> idempotencyKey; /**< Khóa chống trùng lặp khi đưa vào hàng đợi */
+                std::string payload;                /**< Dữ liệu của công việc (thường là JSON) */
+                int attempts;                       /**< Số lần đã nhận xử lý */
+                int maxAttempts;                    /**< Số lần thử tối đa */
+                std::chrono::system_clock::time_point availableAt; /**< Thời điểm sớm nhất được nhận */
+                std::optional<std::string> leaseOwner;   /**< Worker đang giữ công việc */
+                std::optional<std::string> leaseToken;   /**< Mã của lần nhận hiện tại */
+                std::optional<std::chrono::system_clock::time_point> leaseExpiresAt; /**< Hết hạn giữ công việc */
+                std::optional<std::string> lastError;    /**< Lỗi của lần thử gần nhất */
+                std::optional<std::chrono::system_clock::time_point> completedAt;    /**< Thời điểm hoàn thành hoặc thất bại */
+
+                JobDTO() : BaseDTO(), jobType(""), state(JobState::PENDING), priority(1),
+                           attempts(0), maxAttempts(5), availableAt(std::chrono::system_clock::now()) {}
+                virtual ~JobDTO() = default;
+
+                // Utility methods
+                std::string getStateString() const {
+                    switch (state) {
+                        case JobState::PENDING: return "Pending";
+                        case JobState::LEASED: return "Leased";
+                        case JobState::DONE: return "Done";
+                        case JobState::FAILED: return "Failed";
+                        default: return "Unknown";
+                    }
+                }
+            };
+        } // namespace DTO
+    } // namespace TaskEngine
+} // namespace ERP
+#endif // MODULES_TASKENGINE_DTO_JOB_H
@@ -0,0 +1,246 @@
+// Modules/TaskEngine/JobQueue.cpp
+#include "JobQueue.h"     // Đã rút gọn include
+#include "Logger.h"       // Đã rút gọn include
+#include "ErrorHandler.h" // Đã rút gọn include
+#include "Common.h"       // Đã rút gọn include
+#include "Modules/Utils/Utils.h" // For job ids
+#include <algorithm>      // For std::min, std::clamp
+#include <random>         // For retry jitter
+#include <stdexcept>      // For std::runtime_error
+#include <vector>
+
+namespace ERP {
+namespace TaskEngine {
+
+using ERP::TaskEngine::DTO::JobDTO;
+
+JobQueue::JobQueue(std::shared_ptr<DAOs::JobQueueDAO> jobQueueDAO, JobQueueConfig config)
+    : state_(std::make_shared<State>()) {
+    if (!jobQueueDAO) {
+        ERP::Logger::Logger::getInstance().critical("Initialized with null JobQueueDAO.", "JobQueue");
+        throw std::runtime_error("JobQueue: JobQueueDAO is null.");
+    }
+    config.batchSize = std::max<std::size_t>(1, config.batchSize);
+    config.maxInFlight = std::max(config.maxInFlight, config.batchSize);
+    config.maxAttempts = std::max(1, config.maxAttempts);
+    config.leaseDuration = std::max(config.leaseDuration, std::chrono::milliseconds(1000));
+    state_->jobQueueDAO = std::move(jobQueueDAO);
+    state_->config = std::move(config);
+}
+
+JobQueue::~JobQueue() {
+    stop();
+}
+
+void JobQueue::registerHandler(const std::string& jobType, JobHandler handler) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->handlers[jobType] = std::move(handler);
+}
+
+std::optional<std::string> JobQueue::enqueue(const std::string& jobType, const std::string& payload, const JobOptions& options) {
+    JobDTO job;
+    job.id = ERP::Utils::generateUUID();
+    job.jobType = jobType;
+    job.payload = payload;
+    job.priority = static_cast<int>(options.priority);
+    job.idempotencyKey = options.idempotencyKey;
+    job.maxAttempts = std::max(1, options.maxAttempts.value_or(state_->config.maxAttempts));
+    job.availableAt = options.runAt.value_or(job.createdAt);
+    job.createdBy = options.createdBy;
+
+    std::optional<std::string> jobId = state_->jobQueueDAO->enqueue(job);
+    if (!jobId) {
+        ERP::Logger::Logger::getInstance().error("Failed to enqueue job of type " + jobType + ".", "JobQueue");
+        ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::DatabaseError, "JobQueue: Failed to enqueue job of type " + jobType + ".");
+        return std::nullopt;
+    }
+    if (*jobId == job.id && !options.runAt) {
+        // Ready now: poll early instead of waiting for the next interval
+        {
+            std::lock_guard<std::mutex> lock(pollerMutex_);
+            wakeRequested_ = true;
+        }
+        wake_.notify_one();
+    }
+    return jobId;
+}
+
+void JobQueue::start() {
+    std::lock_guard<std::mutex> lock(pollerMutex_);
+    if (poller_.joinable()) {
+        return;
+    }
+    const std::size_t recovered = state_->jobQueueDAO->recoverLeases(state_->config.workerId, std::chrono::system_clock::now());
+    if (recovered > 0) {
+        ERP::Logger::Logger::getInstance().warning("Returned " + std::to_string(recovered) + " jobs leased by " +
+                                                   state_->config.workerId + " before the last shutdown to the queue.", "JobQueue");
+    }
+    stopping_ = false;
+    wakeRequested_ = true;
+    nextLeaseExtension_ = std::chrono::system_clock::now() + state_->config.leaseDuration / 2;
+    poller_ = std::thread(&JobQueue::run, this);
+    ERP::Logger::Logger::getInstance().info("Started worker " + state_->config.workerId + ".", "JobQueue");
+}
+
+void JobQueue::stop() {
+    {
+        std::lock_guard<std::mutex> lock(pollerMutex_);
+        if (!poller_.joinable()) {
+            return;
+        }
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    poller_.join();
+
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    if (!state_->idle.wait_for(lock, state_->config.shutdownTimeout, [this] { return state_->inFlight == 0; })) {
+        ERP::Logger::Logger::getInstance().warning(std::to_string(state_->inFlight) +
+                                                   " jobs still running at shutdown. They are recovered on the next start.", "JobQueue");
+    }
+    ERP::Logger::Logger::getInstance().info("Stopped worker " + state_->config.workerId + ".", "JobQueue");
+}
+
+std::size_t JobQueue::getInFlightCount() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->inFlight;
+}
+
+void JobQueue::run() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(pollerMutex_);
+            wake_.wait_for(lock, state_->config.pollInterval, [this] { return stopping_ || wakeRequested_; });
+            if (stopping_) {
+                return;
+            }
+            wakeRequested_ = false;
+        }
+        try {
+            if (pollOnce()) {
+                std::lock_guard<std::mutex> lock(pollerMutex_);
+                wakeRequested_ = true; // A full batch: more jobs may be ready
+            }
+        } catch (const std::exception& e) {
+            ERP::Logger::Logger::getInstance().error("Poll failed: " + std::string(e.what()), "JobQueue");
+        }
+    }
+}
+
+bool JobQueue::pollOnce() {
+    const auto now = std::chrono::system_clock::now();
+    const JobQueueConfig& config = state_->config;
+    DAOs::JobQueueDAO& dao = *state_->jobQueueDAO;
+
+    std::vector<std::string> jobTypes;
+    std::vector<std::string> activeTokens;
+    std::size_t capacity = 0;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        for (const auto& [jobType, handler] : state_->handlers) {
+            jobTypes.push_back(jobType);
+        }
+        for (const auto& [token, remaining] : state_->activeLeases) {
+            activeTokens.push_back(token);
+        }
+        capacity = config.maxInFlight - std::min(config.maxInFlight, state_->inFlight);
+    }
+
+    if (now >= nextLeaseExtension_) {
+        dao.extendLeases(activeTokens, now + config.leaseDuration, now); // Long imports keep their jobs
+        nextLeaseExtension_ = now + config.leaseDuration / 2;
+    }
+
+    // Released after extending, so a lease this worker still holds is never released at its own expiry
+    const std::size_t released = dao.releaseExpiredLeases(now);
+    if (released > 0) {
+        ERP::Logger::Logger::getInstance().warning("Released " + std::to_string(released) + " jobs whose lease expired.", "JobQueue");
+    }
+
+    const std::size_t limit = std::min(config.batchSize, capacity);
+    if (jobTypes.empty() || limit == 0) {
+        return false;
+    }
+    std::vector<JobDTO> jobs = dao.lease(jobTypes, config.workerId, limit, config.leaseDuration, now);
+    if (jobs.empty()) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->activeLeases[jobs.front().leaseToken.value_or("")] = jobs.size();
+        state_->inFlight += jobs.size();
+    }
+    ERP_LOG_DEBUG("Leased " + std::to_string(jobs.size()) + " jobs.", "JobQueue");
+
+    for (JobDTO& job : jobs) {
+        const TaskPriority priority = static_cast<TaskPriority>(std::clamp(job.priority, static_cast<int>(TaskPriority::LOW), static_cast<int>(TaskPriority::HIGH)));
+        const std::string taskId = "job:" + job.jobType + ":" + job.id;
+        TaskEngine::getInstance().submitTask([state = state_, job = std::move(job)]() { runJob(state, job); }, taskId, priority);
+    }
+    return jobs.size() == limit;
+}
+
+void JobQueue::runJob(const std::shared_ptr<State>& state, const JobDTO& job) {
+    JobHandler handler;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        auto it = state->handlers.find(job.jobType);
+        if (it != state->handlers.end()) {
+            handler = it->second;
+        }
+    }
+
+    bool success = false;
+    std::string error = "Handler returned false.";
+    if (!handler) {
+        error = "No handler registered for job type " + job.jobType + ".";
+    } else {
+        try {
+            success = handler(job);
+        } catch (const std::exception& e) {
+            error = e.what();
+        } catch (...) {
+            error = "Unknown exception.";
+        }
+    }
+
+    const std::string token = job.leaseToken.value_or("");
+    const auto now = std::chrono::system_clock::now();
+    if (success) {
+        state->jobQueueDAO->complete(job.id, token, now);
+    } else if (job.attempts < job.maxAttempts) {
+        const auto retryAt = now + retryDelay(state->config, job.attempts);
+        ERP::Logger::Logger::getInstance().warning("Job " + job.id + " (" + job.jobType + ") failed on attempt " +
+                                                   std::to_string(job.attempts) + ": " + error + " Retrying later.", "JobQueue");
+        state->jobQueueDAO->fail(job.id, token, error, retryAt, now);
+    } else {
+        ERP::Logger::Logger::getInstance().error("Job " + job.id + " (" + job.jobType + ") failed after " +
+                                                 std::to_string(job.attempts) + " attempts: " + error, "JobQueue");
+        ERP::ErrorHandling::ErrorHandler::logError(ERP::Common::ErrorCode::OperationFailed, "JobQueue: Job " + job.id + " failed: " + error);
+        state->jobQueueDAO->fail(job.id, token, error, std::nullopt, now);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        auto it = state->activeLeases.find(token);
+        if (it != state->activeLeases.end() && --it->second == 0) {
+            state->activeLeases.erase(it);
+        }
+        --state->inFlight;
+    }
+    state->idle.notify_all();
+}
+
+std::chrono::milliseconds JobQueue::retryDelay(const JobQueueConfig& config, int attempts) {
+    // Exponential backoff with "equal jitter": half the delay is fixed, half random, so failing jobs spread out
+    const int doublings = std::clamp(attempts - 1, 0, 30);
+    const long long base = std::max<long long>(1, config.baseBackoff.count());
+    const long long cap = std::max(base, static_cast<long long>(config.maxBackoff.count()));
+    const long long delay = base > (cap >> doublings) ? cap : base << doublings;
+    thread_local std::mt19937_64 random{ std::random_device{}() };
+    std::uniform_int_distribution<long long> jitter(0, delay / 2);
+    return std::chrono::milliseconds(delay - delay / 2 + jitter(random));
+}
+
+} // namespace TaskEngine
+} // namespace ERP
@@ -0,0 +1,128 @@
+// Modules/TaskEngine/JobQueue.h
+#ifndef MODULES_TASKENGINE_JOBQUEUE_H
+#define MODULES_TASKENGINE_JOBQUEUE_H
+#include "TaskEngine.h"   // Đã rút gọn include
+#include "Modules/TaskEngine/DAO/JobQueueDAO.h" // For job storage
+#include "Job.h"          // Đã rút gọn include
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <optional>
+#include <functional>
+
+namespace ERP {
+namespace TaskEngine {
+
+/**
+ * @brief Tuning of the durable job queue.
+ */
+struct JobQueueConfig {
+    std::string workerId = "main";                        /**< Stable name of this process; its leases are recovered on start. */
+    std::size_t batchSize = 20;                           /**< Jobs leased per round trip. */
+    std::size_t maxInFlight = 100;                        /**< Leased jobs not yet finished, across batches. */
+    std::chrono::milliseconds leaseDuration{300000};      /**< A job not finished or extended within this returns to the queue. */
+    std::chrono::milliseconds pollInterval{1000};         /**< Time between polls when the queue is idle. */
+    int maxAttempts = 5;                                  /**< Default attempts per job. */
+    std::chrono::milliseconds baseBackoff{5000};          /**< Delay before the first retry; doubles per attempt. */
+    std::chrono::milliseconds maxBackoff{3600000};        /**< Upper bound of the retry delay. */
+    std::chrono::milliseconds shutdownTimeout{30000};     /**< Longest time stop() waits for running jobs. */
+};
+
+/**
+ * @brief Options of an enqueued job.
+ */
+struct JobOptions {
+    std::optional<std::string> idempotencyKey;            /**< Enqueueing the same key again returns the existing job. */
+    TaskPriority priority = TaskPriority::NORMAL;
+    std::optional<std::chrono::system_clock::time_point> runAt; /**< Not before this time; now if unset. */
+    std::optional<int> maxAttempts;                       /**< JobQueueConfig::maxAttempts if unset. */
+    std::optional<std::string> createdBy;
+};
+
+/**
+ * @brief The JobQueue class runs durable jobs stored in task_logs on the TaskEngine.
+ *
+ * Unlike TaskEngine::submitTask, an enqueued job survives a crash or restart. A poller thread
+ * leases batches of ready jobs of the registered types and hands each job to the TaskEngine.
+ * A job whose handler returns true is done; a false result or an exception schedules a retry
+ * with exponential backoff and jitter until maxAttempts is used up, then the job fails.
+ * Leases of running jobs are extended while they run; leases of a crashed worker expire and
+ * the jobs return to the queue, and on start the leases of this workerId are returned at once.
+ * Handlers must therefore be idempotent: a job may run again after a crash.
+ */
+class JobQueue {
+public:
+    /**
+     * @brief Processes one job. Returns true on success, false (or throws) to retry.
+     */
+    using JobHandler = std::function<bool(const ERP::TaskEngine::DTO::JobDTO&)>;
+
+    explicit JobQueue(std::shared_ptr<DAOs::JobQueueDAO> jobQueueDAO, JobQueueConfig config = JobQueueConfig());
+    ~JobQueue();
+
+    JobQueue(const JobQueue&) = delete;
+    JobQueue& operator=(const JobQueue&) = delete;
+
+    /**
+     * @brief Registers the handler of a job type. Only registered types are leased by this worker.
+     */
+    void registerHandler(const std::string& jobType, JobHandler handler);
+
+    /**
+     * @brief Stores a job durably. Can be called before start() and for types this worker does not handle.
+     * @param jobType The type, matching a registered handler.
+     * @param payload The job's data, typically a JSON document.
+     * @return The id of the job (the existing one for a repeated idempotency key), or std::nullopt on error.
+     */
+    std::optional<std::string> enqueue(const std::string& jobType, const std::string& payload, const JobOptions& options = JobOptions());
+
+    /**
+     * @brief Returns this worker's previous leases to the queue and starts polling.
+     */
+    void start();
+
+    /**
+     * @brief Stops polling and waits up to shutdownTimeout for running jobs. Unfinished jobs stay
+     * leased and are recovered on the next start.
+     */
+    void stop();
+
+    /**
+     * @brief Gets the number of leased jobs not yet finished.
+     */
+    std::size_t getInFlightCount() const;
+
+private:
+    // State shared with the jobs on the TaskEngine, so a job finishing after stop() stays valid
+    struct State {
+        std::shared_ptr<DAOs::JobQueueDAO> jobQueueDAO;
+        JobQueueConfig config;
+        mutable std::mutex mutex;
+        std::condition_variable idle;                    // Signalled when inFlight drops
+        std::map<std::string, JobHandler> handlers;
+        std::map<std::string, std::size_t> activeLeases; // Lease token -> jobs of the batch still running
+        std::size_t inFlight = 0;
+    };
+
+    static void runJob(const std::shared_ptr<State>& state, const ERP::TaskEngine::DTO::JobDTO& job);
+    static std::chrono::milliseconds retryDelay(const JobQueueConfig& config, int attempts);
+
+    void run();
+    bool pollOnce(); // Returns true if a full batch was leased (more may be ready)
+
+    std::shared_ptr<State> state_;
+    std::mutex pollerMutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    bool wakeRequested_ = false;
+    std::thread poller_;
+    std::chrono::system_clock::time_point nextLeaseExtension_;
+};
+
+} // namespace TaskEngine
+} // namespace ERP
+#endif // MODULES_TASKENGINE_JOBQUEUE_H
@@ -2,11 +2,65 @@
 #include "TaskEngine.h" // Đã rút gọn include
 #include "Logger.h" // Đã rút gọn include
 #include "DateUtils.h" // Đã rút gọn include
+#include "CronExpression.h" // Đã rút gọn include
+#include "ScheduledTask.h" // Đã rút gọn include
 #include <iostream>
+#include <algorithm> // For std::max, std::min
+#include <ctime>     // For std::tm, std::mktime (calendar recurrence)
 
 namespace ERP {
 namespace TaskEngine {
 
+namespace {
+std::tm toLocalTime(std::time_t time) {
+    std::tm localTime{};
+#ifdef _WIN32
+    localtime_s(&localTime, &time);
+#else
+    localtime_r(&time, &localTime);
+#endif
+    return localTime;
+}
+
+// The anchor moved by whole days and months at the same wall-clock time; the day is clamped to the month's length
+std::chrono::system_clock::time_point addCalendar(const std::tm& anchor, long days, long months) {
+    std::tm time = anchor;
+    const long totalMonths = time.tm_mon + months;
+    time.tm_year += static_cast<int>(totalMonths / 12);
+    time.tm_mon = static_cast<int>(totalMonths % 12);
+    if (months != 0) {
+        static const int DAYS_IN_MONTH[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        const int year = time.tm_year + 1900;
+        const bool leapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        const int monthDays = DAYS_IN_MONTH[time.tm_mon] + (time.tm_mon == 1 && leapYear ? 1 : 0);
+        time.tm_mday = std::min(time.tm_mday, monthDays);
+    }
+    time.tm_mday += static_cast<int>(days);
+    time.tm_isdst = -1;
+    return std::chrono::system_clock::from_time_t(std::mktime(&time));
+}
+
+// Occurrences anchor + k * step (k >= 1), computed from the anchor so month-end days do not drift
+TaskEngine::Recurrence calendarRecurrence(std::chrono::system_clock::time_point anchorTime, long daysPerStep, long monthsPerStep) {
+    const std::tm anchor = toLocalTime(std::chrono::system_clock::to_time_t(anchorTime));
+    // An upper bound of one step, so the estimate below never skips an occurrence
+    const auto maxStep = daysPerStep > 0 ? std::chrono::hours(25) * daysPerStep : std::chrono::hours(24 * 31) * monthsPerStep;
+    return [anchor, anchorTime, daysPerStep, monthsPerStep, maxStep](std::chrono::system_clock::time_point previous)
+        -> std::optional<std::chrono::system_clock::time_point> {
+        long step = std::max<long>(1, static_cast<long>((previous - anchorTime) / maxStep));
+        std::chrono::system_clock::time_point next = addCalendar(anchor, daysPerStep * step, monthsPerStep * step);
+        while (next <= previous) {
+            ++step;
+            next = addCalendar(anchor, daysPerStep * step, monthsPerStep * step);
+        }
+        return next;
+    };
+}
+} // namespace
+
+thread_local TaskEngine* TaskEngine::currentEngine_ = nullptr;
+thread_local std::size_t TaskEngine::currentWorkerIndex_ = 0;
+
 TaskEngine& TaskEngine::getInstance() {
     static TaskEngine instance; // Guaranteed to be destroyed, instantiated on first use.
     return instance;
@@ -17,106 +71,464 @@ TaskEngine::TaskEngine() : running_(false) {
 }
 
 TaskEngine::~TaskEngine() {
-    stop(); // Ensure worker thread is stopped when TaskEngine is destroyed
+    stop(); // Ensure worker threads are stopped when TaskEngine is destroyed
     ERP::Logger::Logger::getInstance().info("TaskEngine: Destroyed.");
 }
 
-void TaskEngine::start() {
-    if (!running_.exchange(true)) { // Set running_ to true and check if it was false
-        workerThread_ = std::thread(&TaskEngine::workerThreadLoop, this);
-        ERP::Logger::Logger::getInstance().info("TaskEngine: Worker thread started.");
-    } else {
-        ERP::Logger::Logger::getInstance().warning("TaskEngine: Attempted to start already running worker thread.");
+void TaskEngine::start(std::size_t workerCount) {
+    std::lock_guard<std::mutex> lifecycleLock(lifecycleMutex_);
+    if (running_.exchange(true)) { // Set running_ to true and check if it was false
+        ERP::Logger::Logger::getInstance().warning("TaskEngine: Attempted to start already running worker threads.");
+        return;
+    }
+    if (workerCount == 0) {
+        workerCount = std::max<std::size_t>(2, std::thread::hardware_concurrency());
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> workersLock(workersMutex_);
+        {
+            std::lock_guard<std::mutex> idleLock(idleMutex_);
+            stopping_ = false;
+        }
+        for (std::size_t i = 0; i < workerCount; ++i) {
+            workerQueues_.push_back(std::make_unique<WorkerQueue>());
+        }
+        // Tasks submitted before start() are spread over the new workers
+        std::size_t index = 0;
+        for (auto& task : backlog_) {
+            WorkerQueue& queue = *workerQueues_[index++ % workerCount];
+            queue.tasks[static_cast<std::size_t>(task.priority)].push_back(std::move(task));
+        }
+        pendingTasks_.fetch_add(backlog_.size(), std::memory_order_release);
+        backlog_.clear();
+        for (std::size_t i = 0; i < workerCount; ++i) {
+            workerThreads_.emplace_back(&TaskEngine::workerThreadLoop, this, i);
+        }
     }
+    timerThread_ = std::thread(&TaskEngine::timerThreadLoop, this);
+    ERP::Logger::Logger::getInstance().info("TaskEngine: Started " + std::to_string(workerCount) + " worker threads and the timer thread.");
 }
 
 void TaskEngine::stop() {
-    if (running_.exchange(false)) { // Set running_ to false and check if it was true
-        cv_.notify_all(); // Notify worker thread to wake up and exit
-        if (workerThread_.joinable()) {
-            workerThread_.join(); // Wait for the worker thread to finish
+    std::lock_guard<std::mutex> lifecycleLock(lifecycleMutex_);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_); // The timer checks running_ under this mutex
+        if (!running_.exchange(false)) { // Set running_ to false and check if it was true
+            ERP::Logger::Logger::getInstance().warning("TaskEngine: Attempted to stop already stopped worker threads.");
+            return;
         }
-        ERP::Logger::Logger::getInstance().info("TaskEngine: Worker thread stopped.");
-    } else {
-        ERP::Logger::Logger::getInstance().warning("TaskEngine: Attempted to stop already stopped worker thread.");
     }
+    cv_.notify_all(); // Wake the timer thread so it exits
+    if (timerThread_.joinable()) {
+        timerThread_.join();
+    }
+
+    // Workers finish the queued tasks, then exit
+    {
+        std::lock_guard<std::mutex> idleLock(idleMutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    std::vector<std::thread> threads;
+    {
+        std::shared_lock<std::shared_mutex> workersLock(workersMutex_);
+        threads.swap(workerThreads_);
+    }
+    for (auto& thread : threads) {
+        if (thread.joinable()) {
+            thread.join(); // Wait for the worker thread to finish
+        }
+    }
+
+    // Tasks submitted while the workers were exiting run after the next start()
+    {
+        std::unique_lock<std::shared_mutex> workersLock(workersMutex_);
+        for (auto& queue : workerQueues_) {
+            for (auto& tasks : queue->tasks) {
+                for (auto& task : tasks) {
+                    backlog_.push_back(std::move(task));
+                }
+            }
+        }
+        workerQueues_.clear();
+        pendingTasks_.store(0, std::memory_order_release);
+    }
+    ERP::Logger::Logger::getInstance().info("TaskEngine: Worker threads stopped.");
 }
 
 void TaskEngine::submitTask(std::function<void()> callback, const std::string& taskId) {
+    submitTask(std::move(callback), taskId, TaskPriority::NORMAL);
+}
+
+std::future<void> TaskEngine::submitTask(std::function<void()> callback, const std::string& taskId, TaskPriority priority) {
+    ERP_LOG_DEBUG("TaskEngine: Immediate task '" + taskId + "' submitted.");
+    return submit(taskId, std::move(callback), priority);
+}
+
+std::future<void> TaskEngine::submitScheduledTask(ScheduledTaskEntry taskEntry) {
+    auto task = std::make_shared<std::packaged_task<void()>>(
+        [callback = std::move(taskEntry.callback), taskId = taskEntry.taskId]() {
+            try {
+                callback();
+            } catch (const std::exception& e) {
+                ERP::Logger::Logger::getInstance().error("TaskEngine: Exception during scheduled task '" + taskId + "': " + e.what());
+                throw; // Reported through the future
+            }
+        });
+    std::future<void> future = task->get_future();
+    ScheduleOptions options;
+    options.priority = taskEntry.priority;
+    scheduleAt(taskEntry.taskId, [task]() { (*task)(); }, taskEntry.nextRunTime, options);
+    return future;
+}
+
+TaskEngine::ScheduleId TaskEngine::scheduleAt(const std::string& taskId, std::function<void()> callback, TimePoint runTime,
+                                              const ScheduleOptions& options) {
+    return scheduleRecurring(taskId, std::move(callback), runTime, nullptr, options);
+}
+
+TaskEngine::ScheduleId TaskEngine::scheduleEvery(const std::string& taskId, std::function<void()> callback, TimePoint firstRunTime,
+                                                 std::chrono::milliseconds interval, const ScheduleOptions& options) {
+    if (interval <= std::chrono::milliseconds::zero()) {
+        ERP::Logger::Logger::getInstance().error("TaskEngine: Invalid interval for scheduled task '" + taskId + "'.");
+        return 0;
+    }
+    return scheduleRecurring(taskId, std::move(callback), firstRunTime,
+                             [interval](TimePoint previous) -> std::optional<TimePoint> { return previous + interval; }, options);
+}
+
+TaskEngine::ScheduleId TaskEngine::scheduleCron(const std::string& taskId, std::function<void()> callback, const std::string& cronExpression,
+                                                const ScheduleOptions& options) {
+    std::optional<CronExpression> cron = CronExpression::parse(cronExpression);
+    if (!cron) {
+        ERP::Logger::Logger::getInstance().error("TaskEngine: Invalid cron expression '" + cronExpression + "' for scheduled task '" + taskId + "'.");
+        return 0;
+    }
+    std::optional<TimePoint> firstRunTime = cron->next(std::chrono::system_clock::now());
+    if (!firstRunTime) {
+        ERP::Logger::Logger::getInstance().error("TaskEngine: Cron expression '" + cronExpression + "' never matches.");
+        return 0;
+    }
+    return scheduleRecurring(taskId, std::move(callback), *firstRunTime,
+                             [cron = *cron](TimePoint previous) { return cron.next(previous); }, options);
+}
+
+TaskEngine::ScheduleId TaskEngine::scheduleRecurring(const std::string& taskId, std::function<void()> callback, TimePoint firstRunTime,
+                                                     Recurrence recurrence, const ScheduleOptions& options) {
+    const ScheduleId scheduleId = nextScheduleId_.fetch_add(1, std::memory_order_relaxed);
+    Schedule schedule{ taskId, std::move(callback), std::move(recurrence), options, firstRunTime, firstRunTime,
+                       std::make_shared<std::atomic<bool>>(false) };
     {
         std::lock_guard<std::mutex> lock(queueMutex_);
-        immediateTaskQueue_.push({callback, taskId});
-        ERP::Logger::Logger::getInstance().debug("TaskEngine: Immediate task '" + taskId + "' submitted.");
+        Schedule& stored = schedules_.emplace(scheduleId, std::move(schedule)).first->second;
+        armSchedule(scheduleId, stored);
+        timerChanged_ = true;
+        ERP_LOG_DEBUG("TaskEngine: Scheduled task '" + taskId + "' submitted for " + ERP::Utils::DateUtils::formatDateTime(firstRunTime, ERP::Common::DATETIME_FORMAT) + ".");
+    }
+    cv_.notify_one(); // Notify the timer thread that a new scheduled task might change its wakeup time
+    return scheduleId;
+}
+
+TaskEngine::ScheduleId TaskEngine::scheduleTask(const ERP::Scheduler::DTO::ScheduledTaskDTO& task, std::function<void()> callback,
+                                                ScheduleOptions options) {
+    using ERP::Scheduler::DTO::ScheduleFrequency;
+    const std::string taskId = task.taskName.empty() ? task.id : task.taskName;
+    if (task.status != ERP::Scheduler::DTO::ScheduledTaskStatus::ACTIVE) {
+        ERP::Logger::Logger::getInstance().warning("TaskEngine: Scheduled task '" + taskId + "' is not active. Not scheduling it.");
+        return 0;
+    }
+
+    Recurrence recurrence;
+    switch (task.frequency) {
+        case ScheduleFrequency::ONCE:
+            break;
+        case ScheduleFrequency::HOURLY:
+            recurrence = [](TimePoint previous) -> std::optional<TimePoint> { return previous + std::chrono::hours(1); };
+            break;
+        case ScheduleFrequency::DAILY:
+            recurrence = calendarRecurrence(task.nextRunTime, 1, 0);
+            break;
+        case ScheduleFrequency::WEEKLY:
+            recurrence = calendarRecurrence(task.nextRunTime, 7, 0);
+            break;
+        case ScheduleFrequency::MONTHLY:
+            recurrence = calendarRecurrence(task.nextRunTime, 0, 1);
+            break;
+        case ScheduleFrequency::YEARLY:
+            recurrence = calendarRecurrence(task.nextRunTime, 0, 12);
+            break;
+        case ScheduleFrequency::CUSTOM_CRON: {
+            std::optional<CronExpression> cron = task.cronExpression ? CronExpression::parse(*task.cronExpression) : std::nullopt;
+            if (!cron) {
+                ERP::Logger::Logger::getInstance().error("TaskEngine: Invalid cron expression '" + task.cronExpression.value_or("") + "' for scheduled task '" + taskId + "'.");
+                return 0;
+            }
+            recurrence = [cron = *cron](TimePoint previous) { return cron.next(previous); };
+            break;
+        }
+    }
+
+    if (task.endDate && !options.endTime) {
+        options.endTime = task.endDate;
+    }
+    TimePoint firstRunTime = task.nextRunTime;
+    while (recurrence && task.startDate && firstRunTime < *task.startDate) {
+        std::optional<TimePoint> next = recurrence(firstRunTime);
+        if (!next) {
+            return 0;
+        }
+        firstRunTime = *next;
+    }
+    if (options.endTime && firstRunTime > *options.endTime) {
+        ERP::Logger::Logger::getInstance().warning("TaskEngine: Scheduled task '" + taskId + "' has no occurrence before its end date.");
+        return 0;
     }
-    cv_.notify_one(); // Notify one waiting thread that a task is available
+    return scheduleRecurring(taskId, std::move(callback), firstRunTime, std::move(recurrence), options);
 }
 
-void TaskEngine::submitScheduledTask(ScheduledTaskEntry taskEntry) {
+bool TaskEngine::cancelScheduledTask(ScheduleId scheduleId) {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    auto it = schedules_.find(scheduleId);
+    if (it == schedules_.end()) {
+        return false;
+    }
+    timerWheel_.cancel(scheduleId);
+    ERP_LOG_DEBUG("TaskEngine: Scheduled task '" + it->second.taskId + "' cancelled.");
+    schedules_.erase(it);
+    return true; // No wake-up needed: an earlier wake-up than necessary is harmless
+}
+
+bool TaskEngine::rescheduleTask(ScheduleId scheduleId, TimePoint nextRunTime) {
     {
         std::lock_guard<std::mutex> lock(queueMutex_);
-        scheduledTaskQueue_.push(taskEntry);
-        ERP::Logger::Logger::getInstance().debug("TaskEngine: Scheduled task '" + taskEntry.taskId + "' submitted for " + ERP::Utils::DateUtils::formatDateTime(taskEntry.nextRunTime, ERP::Common::DATETIME_FORMAT) + ".");
+        auto it = schedules_.find(scheduleId);
+        if (it == schedules_.end()) {
+            return false;
+        }
+        it->second.nextRunTime = nextRunTime;
+        armSchedule(scheduleId, it->second);
+        timerChanged_ = true;
     }
-    cv_.notify_one(); // Notify worker thread that a new scheduled task might change wakeup time
+    cv_.notify_one();
+    return true;
 }
 
-void TaskEngine::workerThreadLoop() {
-    ERP::Logger::Logger::getInstance().info("TaskEngine: Worker thread loop started.");
-    while (running_) {
-        std::unique_lock<std::mutex> lock(queueMutex_);
-
-        // Process immediate tasks first
-        if (!immediateTaskQueue_.empty()) {
-            auto task = immediateTaskQueue_.front();
-            immediateTaskQueue_.pop();
-            lock.unlock(); // Unlock while executing task to not block other submissions
-            ERP::Logger::Logger::getInstance().info("TaskEngine: Executing immediate task: " + task.second);
-            try {
-                task.first(); // Execute the task callback
-            } catch (const std::exception& e) {
-                ERP::Logger::Logger::getInstance().error("TaskEngine: Exception during immediate task '" + task.second + "': " + e.what());
-            }
-            continue; // Go back to check for more immediate tasks or scheduled tasks
+std::optional<TaskEngine::TimePoint> TaskEngine::getNextRunTime(ScheduleId scheduleId) {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    auto it = schedules_.find(scheduleId);
+    if (it == schedules_.end()) {
+        return std::nullopt;
+    }
+    return it->second.nextRunTime;
+}
+
+std::size_t TaskEngine::getScheduledTaskCount() {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    return schedules_.size();
+}
+
+void TaskEngine::armSchedule(ScheduleId scheduleId, Schedule& schedule) {
+    schedule.fireTime = schedule.nextRunTime;
+    if (schedule.options.jitter > std::chrono::milliseconds::zero()) {
+        std::uniform_int_distribution<long long> distribution(0, schedule.options.jitter.count());
+        schedule.fireTime += std::chrono::milliseconds(distribution(jitterRandom_));
+    }
+    timerWheel_.insert(scheduleId, schedule.fireTime);
+}
+
+void TaskEngine::fireSchedule(ScheduleId scheduleId, TimePoint now, std::vector<QueuedTask>& dispatch) {
+    auto it = schedules_.find(scheduleId);
+    if (it == schedules_.end()) {
+        return;
+    }
+    Schedule& schedule = it->second;
+    const bool late = now - schedule.fireTime > schedule.options.misfireThreshold;
+
+    // Occurrences that also passed while this one waited
+    std::size_t runCount = 1;
+    std::size_t missedCount = 0;
+    std::optional<TimePoint> next = schedule.recurrence ? schedule.recurrence(schedule.nextRunTime) : std::nullopt;
+    while (next && *next <= now && (!schedule.options.endTime || *next <= *schedule.options.endTime)) {
+        ++missedCount;
+        next = schedule.recurrence(*next);
+    }
+
+    switch (schedule.options.missedRunPolicy) {
+        case MissedRunPolicy::SKIP:
+            runCount = late ? 0 : 1;
+            break;
+        case MissedRunPolicy::RUN_ONCE:
+            runCount = 1;
+            break;
+        case MissedRunPolicy::CATCH_UP:
+            runCount = std::min<std::size_t>(1 + missedCount, MAX_CATCH_UP_RUNS);
+            break;
+    }
+    if (late || missedCount > 0) {
+        ERP::Logger::Logger::getInstance().warning("TaskEngine: Scheduled task '" + schedule.taskId + "' missed " + std::to_string(missedCount + (late ? 1 : 0)) +
+                                                   " run(s); running it " + std::to_string(runCount) + " time(s).");
+    }
+
+    if (runCount > 0) {
+        const bool busy = schedule.busy->exchange(true);
+        if (busy && !schedule.options.allowOverlap) {
+            ERP::Logger::Logger::getInstance().warning("TaskEngine: Scheduled task '" + schedule.taskId + "' is still running. Skipping this run.");
+        } else {
+            dispatch.push_back(QueuedTask{
+                [callback = schedule.callback, busy = schedule.busy, runCount]() {
+                    struct ClearBusy {
+                        std::shared_ptr<std::atomic<bool>> flag;
+                        ~ClearBusy() { flag->store(false); }
+                    } clearBusy{ busy };
+                    for (std::size_t run = 0; run < runCount; ++run) {
+                        callback(); // Catch-up runs go one after another, never concurrently
+                    }
+                },
+                schedule.taskId, schedule.options.priority });
         }
+    }
+
+    if (next && (!schedule.options.endTime || *next <= *schedule.options.endTime)) {
+        schedule.nextRunTime = *next;
+        armSchedule(scheduleId, schedule);
+    } else {
+        ERP_LOG_DEBUG("TaskEngine: Scheduled task '" + schedule.taskId + "' has no further runs.");
+        schedules_.erase(it);
+    }
+}
+
+std::size_t TaskEngine::getWorkerCount() const {
+    std::shared_lock<std::shared_mutex> workersLock(workersMutex_);
+    return workerThreads_.size();
+}
 
-        // Handle scheduled tasks
-        if (!scheduledTaskQueue_.empty()) {
-            ScheduledTaskEntry& nextTask = scheduledTaskQueue_.top();
-            // Wait until the next scheduled task is due or until notified/shutdown
-            if (std::chrono::system_clock::now() < nextTask.nextRunTime) {
-                ERP::Logger::Logger::getInstance().debug("TaskEngine: Worker waiting for scheduled task '" + nextTask.taskId + "' until: " + ERP::Utils::DateUtils::formatDateTime(nextTask.nextRunTime, ERP::Common::DATETIME_FORMAT));
-                cv_.wait_until(lock, nextTask.nextRunTime, [&] { return !running_ || !immediateTaskQueue_.empty() || std::chrono::system_clock::now() >= nextTask.nextRunTime; });
+std::size_t TaskEngine::getPendingTaskCount() const {
+    std::shared_lock<std::shared_mutex> workersLock(workersMutex_);
+    return pendingTasks_.load(std::memory_order_relaxed) + backlog_.size();
+}
+
+void TaskEngine::enqueue(QueuedTask task) {
+    {
+        std::shared_lock<std::shared_mutex> workersLock(workersMutex_);
+        if (!workerQueues_.empty()) {
+            // A task submitted by a worker stays on that worker; others are spread round-robin
+            const std::size_t index = currentEngine_ == this
+                ? currentWorkerIndex_
+                : nextQueue_.fetch_add(1, std::memory_order_relaxed) % workerQueues_.size();
+            WorkerQueue& queue = *workerQueues_[index];
+            {
+                std::lock_guard<std::mutex> queueLock(queue.mutex);
+                queue.tasks[static_cast<std::size_t>(task.priority)].push_back(std::move(task));
+            }
+            pendingTasks_.fetch_add(1, std::memory_order_release);
+        } else {
+            workersLock.unlock();
+            std::unique_lock<std::shared_mutex> exclusiveLock(workersMutex_);
+            if (workerQueues_.empty()) {
+                backlog_.push_back(std::move(task)); // Runs after start()
+                return;
             }
+            exclusiveLock.unlock();
+            enqueue(std::move(task)); // Started meanwhile
+            return;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> idleLock(idleMutex_); // Pairs with the workers' wait to avoid a lost wake-up
+    }
+    workAvailable_.notify_one();
+}
 
-            if (!running_) break; // Check running_ status again after waking up
-            if (!immediateTaskQueue_.empty()) continue; // Prioritize immediate tasks if new ones arrived
-
-            // If woke up because time is due or passed for nextTask
-            if (std::chrono::system_clock::now() >= nextTask.nextRunTime) {
-                scheduledTaskQueue_.pop(); // Remove task from queue
-                lock.unlock(); // Unlock while executing task
-                ERP::Logger::Logger::getInstance().info("TaskEngine: Executing scheduled task: " + nextTask.taskId);
-                try {
-                    nextTask.callback(); // Execute the scheduled task callback
-                } catch (const std::exception& e) {
-                    ERP::Logger::Logger::getInstance().error("TaskEngine: Exception during scheduled task '" + nextTask.taskId + "': " + e.what());
-                }
-                continue; // Go back to check for next tasks
+bool TaskEngine::takeTask(std::size_t workerIndex, QueuedTask& task) {
+    // Workers only run while workerQueues_ is fixed (see start()/stop()), so no workersMutex_ here
+    const std::size_t workerCount = workerQueues_.size();
+    for (std::size_t priority = PRIORITY_COUNT; priority-- > 0;) {
+        WorkerQueue& own = *workerQueues_[workerIndex];
+        {
+            std::lock_guard<std::mutex> queueLock(own.mutex);
+            auto& tasks = own.tasks[priority];
+            if (!tasks.empty()) {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+                pendingTasks_.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
+            }
+        }
+        // Steal before falling back to lower priority work of our own
+        for (std::size_t offset = 1; offset < workerCount; ++offset) {
+            WorkerQueue& victim = *workerQueues_[(workerIndex + offset) % workerCount];
+            std::lock_guard<std::mutex> queueLock(victim.mutex);
+            auto& tasks = victim.tasks[priority];
+            if (!tasks.empty()) {
+                task = std::move(tasks.back());
+                tasks.pop_back();
+                pendingTasks_.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
             }
         }
-        
-        // If no tasks are ready, wait for a notification or a timeout to re-check
-        auto nextWakeupTime = std::chrono::system_clock::now() + std::chrono::minutes(1); // Default check-in time
-        if (!scheduledTaskQueue_.empty()) {
-            nextWakeupTime = scheduledTaskQueue_.top().nextRunTime;
+    }
+    return false;
+}
+
+void TaskEngine::workerThreadLoop(std::size_t workerIndex) {
+    currentEngine_ = this;
+    currentWorkerIndex_ = workerIndex;
+    ERP_LOG_DEBUG("TaskEngine: Worker thread " + std::to_string(workerIndex) + " loop started.");
+    while (true) {
+        QueuedTask task;
+        if (takeTask(workerIndex, task)) {
+            runTask(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> idleLock(idleMutex_);
+        workAvailable_.wait(idleLock, [this] { return stopping_ || pendingTasks_.load(std::memory_order_acquire) > 0; });
+        if (stopping_ && pendingTasks_.load(std::memory_order_acquire) == 0) {
+            break; // Queued tasks are finished before exiting
         }
+    }
+    currentEngine_ = nullptr;
+    ERP_LOG_DEBUG("TaskEngine: Worker thread " + std::to_string(workerIndex) + " finished its loop.");
+}
 
-        ERP::Logger::Logger::getInstance().debug("TaskEngine: No tasks due. Worker waiting until: " + ERP::Utils::DateUtils::formatDateTime(nextWakeupTime, ERP::Common::DATETIME_FORMAT));
-        cv_.wait_until(lock, nextWakeupTime, [&] { return !running_ || !immediateTaskQueue_.empty(); });
+void TaskEngine::runTask(QueuedTask& task) {
+    ERP::Logger::Logger::getInstance().info("TaskEngine: Executing task: " + task.taskId);
+    try {
+        task.run(); // Exceptions of submitted callables are stored in their futures
+    } catch (const std::exception& e) {
+        ERP::Logger::Logger::getInstance().error("TaskEngine: Exception during task '" + task.taskId + "': " + e.what());
+    }
+}
 
-        if (!running_) break; // Check running_ status after waiting
+void TaskEngine::timerThreadLoop() {
+    ERP::Logger::Logger::getInstance().info("TaskEngine: Timer thread loop started.");
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    while (running_) {
+        timerChanged_ = false;
+        const TimePoint now = std::chrono::system_clock::now();
+        std::vector<QueuedTask> dispatch;
+        for (ScheduleId scheduleId : timerWheel_.advance(now)) {
+            fireSchedule(scheduleId, now, dispatch);
+        }
+        if (!dispatch.empty()) {
+            lock.unlock(); // The timer never runs tasks itself, so a slow task cannot delay others that are due
+            for (auto& task : dispatch) {
+                enqueue(std::move(task));
+            }
+            lock.lock();
+            continue;
+        }
+
+        // Woken early by stop() or by a schedule change; the loop re-evaluates either way
+        const std::optional<TimePoint> wakeTime = timerWheel_.nextWakeTime();
+        auto changed = [this] { return !running_ || timerChanged_; };
+        if (wakeTime) {
+            cv_.wait_until(lock, *wakeTime, changed);
+        } else {
+            cv_.wait(lock, changed);
+        }
     }
-    ERP::Logger::Logger::getInstance().info("TaskEngine: Worker thread finished its loop.");
+    ERP::Logger::Logger::getInstance().info("TaskEngine: Timer thread finished its loop.");
 }
 } // namespace TaskEngine
-} // namespace ERP
\ No newline at end of file
+} // namespace ERP
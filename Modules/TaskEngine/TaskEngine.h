@@ -3,9 +3,17 @@
 #define MODULES_TASKENGINE_TASKENGINE_H
 #include "ITask.h"        // Đã rút gọn include
 #include "Logger.h"       // Đã rút gọn include
+#include "TimerWheel.h"   // Scheduled task timers
 #include <string>
 #include <vector>
-#include <queue>        // For std::priority_queue (if scheduling tasks by time)
+#include <deque>        // For std::deque (per-worker task queues)
+#include <future>       // For std::future, std::packaged_task
+#include <type_traits>  // For std::invoke_result_t
+#include <shared_mutex> // For std::shared_mutex (worker set)
+#include <unordered_map> // For std::unordered_map (schedules)
+#include <optional>     // For std::optional
+#include <random>       // For std::mt19937_64 (schedule jitter)
+#include <cstdint>      // For std::uint64_t
 #include <chrono>       // For std::chrono::system_clock::time_point
 #include <thread>       // For std::thread
 #include <mutex>        // For std::mutex
@@ -14,6 +22,8 @@
 #include <functional>   // For std::function
 #include <memory>       // For std::shared_ptr
 
+namespace ERP { namespace Scheduler { namespace DTO { struct ScheduledTaskDTO; }}}
+
 namespace ERP {
 namespace TaskEngine {
 /**
@@ -39,9 +49,48 @@ public:
 };
 
 
+/**
+ * @brief Priority of a task. Workers take higher priorities first, from their own queue or by stealing.
+ */
+enum class TaskPriority {
+    LOW = 0,
+    NORMAL = 1,
+    HIGH = 2
+};
+
+/**
+ * @brief What a recurring schedule does with occurrences that were missed (engine stopped, clock
+ * jump, or a run still busy).
+ */
+enum class MissedRunPolicy {
+    SKIP = 0,     /**< Drop late occurrences; continue with the next one in the future. */
+    RUN_ONCE = 1, /**< Run once for all missed occurrences, then continue. */
+    CATCH_UP = 2  /**< Run every missed occurrence (up to MAX_CATCH_UP_RUNS), one after another. */
+};
+
+/**
+ * @brief Options of a scheduled task.
+ */
+struct ScheduleOptions {
+    TaskPriority priority = TaskPriority::NORMAL;
+    MissedRunPolicy missedRunPolicy = MissedRunPolicy::RUN_ONCE;
+    std::chrono::milliseconds misfireThreshold{60000};  /**< A run starting later than this after its time is late. */
+    std::chrono::milliseconds jitter{0};                /**< Random delay up to this, to spread jobs due at the same time. */
+    bool allowOverlap = false;                          /**< If false, an occurrence is skipped while the previous run is busy. */
+    std::optional<std::chrono::system_clock::time_point> endTime; /**< No occurrences after this time. */
+};
+
 /**
  * @brief The TaskEngine class is responsible for managing and executing background tasks.
- * It uses a worker thread and a queue to process tasks asynchronously.
+ *
+ * A pool of worker threads runs the tasks. Each worker has its own queue per priority;
+ * submissions are spread over the workers (a task submitted from a worker stays on that
+ * worker), and an idle worker steals from the others, so one slow task only occupies one
+ * worker. Every submission returns a future that reports completion or the task's exception.
+ *
+ * Scheduled tasks wait in a hierarchical timer wheel on a separate timer thread and are handed
+ * to the pool when due. Schedules can be cancelled or moved in O(1) and recur natively (fixed
+ * interval, calendar frequency or cron expression), with a missed-run policy and jitter.
  */
 class TaskEngine : public ITaskExecutorService {
 public:
@@ -56,12 +105,14 @@ public:
     TaskEngine& operator=(const TaskEngine&) = delete;
 
     /**
-     * @brief Starts the TaskEngine's worker thread.
+     * @brief Starts the worker threads and the timer thread.
+     * @param workerCount Number of worker threads; 0 uses the number of hardware threads (at least 2).
      */
-    void start();
+    void start(std::size_t workerCount = 0);
 
     /**
-     * @brief Stops the TaskEngine, gracefully shutting down the worker thread.
+     * @brief Stops the TaskEngine. Tasks already queued are run first; scheduled tasks that are not due
+     * yet stay queued until the next start().
      */
     void stop();
 
@@ -72,40 +123,192 @@ public:
      */
     void submitTask(std::function<void()> callback, const std::string& taskId) override;
 
-    // Structure to hold tasks in the priority queue (for scheduled tasks)
+    /**
+     * @brief Submits a task for asynchronous execution with a priority.
+     * @param callback A callable object (e.g., lambda) representing the task logic.
+     * @param taskId A unique ID for the task, used for logging or tracking.
+     * @param priority The priority of the task.
+     * @return A future that becomes ready when the task has run (and rethrows its exception).
+     */
+    std::future<void> submitTask(std::function<void()> callback, const std::string& taskId, TaskPriority priority);
+
+    /**
+     * @brief Submits a callable returning a value.
+     * @param taskId A unique ID for the task, used for logging or tracking.
+     * @param function The callable; takes no arguments.
+     * @param priority The priority of the task.
+     * @return A future holding the callable's result or exception.
+     */
+    template<typename Function>
+    std::future<std::invoke_result_t<Function>> submit(const std::string& taskId, Function&& function, TaskPriority priority = TaskPriority::NORMAL) {
+        using Result = std::invoke_result_t<Function>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(
+            [function = std::forward<Function>(function), taskId]() mutable -> Result {
+                try {
+                    return function();
+                } catch (const std::exception& e) {
+                    ERP::Logger::Logger::getInstance().error("TaskEngine: Exception during task '" + taskId + "': " + e.what());
+                    throw; // Reported through the future
+                }
+            });
+        std::future<Result> future = task->get_future();
+        enqueue(QueuedTask{ [task]() { (*task)(); }, taskId, priority });
+        return future;
+    }
+
+    using ScheduleId = std::uint64_t; // 0 is never a valid id
+    using TimePoint = std::chrono::system_clock::time_point;
+    using Recurrence = std::function<std::optional<TimePoint>(TimePoint previousRunTime)>; // Next occurrence, or none
+
+    static constexpr std::size_t MAX_CATCH_UP_RUNS = 100;
+
+    // A one-time scheduled task
     struct ScheduledTaskEntry {
         std::chrono::system_clock::time_point nextRunTime;
         std::string taskId;
         std::function<void()> callback;
-
-        bool operator>(const ScheduledTaskEntry& other) const {
-            return nextRunTime > other.nextRunTime;
-        }
+        TaskPriority priority = TaskPriority::NORMAL;
     };
 
     /**
      * @brief Submits a task to be executed at a specific time.
      * @param taskEntry The ScheduledTaskEntry containing the task details.
+     * @return A future that becomes ready when the task has run.
+     */
+    std::future<void> submitScheduledTask(ScheduledTaskEntry taskEntry);
+
+    /**
+     * @brief Schedules a task once.
+     * @return The id of the schedule, for cancelScheduledTask() and rescheduleTask().
      */
-    void submitScheduledTask(ScheduledTaskEntry taskEntry);
+    ScheduleId scheduleAt(const std::string& taskId, std::function<void()> callback, TimePoint runTime,
+                          const ScheduleOptions& options = ScheduleOptions());
 
+    /**
+     * @brief Schedules a task at a fixed interval, starting at firstRunTime.
+     * @return The id of the schedule, or 0 if the interval is not positive.
+     */
+    ScheduleId scheduleEvery(const std::string& taskId, std::function<void()> callback, TimePoint firstRunTime,
+                             std::chrono::milliseconds interval, const ScheduleOptions& options = ScheduleOptions());
+
+    /**
+     * @brief Schedules a task by a cron expression (see CronExpression).
+     * @return The id of the schedule, or 0 if the expression is invalid.
+     */
+    ScheduleId scheduleCron(const std::string& taskId, std::function<void()> callback, const std::string& cronExpression,
+                            const ScheduleOptions& options = ScheduleOptions());
+
+    /**
+     * @brief Schedules a task with a custom recurrence.
+     * @param recurrence Computes the occurrence after a given one; empty for a one-time task.
+     * @return The id of the schedule.
+     */
+    ScheduleId scheduleRecurring(const std::string& taskId, std::function<void()> callback, TimePoint firstRunTime,
+                                 Recurrence recurrence, const ScheduleOptions& options = ScheduleOptions());
+
+    /**
+     * @brief Schedules a ScheduledTaskDTO by its frequency (cron expression for CUSTOM_CRON),
+     * starting at its nextRunTime and bounded by its startDate and endDate.
+     * @return The id of the schedule, or 0 if the task is not active or its schedule is invalid.
+     */
+    ScheduleId scheduleTask(const ERP::Scheduler::DTO::ScheduledTaskDTO& task, std::function<void()> callback,
+                            ScheduleOptions options = ScheduleOptions());
+
+    /**
+     * @brief Cancels a schedule. A run already handed to the workers still completes.
+     * @return True if the schedule existed, false otherwise.
+     */
+    bool cancelScheduledTask(ScheduleId scheduleId);
+
+    /**
+     * @brief Moves the next occurrence of a schedule; later occurrences follow from it.
+     * @return True if the schedule exists, false otherwise.
+     */
+    bool rescheduleTask(ScheduleId scheduleId, TimePoint nextRunTime);
+
+    /**
+     * @brief Gets the next occurrence of a schedule (without jitter).
+     */
+    std::optional<TimePoint> getNextRunTime(ScheduleId scheduleId);
+
+    /**
+     * @brief Gets the number of active schedules.
+     */
+    std::size_t getScheduledTaskCount();
+
+    /**
+     * @brief Gets the number of worker threads (0 when stopped).
+     */
+    std::size_t getWorkerCount() const;
+
+    /**
+     * @brief Gets the number of immediate tasks waiting for a worker (queued before start() included).
+     */
+    std::size_t getPendingTaskCount() const;
 
 private:
     TaskEngine(); // Private constructor for singleton
     ~TaskEngine(); // Private destructor for singleton
 
-    void workerThreadLoop(); // The main loop for the worker thread
+    static constexpr std::size_t PRIORITY_COUNT = 3;
+
+    struct QueuedTask {
+        std::function<void()> run;
+        std::string taskId;
+        TaskPriority priority = TaskPriority::NORMAL;
+    };
+
+    // Queues of one worker: the owner takes from the front, thieves from the back
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<QueuedTask> tasks[PRIORITY_COUNT];
+    };
+
+    void enqueue(QueuedTask task);
+    bool takeTask(std::size_t workerIndex, QueuedTask& task);
+    void workerThreadLoop(std::size_t workerIndex); // The main loop of a worker thread
+    void timerThreadLoop();                         // Hands due scheduled tasks to the workers
+    void runTask(QueuedTask& task);
+
+    struct Schedule {
+        std::string taskId;
+        std::function<void()> callback;
+        Recurrence recurrence;
+        ScheduleOptions options;
+        TimePoint nextRunTime;                  // Nominal time of the next occurrence
+        TimePoint fireTime;                     // nextRunTime plus jitter
+        std::shared_ptr<std::atomic<bool>> busy; // A run is queued or executing
+    };
+
+    void armSchedule(ScheduleId scheduleId, Schedule& schedule);                        // Under queueMutex_
+    void fireSchedule(ScheduleId scheduleId, TimePoint now, std::vector<QueuedTask>& dispatch); // Under queueMutex_
 
     std::atomic<bool> running_;
-    std::thread workerThread_;
+    std::mutex lifecycleMutex_; // Serializes start() and stop()
+
+    // Workers; the set only changes in start()/stop() under the exclusive lock
+    mutable std::shared_mutex workersMutex_;
+    std::vector<std::unique_ptr<WorkerQueue>> workerQueues_;
+    std::vector<std::thread> workerThreads_;
+    std::deque<QueuedTask> backlog_;            // Tasks submitted while no worker runs
+    std::atomic<std::size_t> nextQueue_{0};     // Round-robin target for submissions from other threads
+    std::atomic<std::size_t> pendingTasks_{0};
+    bool stopping_ = false;                     // Guarded by idleMutex_
+    mutable std::mutex idleMutex_;
+    std::condition_variable workAvailable_;
+
+    // Timer; schedules, the wheel and the jitter generator are guarded by queueMutex_
+    std::thread timerThread_;
     std::mutex queueMutex_;
     std::condition_variable cv_;
+    bool timerChanged_ = false;                 // Wakes the timer thread to recompute its wake-up time
+    std::unordered_map<ScheduleId, Schedule> schedules_;
+    TimerWheel timerWheel_;
+    std::atomic<ScheduleId> nextScheduleId_{1};
+    std::mt19937_64 jitterRandom_;
 
-    // Queue for immediate tasks
-    std::queue<std::pair<std::function<void()>, std::string>> immediateTaskQueue_;
-
-    // Priority queue for scheduled tasks (ordered by nextRunTime)
-    std::priority_queue<ScheduledTaskEntry, std::vector<ScheduledTaskEntry>, std::greater<ScheduledTaskEntry>> scheduledTaskQueue_;
+    static thread_local TaskEngine* currentEngine_;        // Engine of the calling worker thread
+    static thread_local std::size_t currentWorkerIndex_;
 };
 } // namespace TaskEngine
 } // namespace ERP
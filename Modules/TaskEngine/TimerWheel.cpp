@@ -0,0 +1,134 @@
+// Modules/TaskEngine/TimerWheel.cpp
+#include "TimerWheel.h" // Đã rút gọn include
+#include <algorithm> // For std::max
+
+namespace ERP {
+namespace TaskEngine {
+
+TimerWheel::TimerWheel(std::chrono::milliseconds tick, TimePoint now)
+    : tick_(std::max(tick, std::chrono::milliseconds(1))) {
+    currentTick_ = toTick(now, false);
+}
+
+std::int64_t TimerWheel::toTick(TimePoint time, bool roundUp) const {
+    const std::int64_t millis = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+    const std::int64_t tickMillis = tick_.count();
+    std::int64_t tick = millis / tickMillis;
+    if (roundUp && tick * tickMillis < millis) {
+        ++tick; // Never fire before the expiry
+    }
+    return tick;
+}
+
+TimerWheel::TimePoint TimerWheel::fromTick(std::int64_t tick) const {
+    return TimePoint(std::chrono::duration_cast<TimePoint::duration>(tick_ * tick));
+}
+
+void TimerWheel::insert(TimerId id, TimePoint expiry) {
+    cancel(id);
+    place(Entry{ id, toTick(expiry, true) });
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    auto it = positions_.find(id);
+    if (it == positions_.end()) {
+        return false;
+    }
+    it->second.slot->erase(it->second.entry);
+    positions_.erase(it);
+    return true;
+}
+
+void TimerWheel::place(Entry entry) {
+    const std::int64_t delta = entry.expiryTick - currentTick_;
+    Slot* slot = &overflow_;
+    if (delta <= 0) {
+        slot = &due_;
+    } else {
+        for (int level = 0; level < LEVELS; ++level) {
+            if (delta < (std::int64_t{1} << (LEVEL_BITS * (level + 1)))) {
+                slot = &levels_[level][(entry.expiryTick >> (LEVEL_BITS * level)) & SLOT_MASK];
+                break;
+            }
+        }
+    }
+    slot->push_back(entry);
+    positions_[entry.id] = Position{ slot, std::prev(slot->end()) };
+}
+
+void TimerWheel::cascade(Slot& slot) {
+    Slot entries;
+    entries.splice(entries.end(), slot);
+    for (const Entry& entry : entries) {
+        place(entry);
+    }
+}
+
+void TimerWheel::rebuild(std::int64_t nowTick) {
+    Slot entries;
+    for (auto& level : levels_) {
+        for (auto& slot : level) {
+            entries.splice(entries.end(), slot);
+        }
+    }
+    entries.splice(entries.end(), overflow_);
+    currentTick_ = nowTick;
+    for (const Entry& entry : entries) {
+        place(entry);
+    }
+}
+
+std::vector<TimerWheel::TimerId> TimerWheel::advance(TimePoint now) {
+    std::vector<TimerId> expired;
+    auto collect = [&](Slot& slot) {
+        for (const Entry& entry : slot) {
+            expired.push_back(entry.id);
+            positions_.erase(entry.id);
+        }
+        slot.clear();
+    };
+
+    collect(due_);
+    const std::int64_t nowTick = toTick(now, false);
+    if (nowTick - currentTick_ > MAX_TICKS_PER_ADVANCE) {
+        rebuild(nowTick); // After a long stop or a clock jump; expired timers land in due_
+        collect(due_);
+        return expired;
+    }
+    while (currentTick_ < nowTick) {
+        ++currentTick_;
+        // Cascade from the top so entries can move down several levels in one tick
+        for (int level = LEVELS; level >= 1; --level) {
+            const std::int64_t boundary = std::int64_t{1} << (LEVEL_BITS * level);
+            if ((currentTick_ & (boundary - 1)) != 0) {
+                continue;
+            }
+            if (level == LEVELS) {
+                cascade(overflow_);
+            } else {
+                cascade(levels_[level][(currentTick_ >> (LEVEL_BITS * level)) & SLOT_MASK]);
+            }
+        }
+        collect(levels_[0][currentTick_ & SLOT_MASK]);
+        collect(due_);
+    }
+    return expired;
+}
+
+std::optional<TimerWheel::TimePoint> TimerWheel::nextWakeTime() const {
+    if (positions_.empty()) {
+        return std::nullopt;
+    }
+    if (!due_.empty()) {
+        return fromTick(currentTick_);
+    }
+    for (std::int64_t tick = currentTick_ + 1; tick <= currentTick_ + SLOTS; ++tick) {
+        if (!levels_[0][tick & SLOT_MASK].empty() || (tick & SLOT_MASK) == 0) {
+            return fromTick(tick); // A level-0 expiry, or a cascade that may bring one
+        }
+    }
+    return fromTick(currentTick_ + SLOTS);
+}
+
+} // namespace TaskEngine
+} // namespace ERP
@@ -0,0 +1,106 @@
+// Modules/TaskEngine/TimerWheel.h
+#ifndef MODULES_TASKENGINE_TIMERWHEEL_H
+#define MODULES_TASKENGINE_TIMERWHEEL_H
+#include <chrono>       // For std::chrono::system_clock
+#include <cstdint>      // For std::uint64_t, std::int64_t
+#include <list>         // For std::list (slot contents)
+#include <optional>     // For std::optional
+#include <unordered_map> // For std::unordered_map (timer positions)
+#include <vector>       // For std::vector
+
+namespace ERP {
+namespace TaskEngine {
+
+/**
+ * @brief Hierarchical timer wheel: O(1) insert and cancel for large numbers of timers.
+ *
+ * Time is divided into ticks. Level 0 has one slot per tick for the next 64 ticks; each higher
+ * level covers 64 slots of the level below. Timers further out than the top level wait in an
+ * overflow list. When the wheel reaches the start of a higher-level slot, that slot's timers are
+ * moved ("cascaded") down, so each timer is touched at most once per level. Timers never fire
+ * before their expiry; they fire at most one tick late. Not thread-safe; the owner locks.
+ */
+class TimerWheel {
+public:
+    using TimerId = std::uint64_t;
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    /**
+     * @brief Constructs a wheel.
+     * @param tick Resolution of the wheel.
+     * @param now The current time.
+     */
+    explicit TimerWheel(std::chrono::milliseconds tick = std::chrono::milliseconds(100),
+                        TimePoint now = std::chrono::system_clock::now());
+
+    /**
+     * @brief Adds a timer, or moves it if the id is already present.
+     * @param id The caller's id of the timer.
+     * @param expiry The time at or after which the timer fires.
+     */
+    void insert(TimerId id, TimePoint expiry);
+
+    /**
+     * @brief Removes a timer.
+     * @return True if the timer was pending, false otherwise.
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief Checks whether a timer is pending.
+     */
+    bool contains(TimerId id) const { return positions_.count(id) > 0; }
+
+    /**
+     * @brief Advances the wheel to a time and removes the timers that expired.
+     * @return Ids of the expired timers, earliest first.
+     */
+    std::vector<TimerId> advance(TimePoint now);
+
+    /**
+     * @brief Gets the time the owner should call advance() next: the earliest level-0 expiry, or the
+     * next cascade if only later timers are pending.
+     * @return The time, or std::nullopt if no timer is pending.
+     */
+    std::optional<TimePoint> nextWakeTime() const;
+
+    /**
+     * @brief Gets the number of pending timers.
+     */
+    std::size_t size() const { return positions_.size(); }
+
+private:
+    static constexpr int LEVEL_BITS = 6;
+    static constexpr std::int64_t SLOTS = 1 << LEVEL_BITS; // Slots per level
+    static constexpr int LEVELS = 4;                        // 64^4 ticks, about 19 days at 100 ms
+    static constexpr std::int64_t SLOT_MASK = SLOTS - 1;
+    static constexpr std::int64_t MAX_TICKS_PER_ADVANCE = SLOTS * SLOTS * SLOTS; // Larger jumps rebuild the wheel
+
+    struct Entry {
+        TimerId id;
+        std::int64_t expiryTick;
+    };
+    using Slot = std::list<Entry>;
+
+    struct Position {
+        Slot* slot;
+        Slot::iterator entry;
+    };
+
+    std::int64_t toTick(TimePoint time, bool roundUp) const;
+    TimePoint fromTick(std::int64_t tick) const;
+    void place(Entry entry);             // Puts an entry into the slot for its expiry
+    void cascade(Slot& slot);            // Re-places the entries of a higher-level slot
+    void rebuild(std::int64_t nowTick);  // Re-places every entry after a large jump in time
+
+    std::chrono::milliseconds tick_;
+    std::int64_t currentTick_;
+    Slot levels_[LEVELS][SLOTS];
+    Slot overflow_;                      // Beyond the top level
+    Slot due_;                           // Already expired, returned by the next advance()
+    std::unordered_map<TimerId, Position> positions_;
+};
+
+} // namespace TaskEngine
+} // namespace ERP
+#endif // MODULES_TASKENGINE_TIMERWHEEL_H
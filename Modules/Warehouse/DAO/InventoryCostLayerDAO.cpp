@@ -6,6 +6,7 @@
 #include "DateUtils.h" // Đã rút gọn include
 #include "DAOHelpers.h" // Đã rút gọn include
 #include "DTOUtils.h" // Đã rút gọn include
+#include <algorithm> // For std::min
 #include <sstream>
 #include <stdexcept>
 #include <typeinfo> // For std::bad_any_cast
@@ -19,6 +20,51 @@ InventoryCostLayerDAO::InventoryCostLayerDAO(std::shared_ptr<ERP::Database::Conn
     Logger::Logger::getInstance().info("InventoryCostLayerDAO: Initialized.");
 }
 
+std::vector<ERP::Warehouse::DTO::InventoryCostLayerDTO> InventoryCostLayerDAO::getOpenLayers(
+    const std::string& productId, const std::string& warehouseId, const std::string& locationId) {
+    // Served by idx_inventory_cost_layers_key_remaining
+    ERP::DAOBase::QueryFilter filter;
+    filter.equals("product_id", productId)
+          .equals("warehouse_id", warehouseId)
+          .equals("location_id", locationId)
+          .greaterThan("remaining_quantity", 0.0)
+          .orderBy("receipt_date")
+          .orderBy("id");
+    return find(filter);
+}
+
+bool InventoryCostLayerDAO::updateRemainingQuantities(const std::vector<std::pair<std::string, double>>& remainingByLayerId,
+                                                      const std::string& userId) {
+    const std::string updatedAt = ERP::Utils::DateUtils::formatDateTime(ERP::Utils::DateUtils::now(), ERP::Common::DATETIME_FORMAT);
+    for (std::size_t offset = 0; offset < remainingByLayerId.size(); offset += REMAINING_UPDATE_CHUNK_SIZE) {
+        const std::size_t end = std::min(offset + REMAINING_UPDATE_CHUNK_SIZE, remainingByLayerId.size());
+        // WITH v(id, remaining) AS (VALUES (:id0, :q0), ...) UPDATE ... WHERE id IN (SELECT id FROM v)
+        std::string values;
+        std::map<std::string, std::any> params;
+        for (std::size_t i = offset; i < end; ++i) {
+            const std::string n = std::to_string(i - offset);
+            values += (i == offset ? "(:id" : ", (:id") + n + ", :q" + n + ")";
+            params["id" + n] = remainingByLayerId[i].first;
+            params["q" + n] = remainingByLayerId[i].second;
+        }
+        params["updated_at"] = updatedAt;
+        params["updated_by"] = userId;
+        std::string sql = "WITH v(id, remaining_quantity) AS (VALUES " + values + ")"
+                          " UPDATE " + tableName_ +
+                          " SET remaining_quantity = (SELECT v.remaining_quantity FROM v WHERE v.id = " + tableName_ + ".id),"
+                          " updated_at = :updated_at, updated_by = :updated_by"
+                          " WHERE id IN (SELECT id FROM v);";
+        if (!executeDbOperation(
+                [](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
+                    return conn->execute(sql_l, p_l);
+                },
+                "InventoryCostLayerDAO", "updateRemainingQuantities", sql, params)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // toMap for InventoryCostLayerDTO
 std::map<std::string, std::any> InventoryCostLayerDAO::toMap(const ERP::Warehouse::DTO::InventoryCostLayerDTO& dto) const {
     std::map<std::string, std::any> data = ERP::Utils::DTOUtils::toMap(dto); // Populate BaseDTO fields
@@ -30,6 +76,7 @@ std::map<std::string, std::any> InventoryCostLayerDAO::toMap(const ERP::Warehous
     ERP::DAOHelpers::putOptionalString(data, "serial_number", dto.serialNumber);
     data["quantity"] = dto.quantity;
     data["unit_cost"] = dto.unitCost;
+    data["remaining_quantity"] = dto.remainingQuantity;
     data["receipt_date"] = ERP::Utils::DateUtils::formatDateTime(dto.receiptDate, ERP::Common::DATETIME_FORMAT);
     ERP::DAOHelpers::putOptionalString(data, "reference_transaction_id", dto.referenceTransactionId);
     ERP::DAOHelpers::putOptionalString(data, "reference_document_type", dto.referenceDocumentType);
@@ -51,6 +98,7 @@ ERP::Warehouse::DTO::InventoryCostLayerDTO InventoryCostLayerDAO::fromMap(const
         ERP::DAOHelpers::getOptionalStringValue(data, "serial_number", dto.serialNumber);
         ERP::DAOHelpers::getPlainValue(data, "quantity", dto.quantity);
         ERP::DAOHelpers::getPlainValue(data, "unit_cost", dto.unitCost);
+        ERP::DAOHelpers::getPlainValue(data, "remaining_quantity", dto.remainingQuantity);
         ERP::DAOHelpers::getPlainTimeValue(data, "receipt_date", dto.receiptDate);
         ERP::DAOHelpers::getOptionalStringValue(data, "reference_transaction_id", dto.referenceTransactionId);
         ERP::DAOHelpers::getOptionalStringValue(data, "reference_document_type", dto.referenceDocumentType);
@@ -14,6 +14,7 @@
 #include <map>
 #include <any>
 #include <optional>
+#include <utility> // For std::pair
 
 namespace ERP {
 namespace Warehouse {
@@ -24,6 +25,21 @@ public:
     explicit InventoryCostLayerDAO(std::shared_ptr<ERP::Database::ConnectionPool> connectionPool);
     ~InventoryCostLayerDAO() override = default;
 
+    /**
+     * @brief Gets the layers of a position that still hold quantity, in receipt order (receipt_date, id).
+     */
+    std::vector<ERP::Warehouse::DTO::InventoryCostLayerDTO> getOpenLayers(const std::string& productId,
+                                                                           const std::string& warehouseId,
+                                                                           const std::string& locationId);
+
+    /**
+     * @brief Writes the remaining quantity of many layers with one UPDATE per chunk of REMAINING_UPDATE_CHUNK_SIZE layers.
+     * @param remainingByLayerId Pairs of layer id and new remaining quantity.
+     * @param userId The user recorded as updated_by.
+     * @return True if every layer was updated, false otherwise.
+     */
+    bool updateRemainingQuantities(const std::vector<std::pair<std::string, double>>& remainingByLayerId, const std::string& userId);
+
     // Override toMap and fromMap for InventoryCostLayerDTO (handled by DAOBase template)
 protected:
     std::map<std::string, std::any> toMap(const ERP::Warehouse::DTO::InventoryCostLayerDTO& dto) const override;
@@ -31,6 +47,7 @@ protected:
 
 private:
     // tableName_ is now a member of DAOBase
+    static constexpr std::size_t REMAINING_UPDATE_CHUNK_SIZE = 400; // Two parameters per layer, below SQLite's bound-parameter limit
 };
 
 } // namespace DAOs
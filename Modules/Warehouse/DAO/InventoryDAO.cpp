@@ -9,6 +9,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <typeinfo> // For std::bad_any_cast
+#include <algorithm> // For std::min
 
 namespace ERP {
 namespace Warehouse {
@@ -19,6 +20,126 @@ InventoryDAO::InventoryDAO(std::shared_ptr<ERP::Database::ConnectionPool> connec
     Logger::Logger::getInstance().info("InventoryDAO: Initialized.");
 }
 
+std::optional<std::size_t> InventoryDAO::applyQuantityDeltas(const std::vector<InventoryQuantityDelta>& deltas, const std::string& userId) {
+    const std::string updatedAt = ERP::Utils::DateUtils::formatDateTime(ERP::Utils::DateUtils::now(), ERP::Common::DATETIME_FORMAT);
+    const auto column = [this](const std::string& name) {
+        return "(SELECT v." + name + " FROM v WHERE v.id = " + tableName_ + ".id)";
+    };
+    std::size_t applied = 0;
+    for (std::size_t offset = 0; offset < deltas.size(); offset += DELTA_UPDATE_CHUNK_SIZE) {
+        const std::size_t end = std::min(offset + DELTA_UPDATE_CHUNK_SIZE, deltas.size());
+        std::string values;
+        std::map<std::string, std::any> params;
+        for (std::size_t i = offset; i < end; ++i) {
+            const std::string n = std::to_string(i - offset);
+            values += (i == offset ? "(:id" : ", (:id") + n + ", :d" + n + ", :rq" + n + ", :rv" + n + ")";
+            params["id" + n] = deltas[i].inventoryId;
+            params["d" + n] = deltas[i].quantityDelta;
+            params["rq" + n] = deltas[i].receivedQuantity;
+            params["rv" + n] = deltas[i].receivedValue;
+        }
+        params["updated_at"] = updatedAt;
+        params["updated_by"] = userId;
+        // Every SET expression reads the row as it was before this UPDATE
+        std::string sql = "WITH v(id, quantity_delta, received_quantity, received_value) AS (VALUES " + values + ")"
+                          " UPDATE " + tableName_ + " SET"
+                          " unit_cost = CASE WHEN quantity + " + column("received_quantity") + " > 0"
+                          " THEN (quantity * COALESCE(unit_cost, 0) + " + column("received_value") + ") / (quantity + " + column("received_quantity") + ")"
+                          " ELSE unit_cost END,"
+                          " quantity = quantity + " + column("quantity_delta") + ","
+                          " available_quantity = quantity + " + column("quantity_delta") + " - COALESCE(reserved_quantity, 0),"
+                          " updated_at = :updated_at, updated_by = :updated_by"
+                          " WHERE id IN (SELECT v.id FROM v WHERE v.id = " + tableName_ + ".id"
+                          " AND (v.quantity_delta >= 0 OR quantity >= -v.quantity_delta));";
+        long long changed = 0;
+        if (!executeDbOperation(
+                [&changed](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
+                    if (!conn->execute(sql_l, p_l)) {
+                        return false;
+                    }
+                    ERP::Database::ResultSet changes = conn->queryResultSet("SELECT changes();");
+                    changed = changes.empty() ? 0 : changes.getInt64(0, 0).value_or(0);
+                    return true;
+                },
+                "InventoryDAO", "applyQuantityDeltas", sql, params)) {
+            return std::nullopt;
+        }
+        applied += static_cast<std::size_t>(changed);
+    }
+    return applied;
+}
+
+bool InventoryDAO::updateDetails(const ERP::Warehouse::DTO::InventoryDTO& dto, const std::string& userId) {
+    const std::map<std::string, std::any> row = toMap(dto);
+    std::map<std::string, std::any> params;
+    std::string assignments;
+    for (const char* column : { "lot_number", "serial_number", "manufacture_date", "expiration_date", "reorder_level", "reorder_quantity", "status" }) {
+        assignments += std::string(column) + " = :" + column + ", ";
+        params[column] = row.at(column);
+    }
+    params["id"] = dto.id;
+    params["updated_at"] = ERP::Utils::DateUtils::formatDateTime(ERP::Utils::DateUtils::now(), ERP::Common::DATETIME_FORMAT);
+    params["updated_by"] = userId;
+    std::string sql = "UPDATE " + tableName_ + " SET " + assignments + "updated_at = :updated_at, updated_by = :updated_by WHERE id = :id;";
+    long long changed = 0;
+    if (!executeDbOperation(
+            [&changed](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
+                if (!conn->execute(sql_l, p_l)) {
+                    return false;
+                }
+                ERP::Database::ResultSet changes = conn->queryResultSet("SELECT changes();");
+                changed = changes.empty() ? 0 : changes.getInt64(0, 0).value_or(0);
+                return true;
+            },
+            "InventoryDAO", "updateDetails", sql, params)) {
+        return false;
+    }
+    return changed == 1;
+}
+
+std::optional<std::size_t> InventoryDAO::applyReservationDeltas(const std::vector<InventoryReservationDelta>& deltas, const std::string& userId) {
+    const std::string updatedAt = ERP::Utils::DateUtils::formatDateTime(ERP::Utils::DateUtils::now(), ERP::Common::DATETIME_FORMAT);
+    const std::string delta = "(SELECT v.reserved_delta FROM v WHERE v.id = " + tableName_ + ".id)";
+    std::size_t applied = 0;
+    for (std::size_t offset = 0; offset < deltas.size(); offset += RESERVATION_UPDATE_CHUNK_SIZE) {
+        const std::size_t end = std::min(offset + RESERVATION_UPDATE_CHUNK_SIZE, deltas.size());
+        std::string values;
+        std::map<std::string, std::any> params;
+        for (std::size_t i = offset; i < end; ++i) {
+            const std::string n = std::to_string(i - offset);
+            values += (i == offset ? "(:id" : ", (:id") + n + ", :d" + n + ")";
+            params["id" + n] = deltas[i].inventoryId;
+            params["d" + n] = deltas[i].reservedDelta;
+        }
+        params["updated_at"] = updatedAt;
+        params["updated_by"] = userId;
+        // Available is derived from quantity and reserved_quantity, as the row is at the time of the write
+        std::string sql = "WITH v(id, reserved_delta) AS (VALUES " + values + ")"
+                          " UPDATE " + tableName_ + " SET"
+                          " reserved_quantity = COALESCE(reserved_quantity, 0) + " + delta + ","
+                          " available_quantity = quantity - COALESCE(reserved_quantity, 0) - " + delta + ","
+                          " updated_at = :updated_at, updated_by = :updated_by"
+                          " WHERE id IN (SELECT v.id FROM v WHERE v.id = " + tableName_ + ".id"
+                          " AND (v.reserved_delta <= 0 OR quantity - COALESCE(reserved_quantity, 0) >= v.reserved_delta)"
+                          " AND (v.reserved_delta >= 0 OR COALESCE(reserved_quantity, 0) >= -v.reserved_delta));";
+        long long changed = 0;
+        if (!executeDbOperation(
+                [&changed](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
+                    if (!conn->execute(sql_l, p_l)) {
+                        return false;
+                    }
+                    ERP::Database::ResultSet changes = conn->queryResultSet("SELECT changes();");
+                    changed = changes.empty() ? 0 : changes.getInt64(0, 0).value_or(0);
+                    return true;
+                },
+                "InventoryDAO", "applyReservationDeltas", sql, params)) {
+            return std::nullopt;
+        }
+        applied += static_cast<std::size_t>(changed);
+    }
+    return applied;
+}
+
 // toMap for InventoryDTO
 std::map<std::string, std::any> InventoryDAO::toMap(const ERP::Warehouse::DTO::InventoryDTO& dto) const {
     std::map<std::string, std::any> data = ERP::Utils::DTOUtils::toMap(dto); // Populate BaseDTO fields
@@ -69,6 +190,27 @@ ERP::Warehouse::DTO::InventoryDTO InventoryDAO::fromMap(const std::map<std::stri
     return dto;
 }
 
+// Typed column binding for InventoryDTO (mirrors fromMap)
+const ERP::DAOBase::ColumnBinding<ERP::Warehouse::DTO::InventoryDTO>* InventoryDAO::columnBinding() const {
+    using ERP::Warehouse::DTO::InventoryDTO;
+    static const ERP::DAOBase::ColumnBinding<InventoryDTO> binding = ERP::DAOBase::ColumnBinding<InventoryDTO>()
+        .bindBaseFields()
+        .bind("product_id", &InventoryDTO::productId)
+        .bind("warehouse_id", &InventoryDTO::warehouseId)
+        .bind("location_id", &InventoryDTO::locationId)
+        .bind("quantity", &InventoryDTO::quantity)
+        .bind("reserved_quantity", &InventoryDTO::reservedQuantity)
+        .bind("available_quantity", &InventoryDTO::availableQuantity)
+        .bind("unit_cost", &InventoryDTO::unitCost)
+        .bind("lot_number", &InventoryDTO::lotNumber)
+        .bind("serial_number", &InventoryDTO::serialNumber)
+        .bind("manufacture_date", &InventoryDTO::manufactureDate)
+        .bind("expiration_date", &InventoryDTO::expirationDate)
+        .bind("reorder_level", &InventoryDTO::reorderLevel)
+        .bind("reorder_quantity", &InventoryDTO::reorderQuantity);
+    return &binding;
+}
+
 } // namespace DAOs
 } // namespace Warehouse
 } // namespace ERP
\ No newline at end of file
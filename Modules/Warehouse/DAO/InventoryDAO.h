@@ -19,18 +19,72 @@ namespace ERP {
 namespace Warehouse {
 namespace DAOs {
 
+/**
+ * @brief Net change of one inventory row, applied by InventoryDAO::applyQuantityDeltas.
+ */
+struct InventoryQuantityDelta {
+    std::string inventoryId;
+    double quantityDelta = 0.0;    // Received minus issued quantity
+    double receivedQuantity = 0.0; // Quantity received at receivedValue (enters the average unit cost)
+    double receivedValue = 0.0;    // Sum of quantity * unit cost of the receipts
+};
+
+/**
+ * @brief Change of the reserved quantity of one inventory row, applied by InventoryDAO::applyReservationDeltas.
+ */
+struct InventoryReservationDelta {
+    std::string inventoryId;
+    double reservedDelta = 0.0; // Positive reserves, negative releases
+};
+
 class InventoryDAO : public ERP::DAOBase::DAOBase<ERP::Warehouse::DTO::InventoryDTO> {
 public:
     explicit InventoryDAO(std::shared_ptr<ERP::Database::ConnectionPool> connectionPool);
     ~InventoryDAO() override = default;
 
+    /**
+     * @brief Adds quantity deltas to many rows with one UPDATE per chunk, relative to the stored values.
+     * Receipts are averaged into unit_cost and available_quantity is recomputed. A negative delta is applied
+     * only if the row still holds that much; the check and the write are one statement. Each row may appear once.
+     * @param deltas One entry per row.
+     * @param userId The user recorded as updated_by.
+     * @return The number of rows whose delta was applied (less than deltas.size() if a row held too little),
+     * or std::nullopt on a database error.
+     */
+    std::optional<std::size_t> applyQuantityDeltas(const std::vector<InventoryQuantityDelta>& deltas, const std::string& userId);
+
+    /**
+     * @brief Updates the descriptive columns of a row (lot, serial, dates, reorder settings, status).
+     * Quantities and unit cost are left to the delta updates, so a stale DTO cannot overwrite them.
+     * @param dto The row; only the columns above are written.
+     * @param userId The user recorded as updated_by.
+     * @return True if the row was updated, false if it does not exist or the update failed.
+     */
+    bool updateDetails(const ERP::Warehouse::DTO::InventoryDTO& dto, const std::string& userId);
+
+    /**
+     * @brief Adds reservation deltas to many rows as conditional UPDATEs, one per chunk, relative to the stored values.
+     * A positive delta is applied only if the row has that much available (quantity - reserved_quantity), a
+     * negative one only if that much is reserved; the check and the write are one statement, so concurrent
+     * reservations cannot both take the last units. Each row may appear once.
+     * @param deltas One entry per row.
+     * @param userId The user recorded as updated_by.
+     * @return The number of rows whose delta was applied (less than deltas.size() if a condition failed),
+     * or std::nullopt on a database error.
+     */
+    std::optional<std::size_t> applyReservationDeltas(const std::vector<InventoryReservationDelta>& deltas, const std::string& userId);
+
     // Override toMap and fromMap for InventoryDTO (handled by DAOBase template)
 protected:
     std::map<std::string, std::any> toMap(const ERP::Warehouse::DTO::InventoryDTO& dto) const override;
     ERP::Warehouse::DTO::InventoryDTO fromMap(const std::map<std::string, std::any>& data) const override;
+    // Typed column binding so large inventory loads skip the per-row map
+    const ERP::DAOBase::ColumnBinding<ERP::Warehouse::DTO::InventoryDTO>* columnBinding() const override;
 
 private:
     // tableName_ is now a member of DAOBase
+    static constexpr std::size_t DELTA_UPDATE_CHUNK_SIZE = 200; // Four parameters per row, below SQLite's bound-parameter limit
+    static constexpr std::size_t RESERVATION_UPDATE_CHUNK_SIZE = 400; // Two parameters per row
 };
 
 } // namespace DAOs
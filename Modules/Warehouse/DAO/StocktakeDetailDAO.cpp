@@ -6,6 +6,7 @@
 #include "Common.h"         // Standard includes
 #include "DateUtils.h"      // Standard includes
 #include "DTOUtils.h"       // For BaseDTO conversions
+#include <algorithm>        // For std::min
 
 namespace ERP {
     namespace Warehouse {
@@ -119,6 +120,45 @@ namespace ERP {
                 return success;
             }
 
+            bool StocktakeDetailDAO::updateReconciliationResults(const std::vector<ERP::Warehouse::DTO::StocktakeDetailDTO>& details, const std::string& userId) {
+                const std::string updatedAt = ERP::Utils::DateUtils::formatDateTime(ERP::Utils::DateUtils::now(), ERP::Common::DATETIME_FORMAT);
+                for (std::size_t offset = 0; offset < details.size(); offset += RECONCILIATION_UPDATE_CHUNK_SIZE) {
+                    const std::size_t end = std::min(offset + RECONCILIATION_UPDATE_CHUNK_SIZE, details.size());
+                    // WITH v(id, system_quantity, difference, adjustment_transaction_id) AS (VALUES ...) UPDATE ... WHERE id IN (SELECT id FROM v)
+                    std::string values;
+                    std::map<std::string, std::any> params;
+                    for (std::size_t i = offset; i < end; ++i) {
+                        const std::string n = std::to_string(i - offset);
+                        // Lines that matched the system quantity have no adjustment: a literal NULL, nothing to bind
+                        values += (i == offset ? "(:id" : ", (:id") + n + ", :sq" + n + ", :d" + n +
+                                  (details[i].adjustmentTransactionId ? ", :t" + n + ")" : ", NULL)");
+                        params["id" + n] = details[i].id;
+                        params["sq" + n] = details[i].systemQuantity;
+                        params["d" + n] = details[i].difference;
+                        if (details[i].adjustmentTransactionId) {
+                            params["t" + n] = *details[i].adjustmentTransactionId;
+                        }
+                    }
+                    params["updated_at"] = updatedAt;
+                    params["updated_by"] = userId;
+                    std::string sql = "WITH v(id, system_quantity, difference, adjustment_transaction_id) AS (VALUES " + values + ")"
+                                      " UPDATE " + tableName_ +
+                                      " SET system_quantity = (SELECT v.system_quantity FROM v WHERE v.id = " + tableName_ + ".id),"
+                                      " difference = (SELECT v.difference FROM v WHERE v.id = " + tableName_ + ".id),"
+                                      " adjustment_transaction_id = (SELECT v.adjustment_transaction_id FROM v WHERE v.id = " + tableName_ + ".id),"
+                                      " updated_at = :updated_at, updated_by = :updated_by"
+                                      " WHERE id IN (SELECT id FROM v);";
+                    if (!executeDbOperation(
+                            [](std::shared_ptr<ERP::Database::DBConnection> conn, const std::string& sql_l, const std::map<std::string, std::any>& p_l) {
+                                return conn->execute(sql_l, p_l);
+                            },
+                            "StocktakeDetailDAO", "updateReconciliationResults", sql, params)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
         } // namespace DAOs
     } // namespace Warehouse
 } // namespace ERP
\ No newline at end of file
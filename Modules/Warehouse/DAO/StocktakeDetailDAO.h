@@ -62,6 +62,15 @@ namespace ERP {
                  */
                 bool removeStocktakeDetailsByRequestId(const std::string& stocktakeRequestId);
 
+                /**
+                 * @brief Writes the reconciliation result (system quantity, difference, adjustment transaction) of many details
+                 * with one UPDATE per chunk of RECONCILIATION_UPDATE_CHUNK_SIZE details.
+                 * @param details The reconciled details.
+                 * @param userId The user recorded as updated_by.
+                 * @return true if every detail was updated, false otherwise.
+                 */
+                bool updateReconciliationResults(const std::vector<ERP::Warehouse::DTO::StocktakeDetailDTO>& details, const std::string& userId);
+
             protected:
                 // Required overrides for mapping between DTO and std::map<string, any>
                 std::map<std::string, std::any> toMap(const ERP::Warehouse::DTO::StocktakeDetailDTO& detail) const override;
@@ -69,6 +78,7 @@ namespace ERP {
 
             private:
                 std::string tableName_ = "stocktake_details";
+                static constexpr std::size_t RECONCILIATION_UPDATE_CHUNK_SIZE = 200; // Four parameters per detail, below SQLite's bound-parameter limit
             };
 
         } // namespace DAOs
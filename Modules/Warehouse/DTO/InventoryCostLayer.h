@@ -23,12 +23,13 @@ namespace ERP {
                 std::optional<std::string> serialNumber;// Serial number (if applicable)
                 double quantity;            // Quantity in this cost layer
                 double unitCost;            // Unit cost for this layer
+                double remainingQuantity;   // Quantity of this layer not yet issued
                 std::chrono::system_clock::time_point receiptDate; // Date when this layer was received
                 std::optional<std::string> referenceTransactionId; // Link to the InventoryTransaction (e.g., Goods Receipt)
                 std::optional<std::string> referenceDocumentType; // Type of document (e.g., "PurchaseOrder", "ProductionOrder")
                 std::optional<std::string> referenceDocumentNumber; // Number of the document
 
-                InventoryCostLayerDTO() : quantity(0.0), unitCost(0.0) {} // Default constructor
+                InventoryCostLayerDTO() : quantity(0.0), unitCost(0.0), remainingQuantity(0.0) {} // Default constructor
                 virtual ~InventoryCostLayerDTO() = default;
             };
         } // namespace DTO
@@ -12,11 +12,32 @@
 #include "Inventory.h"          // Inventory DTO
 #include "InventoryTransaction.h" // InventoryTransaction DTO
 #include "InventoryCostLayer.h" // InventoryCostLayer DTO
+#include "DAOBase/Paging.h"     // PageRequest, Page
+#include "InventoryPositionCache.h" // InventoryPositionCacheStats
 
 namespace ERP {
 namespace Warehouse {
 namespace Services {
 
+/**
+ * @brief Identifies an inventory position, used by getInventoryByKeys.
+ */
+struct InventoryPositionKey {
+    std::string productId;
+    std::string warehouseId;
+    std::string locationId;
+};
+
+/**
+ * @brief One line of a batch reservation, e.g. a line of a sales order.
+ */
+struct InventoryReservationRequest {
+    std::string productId;
+    std::string warehouseId;
+    std::string locationId;
+    double quantity = 0.0;
+};
+
 /**
  * @brief IInventoryManagementService interface defines operations for managing inventory levels and movements.
  */
@@ -56,6 +77,18 @@ public:
         const std::string& warehouseId,
         const std::string& locationId,
         const std::vector<std::string>& userRoleIds = {}) = 0;
+    /**
+     * @brief Retrieves the inventory of many positions with one permission check. Positions held in the
+     * position cache are answered from memory; the others are read with one product_id IN (...) query per chunk.
+     * @param keys The positions (duplicates allowed).
+     * @param currentUserId ID of the user performing the operation.
+     * @param userRoleIds Roles of the user performing the operation.
+     * @return The rows found, in no particular order; positions without a row are skipped.
+     */
+    virtual std::vector<ERP::Warehouse::DTO::InventoryDTO> getInventoryByKeys(
+        const std::vector<InventoryPositionKey>& keys,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds) = 0;
     /**
      * @brief Retrieves all inventory records or records matching a filter.
      * @param filter Map of filter conditions.
@@ -65,6 +98,19 @@ public:
     virtual std::vector<ERP::Warehouse::DTO::InventoryDTO> getAllInventory(
         const std::map<std::string, std::any>& filter = {},
         const std::vector<std::string>& userRoleIds = {}) = 0;
+    /**
+     * @brief Retrieves one page of inventory records (keyset pagination on created_at, id).
+     * @param filter Map of filter conditions.
+     * @param pageRequest Page size, cursor and optional column projection.
+     * @param currentUserId ID of the user performing the operation.
+     * @param userRoleIds Roles of the user performing the operation.
+     * @return The page of InventoryDTOs and the cursor for the next one.
+     */
+    virtual ERP::DAOBase::Page<ERP::Warehouse::DTO::InventoryDTO> getInventoryPage(
+        const std::map<std::string, std::any>& filter,
+        const ERP::DAOBase::PageRequest& pageRequest,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds = {}) = 0;
     /**
      * @brief Retrieves all inventory records for a specific product across all warehouses/locations.
      * @param productId ID of the product.
@@ -76,6 +122,7 @@ public:
         const std::vector<std::string>& userRoleIds = {}) = 0;
     /**
      * @brief Updates inventory information (e.g., reorder levels).
+     * Quantities and unit cost are not written; they change only through receipts, issues, adjustments and reservations.
      * @param inventoryDTO DTO containing updated inventory information (must have ID).
      * @param currentUserId ID of the user performing the operation.
      * @param userRoleIds Roles of the user performing the operation.
@@ -121,9 +168,25 @@ public:
         const ERP::Warehouse::DTO::InventoryTransactionDTO& transactionDTO,
         const std::string& currentUserId,
         const std::vector<std::string>& userRoleIds) = 0;
+    /**
+     * @brief Records many goods receipts, goods issues and adjustments (e.g., a receipt slip or an EDI import) in one transaction.
+     * Lines are grouped by (product, warehouse, location); within a position, receipts are applied before issues.
+     * Permissions and referenced products, warehouses and locations are checked once per batch, rows are
+     * written with multi-row statements, and one summarized audit record is written. A line whose id is set
+     * keeps it as its transaction id.
+     * @param transactionDTOs Lines of type GOODS_RECEIPT, GOODS_ISSUE, ADJUSTMENT_IN or ADJUSTMENT_OUT.
+     * @param currentUserId ID of the user performing the operation.
+     * @param userRoleIds Roles of the user performing the operation.
+     * @return true if every line is recorded, false otherwise (nothing is recorded).
+     */
+    virtual bool recordInventoryMovements(
+        const std::vector<ERP::Warehouse::DTO::InventoryTransactionDTO>& transactionDTOs,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds) = 0;
     /**
      * @brief Reserves a specified quantity of a product in inventory.
-     * Decreases available quantity and increases reserved quantity.
+     * Decreases available quantity and increases reserved quantity. The check and the write are one conditional
+     * UPDATE, so concurrent reservations of the same row cannot oversell it.
      * @param productId ID of the product.
      * @param warehouseId ID of the warehouse.
      * @param locationId ID of the location.
@@ -139,6 +202,18 @@ public:
         double quantityToReserve,
         const std::string& currentUserId,
         const std::vector<std::string>& userRoleIds) = 0;
+    /**
+     * @brief Reserves many lines (e.g., a whole sales order) in one transaction: all of them or none.
+     * Lines of the same position are merged and every position is reserved with conditional UPDATEs.
+     * @param reservations The lines to reserve.
+     * @param currentUserId ID of the user performing the operation.
+     * @param userRoleIds Roles of the user performing the operation.
+     * @return true if every line is reserved, false otherwise (nothing is reserved).
+     */
+    virtual bool reserveMany(
+        const std::vector<InventoryReservationRequest>& reservations,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds) = 0;
     /**
      * @brief Unreserves a specified quantity of a product in inventory.
      * Increases available quantity and decreases reserved quantity.
@@ -222,15 +297,20 @@ public:
      * @param quantityToConsume Quantity to consume from layers.
      * @param currentUserId ID of the user performing the operation.
      * @param userRoleIds Roles of the user.
-     * @return true if successful, false otherwise.
+     * @return The cost of goods issued if successful, std::nullopt otherwise.
      */
-    virtual bool consumeInventoryCostLayers(
+    virtual std::optional<double> consumeInventoryCostLayers(
         const std::string& productId,
         const std::string& warehouseId,
         const std::string& locationId,
         double quantityToConsume,
         const std::string& currentUserId,
         const std::vector<std::string>& userRoleIds) = 0;
+    /**
+     * @brief Gets the hit/miss counters of each shard of the inventory position cache.
+     * @return One entry per shard.
+     */
+    virtual std::vector<InventoryPositionCacheStats> getPositionCacheStats() const = 0;
 };
 
 } // namespace Services
@@ -6,6 +6,8 @@
 #include <optional>
 #include <map>    // For std::map<std::string, std::any>
 #include <chrono> // For std::chrono::system_clock::time_point
+#include <functional> // For std::function (reconciliation progress)
+#include <future>     // For std::future (asynchronous reconciliation)
 
 // Rút gọn các include paths
 #include "BaseService.h"        // Base Service
@@ -16,6 +18,30 @@ namespace ERP {
     namespace Warehouse {
         namespace Services {
 
+            /**
+             * @brief Enum định nghĩa giai đoạn của một lần đối chiếu kiểm kê.
+             */
+            enum class StocktakeReconciliationPhase {
+                LOADING = 0,   /**< Đọc chi tiết kiểm kê và ảnh chụp tồn kho */
+                DIFFING = 1,   /**< So sánh số lượng đã đếm với tồn kho */
+                APPLYING = 2,  /**< Ghi các giao dịch điều chỉnh */
+                COMPLETED = 3, /**< Đã đối chiếu */
+                FAILED = 4     /**< Đối chiếu thất bại, không có thay đổi nào được ghi */
+            };
+
+            /**
+             * @brief Progress of a stocktake reconciliation, reported to the caller's callback.
+             */
+            struct StocktakeReconciliationProgress {
+                std::string requestId;
+                StocktakeReconciliationPhase phase = StocktakeReconciliationPhase::LOADING;
+                std::size_t processedLines = 0;  /**< Detail lines diffed so far */
+                std::size_t totalLines = 0;      /**< Detail lines of the request */
+                std::size_t adjustmentLines = 0; /**< Lines with a difference, i.e. adjustment transactions */
+            };
+
+            using StocktakeReconciliationProgressCallback = std::function<void(const StocktakeReconciliationProgress&)>;
+
             /**
              * @brief IStocktakeService interface defines operations for managing stocktake requests.
              */
@@ -140,15 +166,29 @@ namespace ERP {
                     const std::vector<std::string>& userRoleIds) = 0;
                 /**
                  * @brief Reconciles a completed stocktake request, posting inventory adjustments based on differences.
+                 * The counted quantities are diffed in one pass against a snapshot of the inventory read in the same
+                 * transaction, and all adjustments are posted as one batch of inventory movements.
                  * @param requestId ID of the stocktake request to reconcile.
                  * @param currentUserId ID of the user performing the operation.
                  * @param userRoleIds Roles of the user performing the operation.
+                 * @param onProgress Optional: called at each phase and every few hundred diffed lines.
                  * @return true if reconciliation is successful, false otherwise.
                  */
                 virtual bool reconcileStocktake(
                     const std::string& requestId,
                     const std::string& currentUserId,
-                    const std::vector<std::string>& userRoleIds) = 0;
+                    const std::vector<std::string>& userRoleIds,
+                    const StocktakeReconciliationProgressCallback& onProgress = {}) = 0;
+                /**
+                 * @brief Runs reconcileStocktake() as a task of the TaskEngine.
+                 * @param onProgress Optional: called on the worker thread running the reconciliation.
+                 * @return A future holding the result of reconcileStocktake().
+                 */
+                virtual std::future<bool> reconcileStocktakeAsync(
+                    const std::string& requestId,
+                    const std::string& currentUserId,
+                    const std::vector<std::string>& userRoleIds,
+                    StocktakeReconciliationProgressCallback onProgress = {}) = 0;
             };
 
         } // namespace Services
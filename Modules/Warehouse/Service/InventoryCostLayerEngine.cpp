@@ -0,0 +1,363 @@
+// Modules/Warehouse/Service/InventoryCostLayerEngine.cpp
+#include "InventoryCostLayerEngine.h" // Standard includes
+#include "UnitOfWork.h"               // Transaction hooks
+#include "Logger.h"                   // Logger
+#include "ErrorHandler.h"             // ErrorHandler
+#include "Common.h"                   // ErrorCode
+#include <algorithm>                  // For std::lower_bound, std::min, std::max
+#include <condition_variable>
+#include <deque>
+#include <unordered_set>
+#include <utility>                    // For std::pair
+
+namespace ERP {
+namespace Warehouse {
+namespace Services {
+
+namespace {
+constexpr double QUANTITY_EPSILON = 1e-9;
+
+std::string positionKey(const std::string& productId, const std::string& warehouseId, const std::string& locationId) {
+    return productId + '\x1f' + warehouseId + '\x1f' + locationId;
+}
+
+bool receivedBefore(const ERP::Warehouse::DTO::InventoryCostLayerDTO& a, const ERP::Warehouse::DTO::InventoryCostLayerDTO& b) {
+    return a.receiptDate != b.receiptDate ? a.receiptDate < b.receiptDate : a.id < b.id;
+}
+} // namespace
+
+/**
+ * @brief The open layers of one position. A layer covers [qtyStart, qtyEnd) on the running-quantity
+ * axis and its running cost starts at costStart; only the window [low, high) is still on hand.
+ */
+struct InventoryCostLayerEngine::LayerStack {
+    struct Entry {
+        ERP::Warehouse::DTO::InventoryCostLayerDTO layer;
+        double qtyStart = 0.0;
+        double qtyEnd = 0.0;
+        double costStart = 0.0;
+    };
+
+    std::mutex mutex;
+    std::condition_variable released;
+    const ERP::Database::DBConnection* owner = nullptr; // Transaction holding the position
+    bool loaded = false;
+    std::unordered_set<std::string> loadedIds; // Layers read by the owner's load; addLayer skips them
+
+    std::deque<Entry> entries; // Receipt order
+    double low = 0.0;
+    double high = 0.0;
+
+    bool hasDirty = false;     // [dirtyLow, dirtyHigh) was consumed in the owning transaction
+    double dirtyLow = 0.0;
+    double dirtyHigh = 0.0;
+    std::vector<std::string> retiredIds; // Popped layers, persisted with remaining 0
+
+    // First entry whose range ends at or after x
+    std::size_t indexAt(double x) const {
+        auto it = std::lower_bound(entries.begin(), entries.end(), x,
+                                   [](const Entry& entry, double value) { return entry.qtyEnd < value; });
+        return std::min<std::size_t>(static_cast<std::size_t>(it - entries.begin()), entries.size() - 1);
+    }
+
+    // Running cost at x, for x inside the window
+    double costAt(double x) const {
+        const Entry& entry = entries[indexAt(x)];
+        return entry.costStart + (x - entry.qtyStart) * entry.layer.unitCost;
+    }
+
+    double remainingOf(const Entry& entry) const {
+        return std::max(0.0, std::min(high, entry.qtyEnd) - std::max(low, entry.qtyStart));
+    }
+
+    void markDirty(double from, double to) {
+        dirtyLow = hasDirty ? std::min(dirtyLow, from) : from;
+        dirtyHigh = hasDirty ? std::max(dirtyHigh, to) : to;
+        hasDirty = true;
+    }
+
+    std::vector<double> remainingQuantities() const {
+        std::vector<double> remaining;
+        remaining.reserve(entries.size());
+        for (const Entry& entry : entries) {
+            remaining.push_back(remainingOf(entry));
+        }
+        return remaining;
+    }
+
+    // Lays the entries out again from 0, remaining[i] being what entries[i] still holds
+    void layOut(const std::vector<double>& remaining) {
+        double quantity = 0.0;
+        double cost = 0.0;
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            entries[i].qtyStart = quantity;
+            entries[i].costStart = cost;
+            quantity += remaining[i];
+            cost += remaining[i] * entries[i].layer.unitCost;
+            entries[i].qtyEnd = quantity;
+        }
+        const bool wasDirty = hasDirty;
+        low = 0.0;
+        high = quantity;
+        hasDirty = false;
+        if (wasDirty) {
+            markDirty(low, high); // The old coordinates are gone; write every layer
+        }
+    }
+
+    void unload() {
+        entries.clear();
+        retiredIds.clear();
+        loadedIds.clear();
+        low = high = 0.0;
+        hasDirty = false;
+        loaded = false;
+    }
+};
+
+InventoryCostLayerEngine::InventoryCostLayerEngine(std::shared_ptr<DAOs::InventoryCostLayerDAO> inventoryCostLayerDAO,
+                                                   CostingMethod costingMethod,
+                                                   std::chrono::milliseconds lockTimeout)
+    : inventoryCostLayerDAO_(std::move(inventoryCostLayerDAO)),
+      costingMethod_(costingMethod),
+      lockTimeout_(lockTimeout) {
+    if (!inventoryCostLayerDAO_) {
+        ERP::Logger::Logger::getInstance().critical("Initialized with null InventoryCostLayerDAO.", "InventoryCostLayerEngine");
+        throw std::runtime_error("InventoryCostLayerEngine: InventoryCostLayerDAO is null.");
+    }
+}
+
+InventoryCostLayerEngine::~InventoryCostLayerEngine() = default;
+
+std::shared_ptr<InventoryCostLayerEngine::LayerStack> InventoryCostLayerEngine::acquire(
+    const std::string& productId, const std::string& warehouseId, const std::string& locationId,
+    std::unique_lock<std::mutex>& lock) {
+    const std::shared_ptr<ERP::Database::DBConnection> transaction = ERP::Database::UnitOfWork::current();
+    if (!transaction) {
+        ERP::Logger::Logger::getInstance().error("Cost layers can only change inside a unit of work.", "InventoryCostLayerEngine");
+        return nullptr;
+    }
+
+    std::shared_ptr<LayerStack> stack;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        std::shared_ptr<LayerStack>& slot = stacks_[positionKey(productId, warehouseId, locationId)];
+        if (!slot) {
+            slot = std::make_shared<LayerStack>();
+        }
+        stack = slot;
+    }
+
+    lock = std::unique_lock<std::mutex>(stack->mutex);
+    if (!stack->released.wait_for(lock, lockTimeout_, [&] { return !stack->owner || stack->owner == transaction.get(); })) {
+        lock.unlock();
+        ERP::Logger::Logger::getInstance().warning("Cost layers of product " + productId + " at " + warehouseId + "/" + locationId +
+                                                   " stayed held by another transaction.", "InventoryCostLayerEngine");
+        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::OperationFailed, "Lớp chi phí tồn kho đang được giao dịch khác xử lý. Vui lòng thử lại.");
+        return nullptr;
+    }
+
+    if (!stack->owner) {
+        stack->owner = transaction.get();
+        const ERP::Database::DBConnection* key = transaction.get();
+        bool firstStack = false;
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            auto [it, inserted] = touched_.try_emplace(key);
+            it->second.stacks.push_back(stack);
+            firstStack = inserted;
+        }
+        if (firstStack) {
+            ERP::Database::UnitOfWork::runBeforeCommit([this, key]() { return flush(key); });
+            ERP::Database::UnitOfWork::runAfterCommit([this, key]() { release(key, true); });
+            ERP::Database::UnitOfWork::runAfterRollback([this, key]() { release(key, false); });
+        }
+    }
+
+    if (!stack->loaded) {
+        // Read on the transaction's connection, so layers it inserted are included
+        std::vector<double> remaining;
+        for (const auto& layer : inventoryCostLayerDAO_->getOpenLayers(productId, warehouseId, locationId)) {
+            LayerStack::Entry entry;
+            entry.layer = layer;
+            stack->loadedIds.insert(layer.id);
+            stack->entries.push_back(std::move(entry));
+            remaining.push_back(layer.remainingQuantity);
+        }
+        stack->layOut(remaining);
+        stack->loaded = true;
+        ERP_LOG_DEBUG("Loaded " + std::to_string(stack->entries.size()) + " open cost layers of product " + productId +
+                      " at " + warehouseId + "/" + locationId + ".", "InventoryCostLayerEngine");
+    }
+    return stack;
+}
+
+bool InventoryCostLayerEngine::addLayer(const ERP::Warehouse::DTO::InventoryCostLayerDTO& layer) {
+    if (layer.remainingQuantity <= QUANTITY_EPSILON) {
+        return true;
+    }
+    std::unique_lock<std::mutex> lock;
+    std::shared_ptr<LayerStack> stack = acquire(layer.productId, layer.warehouseId, layer.locationId, lock);
+    if (!stack) {
+        return false;
+    }
+    if (stack->loadedIds.count(layer.id) > 0) {
+        // The load ran on this transaction's connection after the insert, so the row is already there.
+        // This holds for every row of a batch inserted before its first addLayer, not only the first one.
+        return true;
+    }
+
+    LayerStack::Entry entry;
+    entry.layer = layer;
+    if (stack->entries.empty() || !receivedBefore(layer, stack->entries.back().layer)) {
+        if (!stack->entries.empty()) {
+            stack->entries.back().qtyEnd = stack->high; // Drop what LIFO issues took off the top
+        } else {
+            stack->low = stack->high = 0.0;
+        }
+        entry.qtyStart = stack->high;
+        entry.costStart = stack->entries.empty() ? 0.0 : stack->costAt(stack->high);
+        entry.qtyEnd = stack->high + layer.remainingQuantity;
+        stack->high = entry.qtyEnd;
+        stack->entries.push_back(std::move(entry));
+        return true;
+    }
+
+    // Back-dated receipt: insert in receipt order and lay the axis out again (rare, O(n))
+    auto position = std::upper_bound(stack->entries.begin(), stack->entries.end(), layer,
+                                     [](const ERP::Warehouse::DTO::InventoryCostLayerDTO& value, const LayerStack::Entry& e) {
+                                         return receivedBefore(value, e.layer);
+                                     });
+    std::vector<double> remaining = stack->remainingQuantities();
+    remaining.insert(remaining.begin() + (position - stack->entries.begin()), layer.remainingQuantity);
+    stack->entries.insert(position, std::move(entry));
+    stack->layOut(remaining);
+    return true;
+}
+
+std::optional<double> InventoryCostLayerEngine::issue(const std::string& productId, const std::string& warehouseId, const std::string& locationId,
+                                                      double quantity, const std::string& userId) {
+    std::unique_lock<std::mutex> lock;
+    std::shared_ptr<LayerStack> stack = acquire(productId, warehouseId, locationId, lock);
+    if (!stack) {
+        return std::nullopt;
+    }
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        touched_[stack->owner].userId = userId;
+    }
+
+    const double available = stack->high - stack->low;
+    if (quantity > available + QUANTITY_EPSILON) {
+        ERP::Logger::Logger::getInstance().warning("Not enough quantity in cost layers of product " + productId + " at " + warehouseId + "/" + locationId +
+                                                   ". Available: " + std::to_string(available) + ", requested: " + std::to_string(quantity) + ".", "InventoryCostLayerEngine");
+        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InsufficientStock, "Không đủ số lượng trong lớp chi phí tồn kho để tiêu thụ.");
+        return std::nullopt;
+    }
+    quantity = std::min(quantity, available);
+    if (quantity <= 0.0) {
+        return 0.0;
+    }
+
+    double cost = 0.0;
+    if (costingMethod_ == CostingMethod::LIFO) {
+        const double from = stack->high - quantity;
+        cost = stack->costAt(stack->high) - stack->costAt(from);
+        stack->markDirty(from, stack->high);
+        stack->high = from;
+        while (!stack->entries.empty() && stack->entries.back().qtyStart >= stack->high - QUANTITY_EPSILON) {
+            stack->retiredIds.push_back(stack->entries.back().layer.id);
+            stack->entries.pop_back();
+        }
+    } else {
+        if (costingMethod_ == CostingMethod::WEIGHTED_AVERAGE) {
+            // Every layer gives up the same share, so what stays on hand keeps the average cost (O(n) per issue)
+            const double keep = 1.0 - quantity / available;
+            cost = quantity * (stack->costAt(stack->high) - stack->costAt(stack->low)) / available;
+            std::vector<double> remaining = stack->remainingQuantities();
+            for (double& value : remaining) {
+                value = keep > QUANTITY_EPSILON ? value * keep : 0.0;
+            }
+            stack->markDirty(stack->low, stack->high);
+            stack->layOut(remaining);
+        } else {
+            const double to = stack->low + quantity;
+            cost = stack->costAt(to) - stack->costAt(stack->low);
+            stack->markDirty(stack->low, to);
+            stack->low = to;
+        }
+        while (!stack->entries.empty() && stack->entries.front().qtyEnd <= stack->low + QUANTITY_EPSILON) {
+            stack->retiredIds.push_back(stack->entries.front().layer.id);
+            stack->entries.pop_front();
+        }
+    }
+    if (stack->entries.empty()) {
+        stack->low = stack->high = 0.0; // Start the axis over; the retired ids carry the pending writes
+        stack->hasDirty = false;
+    }
+    return cost;
+}
+
+bool InventoryCostLayerEngine::flush(const ERP::Database::DBConnection* transaction) {
+    TouchedStacks touched;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto it = touched_.find(transaction);
+        if (it == touched_.end()) {
+            return true;
+        }
+        touched = it->second;
+    }
+
+    std::vector<std::pair<std::string, double>> remainingByLayerId;
+    for (const auto& stack : touched.stacks) {
+        std::lock_guard<std::mutex> lock(stack->mutex);
+        for (const std::string& id : stack->retiredIds) {
+            remainingByLayerId.emplace_back(id, 0.0);
+        }
+        stack->retiredIds.clear();
+        if (stack->hasDirty && !stack->entries.empty()) {
+            for (std::size_t i = stack->indexAt(stack->dirtyLow); i < stack->entries.size() && stack->entries[i].qtyStart < stack->dirtyHigh; ++i) {
+                remainingByLayerId.emplace_back(stack->entries[i].layer.id, stack->remainingOf(stack->entries[i]));
+            }
+        }
+        stack->hasDirty = false;
+    }
+    if (remainingByLayerId.empty()) {
+        return true;
+    }
+    if (!inventoryCostLayerDAO_->updateRemainingQuantities(remainingByLayerId, touched.userId)) {
+        ERP::Logger::Logger::getInstance().error("Failed to persist " + std::to_string(remainingByLayerId.size()) + " cost layers.", "InventoryCostLayerEngine");
+        return false;
+    }
+    ERP_LOG_DEBUG("Persisted " + std::to_string(remainingByLayerId.size()) + " cost layers.", "InventoryCostLayerEngine");
+    return true;
+}
+
+void InventoryCostLayerEngine::release(const ERP::Database::DBConnection* transaction, bool committed) {
+    std::vector<std::shared_ptr<LayerStack>> stacks;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        auto it = touched_.find(transaction);
+        if (it == touched_.end()) {
+            return;
+        }
+        stacks.swap(it->second.stacks);
+        touched_.erase(it);
+    }
+    for (const auto& stack : stacks) {
+        {
+            std::lock_guard<std::mutex> lock(stack->mutex);
+            if (!committed) {
+                stack->unload(); // Reloaded from the database on next use
+            }
+            stack->owner = nullptr;
+            stack->loadedIds.clear(); // Only rows inserted before the load can come back through addLayer
+        }
+        stack->released.notify_all();
+    }
+}
+
+} // namespace Services
+} // namespace Warehouse
+} // namespace ERP
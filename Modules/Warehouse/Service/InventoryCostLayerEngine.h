@@ -0,0 +1,109 @@
+// Modules/Warehouse/Service/InventoryCostLayerEngine.h
+#ifndef MODULES_WAREHOUSE_SERVICE_INVENTORYCOSTLAYERENGINE_H
+#define MODULES_WAREHOUSE_SERVICE_INVENTORYCOSTLAYERENGINE_H
+#include <string>
+#include <vector>
+#include <optional>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <unordered_map>
+
+// Rút gọn các include paths
+#include "InventoryCostLayer.h"    // InventoryCostLayer DTO
+#include "InventoryCostLayerDAO.h" // InventoryCostLayer DAO
+#include "DBConnection.h"          // Transaction identity
+
+namespace ERP {
+namespace Warehouse {
+namespace Services {
+
+/**
+ * @brief Enum định nghĩa phương pháp tính giá vốn hàng xuất kho.
+ */
+enum class CostingMethod {
+    FIFO = 0,             /**< Nhập trước, xuất trước */
+    LIFO = 1,             /**< Nhập sau, xuất trước */
+    WEIGHTED_AVERAGE = 2  /**< Bình quân gia quyền (mọi lớp được trừ theo cùng tỷ lệ) */
+};
+
+/**
+ * @brief In-memory cost layers of every (product, warehouse, location), used to cost goods issues.
+ *
+ * The open layers of a position are loaded on first use and kept in a deque in receipt order.
+ * Each layer occupies a range on a running-quantity axis with the running cost at both ends;
+ * the quantity still on hand is the window [low, high) of that axis. FIFO issues move low up,
+ * LIFO issues move high down, so the cost of any quantity is a difference of two running costs
+ * found by binary search, and fully consumed layers are popped off the ends. Weighted-average
+ * issues take the same share of every layer and lay the axis out again, which is linear in the
+ * number of open layers.
+ *
+ * Changes are made inside the caller's UnitOfWork. The transaction holds the positions it touched
+ * until it ends, so other transactions wait for them (up to lockTimeout) instead of seeing its
+ * uncommitted consumption. The remaining quantities of every layer touched in the transaction are
+ * written right before COMMIT with one batched UPDATE; on rollback the positions are unloaded and
+ * reloaded from the database on next use.
+ */
+class InventoryCostLayerEngine {
+public:
+    /**
+     * @brief Constructs the engine.
+     * @param inventoryCostLayerDAO DAO used to load layers and persist remaining quantities.
+     * @param costingMethod Method used to cost issues.
+     * @param lockTimeout How long a transaction waits for a position held by another transaction.
+     */
+    InventoryCostLayerEngine(std::shared_ptr<DAOs::InventoryCostLayerDAO> inventoryCostLayerDAO,
+                             CostingMethod costingMethod = CostingMethod::FIFO,
+                             std::chrono::milliseconds lockTimeout = std::chrono::seconds(10));
+    ~InventoryCostLayerEngine();
+
+    InventoryCostLayerEngine(const InventoryCostLayerEngine&) = delete;
+    InventoryCostLayerEngine& operator=(const InventoryCostLayerEngine&) = delete;
+
+    /**
+     * @brief Adds a layer the current transaction has just inserted. If the position is not loaded
+     * yet, it is loaded now and the new row comes with it; rows that load already read are skipped.
+     * @return True on success, false if no transaction is open or the position is held by another one.
+     */
+    bool addLayer(const ERP::Warehouse::DTO::InventoryCostLayerDTO& layer);
+
+    /**
+     * @brief Consumes quantity from the layers of a position and computes its cost.
+     * @param userId The user recorded as updated_by on the touched layers.
+     * @return The cost of goods issued, or std::nullopt if the layers do not hold the quantity,
+     * no transaction is open, or the position stayed held by another transaction.
+     */
+    std::optional<double> issue(const std::string& productId, const std::string& warehouseId, const std::string& locationId,
+                                double quantity, const std::string& userId);
+
+    /**
+     * @brief Gets the costing method.
+     */
+    CostingMethod getCostingMethod() const { return costingMethod_; }
+
+private:
+    struct LayerStack;
+
+    std::shared_ptr<LayerStack> acquire(const std::string& productId, const std::string& warehouseId, const std::string& locationId,
+                                        std::unique_lock<std::mutex>& lock);
+    bool flush(const ERP::Database::DBConnection* transaction);
+    void release(const ERP::Database::DBConnection* transaction, bool committed);
+
+    std::shared_ptr<DAOs::InventoryCostLayerDAO> inventoryCostLayerDAO_;
+    CostingMethod costingMethod_;
+    std::chrono::milliseconds lockTimeout_;
+
+    std::mutex mutex_; // Guards stacks_ and touched_
+    std::unordered_map<std::string, std::shared_ptr<LayerStack>> stacks_;
+
+    struct TouchedStacks {
+        std::vector<std::shared_ptr<LayerStack>> stacks;
+        std::string userId;
+    };
+    std::unordered_map<const ERP::Database::DBConnection*, TouchedStacks> touched_; // Per open transaction
+};
+
+} // namespace Services
+} // namespace Warehouse
+} // namespace ERP
+#endif // MODULES_WAREHOUSE_SERVICE_INVENTORYCOSTLAYERENGINE_H
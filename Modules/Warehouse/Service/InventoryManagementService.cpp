@@ -9,6 +9,7 @@
 #include "Event.h"                  // Event DTO
 #include "ConnectionPool.h"         // ConnectionPool
 #include "DBConnection.h"           // DBConnection
+#include "UnitOfWork.h"             // For after-commit cache writes
 #include "Common.h"                 // Common Enums/Constants
 #include "Utils.h"                  // Utility functions
 #include "DateUtils.h"              // Date utility functions
@@ -23,11 +24,40 @@
 #include <sstream>
 #include <stdexcept>
 #include <algorithm> // For std::all_of if needed
+#include <set>       // For positions written by the open transaction
 
 namespace ERP {
 namespace Warehouse {
 namespace Services {
 
+namespace {
+// Positions written by the transaction open on this thread. Their cache entries are dropped until
+// the commit, so the transaction itself must read them from the database.
+struct PendingPositionWrites {
+    const ERP::Database::DBConnection* connection = nullptr;
+    std::set<std::string> keys;
+};
+thread_local PendingPositionWrites t_pendingPositionWrites;
+
+void markPendingPositionWrite(const std::string& key) {
+    const std::shared_ptr<ERP::Database::DBConnection> connection = ERP::Database::UnitOfWork::current();
+    if (t_pendingPositionWrites.connection != connection.get()) {
+        t_pendingPositionWrites.connection = connection.get(); // A new transaction; a rolled back one leaves stale keys
+        t_pendingPositionWrites.keys.clear();
+    }
+    t_pendingPositionWrites.keys.insert(key);
+}
+
+bool isPendingPositionWrite(const std::shared_ptr<ERP::Database::DBConnection>& connection, const std::string& key) {
+    return connection && t_pendingPositionWrites.connection == connection.get() && t_pendingPositionWrites.keys.count(key) > 0;
+}
+
+void clearPendingPositionWrites() {
+    t_pendingPositionWrites.connection = nullptr;
+    t_pendingPositionWrites.keys.clear();
+}
+} // namespace
+
 InventoryManagementService::InventoryManagementService(
     std::shared_ptr<DAOs::InventoryDAO> inventoryDAO,
     std::shared_ptr<DAOs::InventoryTransactionDAO> inventoryTransactionDAO, // Note: This DAO is now used directly within InventoryTransactionService, not here.
@@ -46,7 +76,9 @@ InventoryManagementService::InventoryManagementService(
       productService_(productService),
       warehouseService_(warehouseService),
       locationService_(locationService),
-      inventoryTransactionService_(inventoryTransactionService) { // NEW: Initialize InventoryTransactionService
+      inventoryTransactionService_(inventoryTransactionService), // NEW: Initialize InventoryTransactionService
+      positionCache_(std::make_shared<InventoryPositionCache>()),
+      costLayerEngine_(inventoryCostLayerDAO ? std::make_shared<InventoryCostLayerEngine>(inventoryCostLayerDAO, CostingMethod::FIFO) : nullptr) {
     
     // Check for null dependencies
     if (!inventoryDAO_ || !inventoryCostLayerDAO_ || !productService_ || !warehouseService_ || !locationService_ || !inventoryTransactionService_ || !securityManager_) {
@@ -54,9 +86,122 @@ InventoryManagementService::InventoryManagementService(
         ERP::Logger::Logger::getInstance().critical("InventoryManagementService: One or more injected DAOs/Services are null.");
         throw std::runtime_error("InventoryManagementService: Null dependencies.");
     }
+    // Any level change drops the cached position. A matching quantity does not prove the rest of the
+    // cached row (reserved and available quantities, timestamps) is current, so the next read reloads it.
+    levelChangedSubscription_ = eventBus_.subscribe<EventBus::InventoryLevelChangedEvent>(
+        [cache = positionCache_](const EventBus::InventoryLevelChangedEvent& event) {
+            cache->invalidate(InventoryPositionCache::makeKey(event.productId, event.warehouseId, event.locationId));
+        });
     ERP::Logger::Logger::getInstance().info("InventoryManagementService: Initialized.");
 }
 
+InventoryManagementService::~InventoryManagementService() {
+    eventBus_.unsubscribe(levelChangedSubscription_);
+}
+
+std::optional<ERP::Warehouse::DTO::InventoryDTO> InventoryManagementService::findPosition(
+    const std::string& productId,
+    const std::string& warehouseId,
+    const std::string& locationId) {
+    const std::string key = InventoryPositionCache::makeKey(productId, warehouseId, locationId);
+    const std::shared_ptr<ERP::Database::DBConnection> transaction = ERP::Database::UnitOfWork::current();
+    if (!isPendingPositionWrite(transaction, key)) {
+        if (std::optional<ERP::Warehouse::DTO::InventoryDTO> cached = positionCache_->get(key)) {
+            return cached;
+        }
+    }
+
+    const std::uint64_t epoch = positionCache_->loadEpoch(key);
+    std::map<std::string, std::any> filter;
+    filter["product_id"] = productId;
+    filter["warehouse_id"] = warehouseId;
+    filter["location_id"] = locationId;
+    std::vector<ERP::Warehouse::DTO::InventoryDTO> results = inventoryDAO_->getInventory(filter);
+    if (results.empty()) {
+        return std::nullopt;
+    }
+    if (!transaction) {
+        positionCache_->fill(results[0], epoch); // A transaction may read rows it has not committed yet
+    }
+    return results[0];
+}
+
+std::map<std::string, ERP::Warehouse::DTO::InventoryDTO> InventoryManagementService::readPositions(
+    const std::set<std::string>& productIds,
+    const std::function<bool(const std::string&)>& isWanted) {
+    std::map<std::string, ERP::Warehouse::DTO::InventoryDTO> positions;
+    const std::vector<std::string> productIdList(productIds.begin(), productIds.end());
+    for (std::size_t offset = 0; offset < productIdList.size(); offset += POSITION_PRODUCT_CHUNK_SIZE) {
+        const std::size_t end = std::min(offset + POSITION_PRODUCT_CHUNK_SIZE, productIdList.size());
+        ERP::DAOBase::QueryFilter filter;
+        filter.in("product_id", std::vector<std::string>(productIdList.begin() + offset, productIdList.begin() + end));
+        for (auto& row : inventoryDAO_->find(filter)) {
+            std::string key = InventoryPositionCache::makeKey(row.productId, row.warehouseId, row.locationId);
+            if (isWanted(key)) {
+                positions.emplace(std::move(key), std::move(row));
+            }
+        }
+    }
+    return positions;
+}
+
+std::optional<ERP::Warehouse::DTO::InventoryDTO> InventoryManagementService::readPosition(
+    const std::string& productId,
+    const std::string& warehouseId,
+    const std::string& locationId) {
+    ERP::DAOBase::QueryFilter filter;
+    filter.equals("product_id", productId).equals("warehouse_id", warehouseId).equals("location_id", locationId);
+    std::vector<ERP::Warehouse::DTO::InventoryDTO> results = inventoryDAO_->find(filter);
+    if (results.empty()) {
+        return std::nullopt;
+    }
+    return results.front();
+}
+
+std::optional<ERP::Warehouse::DTO::InventoryDTO> InventoryManagementService::applyPositionDelta(
+    const DAOs::InventoryQuantityDelta& delta,
+    const std::string& userId,
+    bool& insufficient) {
+    insufficient = false;
+    std::optional<std::size_t> applied = inventoryDAO_->applyQuantityDeltas({ delta }, userId);
+    if (!applied) {
+        return std::nullopt;
+    }
+    if (*applied == 0) {
+        insufficient = true; // The guard saw less than the outgoing quantity at the time of the write
+        return std::nullopt;
+    }
+    return inventoryDAO_->getById(delta.inventoryId);
+}
+
+void InventoryManagementService::cachePositionAfterCommit(const ERP::Warehouse::DTO::InventoryDTO& inventory) {
+    const std::string key = InventoryPositionCache::makeKey(inventory.productId, inventory.warehouseId, inventory.locationId);
+    positionCache_->invalidate(key);
+    if (!ERP::Database::UnitOfWork::runAfterCommit([cache = positionCache_, inventory]() {
+            cache->put(inventory);
+            clearPendingPositionWrites();
+        })) {
+        positionCache_->put(inventory);
+        return;
+    }
+    markPendingPositionWrite(key);
+}
+
+void InventoryManagementService::dropPositionAfterCommit(const ERP::Warehouse::DTO::InventoryDTO& inventory) {
+    const std::string key = InventoryPositionCache::makeKey(inventory.productId, inventory.warehouseId, inventory.locationId);
+    positionCache_->invalidate(key);
+    if (ERP::Database::UnitOfWork::runAfterCommit([cache = positionCache_, key]() {
+            cache->invalidate(key); // A reader may have cached the row before the delete committed
+            clearPendingPositionWrites();
+        })) {
+        markPendingPositionWrite(key);
+    }
+}
+
+std::vector<InventoryPositionCacheStats> InventoryManagementService::getPositionCacheStats() const {
+    return positionCache_->getStats();
+}
+
 std::optional<ERP::Warehouse::DTO::InventoryDTO> InventoryManagementService::createInventory(
     const ERP::Warehouse::DTO::InventoryDTO& inventoryDTO,
     const std::string& currentUserId,
@@ -120,6 +265,7 @@ std::optional<ERP::Warehouse::DTO::InventoryDTO> InventoryManagementService::cre
                 return false;
             }
             createdInventory = newInventory;
+            cachePositionAfterCommit(newInventory);
             // Optionally, publish event
             // eventBus_.publish(std::make_shared<EventBus::InventoryCreatedEvent>(newInventory.id, newInventory.productId, newInventory.warehouseId, newInventory.locationId)); // Assuming such an event
             return true;
@@ -161,15 +307,51 @@ std::optional<ERP::Warehouse::DTO::InventoryDTO> InventoryManagementService::get
         return std::nullopt;
     }
 
-    std::map<std::string, std::any> filter;
-    filter["product_id"] = productId;
-    filter["warehouse_id"] = warehouseId;
-    filter["location_id"] = locationId;
-    std::vector<ERP::Warehouse::DTO::InventoryDTO> results = inventoryDAO_->getInventory(filter);
-    if (!results.empty()) {
-        return results[0];
+    return findPosition(productId, warehouseId, locationId);
+}
+
+std::vector<ERP::Warehouse::DTO::InventoryDTO> InventoryManagementService::getInventoryByKeys(
+    const std::vector<InventoryPositionKey>& keys,
+    const std::string& currentUserId,
+    const std::vector<std::string>& userRoleIds) {
+    ERP::Logger::Logger::getInstance().debug("InventoryManagementService: Retrieving inventory for " + std::to_string(keys.size()) + " positions.");
+
+    if (!checkPermission(currentUserId, userRoleIds, "Warehouse.ViewInventory", "Bạn không có quyền xem tồn kho.")) {
+        return {};
     }
-    return std::nullopt;
+
+    // Same rules as findPosition(): cached positions first, then one read for all the misses
+    const std::shared_ptr<ERP::Database::DBConnection> transaction = ERP::Database::UnitOfWork::current();
+    std::vector<ERP::Warehouse::DTO::InventoryDTO> results;
+    std::set<std::string> seen;
+    std::map<std::string, std::uint64_t> misses; // Position key -> cache epoch before the read
+    std::set<std::string> missedProductIds;
+    for (const auto& position : keys) {
+        std::string key = InventoryPositionCache::makeKey(position.productId, position.warehouseId, position.locationId);
+        if (!seen.insert(key).second) {
+            continue;
+        }
+        if (!isPendingPositionWrite(transaction, key)) {
+            if (std::optional<ERP::Warehouse::DTO::InventoryDTO> cached = positionCache_->get(key)) {
+                results.push_back(std::move(*cached));
+                continue;
+            }
+        }
+        const std::uint64_t epoch = positionCache_->loadEpoch(key);
+        misses.emplace(std::move(key), epoch);
+        missedProductIds.insert(position.productId);
+    }
+    if (misses.empty()) {
+        return results;
+    }
+
+    for (auto& [key, row] : readPositions(missedProductIds, [&misses](const std::string& k) { return misses.count(k) > 0; })) {
+        if (!transaction) {
+            positionCache_->fill(row, misses.at(key)); // A transaction may read rows it has not committed yet
+        }
+        results.push_back(std::move(row));
+    }
+    return results;
 }
 
 std::vector<ERP::Warehouse::DTO::InventoryDTO> InventoryManagementService::getAllInventory(
@@ -184,6 +366,20 @@ std::vector<ERP::Warehouse::DTO::InventoryDTO> InventoryManagementService::getAl
     return inventoryDAO_->getInventory(filter);
 }
 
+ERP::DAOBase::Page<ERP::Warehouse::DTO::InventoryDTO> InventoryManagementService::getInventoryPage(
+    const std::map<std::string, std::any>& filter,
+    const ERP::DAOBase::PageRequest& pageRequest,
+    const std::string& currentUserId,
+    const std::vector<std::string>& userRoleIds) {
+    ERP::Logger::Logger::getInstance().info("InventoryManagementService: Retrieving a page of inventory records.");
+
+    if (!checkPermission(currentUserId, userRoleIds, "Warehouse.ViewInventory", "Bạn không có quyền xem tất cả bản ghi tồn kho.")) {
+        return {};
+    }
+
+    return inventoryDAO_->getPage(filter, pageRequest);
+}
+
 std::vector<ERP::Warehouse::DTO::InventoryDTO> InventoryManagementService::getInventoryByProduct(
     const std::string& productId,
     const std::vector<std::string>& userRoleIds) {
@@ -225,15 +421,20 @@ bool InventoryManagementService::updateInventory(
     }
 
     ERP::Warehouse::DTO::InventoryDTO updatedInventory = inventoryDTO;
-    updatedInventory.updatedAt = ERP::Utils::DateUtils::now();
-    updatedInventory.updatedBy = currentUserId;
 
     bool success = executeTransaction(
         [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
-            if (!inventoryDAO_->update(updatedInventory)) { // Specific DAO method
-                ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to update inventory record " + updatedInventory.id + " in DAO.");
+            // Quantities and cost belong to the stock movements; only the descriptive columns are written
+            if (!inventoryDAO_->updateDetails(inventoryDTO, currentUserId)) {
+                ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to update inventory record " + inventoryDTO.id + " in DAO.");
                 return false;
             }
+            std::optional<ERP::Warehouse::DTO::InventoryDTO> writtenInventory = inventoryDAO_->getById(inventoryDTO.id);
+            if (!writtenInventory) {
+                return false;
+            }
+            updatedInventory = *writtenInventory;
+            cachePositionAfterCommit(updatedInventory);
             // Optionally, publish event
             // eventBus_.publish(std::make_shared<EventBus::InventoryUpdatedEvent>(updatedInventory.id, updatedInventory.productId, updatedInventory.quantity)); // Assuming such an event
             return true;
@@ -272,8 +473,8 @@ bool InventoryManagementService::recordGoodsReceipt(
         return false;
     }
 
-    std::optional<ERP::Warehouse::DTO::InventoryDTO> inventoryOpt = getInventoryByProductLocation(transactionDTO.productId, transactionDTO.warehouseId, transactionDTO.locationId, userRoleIds);
     ERP::Warehouse::DTO::InventoryDTO currentInventory;
+    double oldQuantity = 0.0;
 
     bool success = executeTransaction(
         [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
@@ -286,6 +487,7 @@ bool InventoryManagementService::recordGoodsReceipt(
             }
 
             // Step 2: Update (or create) the inventory record
+            std::optional<ERP::Warehouse::DTO::InventoryDTO> inventoryOpt = readPosition(transactionDTO.productId, transactionDTO.warehouseId, transactionDTO.locationId);
             if (!inventoryOpt) {
                 // If inventory record does not exist, create it.
                 ERP::Logger::Logger::getInstance().info("InventoryManagementService: Inventory record not found, creating new for product " + transactionDTO.productId + " at " + transactionDTO.warehouseId + "/" + transactionDTO.locationId + ".");
@@ -312,26 +514,19 @@ bool InventoryManagementService::recordGoodsReceipt(
                 }
                 currentInventory = newInventory;
             } else {
-                // Update existing inventory record
-                currentInventory = *inventoryOpt;
-                double oldQuantity = currentInventory.quantity;
-                currentInventory.quantity += transactionDTO.quantity;
-                currentInventory.availableQuantity = currentInventory.quantity - currentInventory.reservedQuantity.value_or(0.0);
-                // Update unit cost (e.g., using Weighted Average Cost or FIFO/LIFO logic)
-                // For simplicity, let's use a basic average cost update or just latest cost
-                if (oldQuantity + transactionDTO.quantity > 0) { // Avoid division by zero
-                    currentInventory.unitCost = (oldQuantity * currentInventory.unitCost + transactionDTO.quantity * transactionDTO.unitCost) / (oldQuantity + transactionDTO.quantity);
-                } else {
-                    currentInventory.unitCost = transactionDTO.unitCost; // If starting from 0 or negative
-                }
-                currentInventory.updatedAt = ERP::Utils::DateUtils::now();
-                currentInventory.updatedBy = currentUserId;
-
-                if (!inventoryDAO_->update(currentInventory)) {
+                // Add to the stored quantity and average cost; reserved quantity is left to the reservation path
+                bool insufficient = false;
+                std::optional<ERP::Warehouse::DTO::InventoryDTO> receivedInventory = applyPositionDelta(
+                    { inventoryOpt->id, transactionDTO.quantity, transactionDTO.quantity, transactionDTO.quantity * transactionDTO.unitCost },
+                    currentUserId, insufficient);
+                if (!receivedInventory) {
                     ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to update existing inventory record for goods receipt.");
                     return false;
                 }
+                currentInventory = *receivedInventory;
+                oldQuantity = currentInventory.quantity - transactionDTO.quantity;
             }
+            cachePositionAfterCommit(currentInventory);
 
             // Step 3: Record inventory cost layer (if using costing methods like FIFO/LIFO)
             // This is crucial for accurate cost of goods sold.
@@ -348,7 +543,7 @@ bool InventoryManagementService::recordGoodsReceipt(
             newCostLayer.createdBy = currentUserId;
             newCostLayer.status = ERP::Common::EntityStatus::ACTIVE; // Active layer
 
-            if (!inventoryCostLayerDAO_->create(newCostLayer)) { // Specific DAO method
+            if (!inventoryCostLayerDAO_->create(newCostLayer) || !costLayerEngine_->addLayer(newCostLayer)) { // Specific DAO method
                 ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to record inventory cost layer for goods receipt.");
                 return false;
             }
@@ -356,7 +551,7 @@ bool InventoryManagementService::recordGoodsReceipt(
             // Optionally, publish event for Inventory Level Change
             eventBus_.publish(std::make_shared<EventBus::InventoryLevelChangedEvent>(
                 currentInventory.productId, currentInventory.warehouseId, currentInventory.locationId,
-                inventoryOpt ? inventoryOpt->quantity : 0.0, currentInventory.quantity, "GoodsReceipt"
+                oldQuantity, currentInventory.quantity, "GoodsReceipt"
             ));
             return true;
         },
@@ -394,54 +589,54 @@ bool InventoryManagementService::recordGoodsIssue(
         return false;
     }
 
-    std::optional<ERP::Warehouse::DTO::InventoryDTO> inventoryOpt = getInventoryByProductLocation(transactionDTO.productId, transactionDTO.warehouseId, transactionDTO.locationId, userRoleIds);
-    if (!inventoryOpt) {
-        ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Inventory record not found for product " + transactionDTO.productId + " at " + transactionDTO.warehouseId + "/" + transactionDTO.locationId + " for goods issue.");
-        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::NotFound, "Không tìm thấy bản ghi tồn kho cho sản phẩm tại vị trí này.");
-        return false;
-    }
-    ERP::Warehouse::DTO::InventoryDTO currentInventory = *inventoryOpt;
-
-    // Check if enough quantity available for issue (considering reserved vs. actual quantity)
-    // Here we check against total quantity, assuming reserved is handled.
-    if (currentInventory.quantity < transactionDTO.quantity) {
-        ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Insufficient quantity for goods issue. Product " + transactionDTO.productId + ", available: " + std::to_string(currentInventory.quantity) + ", requested: " + std::to_string(transactionDTO.quantity) + ".");
-        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InsufficientStock, "Không đủ số lượng tồn kho để xuất.");
-        return false;
-    }
+    ERP::Warehouse::DTO::InventoryDTO currentInventory;
 
     bool success = executeTransaction(
         [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
-            // Step 1: Record the inventory transaction
-            std::optional<ERP::Warehouse::DTO::InventoryTransactionDTO> createdTransaction = 
-                inventoryTransactionService_->createInventoryTransaction(transactionDTO, currentUserId, userRoleIds); // Use the new service
-            if (!createdTransaction) {
-                ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to create goods issue transaction.");
+            std::optional<ERP::Warehouse::DTO::InventoryDTO> inventoryOpt = readPosition(transactionDTO.productId, transactionDTO.warehouseId, transactionDTO.locationId);
+            if (!inventoryOpt) {
+                ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Inventory record not found for product " + transactionDTO.productId + " at " + transactionDTO.warehouseId + "/" + transactionDTO.locationId + " for goods issue.");
+                ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::NotFound, "Không tìm thấy bản ghi tồn kho cho sản phẩm tại vị trí này.");
                 return false;
             }
 
-            // Step 2: Update the inventory record
-            double oldQuantity = currentInventory.quantity;
-            currentInventory.quantity -= transactionDTO.quantity;
-            currentInventory.availableQuantity = currentInventory.quantity - currentInventory.reservedQuantity.value_or(0.0);
-            currentInventory.updatedAt = ERP::Utils::DateUtils::now();
-            currentInventory.updatedBy = currentUserId;
-
-            if (!inventoryDAO_->update(currentInventory)) {
-                ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to update existing inventory record for goods issue.");
+            // Step 1: Take the quantity off the stored row; the guard in the UPDATE rejects an issue larger than the stock
+            bool insufficient = false;
+            std::optional<ERP::Warehouse::DTO::InventoryDTO> issuedInventory = applyPositionDelta(
+                { inventoryOpt->id, -transactionDTO.quantity, 0.0, 0.0 }, currentUserId, insufficient);
+            if (!issuedInventory) {
+                if (insufficient) {
+                    ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Insufficient quantity for goods issue. Product " + transactionDTO.productId + ", requested: " + std::to_string(transactionDTO.quantity) + ".");
+                    ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InsufficientStock, "Không đủ số lượng tồn kho để xuất.");
+                } else {
+                    ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to update existing inventory record for goods issue.");
+                }
                 return false;
             }
+            currentInventory = *issuedInventory;
 
-            // Step 3: Consume from inventory cost layers (e.g., FIFO/LIFO logic)
-            if (!consumeInventoryCostLayers(transactionDTO.productId, transactionDTO.warehouseId, transactionDTO.locationId, transactionDTO.quantity, currentUserId, userRoleIds)) {
+            // Step 2: Consume from inventory cost layers; the issue is recorded at the cost of goods issued
+            std::optional<double> costOfGoodsIssued = consumeInventoryCostLayers(transactionDTO.productId, transactionDTO.warehouseId, transactionDTO.locationId, transactionDTO.quantity, currentUserId, userRoleIds);
+            if (!costOfGoodsIssued) {
                 ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to consume from inventory cost layers for goods issue.");
                 return false;
             }
+            ERP::Warehouse::DTO::InventoryTransactionDTO issueTransaction = transactionDTO;
+            issueTransaction.unitCost = *costOfGoodsIssued / transactionDTO.quantity;
+
+            // Step 3: Record the inventory transaction
+            std::optional<ERP::Warehouse::DTO::InventoryTransactionDTO> createdTransaction = 
+                inventoryTransactionService_->createInventoryTransaction(issueTransaction, currentUserId, userRoleIds); // Use the new service
+            if (!createdTransaction) {
+                ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to create goods issue transaction.");
+                return false;
+            }
+            cachePositionAfterCommit(currentInventory);
 
             // Optionally, publish event for Inventory Level Change
             eventBus_.publish(std::make_shared<EventBus::InventoryLevelChangedEvent>(
                 currentInventory.productId, currentInventory.warehouseId, currentInventory.locationId,
-                oldQuantity, currentInventory.quantity, "GoodsIssue"
+                currentInventory.quantity + transactionDTO.quantity, currentInventory.quantity, "GoodsIssue"
             ));
             return true;
         },
@@ -479,7 +674,7 @@ bool InventoryManagementService::adjustInventory(
         return false;
     }
 
-    std::optional<ERP::Warehouse::DTO::InventoryDTO> inventoryOpt = getInventoryByProductLocation(transactionDTO.productId, transactionDTO.warehouseId, transactionDTO.locationId, userRoleIds);
+    std::optional<ERP::Warehouse::DTO::InventoryDTO> inventoryOpt; // Row as read inside the transaction, for the audit log
     ERP::Warehouse::DTO::InventoryDTO currentInventory;
 
     bool success = executeTransaction(
@@ -493,6 +688,7 @@ bool InventoryManagementService::adjustInventory(
             }
 
             // Step 2: Update (or create) the inventory record based on adjustment type
+            inventoryOpt = readPosition(transactionDTO.productId, transactionDTO.warehouseId, transactionDTO.locationId);
             if (!inventoryOpt) {
                 // If inventory record does not exist, create it.
                 // This usually happens for ADJ_IN, starting from zero.
@@ -522,36 +718,25 @@ bool InventoryManagementService::adjustInventory(
                 }
                 currentInventory = newInventory;
             } else {
-                // Update existing inventory record
-                currentInventory = *inventoryOpt;
-                double oldQuantity = currentInventory.quantity;
-
-                if (transactionDTO.type == ERP::Warehouse::DTO::InventoryTransactionType::ADJUSTMENT_IN) {
-                    currentInventory.quantity += transactionDTO.quantity;
-                    // Update unit cost for ADJ_IN (e.g., by average)
-                    if (oldQuantity + transactionDTO.quantity > 0) {
-                        currentInventory.unitCost = (oldQuantity * currentInventory.unitCost + transactionDTO.quantity * transactionDTO.unitCost) / (oldQuantity + transactionDTO.quantity);
-                    } else {
-                        currentInventory.unitCost = transactionDTO.unitCost;
-                    }
-                } else if (transactionDTO.type == ERP::Warehouse::DTO::InventoryTransactionType::ADJUSTMENT_OUT) {
-                    if (currentInventory.quantity < transactionDTO.quantity) {
-                        ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Insufficient quantity for ADJUSTMENT_OUT. Product " + transactionDTO.productId + ", available: " + std::to_string(currentInventory.quantity) + ", requested: " + std::to_string(transactionDTO.quantity) + ".");
+                // ADJ_IN averages the unit cost like a receipt; ADJ_OUT leaves it and is guarded against going below zero
+                DAOs::InventoryQuantityDelta delta{ inventoryOpt->id, transactionDTO.quantity, transactionDTO.quantity, transactionDTO.quantity * transactionDTO.unitCost };
+                if (transactionDTO.type == ERP::Warehouse::DTO::InventoryTransactionType::ADJUSTMENT_OUT) {
+                    delta = { inventoryOpt->id, -transactionDTO.quantity, 0.0, 0.0 };
+                }
+                bool insufficient = false;
+                std::optional<ERP::Warehouse::DTO::InventoryDTO> adjustedInventory = applyPositionDelta(delta, currentUserId, insufficient);
+                if (!adjustedInventory) {
+                    if (insufficient) {
+                        ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Insufficient quantity for ADJUSTMENT_OUT. Product " + transactionDTO.productId + ", requested: " + std::to_string(transactionDTO.quantity) + ".");
                         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InsufficientStock, "Không đủ số lượng tồn kho để điều chỉnh giảm.");
-                        return false;
+                    } else {
+                        ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to update existing inventory record for adjustment.");
                     }
-                    currentInventory.quantity -= transactionDTO.quantity;
-                    // For ADJ_OUT, unitCost typically doesn't change unless it's a specific costing method.
-                }
-                currentInventory.availableQuantity = currentInventory.quantity - currentInventory.reservedQuantity.value_or(0.0);
-                currentInventory.updatedAt = ERP::Utils::DateUtils::now();
-                currentInventory.updatedBy = currentUserId;
-
-                if (!inventoryDAO_->update(currentInventory)) {
-                    ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to update existing inventory record for adjustment.");
                     return false;
                 }
+                currentInventory = *adjustedInventory;
             }
+            cachePositionAfterCommit(currentInventory);
 
             // Step 3: Record inventory cost layer for adjustments (simplified)
             // For ADJ_IN, create a new layer. For ADJ_OUT, consume from existing layers.
@@ -568,7 +753,7 @@ bool InventoryManagementService::adjustInventory(
                 newCostLayer.createdAt = ERP::Utils::DateUtils::now();
                 newCostLayer.createdBy = currentUserId;
                 newCostLayer.status = ERP::Common::EntityStatus::ACTIVE;
-                if (!inventoryCostLayerDAO_->create(newCostLayer)) {
+                if (!inventoryCostLayerDAO_->create(newCostLayer) || !costLayerEngine_->addLayer(newCostLayer)) {
                     ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to record cost layer for adjustment in.");
                     return false;
                 }
@@ -600,6 +785,230 @@ bool InventoryManagementService::adjustInventory(
     return false;
 }
 
+bool InventoryManagementService::recordInventoryMovements(
+    const std::vector<ERP::Warehouse::DTO::InventoryTransactionDTO>& transactionDTOs,
+    const std::string& currentUserId,
+    const std::vector<std::string>& userRoleIds) {
+    ERP::Logger::Logger::getInstance().info("InventoryManagementService: Recording " + std::to_string(transactionDTOs.size()) + " inventory movements by " + currentUserId + ".");
+    if (transactionDTOs.empty()) {
+        return true;
+    }
+
+    using ERP::Warehouse::DTO::InventoryTransactionType;
+    // Each permission is checked once for the whole batch
+    std::map<std::string, std::string> permissions; // Permission -> message when denied
+    for (const auto& transactionDTO : transactionDTOs) {
+        switch (transactionDTO.type) {
+            case InventoryTransactionType::GOODS_RECEIPT:
+                permissions.emplace("Warehouse.RecordGoodsReceipt", "Bạn không có quyền ghi nhận nhập kho.");
+                break;
+            case InventoryTransactionType::GOODS_ISSUE:
+                permissions.emplace("Warehouse.RecordGoodsIssue", "Bạn không có quyền ghi nhận xuất kho.");
+                permissions.emplace("Warehouse.ConsumeInventoryCostLayers", "Bạn không có quyền tiêu thụ lớp chi phí tồn kho.");
+                break;
+            case InventoryTransactionType::ADJUSTMENT_IN:
+                permissions.emplace("Warehouse.AdjustInventoryManual", "Bạn không có quyền điều chỉnh tồn kho.");
+                break;
+            case InventoryTransactionType::ADJUSTMENT_OUT:
+                permissions.emplace("Warehouse.AdjustInventoryManual", "Bạn không có quyền điều chỉnh tồn kho.");
+                permissions.emplace("Warehouse.ConsumeInventoryCostLayers", "Bạn không có quyền tiêu thụ lớp chi phí tồn kho.");
+                break;
+            default:
+                ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Invalid transaction type in inventory movements: " + transactionDTO.getTypeString());
+                ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Loại giao dịch không hợp lệ cho nhập/xuất kho.");
+                return false;
+        }
+        if (transactionDTO.quantity <= 0) {
+            ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Inventory movement quantity must be positive.");
+            ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Số lượng nhập/xuất kho phải là số dương.");
+            return false;
+        }
+    }
+    for (const auto& [permission, deniedMessage] : permissions) {
+        if (!checkPermission(currentUserId, userRoleIds, permission, deniedMessage)) {
+            return false;
+        }
+    }
+
+    // Group the lines by position; the map's order is the order positions are taken in by every batch
+    struct PositionMovement {
+        std::size_t firstLine = 0;
+        double receivedQuantity = 0.0;
+        double receivedValue = 0.0;
+        double issuedQuantity = 0.0;
+        std::vector<std::size_t> issueLines;
+    };
+    std::vector<ERP::Warehouse::DTO::InventoryTransactionDTO> lines = transactionDTOs;
+    std::map<std::string, PositionMovement> movements;
+    std::set<std::string> productIds;
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        const auto& line = lines[i];
+        auto [it, inserted] = movements.try_emplace(InventoryPositionCache::makeKey(line.productId, line.warehouseId, line.locationId));
+        PositionMovement& movement = it->second;
+        if (inserted) {
+            movement.firstLine = i;
+        }
+        if (line.type == InventoryTransactionType::GOODS_RECEIPT || line.type == InventoryTransactionType::ADJUSTMENT_IN) {
+            movement.receivedQuantity += line.quantity;
+            movement.receivedValue += line.quantity * line.unitCost;
+        } else {
+            movement.issuedQuantity += line.quantity;
+            movement.issueLines.push_back(i);
+        }
+        productIds.insert(line.productId);
+    }
+
+    std::vector<std::pair<ERP::Warehouse::DTO::InventoryDTO, double>> changedPositions; // Row after the batch, quantity before
+    bool success = executeTransaction(
+        [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
+            // Step 1: Read the existing rows of every position, a chunk of products per query
+            std::map<std::string, ERP::Warehouse::DTO::InventoryDTO> positions = readPositions(productIds,
+                [&movements](const std::string& key) { return movements.count(key) > 0; });
+
+            // Step 2: Check stock, receipts of the batch included
+            for (const auto& [key, movement] : movements) {
+                auto it = positions.find(key);
+                const ERP::Warehouse::DTO::InventoryTransactionDTO& line = lines[movement.firstLine];
+                if (it == positions.end() && movement.receivedQuantity <= 0) {
+                    ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Inventory record not found for product " + line.productId + " at " + line.warehouseId + "/" + line.locationId + " for inventory movements.");
+                    ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::NotFound, "Không tìm thấy bản ghi tồn kho cho sản phẩm tại vị trí này.");
+                    return false;
+                }
+                const double onHand = (it != positions.end() ? it->second.quantity : 0.0) + movement.receivedQuantity;
+                if (onHand < movement.issuedQuantity) {
+                    ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Insufficient quantity for inventory movements. Product " + line.productId + ", available: " + std::to_string(onHand) + ", requested: " + std::to_string(movement.issuedQuantity) + ".");
+                    ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InsufficientStock, "Không đủ số lượng tồn kho để xuất.");
+                    return false;
+                }
+            }
+
+            // Step 3: One cost layer per incoming line, then cost the issues of each position
+            std::vector<ERP::Warehouse::DTO::InventoryCostLayerDTO> newCostLayers;
+            const auto now = ERP::Utils::DateUtils::now();
+            for (const auto& line : lines) {
+                if (line.type != InventoryTransactionType::GOODS_RECEIPT && line.type != InventoryTransactionType::ADJUSTMENT_IN) {
+                    continue;
+                }
+                ERP::Warehouse::DTO::InventoryCostLayerDTO newCostLayer;
+                newCostLayer.id = ERP::Utils::generateUUID();
+                newCostLayer.productId = line.productId;
+                newCostLayer.warehouseId = line.warehouseId;
+                newCostLayer.locationId = line.locationId;
+                newCostLayer.receiptDate = line.transactionDate;
+                newCostLayer.quantity = line.quantity;
+                newCostLayer.unitCost = line.unitCost;
+                newCostLayer.remainingQuantity = line.quantity;
+                newCostLayer.createdAt = now;
+                newCostLayer.createdBy = currentUserId;
+                newCostLayer.status = ERP::Common::EntityStatus::ACTIVE;
+                newCostLayers.push_back(std::move(newCostLayer));
+            }
+            if (!inventoryCostLayerDAO_->createMany(newCostLayers)) {
+                ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to record cost layers for inventory movements.");
+                return false;
+            }
+            for (const auto& newCostLayer : newCostLayers) {
+                if (!costLayerEngine_->addLayer(newCostLayer)) {
+                    return false;
+                }
+            }
+            for (const auto& [key, movement] : movements) {
+                if (movement.issuedQuantity <= 0) {
+                    continue;
+                }
+                const ERP::Warehouse::DTO::InventoryTransactionDTO& line = lines[movement.firstLine];
+                std::optional<double> costOfGoodsIssued = costLayerEngine_->issue(line.productId, line.warehouseId, line.locationId, movement.issuedQuantity, currentUserId);
+                if (!costOfGoodsIssued) {
+                    ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to consume from inventory cost layers for inventory movements.");
+                    return false;
+                }
+                for (std::size_t i : movement.issueLines) {
+                    lines[i].unitCost = *costOfGoodsIssued / movement.issuedQuantity;
+                }
+            }
+
+            // Step 4: Record the inventory transactions (validates products, warehouses and locations once)
+            if (!inventoryTransactionService_->createInventoryTransactions(lines, currentUserId, userRoleIds)) {
+                ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to create transactions for inventory movements.");
+                return false;
+            }
+
+            // Step 5: Create the missing inventory rows and apply the deltas of the existing ones
+            std::vector<ERP::Warehouse::DTO::InventoryDTO> newInventories;
+            std::vector<DAOs::InventoryQuantityDelta> deltas;
+            std::map<std::string, double> oldQuantities; // Quantity before the batch, for the events
+            for (const auto& [key, movement] : movements) {
+                const double quantityDelta = movement.receivedQuantity - movement.issuedQuantity;
+                auto it = positions.find(key);
+                if (it == positions.end()) {
+                    const ERP::Warehouse::DTO::InventoryTransactionDTO& line = lines[movement.firstLine];
+                    ERP::Warehouse::DTO::InventoryDTO newInventory;
+                    newInventory.id = ERP::Utils::generateUUID();
+                    newInventory.productId = line.productId;
+                    newInventory.warehouseId = line.warehouseId;
+                    newInventory.locationId = line.locationId;
+                    newInventory.quantity = quantityDelta;
+                    newInventory.availableQuantity = newInventory.quantity;
+                    newInventory.unitCost = movement.receivedValue / movement.receivedQuantity;
+                    newInventory.createdAt = now;
+                    newInventory.createdBy = currentUserId;
+                    newInventory.status = ERP::Common::EntityStatus::ACTIVE;
+                    newInventory.lotNumber = line.lotNumber;
+                    newInventory.serialNumber = line.serialNumber;
+                    newInventory.manufactureDate = line.manufactureDate;
+                    newInventory.expirationDate = line.expirationDate;
+                    newInventories.push_back(std::move(newInventory));
+                    oldQuantities.emplace(key, 0.0);
+                    continue;
+                }
+                deltas.push_back({it->second.id, quantityDelta, movement.receivedQuantity, movement.receivedValue});
+                oldQuantities.emplace(key, it->second.quantity);
+            }
+            if (!inventoryDAO_->createMany(newInventories)) {
+                ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to write inventory records for inventory movements.");
+                return false;
+            }
+            std::optional<std::size_t> applied = inventoryDAO_->applyQuantityDeltas(deltas, currentUserId);
+            if (!applied) {
+                ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to write inventory records for inventory movements.");
+                return false;
+            }
+            if (*applied != deltas.size()) {
+                // A row fell below an issue between the read of Step 1 and the write
+                ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Insufficient quantity for inventory movements; " + std::to_string(deltas.size() - *applied) + " positions were not applied.");
+                ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InsufficientStock, "Không đủ số lượng tồn kho để xuất.");
+                return false;
+            }
+
+            // Cache and publish the rows as stored, reserved quantities included
+            for (auto& [key, inventory] : readPositions(productIds, [&movements](const std::string& k) { return movements.count(k) > 0; })) {
+                changedPositions.emplace_back(std::move(inventory), oldQuantities[key]);
+            }
+
+            // One level change per position, delivered together after commit
+            for (const auto& [inventory, oldQuantity] : changedPositions) {
+                cachePositionAfterCommit(inventory);
+                eventBus_.publish(std::make_shared<EventBus::InventoryLevelChangedEvent>(
+                    inventory.productId, inventory.warehouseId, inventory.locationId,
+                    oldQuantity, inventory.quantity, "InventoryMovements"
+                ));
+            }
+            return true;
+        },
+        "InventoryManagementService", "recordInventoryMovements"
+    );
+
+    if (success) {
+        ERP::Logger::Logger::getInstance().info("InventoryManagementService: Recorded " + std::to_string(lines.size()) + " inventory movements over " + std::to_string(movements.size()) + " positions.");
+        recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
+                       ERP::Security::DTO::AuditActionType::UPDATE, ERP::Common::LogSeverity::INFO,
+                       "Warehouse", "InventoryMovements", changedPositions.front().first.id, "Inventory", std::to_string(movements.size()) + " positions",
+                       std::nullopt, std::nullopt, "Recorded " + std::to_string(lines.size()) + " inventory movement lines over " + std::to_string(movements.size()) + " positions.");
+        return true;
+    }
+    return false;
+}
+
 bool InventoryManagementService::reserveInventory(
     const std::string& productId,
     const std::string& warehouseId,
@@ -618,6 +1027,7 @@ bool InventoryManagementService::reserveInventory(
         return false;
     }
 
+    // The row only supplies the id; availability is checked by the conditional UPDATE against the stored values
     std::optional<ERP::Warehouse::DTO::InventoryDTO> inventoryOpt = getInventoryByProductLocation(productId, warehouseId, locationId, userRoleIds);
     if (!inventoryOpt) {
         ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Inventory record not found for product " + productId + " at " + warehouseId + "/" + locationId + " for reservation.");
@@ -626,24 +1036,19 @@ bool InventoryManagementService::reserveInventory(
     }
     ERP::Warehouse::DTO::InventoryDTO currentInventory = *inventoryOpt;
 
-    if (currentInventory.availableQuantity.value_or(0.0) < quantityToReserve) {
-        ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Insufficient available quantity for reservation. Product " + productId + ", available: " + std::to_string(currentInventory.availableQuantity.value_or(0.0)) + ", requested: " + std::to_string(quantityToReserve) + ".");
-        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InsufficientStock, "Không đủ số lượng tồn kho khả dụng để đặt trước.");
-        return false;
-    }
-
-    ERP::Warehouse::DTO::InventoryDTO updatedInventory = currentInventory;
-    updatedInventory.reservedQuantity = updatedInventory.reservedQuantity.value_or(0.0) + quantityToReserve;
-    updatedInventory.availableQuantity = updatedInventory.quantity - updatedInventory.reservedQuantity.value_or(0.0);
-    updatedInventory.updatedAt = ERP::Utils::DateUtils::now();
-    updatedInventory.updatedBy = currentUserId;
-
     bool success = executeTransaction(
         [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
-            if (!inventoryDAO_->update(updatedInventory)) {
+            std::optional<std::size_t> applied = inventoryDAO_->applyReservationDeltas({{currentInventory.id, quantityToReserve}}, currentUserId);
+            if (!applied) {
                 ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to update inventory for reservation.");
                 return false;
             }
+            if (*applied == 0) {
+                ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Insufficient available quantity for reservation. Product " + productId + ", requested: " + std::to_string(quantityToReserve) + ".");
+                ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InsufficientStock, "Không đủ số lượng tồn kho khả dụng để đặt trước.");
+                return false;
+            }
+            dropPositionAfterCommit(currentInventory);
             return true;
         },
         "InventoryManagementService", "reserveInventory"
@@ -651,6 +1056,9 @@ bool InventoryManagementService::reserveInventory(
 
     if (success) {
         ERP::Logger::Logger::getInstance().info("InventoryManagementService: Reserved " + std::to_string(quantityToReserve) + " of product " + productId + " successfully.");
+        ERP::Warehouse::DTO::InventoryDTO updatedInventory = currentInventory; // As last read, plus the reservation
+        updatedInventory.reservedQuantity = updatedInventory.reservedQuantity.value_or(0.0) + quantityToReserve;
+        updatedInventory.availableQuantity = updatedInventory.quantity - updatedInventory.reservedQuantity.value_or(0.0);
         recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
                        ERP::Security::DTO::AuditActionType::UPDATE, ERP::Common::LogSeverity::INFO,
                        "Warehouse", "InventoryReservation", currentInventory.id, "Inventory", currentInventory.productId,
@@ -660,6 +1068,79 @@ bool InventoryManagementService::reserveInventory(
     return false;
 }
 
+bool InventoryManagementService::reserveMany(
+    const std::vector<InventoryReservationRequest>& reservations,
+    const std::string& currentUserId,
+    const std::vector<std::string>& userRoleIds) {
+    ERP::Logger::Logger::getInstance().info("InventoryManagementService: Reserving " + std::to_string(reservations.size()) + " lines by " + currentUserId + ".");
+
+    if (!checkPermission(currentUserId, userRoleIds, "Warehouse.ReserveInventory", "Bạn không có quyền đặt trước tồn kho.")) {
+        return false;
+    }
+    if (reservations.empty()) {
+        return true;
+    }
+
+    // Lines of the same position are merged; a sales order may list a product twice
+    std::map<std::string, double> quantities; // Position key -> quantity to reserve
+    std::set<std::string> productIds;
+    for (const auto& reservation : reservations) {
+        if (reservation.quantity <= 0) {
+            ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Quantity to reserve must be positive.");
+            ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Số lượng đặt trước phải là số dương.");
+            return false;
+        }
+        quantities[InventoryPositionCache::makeKey(reservation.productId, reservation.warehouseId, reservation.locationId)] += reservation.quantity;
+        productIds.insert(reservation.productId);
+    }
+
+    std::string firstInventoryId;
+    bool success = executeTransaction(
+        [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
+            std::map<std::string, ERP::Warehouse::DTO::InventoryDTO> positions = readPositions(productIds,
+                [&quantities](const std::string& key) { return quantities.count(key) > 0; });
+            std::vector<DAOs::InventoryReservationDelta> deltas;
+            deltas.reserve(quantities.size());
+            for (const auto& [key, quantity] : quantities) {
+                auto it = positions.find(key);
+                if (it == positions.end()) {
+                    ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Inventory record not found for a position of the reservation batch.");
+                    ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::NotFound, "Không tìm thấy bản ghi tồn kho để đặt trước.");
+                    return false;
+                }
+                deltas.push_back({it->second.id, quantity});
+            }
+
+            std::optional<std::size_t> applied = inventoryDAO_->applyReservationDeltas(deltas, currentUserId);
+            if (!applied) {
+                ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to update inventory for the reservation batch.");
+                return false;
+            }
+            if (*applied < deltas.size()) { // The reservations already applied roll back with the transaction
+                ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Insufficient available quantity for " + std::to_string(deltas.size() - *applied) + " of " + std::to_string(deltas.size()) + " positions of the reservation batch.");
+                ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InsufficientStock, "Không đủ số lượng tồn kho khả dụng để đặt trước.");
+                return false;
+            }
+            for (const auto& [key, inventory] : positions) {
+                dropPositionAfterCommit(inventory);
+            }
+            firstInventoryId = deltas.front().inventoryId;
+            return true;
+        },
+        "InventoryManagementService", "reserveMany"
+    );
+
+    if (success) {
+        ERP::Logger::Logger::getInstance().info("InventoryManagementService: Reserved " + std::to_string(reservations.size()) + " lines over " + std::to_string(quantities.size()) + " positions.");
+        recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
+                       ERP::Security::DTO::AuditActionType::UPDATE, ERP::Common::LogSeverity::INFO,
+                       "Warehouse", "InventoryReservationBatch", firstInventoryId, "Inventory", std::to_string(quantities.size()) + " positions",
+                       std::nullopt, std::nullopt, "Reserved " + std::to_string(reservations.size()) + " lines over " + std::to_string(quantities.size()) + " positions.");
+        return true;
+    }
+    return false;
+}
+
 bool InventoryManagementService::unreserveInventory(
     const std::string& productId,
     const std::string& warehouseId,
@@ -686,24 +1167,19 @@ bool InventoryManagementService::unreserveInventory(
     }
     ERP::Warehouse::DTO::InventoryDTO currentInventory = *inventoryOpt;
 
-    if (currentInventory.reservedQuantity.value_or(0.0) < quantityToUnreserve) {
-        ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Quantity to unreserve exceeds reserved quantity for product " + productId + ".");
-        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Số lượng hủy đặt trước vượt quá số lượng đã đặt trước.");
-        return false;
-    }
-
-    ERP::Warehouse::DTO::InventoryDTO updatedInventory = currentInventory;
-    updatedInventory.reservedQuantity = updatedInventory.reservedQuantity.value_or(0.0) - quantityToUnreserve;
-    updatedInventory.availableQuantity = updatedInventory.quantity - updatedInventory.reservedQuantity.value_or(0.0);
-    updatedInventory.updatedAt = ERP::Utils::DateUtils::now();
-    updatedInventory.updatedBy = currentUserId;
-
     bool success = executeTransaction(
         [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
-            if (!inventoryDAO_->update(updatedInventory)) {
+            std::optional<std::size_t> applied = inventoryDAO_->applyReservationDeltas({{currentInventory.id, -quantityToUnreserve}}, currentUserId);
+            if (!applied) {
                 ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to update inventory for unreservation.");
                 return false;
             }
+            if (*applied == 0) {
+                ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Quantity to unreserve exceeds reserved quantity for product " + productId + ".");
+                ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Số lượng hủy đặt trước vượt quá số lượng đã đặt trước.");
+                return false;
+            }
+            dropPositionAfterCommit(currentInventory);
             return true;
         },
         "InventoryManagementService", "unreserveInventory"
@@ -711,6 +1187,9 @@ bool InventoryManagementService::unreserveInventory(
 
     if (success) {
         ERP::Logger::Logger::getInstance().info("InventoryManagementService: Unreserved " + std::to_string(quantityToUnreserve) + " of product " + productId + " successfully.");
+        ERP::Warehouse::DTO::InventoryDTO updatedInventory = currentInventory; // As last read, minus the released quantity
+        updatedInventory.reservedQuantity = updatedInventory.reservedQuantity.value_or(0.0) - quantityToUnreserve;
+        updatedInventory.availableQuantity = updatedInventory.quantity - updatedInventory.reservedQuantity.value_or(0.0);
         recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
                        ERP::Security::DTO::AuditActionType::UPDATE, ERP::Common::LogSeverity::INFO,
                        "Warehouse", "InventoryUnreservation", currentInventory.id, "Inventory", currentInventory.productId,
@@ -848,6 +1327,7 @@ bool InventoryManagementService::deleteInventory(
                 ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to delete inventory record " + inventoryId + " in DAO.");
                 return false;
             }
+            dropPositionAfterCommit(inventoryToDelete);
             return true;
         },
         "InventoryManagementService", "deleteInventory"
@@ -920,7 +1400,7 @@ bool InventoryManagementService::recordInventoryCostLayer(
 
     bool success = executeTransaction(
         [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
-            if (!inventoryCostLayerDAO_->create(newCostLayer)) { // Specific DAO method
+            if (!inventoryCostLayerDAO_->create(newCostLayer) || !costLayerEngine_->addLayer(newCostLayer)) { // Specific DAO method
                 ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to create inventory cost layer in DAO.");
                 return false;
             }
@@ -940,7 +1420,7 @@ bool InventoryManagementService::recordInventoryCostLayer(
     return false;
 }
 
-bool InventoryManagementService::consumeInventoryCostLayers(
+std::optional<double> InventoryManagementService::consumeInventoryCostLayers(
     const std::string& productId,
     const std::string& warehouseId,
     const std::string& locationId,
@@ -950,62 +1430,33 @@ bool InventoryManagementService::consumeInventoryCostLayers(
     ERP::Logger::Logger::getInstance().info("InventoryManagementService: Consuming " + std::to_string(quantityToConsume) + " from cost layers for product " + productId + " at " + warehouseId + "/" + locationId + ".");
 
     if (!checkPermission(currentUserId, userRoleIds, "Warehouse.ConsumeInventoryCostLayers", "Bạn không có quyền tiêu thụ lớp chi phí tồn kho.")) {
-        return false;
+        return std::nullopt;
     }
     if (quantityToConsume <= 0) {
         ERP::Logger::Logger::getInstance().warning("InventoryManagementService: Quantity to consume must be positive.");
         ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Số lượng tiêu thụ phải là số dương.");
-        return false;
+        return std::nullopt;
     }
 
-    std::map<std::string, std::any> filters;
-    filters["product_id"] = productId;
-    filters["warehouse_id"] = warehouseId;
-    filters["location_id"] = locationId;
-    filters["remaining_quantity_gt"] = 0.0; // Only get layers with remaining quantity
-    // Order by receipt_date ASC for FIFO, or DESC for LIFO
-    std::vector<ERP::Warehouse::DTO::InventoryCostLayerDTO> activeLayers = inventoryCostLayerDAO_->getCostLayers(filters); // Assuming getCostLayers supports ordering
-
-    double remainingToConsume = quantityToConsume;
-
+    // The engine costs the issue in memory; the touched layers are written in one batch before COMMIT
+    std::optional<double> costOfGoodsIssued;
     bool success = executeTransaction(
         [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
-            for (auto& layer : activeLayers) {
-                if (remainingToConsume <= 0) break; // All consumed
-                
-                double consumeFromThisLayer = std::min(remainingToConsume, layer.remainingQuantity);
-                
-                ERP::Warehouse::DTO::InventoryCostLayerDTO updatedLayer = layer;
-                updatedLayer.remainingQuantity -= consumeFromThisLayer;
-                updatedLayer.updatedAt = ERP::Utils::DateUtils::now();
-                updatedLayer.updatedBy = currentUserId;
-
-                if (!inventoryCostLayerDAO_->update(updatedLayer)) { // Specific DAO method
-                    ERP::Logger::Logger::getInstance().error("InventoryManagementService: Failed to update cost layer " + layer.id + " during consumption.");
-                    return false;
-                }
-                remainingToConsume -= consumeFromThisLayer;
-            }
-
-            if (remainingToConsume > 0) {
-                ERP::Logger::Logger::getInstance().error("InventoryManagementService: Not enough quantity in cost layers to consume. Remaining: " + std::to_string(remainingToConsume));
-                ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InsufficientStock, "Không đủ số lượng trong lớp chi phí tồn kho để tiêu thụ.");
-                return false;
-            }
-            return true;
+            costOfGoodsIssued = costLayerEngine_->issue(productId, warehouseId, locationId, quantityToConsume, currentUserId);
+            return costOfGoodsIssued.has_value();
         },
         "InventoryManagementService", "consumeInventoryCostLayers"
     );
 
     if (success) {
-        ERP::Logger::Logger::getInstance().info("InventoryManagementService: Consumed " + std::to_string(quantityToConsume) + " from cost layers for product " + productId + " successfully.");
+        ERP::Logger::Logger::getInstance().info("InventoryManagementService: Consumed " + std::to_string(quantityToConsume) + " from cost layers for product " + productId + " successfully. Cost of goods issued: " + std::to_string(*costOfGoodsIssued) + ".");
         recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
                        ERP::Security::DTO::AuditActionType::UPDATE, ERP::Common::LogSeverity::INFO,
                        "Warehouse", "InventoryCostLayerConsumption", productId, "Product", productId,
                        std::nullopt, std::nullopt, "Consumed quantity from cost layers."); // Before/after data could be more specific
-        return true;
+        return costOfGoodsIssued;
     }
-    return false;
+    return std::nullopt;
 }
 
 } // namespace Services
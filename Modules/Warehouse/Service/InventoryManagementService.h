@@ -7,12 +7,17 @@
 #include <memory>
 #include <map>
 #include <set> // For permissions
+#include <functional> // For std::function
 
 // Rút gọn các include paths
 #include "BaseService.h"        // Base Service
+#include "IInventoryManagementService.h" // Interface
+#include "InventoryPositionCache.h" // Position cache
+#include "InventoryCostLayerEngine.h" // Cost layer engine
 #include "Inventory.h"          // Inventory DTO
 #include "InventoryTransaction.h" // InventoryTransaction DTO
 #include "InventoryCostLayer.h" // InventoryCostLayer DTO
+#include "DAOBase/Paging.h"     // PageRequest, Page
 #include "Product.h"            // Product DTO
 #include "Warehouse.h"          // Warehouse DTO
 #include "Location.h"           // Location DTO
@@ -43,159 +48,105 @@ namespace Warehouse {
 namespace Services {
 
 /**
- * @brief IInventoryManagementService interface defines operations for managing inventory levels and movements.
+ * @brief Default implementation of IInventoryManagementService.
+ * Positions read by (product, warehouse, location) are served from an InventoryPositionCache,
+ * written through by this service's own commits and invalidated on InventoryLevelChangedEvent.
  */
-class IInventoryManagementService {
+class InventoryManagementService : public IInventoryManagementService, public ERP::Common::Services::BaseService { // Inherit BaseService
 public:
-    virtual ~IInventoryManagementService() = default;
     /**
-     * @brief Creates a new inventory record for a product at a specific location.
-     * @param inventoryDTO DTO containing initial inventory information.
-     * @param currentUserId ID of the user performing the operation.
-     * @param userRoleIds Roles of the user performing the operation.
-     * @return An optional InventoryDTO if creation is successful, std::nullopt otherwise.
-     */
-    virtual std::optional<ERP::Warehouse::DTO::InventoryDTO> createInventory(
+     * @brief Constructor for InventoryManagementService.
+     * @param inventoryDAO Shared pointer to InventoryDAO.
+     * @param inventoryTransactionDAO Shared pointer to InventoryTransactionDAO (unused; transactions go through InventoryTransactionService).
+     * @param inventoryCostLayerDAO Shared pointer to InventoryCostLayerDAO.
+     * @param productService Shared pointer to IProductService.
+     * @param warehouseService Shared pointer to IWarehouseService.
+     * @param locationService Shared pointer to ILocationService.
+     * @param inventoryTransactionService Shared pointer to IInventoryTransactionService.
+     * @param authorizationService Shared pointer to IAuthorizationService.
+     * @param auditLogService Shared pointer to IAuditLogService.
+     * @param connectionPool Shared pointer to ConnectionPool.
+     * @param securityManager Shared pointer to ISecurityManager.
+     */
+    InventoryManagementService(std::shared_ptr<DAOs::InventoryDAO> inventoryDAO,
+                               std::shared_ptr<DAOs::InventoryTransactionDAO> inventoryTransactionDAO,
+                               std::shared_ptr<DAOs::InventoryCostLayerDAO> inventoryCostLayerDAO,
+                               std::shared_ptr<ERP::Product::Services::IProductService> productService,
+                               std::shared_ptr<ERP::Catalog::Services::IWarehouseService> warehouseService,
+                               std::shared_ptr<ERP::Catalog::Services::ILocationService> locationService,
+                               std::shared_ptr<ERP::Warehouse::Services::IInventoryTransactionService> inventoryTransactionService,
+                               std::shared_ptr<ERP::Security::Service::IAuthorizationService> authorizationService,
+                               std::shared_ptr<ERP::Security::Service::IAuditLogService> auditLogService,
+                               std::shared_ptr<ERP::Database::ConnectionPool> connectionPool,
+                               std::shared_ptr<ERP::Security::ISecurityManager> securityManager);
+    ~InventoryManagementService() override;
+
+    std::optional<ERP::Warehouse::DTO::InventoryDTO> createInventory(
         const ERP::Warehouse::DTO::InventoryDTO& inventoryDTO,
         const std::string& currentUserId,
-        const std::vector<std::string>& userRoleIds) = 0;
-    /**
-     * @brief Retrieves inventory information by ID.
-     * @param inventoryId ID of the inventory record to retrieve.
-     * @param userRoleIds Roles of the user performing the operation.
-     * @return An optional InventoryDTO if found, std::nullopt otherwise.
-     */
-    virtual std::optional<ERP::Warehouse::DTO::InventoryDTO> getInventoryById(
+        const std::vector<std::string>& userRoleIds) override;
+    std::optional<ERP::Warehouse::DTO::InventoryDTO> getInventoryById(
         const std::string& inventoryId,
-        const std::vector<std::string>& userRoleIds = {}) = 0;
-    /**
-     * @brief Retrieves inventory information for a specific product at a given warehouse and location.
-     * @param productId ID of the product.
-     * @param warehouseId ID of the warehouse.
-     * @param locationId ID of the location.
-     * @param userRoleIds Roles of the user performing the operation.
-     * @return An optional InventoryDTO if found, std::nullopt otherwise.
-     */
-    virtual std::optional<ERP::Warehouse::DTO::InventoryDTO> getInventoryByProductLocation(
+        const std::vector<std::string>& userRoleIds = {}) override;
+    std::optional<ERP::Warehouse::DTO::InventoryDTO> getInventoryByProductLocation(
         const std::string& productId,
         const std::string& warehouseId,
         const std::string& locationId,
-        const std::vector<std::string>& userRoleIds = {}) = 0;
-    /**
-     * @brief Retrieves all inventory records or records matching a filter.
-     * @param filter Map of filter conditions.
-     * @param userRoleIds Roles of the user performing the operation.
-     * @return Vector of matching InventoryDTOs.
-     */
-    virtual std::vector<ERP::Warehouse::DTO::InventoryDTO> getAllInventory(
+        const std::vector<std::string>& userRoleIds = {}) override;
+    std::vector<ERP::Warehouse::DTO::InventoryDTO> getInventoryByKeys(
+        const std::vector<InventoryPositionKey>& keys,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds) override;
+    std::vector<ERP::Warehouse::DTO::InventoryDTO> getAllInventory(
         const std::map<std::string, std::any>& filter = {},
-        const std::vector<std::string>& userRoleIds = {}) = 0;
-    /**
-     * @brief Retrieves all inventory records for a specific product across all warehouses/locations.
-     * @param productId ID of the product.
-     * @param userRoleIds Roles of the user performing the operation.
-     * @return Vector of matching InventoryDTOs.
-     */
-    virtual std::vector<ERP::Warehouse::DTO::InventoryDTO> getInventoryByProduct(
+        const std::vector<std::string>& userRoleIds = {}) override;
+    ERP::DAOBase::Page<ERP::Warehouse::DTO::InventoryDTO> getInventoryPage(
+        const std::map<std::string, std::any>& filter,
+        const ERP::DAOBase::PageRequest& pageRequest,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds = {}) override;
+    std::vector<ERP::Warehouse::DTO::InventoryDTO> getInventoryByProduct(
         const std::string& productId,
-        const std::vector<std::string>& userRoleIds = {}) = 0;
-    /**
-     * @brief Updates inventory information (e.g., reorder levels).
-     * @param inventoryDTO DTO containing updated inventory information (must have ID).
-     * @param currentUserId ID of the user performing the operation.
-     * @param userRoleIds Roles of the user performing the operation.
-     * @return true if update is successful, false otherwise.
-     */
-    virtual bool updateInventory(
+        const std::vector<std::string>& userRoleIds = {}) override;
+    bool updateInventory(
         const ERP::Warehouse::DTO::InventoryDTO& inventoryDTO,
         const std::string& currentUserId,
-        const std::vector<std::string>& userRoleIds) = 0;
-    /**
-     * @brief Records a goods receipt, increasing inventory quantity.
-     * This method also creates an InventoryTransaction.
-     * @param transactionDTO DTO containing details of the goods receipt.
-     * @param currentUserId ID of the user performing the operation.
-     * @param userRoleIds Roles of the user performing the operation.
-     * @return true if receipt is successful, false otherwise.
-     */
-    virtual bool recordGoodsReceipt(
+        const std::vector<std::string>& userRoleIds) override;
+    bool recordGoodsReceipt(
         const ERP::Warehouse::DTO::InventoryTransactionDTO& transactionDTO,
         const std::string& currentUserId,
-        const std::vector<std::string>& userRoleIds) = 0;
-    /**
-     * @brief Records a goods issue, decreasing inventory quantity.
-     * This method also creates an InventoryTransaction.
-     * @param transactionDTO DTO containing details of the goods issue.
-     * @param currentUserId ID of the user performing the operation.
-     * @param userRoleIds Roles of the user performing the operation.
-     * @return true if issue is successful, false otherwise.
-     */
-    virtual bool recordGoodsIssue(
+        const std::vector<std::string>& userRoleIds) override;
+    bool recordGoodsIssue(
         const ERP::Warehouse::DTO::InventoryTransactionDTO& transactionDTO,
         const std::string& currentUserId,
-        const std::vector<std::string>& userRoleIds) = 0;
-    /**
-     * @brief Adjusts inventory quantity (in or out) for discrepancies.
-     * This method also creates an InventoryTransaction.
-     * @param transactionDTO DTO containing details of the adjustment.
-     * @param currentUserId ID of the user performing the operation.
-     * @param userRoleIds Roles of the user performing the operation.
-     * @return true if adjustment is successful, false otherwise.
-     */
-    virtual bool adjustInventory(
+        const std::vector<std::string>& userRoleIds) override;
+    bool adjustInventory(
         const ERP::Warehouse::DTO::InventoryTransactionDTO& transactionDTO,
         const std::string& currentUserId,
-        const std::vector<std::string>& userRoleIds) = 0;
-    /**
-     * @brief Reserves a specified quantity of a product in inventory.
-     * Decreases available quantity and increases reserved quantity.
-     * @param productId ID of the product.
-     * @param warehouseId ID of the warehouse.
-     * @param locationId ID of the location.
-     * @param quantityToReserve Quantity to reserve.
-     * @param currentUserId ID of the user performing the operation.
-     * @param userRoleIds Roles of the user performing the operation.
-     * @return true if reservation is successful, false otherwise.
-     */
-    virtual bool reserveInventory(
+        const std::vector<std::string>& userRoleIds) override;
+    bool recordInventoryMovements(
+        const std::vector<ERP::Warehouse::DTO::InventoryTransactionDTO>& transactionDTOs,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds) override;
+    bool reserveInventory(
         const std::string& productId,
         const std::string& warehouseId,
         const std::string& locationId,
         double quantityToReserve,
         const std::string& currentUserId,
-        const std::vector<std::string>& userRoleIds) = 0;
-    /**
-     * @brief Unreserves a specified quantity of a product in inventory.
-     * Increases available quantity and decreases reserved quantity.
-     * @param productId ID of the product.
-     * @param warehouseId ID of the warehouse.
-     * @param locationId ID of the location.
-     * @param quantityToUnreserve Quantity to unreserve.
-     * @param currentUserId ID of the user performing the operation.
-     * @param userRoleIds Roles of the user performing the operation.
-     * @return true if unreservation is successful, false otherwise.
-     */
-    virtual bool unreserveInventory(
+        const std::vector<std::string>& userRoleIds) override;
+    bool reserveMany(
+        const std::vector<InventoryReservationRequest>& reservations,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds) override;
+    bool unreserveInventory(
         const std::string& productId,
         const std::string& warehouseId,
         const std::string& locationId,
         double quantityToUnreserve,
         const std::string& currentUserId,
-        const std::vector<std::string>& userRoleIds) = 0;
-    /**
-     * @brief Transfers stock from one location to another within or between warehouses.
-     * Creates two inventory transactions (issue from source, receipt to destination).
-     * @param productId ID of the product.
-     * @param sourceWarehouseId Source warehouse ID.
-     * @param sourceLocationId Source location ID.
-     * @param destinationWarehouseId Destination warehouse ID.
-     * @param destinationLocationId Destination location ID.
-     * @param quantity Quantity to transfer.
-     * @param currentUserId ID of the user performing the operation.
-     * @param userRoleIds Roles of the user performing the operation.
-     * @return true if transfer is successful, false otherwise.
-     */
-    virtual bool transferStock(
+        const std::vector<std::string>& userRoleIds) override;
+    bool transferStock(
         const std::string& productId,
         const std::string& sourceWarehouseId,
         const std::string& sourceLocationId,
@@ -203,62 +154,89 @@ public:
         const std::string& destinationLocationId,
         double quantity,
         const std::string& currentUserId,
-        const std::vector<std::string>& userRoleIds) = 0;
-    /**
-     * @brief Deletes an inventory record by ID (soft delete).
-     * @param inventoryId ID of the inventory record to delete.
-     * @param currentUserId ID of the user performing the operation.
-     * @param userRoleIds Roles of the user performing the operation.
-     * @return true if deletion is successful, false otherwise.
-     */
-    virtual bool deleteInventory(
+        const std::vector<std::string>& userRoleIds) override;
+    bool deleteInventory(
         const std::string& inventoryId,
         const std::string& currentUserId,
-        const std::vector<std::string>& userRoleIds) = 0;
-    /**
-     * @brief Gets the default location ID for a given warehouse.
-     * @param warehouseId The ID of the warehouse.
-     * @param userRoleIds The roles of the current user.
-     * @return An optional string containing the default location ID, or std::nullopt if not found.
-     */
-    virtual std::optional<std::string> getDefaultLocationForWarehouse(
+        const std::vector<std::string>& userRoleIds) override;
+    std::optional<std::string> getDefaultLocationForWarehouse(
         const std::string& warehouseId,
-        const std::vector<std::string>& userRoleIds) = 0;
-
-    // NEW: Inventory Cost Layer Management (if implemented)
-    /**
-     * @brief Records a new cost layer for inventory (e.g., for FIFO/LIFO costing).
-     * This is typically called internally by recordGoodsReceipt.
-     * @param costLayerDTO DTO containing cost layer details.
-     * @param currentUserId ID of the user performing the operation.
-     * @param userRoleIds Roles of the user.
-     * @return true if successful, false otherwise.
-     */
-    virtual bool recordInventoryCostLayer(
+        const std::vector<std::string>& userRoleIds) override;
+    bool recordInventoryCostLayer(
         const ERP::Warehouse::DTO::InventoryCostLayerDTO& costLayerDTO,
         const std::string& currentUserId,
-        const std::vector<std::string>& userRoleIds) = 0;
-    /**
-     * @brief Consumes quantity from inventory cost layers (e.g., when goods are issued).
-     * This is typically called internally by recordGoodsIssue.
-     * @param productId ID of the product.
-     * @param warehouseId ID of the warehouse.
-     * @param locationId ID of the location.
-     * @param quantityToConsume Quantity to consume from layers.
-     * @param currentUserId ID of the user performing the operation.
-     * @param userRoleIds Roles of the user.
-     * @return true if successful, false otherwise.
-     */
-    virtual bool consumeInventoryCostLayers(
+        const std::vector<std::string>& userRoleIds) override;
+    std::optional<double> consumeInventoryCostLayers(
         const std::string& productId,
         const std::string& warehouseId,
         const std::string& locationId,
         double quantityToConsume,
         const std::string& currentUserId,
-        const std::vector<std::string>& userRoleIds) = 0;
+        const std::vector<std::string>& userRoleIds) override;
+    std::vector<InventoryPositionCacheStats> getPositionCacheStats() const override;
+
+private:
+    std::shared_ptr<DAOs::InventoryDAO> inventoryDAO_;
+    std::shared_ptr<DAOs::InventoryCostLayerDAO> inventoryCostLayerDAO_;
+    std::shared_ptr<ERP::Product::Services::IProductService> productService_;
+    std::shared_ptr<ERP::Catalog::Services::IWarehouseService> warehouseService_;
+    std::shared_ptr<ERP::Catalog::Services::ILocationService> locationService_;
+    std::shared_ptr<ERP::Warehouse::Services::IInventoryTransactionService> inventoryTransactionService_;
+    // Inherited: authorizationService_, auditLogService_, connectionPool_, securityManager_
+
+    ERP::EventBus::EventBus& eventBus_ = ERP::EventBus::EventBus::getInstance();
+
+    std::shared_ptr<InventoryPositionCache> positionCache_; // Shared with the event handler
+    ERP::EventBus::SubscriptionId levelChangedSubscription_ = 0;
+    std::shared_ptr<InventoryCostLayerEngine> costLayerEngine_; // FIFO costing of goods issues
+
+    static constexpr std::size_t POSITION_PRODUCT_CHUNK_SIZE = 500; // Products per IN list when reading a batch's positions
+
+    /**
+     * @brief Reads the rows of many positions from the database, one query per POSITION_PRODUCT_CHUNK_SIZE products.
+     * @param productIds Products of the positions.
+     * @param isWanted Tells from a position key whether the row is needed; the other rows of the products are skipped.
+     * @return The rows by position key.
+     */
+    std::map<std::string, ERP::Warehouse::DTO::InventoryDTO> readPositions(
+        const std::set<std::string>& productIds, const std::function<bool(const std::string&)>& isWanted);
+
+    /**
+     * @brief Reads a position through the cache. Inside a transaction, positions the transaction
+     * wrote are read from the database, and rows read from the database are not cached.
+     */
+    std::optional<ERP::Warehouse::DTO::InventoryDTO> findPosition(
+        const std::string& productId, const std::string& warehouseId, const std::string& locationId);
+
+    /**
+     * @brief Reads a position from the database, bypassing the cache. Used inside a transaction
+     * before a write that depends on the row.
+     */
+    std::optional<ERP::Warehouse::DTO::InventoryDTO> readPosition(
+        const std::string& productId, const std::string& warehouseId, const std::string& locationId);
+
+    /**
+     * @brief Applies one quantity delta with InventoryDAO::applyQuantityDeltas and reads the row back on
+     * the transaction's connection, so the cache and the events get the row as it was written.
+     * @param insufficient Set when an outgoing delta found less than its quantity in the row.
+     * @return The row after the change, or std::nullopt if the delta was not applied.
+     */
+    std::optional<ERP::Warehouse::DTO::InventoryDTO> applyPositionDelta(
+        const DAOs::InventoryQuantityDelta& delta, const std::string& userId, bool& insufficient);
+
+    /**
+     * @brief Writes a row through to the cache once the enclosing transaction commits.
+     * Until then the position is dropped, so no thread reads the pre-commit row from memory.
+     */
+    void cachePositionAfterCommit(const ERP::Warehouse::DTO::InventoryDTO& inventory);
+
+    /**
+     * @brief Drops a deleted row from the cache now and again once the enclosing transaction commits.
+     */
+    void dropPositionAfterCommit(const ERP::Warehouse::DTO::InventoryDTO& inventory);
 };
 
 } // namespace Services
 } // namespace Warehouse
 } // namespace ERP
-#endif // MODULES_WAREHOUSE_SERVICE_IINVENTORYMANAGEMENTSERVICE_H
\ No newline at end of file
+#endif // MODULES_WAREHOUSE_SERVICE_INVENTORYMANAGEMENTSERVICE_H
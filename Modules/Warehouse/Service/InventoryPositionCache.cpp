@@ -0,0 +1,99 @@
+// Modules/Warehouse/Service/InventoryPositionCache.cpp
+#include "InventoryPositionCache.h" // Standard includes
+#include <algorithm> // For std::max
+#include <functional>// For std::hash
+
+namespace ERP {
+namespace Warehouse {
+namespace Services {
+
+InventoryPositionCache::InventoryPositionCache(std::size_t shardCount)
+    : shards_(new Shard[std::max<std::size_t>(1, shardCount)]),
+      shardCount_(std::max<std::size_t>(1, shardCount)) {}
+
+std::string InventoryPositionCache::makeKey(const std::string& productId, const std::string& warehouseId, const std::string& locationId) {
+    std::string key;
+    key.reserve(productId.size() + warehouseId.size() + locationId.size() + 2);
+    key.append(productId).push_back('\x1f'); // Unit separator: never part of an id
+    key.append(warehouseId).push_back('\x1f');
+    key.append(locationId);
+    return key;
+}
+
+InventoryPositionCache::Shard& InventoryPositionCache::shardFor(const std::string& key) const {
+    return shards_[std::hash<std::string>{}(key) % shardCount_];
+}
+
+std::optional<ERP::Warehouse::DTO::InventoryDTO> InventoryPositionCache::get(const std::string& key) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.positions.find(key);
+    if (it == shard.positions.end()) {
+        ++shard.misses;
+        return std::nullopt;
+    }
+    ++shard.hits;
+    return it->second;
+}
+
+std::uint64_t InventoryPositionCache::loadEpoch(const std::string& key) const {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.epoch;
+}
+
+void InventoryPositionCache::fill(const ERP::Warehouse::DTO::InventoryDTO& inventory, std::uint64_t epoch) {
+    const std::string key = makeKey(inventory.productId, inventory.warehouseId, inventory.locationId);
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.epoch != epoch) {
+        return; // A commit or invalidation overtook this read; the row may be stale
+    }
+    shard.positions.emplace(key, inventory);
+}
+
+void InventoryPositionCache::put(const ERP::Warehouse::DTO::InventoryDTO& inventory) {
+    const std::string key = makeKey(inventory.productId, inventory.warehouseId, inventory.locationId);
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ++shard.epoch;
+    shard.positions[key] = inventory;
+}
+
+void InventoryPositionCache::invalidate(const std::string& key) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ++shard.epoch;
+    if (shard.positions.erase(key) > 0) {
+        ++shard.invalidations;
+    }
+}
+
+void InventoryPositionCache::clear() {
+    for (std::size_t i = 0; i < shardCount_; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        ++shards_[i].epoch;
+        shards_[i].invalidations += shards_[i].positions.size();
+        shards_[i].positions.clear();
+    }
+}
+
+std::vector<InventoryPositionCacheStats> InventoryPositionCache::getStats() const {
+    std::vector<InventoryPositionCacheStats> stats;
+    stats.reserve(shardCount_);
+    for (std::size_t i = 0; i < shardCount_; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        InventoryPositionCacheStats shardStats;
+        shardStats.shard = i;
+        shardStats.entries = shards_[i].positions.size();
+        shardStats.hits = shards_[i].hits;
+        shardStats.misses = shards_[i].misses;
+        shardStats.invalidations = shards_[i].invalidations;
+        stats.push_back(shardStats);
+    }
+    return stats;
+}
+
+} // namespace Services
+} // namespace Warehouse
+} // namespace ERP
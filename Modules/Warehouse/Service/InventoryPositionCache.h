@@ -0,0 +1,112 @@
+// Modules/Warehouse/Service/InventoryPositionCache.h
+#ifndef MODULES_WAREHOUSE_SERVICE_INVENTORYPOSITIONCACHE_H
+#define MODULES_WAREHOUSE_SERVICE_INVENTORYPOSITIONCACHE_H
+#include <string>
+#include <vector>
+#include <optional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+
+// Rút gọn các include paths
+#include "Inventory.h"          // Inventory DTO
+
+namespace ERP {
+namespace Warehouse {
+namespace Services {
+
+/**
+ * @brief Counters of one shard of the InventoryPositionCache.
+ */
+struct InventoryPositionCacheStats {
+    std::size_t shard = 0;          /**< Index of the shard */
+    std::size_t entries = 0;        /**< Positions held */
+    std::uint64_t hits = 0;         /**< Lookups answered from memory */
+    std::uint64_t misses = 0;       /**< Lookups that went to the database */
+    std::uint64_t invalidations = 0;/**< Entries dropped by invalidate() or a level change */
+
+    double hitRate() const {
+        const std::uint64_t lookups = hits + misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+    }
+};
+
+/**
+ * @brief In-memory copy of inventory rows keyed by (product, warehouse, location).
+ *
+ * Positions are spread over shards by key hash, each with its own mutex, so concurrent lookups
+ * of different positions rarely contend. Rows read from the database enter through fill(), which
+ * is refused if the shard was written or invalidated since the caller took its epoch: a reader
+ * that loaded a row before a commit cannot overwrite the row put() by that commit.
+ */
+class InventoryPositionCache {
+public:
+    /**
+     * @brief Constructs the cache.
+     * @param shardCount Number of shards (at least 1).
+     */
+    explicit InventoryPositionCache(std::size_t shardCount = 16);
+
+    /**
+     * @brief Builds the cache key of a position.
+     */
+    static std::string makeKey(const std::string& productId, const std::string& warehouseId, const std::string& locationId);
+
+    /**
+     * @brief Looks a position up and counts the hit or miss.
+     * @return The cached row, or std::nullopt if the position is not cached.
+     */
+    std::optional<ERP::Warehouse::DTO::InventoryDTO> get(const std::string& key);
+
+    /**
+     * @brief Gets the write epoch of the key's shard; take it before reading the row from the database.
+     */
+    std::uint64_t loadEpoch(const std::string& key) const;
+
+    /**
+     * @brief Caches a row read from the database, unless the position is cached already or the shard
+     * changed since loadEpoch().
+     */
+    void fill(const ERP::Warehouse::DTO::InventoryDTO& inventory, std::uint64_t epoch);
+
+    /**
+     * @brief Stores a row the service has just committed (write-through).
+     */
+    void put(const ERP::Warehouse::DTO::InventoryDTO& inventory);
+
+    /**
+     * @brief Drops a position.
+     */
+    void invalidate(const std::string& key);
+
+    /**
+     * @brief Drops every position.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the counters of every shard.
+     */
+    std::vector<InventoryPositionCacheStats> getStats() const;
+
+private:
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, ERP::Warehouse::DTO::InventoryDTO> positions;
+        std::uint64_t epoch = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t invalidations = 0;
+    };
+
+    Shard& shardFor(const std::string& key) const;
+
+    std::unique_ptr<Shard[]> shards_;
+    std::size_t shardCount_;
+};
+
+} // namespace Services
+} // namespace Warehouse
+} // namespace ERP
+#endif // MODULES_WAREHOUSE_SERVICE_INVENTORYPOSITIONCACHE_H
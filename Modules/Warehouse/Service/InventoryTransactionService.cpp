@@ -20,6 +20,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <algorithm> // For std::all_of if needed
+#include <set>       // For distinct ids of a batch
 
 namespace ERP {
 namespace Warehouse {
@@ -130,6 +131,112 @@ std::optional<ERP::Warehouse::DTO::InventoryTransactionDTO> InventoryTransaction
     return std::nullopt;
 }
 
+std::optional<std::vector<ERP::Warehouse::DTO::InventoryTransactionDTO>> InventoryTransactionService::createInventoryTransactions(
+    const std::vector<ERP::Warehouse::DTO::InventoryTransactionDTO>& transactionDTOs,
+    const std::string& currentUserId,
+    const std::vector<std::string>& userRoleIds) {
+    ERP::Logger::Logger::getInstance().info("InventoryTransactionService: Attempting to create " + std::to_string(transactionDTOs.size()) + " transactions by " + currentUserId + ".");
+
+    if (!checkPermission(currentUserId, userRoleIds, "Warehouse.CreateInventoryTransaction", "Bạn không có quyền tạo giao dịch tồn kho.")) {
+        return std::nullopt;
+    }
+    if (transactionDTOs.empty()) {
+        return std::vector<ERP::Warehouse::DTO::InventoryTransactionDTO>();
+    }
+
+    // 1. Validate every line and collect the distinct ids to look up
+    std::set<std::string> productIds;
+    std::set<std::string> warehouseIds;
+    std::set<std::pair<std::string, std::string>> locationWarehousePairs;
+    std::set<std::string> unitOfMeasureIds;
+    for (const auto& transactionDTO : transactionDTOs) {
+        if (transactionDTO.productId.empty() || transactionDTO.warehouseId.empty() || transactionDTO.locationId.empty() || transactionDTO.quantity == 0 || transactionDTO.unitOfMeasureId.empty() || transactionDTO.type == ERP::Warehouse::DTO::InventoryTransactionType::UNKNOWN) {
+            ERP::Logger::Logger::getInstance().warning("InventoryTransactionService: Invalid input for batch transaction creation (missing essential fields).");
+            ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Thông tin giao dịch tồn kho không đầy đủ.");
+            return std::nullopt;
+        }
+        productIds.insert(transactionDTO.productId);
+        warehouseIds.insert(transactionDTO.warehouseId);
+        locationWarehousePairs.emplace(transactionDTO.locationId, transactionDTO.warehouseId);
+        unitOfMeasureIds.insert(transactionDTO.unitOfMeasureId);
+    }
+
+    // 2. Validate each distinct Product, Warehouse, Location and Unit of Measure once
+    for (const auto& productId : productIds) {
+        std::optional<ERP::Product::DTO::ProductDTO> product = productService_->getProductById(productId, userRoleIds);
+        if (!product || product->status != ERP::Common::EntityStatus::ACTIVE) {
+            ERP::Logger::Logger::getInstance().warning("InventoryTransactionService: Invalid or inactive Product ID: " + productId);
+            ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "ID sản phẩm không hợp lệ hoặc không hoạt động.");
+            return std::nullopt;
+        }
+    }
+    for (const auto& warehouseId : warehouseIds) {
+        std::optional<ERP::Catalog::DTO::WarehouseDTO> warehouse = warehouseService_->getWarehouseById(warehouseId, userRoleIds);
+        if (!warehouse || warehouse->status != ERP::Common::EntityStatus::ACTIVE) {
+            ERP::Logger::Logger::getInstance().warning("InventoryTransactionService: Invalid or inactive Warehouse ID: " + warehouseId);
+            ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "ID kho hàng không hợp lệ hoặc không hoạt động.");
+            return std::nullopt;
+        }
+    }
+    std::map<std::string, std::optional<ERP::Catalog::DTO::LocationDTO>> locations;
+    for (const auto& [locationId, warehouseId] : locationWarehousePairs) {
+        auto it = locations.find(locationId);
+        if (it == locations.end()) {
+            it = locations.emplace(locationId, locationService_->getLocationById(locationId, userRoleIds)).first;
+        }
+        const std::optional<ERP::Catalog::DTO::LocationDTO>& location = it->second;
+        if (!location || location->status != ERP::Common::EntityStatus::ACTIVE || location->warehouseId != warehouseId) {
+            ERP::Logger::Logger::getInstance().warning("InventoryTransactionService: Invalid or inactive Location ID: " + locationId + " for warehouse " + warehouseId + ".");
+            ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "ID vị trí không hợp lệ hoặc không hoạt động.");
+            return std::nullopt;
+        }
+    }
+    for (const auto& unitOfMeasureId : unitOfMeasureIds) {
+        std::optional<ERP::Catalog::DTO::UnitOfMeasureDTO> uom = unitOfMeasureService_->getUnitOfMeasureById(unitOfMeasureId, userRoleIds);
+        if (!uom || uom->status != ERP::Common::EntityStatus::ACTIVE) {
+            ERP::Logger::Logger::getInstance().warning("InventoryTransactionService: Invalid or inactive Unit of Measure ID: " + unitOfMeasureId);
+            ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "ID đơn vị đo không hợp lệ hoặc không hoạt động.");
+            return std::nullopt;
+        }
+    }
+
+    std::vector<ERP::Warehouse::DTO::InventoryTransactionDTO> createdTransactions;
+    createdTransactions.reserve(transactionDTOs.size());
+    const auto now = ERP::Utils::DateUtils::now();
+    for (const auto& transactionDTO : transactionDTOs) {
+        ERP::Warehouse::DTO::InventoryTransactionDTO newTransaction = transactionDTO;
+        if (newTransaction.id.empty()) {
+            newTransaction.id = ERP::Utils::generateUUID(); // Callers may set the id to link other records to the line
+        }
+        newTransaction.createdAt = now;
+        newTransaction.createdBy = currentUserId;
+        newTransaction.status = ERP::Common::EntityStatus::ACTIVE; // Transactions are generally active upon creation
+        newTransaction.transactionDate = now; // Ensure date is current
+        createdTransactions.push_back(std::move(newTransaction));
+    }
+
+    bool success = executeTransaction(
+        [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
+            if (!inventoryTransactionDAO_->createMany(createdTransactions)) {
+                ERP::Logger::Logger::getInstance().error("InventoryTransactionService: Failed to create " + std::to_string(createdTransactions.size()) + " transactions in DAO.");
+                return false;
+            }
+            return true;
+        },
+        "InventoryTransactionService", "createInventoryTransactions"
+    );
+
+    if (success) {
+        ERP::Logger::Logger::getInstance().info("InventoryTransactionService: " + std::to_string(createdTransactions.size()) + " transactions created successfully.");
+        recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
+                       ERP::Security::DTO::AuditActionType::CREATE, ERP::Common::LogSeverity::INFO,
+                       "Warehouse", "InventoryTransactionBatch", createdTransactions.front().id, "InventoryTransaction", std::to_string(createdTransactions.size()) + " transactions",
+                       std::nullopt, std::nullopt, std::to_string(createdTransactions.size()) + " inventory transactions created.");
+        return createdTransactions;
+    }
+    return std::nullopt;
+}
+
 std::optional<ERP::Warehouse::DTO::InventoryTransactionDTO> InventoryTransactionService::getInventoryTransactionById(
     const std::string& transactionId,
     const std::vector<std::string>& userRoleIds) {
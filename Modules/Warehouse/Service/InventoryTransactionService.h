@@ -43,6 +43,19 @@ public:
         const ERP::Warehouse::DTO::InventoryTransactionDTO& transactionDTO,
         const std::string& currentUserId,
         const std::vector<std::string>& userRoleIds) = 0;
+    /**
+     * @brief Creates many inventory transaction records in one transaction.
+     * Each distinct product, warehouse, location and unit of measure is validated once, and the
+     * records are written with multi-row inserts. A DTO whose id is already set keeps it.
+     * @param transactionDTOs DTOs containing transaction details.
+     * @param currentUserId ID of the user performing the operation.
+     * @param userRoleIds Roles of the user.
+     * @return The created InventoryTransactionDTOs in input order, or std::nullopt if any line is invalid or the insert fails.
+     */
+    virtual std::optional<std::vector<ERP::Warehouse::DTO::InventoryTransactionDTO>> createInventoryTransactions(
+        const std::vector<ERP::Warehouse::DTO::InventoryTransactionDTO>& transactionDTOs,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds) = 0;
     /**
      * @brief Retrieves inventory transaction information by ID.
      * @param transactionId ID of the transaction to retrieve.
@@ -92,6 +105,10 @@ public:
         const ERP::Warehouse::DTO::InventoryTransactionDTO& transactionDTO,
         const std::string& currentUserId,
         const std::vector<std::string>& userRoleIds) override;
+    std::optional<std::vector<ERP::Warehouse::DTO::InventoryTransactionDTO>> createInventoryTransactions(
+        const std::vector<ERP::Warehouse::DTO::InventoryTransactionDTO>& transactionDTOs,
+        const std::string& currentUserId,
+        const std::vector<std::string>& userRoleIds) override;
     std::optional<ERP::Warehouse::DTO::InventoryTransactionDTO> getInventoryTransactionById(
         const std::string& transactionId,
         const std::vector<std::string>& userRoleIds = {}) override;
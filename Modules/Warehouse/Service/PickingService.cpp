@@ -19,12 +19,14 @@
 #include "SalesOrderService.h"      // SalesOrderService (for SO validation/updates)
 #include "CustomerService.h"        // CustomerService (for customer validation)
 #include "WarehouseService.h"       // WarehouseService (for warehouse validation)
+#include "LocationService.h"        // LocationService (for location validation)
 #include "ProductService.h"         // ProductService (for product validation)
 #include "InventoryManagementService.h" // InventoryManagementService (for goods issue)
 
 #include <sstream>
 #include <stdexcept>
 #include <algorithm> // For std::all_of if needed
+#include <map>       // For validation lookups
 
 namespace ERP {
     namespace Warehouse {
@@ -36,6 +38,7 @@ namespace ERP {
                 std::shared_ptr<ERP::Sales::Services::ISalesOrderService> salesOrderService,
                 std::shared_ptr<ERP::Customer::Services::ICustomerService> customerService,
                 std::shared_ptr<ERP::Catalog::Services::IWarehouseService> warehouseService,
+                std::shared_ptr<ERP::Catalog::Services::ILocationService> locationService,
                 std::shared_ptr<ERP::Product::Services::IProductService> productService,
                 std::shared_ptr<ERP::Warehouse::Services::IInventoryManagementService> inventoryManagementService,
                 std::shared_ptr<ERP::Security::Service::IAuthorizationService> authorizationService,
@@ -48,10 +51,11 @@ namespace ERP {
                 salesOrderService_(salesOrderService),
                 customerService_(customerService),
                 warehouseService_(warehouseService),
+                locationService_(locationService),
                 productService_(productService),
                 inventoryManagementService_(inventoryManagementService) {
 
-                if (!pickingRequestDAO_ || !pickingDetailDAO_ || !salesOrderService_ || !customerService_ || !warehouseService_ || !productService_ || !inventoryManagementService_ || !securityManager_) { // BaseService checks its own dependencies
+                if (!pickingRequestDAO_ || !pickingDetailDAO_ || !salesOrderService_ || !customerService_ || !warehouseService_ || !locationService_ || !productService_ || !inventoryManagementService_ || !securityManager_) { // BaseService checks its own dependencies
                     ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::ServerError, "PickingService: Initialized with null DAO or dependent services.", "Lỗi hệ thống trong quá trình khởi tạo dịch vụ lấy hàng.");
                     ERP::Logger::Logger::getInstance().critical("PickingService: One or more injected DAOs/Services are null.");
                     throw std::runtime_error("PickingService: Null dependencies.");
@@ -93,32 +97,9 @@ namespace ERP {
                     return std::nullopt;
                 }
 
-                // Validate details: Product existence, Location existence, quantities
-                for (const auto& detail : pickingDetails) {
-                    std::optional<ERP::Product::DTO::ProductDTO> product = productService_->getProductById(detail.productId, userRoleIds);
-                    if (!product || product->status != ERP::Common::EntityStatus::ACTIVE) {
-                        ERP::Logger::Logger::getInstance().warning("PickingService: Product " + detail.productId + " not found or not active in picking detail.");
-                        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Sản phẩm trong chi tiết lấy hàng không hợp lệ.");
-                        return std::nullopt;
-                    }
-                    std::optional<ERP::Catalog::DTO::LocationDTO> location = warehouseService_->getLocationById(detail.locationId, userRoleIds);
-                    if (!location || location->status != ERP::Common::EntityStatus::ACTIVE || location->warehouseId != detail.warehouseId) {
-                        ERP::Logger::Logger::getInstance().warning("PickingService: Location " + detail.locationId + " not found or not active or does not belong to warehouse " + detail.warehouseId + " in picking detail.");
-                        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Vị trí lấy hàng không hợp lệ.");
-                        return std::nullopt;
-                    }
-                    if (detail.requestedQuantity <= 0) {
-                        ERP::Logger::Logger::getInstance().warning("PickingService: Invalid requested quantity in picking detail for product " + detail.productId);
-                        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Số lượng yêu cầu trong chi tiết lấy hàng không hợp lệ.");
-                        return std::nullopt;
-                    }
-                    // Check if enough available inventory for picking
-                    std::optional<ERP::Warehouse::DTO::InventoryDTO> inventory = inventoryManagementService_->getInventoryByProductLocation(detail.productId, detail.warehouseId, detail.locationId, userRoleIds);
-                    if (!inventory || inventory->availableQuantity.value_or(0.0) < detail.requestedQuantity) {
-                        ERP::Logger::Logger::getInstance().warning("PickingService: Insufficient available stock for product " + detail.productId + " at " + detail.warehouseId + "/" + detail.locationId + ". Requested: " + std::to_string(detail.requestedQuantity) + ", Available: " + std::to_string(inventory->availableQuantity.value_or(0.0)));
-                        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InsufficientStock, "Không đủ tồn kho khả dụng để tạo yêu cầu lấy hàng.");
-                        return std::nullopt;
-                    }
+                // Validate details: Product existence, Location existence, quantities, available stock
+                if (!validatePickingDetails(pickingDetails, true, currentUserId, userRoleIds)) {
+                    return std::nullopt;
                 }
 
                 ERP::Warehouse::DTO::PickingRequestDTO newRequest = pickingRequestDTO;
@@ -137,7 +118,9 @@ namespace ERP {
                             ERP::Logger::Logger::getInstance().error("PickingService: Failed to create picking request in DAO.");
                             return false;
                         }
-                        // Save details and reserve inventory
+                        // Save details, then reserve inventory for all of them at once
+                        std::vector<InventoryReservationRequest> reservations;
+                        reservations.reserve(pickingDetails.size());
                         for (auto detail : pickingDetails) {
                             detail.id = ERP::Utils::generateUUID();
                             detail.pickingRequestId = newRequest.id;
@@ -152,11 +135,11 @@ namespace ERP {
                                 ERP::Logger::Logger::getInstance().error("PickingService: Failed to create picking detail for product " + detail.productId + ".");
                                 return false;
                             }
-                            // Reserve inventory for this picking request
-                            if (!inventoryManagementService_->reserveInventory(detail.productId, detail.warehouseId, detail.locationId, detail.requestedQuantity, currentUserId, userRoleIds)) {
-                                ERP::Logger::Logger::getInstance().error("PickingService: Failed to reserve inventory for product " + detail.productId + ".");
-                                return false;
-                            }
+                            reservations.push_back({detail.productId, detail.warehouseId, detail.locationId, detail.requestedQuantity});
+                        }
+                        if (!inventoryManagementService_->reserveMany(reservations, currentUserId, userRoleIds)) {
+                            ERP::Logger::Logger::getInstance().error("PickingService: Failed to reserve inventory for picking request " + newRequest.id + ".");
+                            return false;
                         }
                         createdRequest = newRequest;
                         // Optionally, publish event
@@ -280,27 +263,11 @@ namespace ERP {
                 }
 
                 // Validate each new detail
-                for (const auto& detail : pickingDetails) {
-                    std::optional<ERP::Product::DTO::ProductDTO> product = productService_->getProductById(detail.productId, userRoleIds);
-                    if (!product || product->status != ERP::Common::EntityStatus::ACTIVE) {
-                        ERP::Logger::Logger::getInstance().warning("PickingService: Product " + detail.productId + " not found or not active in new picking detail.");
-                        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Sản phẩm trong chi tiết lấy hàng không hợp lệ.");
-                        return std::nullopt;
-                    }
-                    std::optional<ERP::Catalog::DTO::LocationDTO> location = warehouseService_->getLocationById(detail.locationId, userRoleIds);
-                    if (!location || location->status != ERP::Common::EntityStatus::ACTIVE || location->warehouseId != detail.warehouseId) {
-                        ERP::Logger::Logger::getInstance().warning("PickingService: Location " + detail.locationId + " not found or not active or does not belong to warehouse " + detail.warehouseId + " in new picking detail.");
-                        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Vị trí lấy hàng không hợp lệ.");
-                        return std::nullopt;
-                    }
-                    if (detail.requestedQuantity <= 0) {
-                        ERP::Logger::Logger::getInstance().warning("PickingService: Invalid requested quantity in new picking detail for product " + detail.productId);
-                        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Số lượng yêu cầu trong chi tiết lấy hàng không hợp lệ.");
-                        return std::nullopt;
-                    }
-                    // If updating a detail with changed quantity, we need to adjust reservations. This is complex.
-                    // For simplicity, the current model assumes `recordPickedQuantity` handles inventory.
-                    // If `pickingDetails` is a full replacement, need to handle inventory differences here.
+                // If updating a detail with changed quantity, we need to adjust reservations. This is complex.
+                // For simplicity, the current model assumes `recordPickedQuantity` handles inventory.
+                // If `pickingDetails` is a full replacement, need to handle inventory differences here.
+                if (!validatePickingDetails(pickingDetails, false, currentUserId, userRoleIds)) {
+                    return false;
                 }
 
 
@@ -636,6 +603,73 @@ namespace ERP {
                 return false;
             }
 
+            bool PickingService::validatePickingDetails(
+                const std::vector<ERP::Warehouse::DTO::PickingDetailDTO>& pickingDetails,
+                bool checkStock,
+                const std::string& currentUserId,
+                const std::vector<std::string>& userRoleIds) {
+                // One bulk lookup per kind of reference instead of one call (and permission check) per detail
+                std::vector<std::string> productIds;
+                std::vector<std::string> locationIds;
+                std::vector<InventoryPositionKey> positionKeys;
+                productIds.reserve(pickingDetails.size());
+                locationIds.reserve(pickingDetails.size());
+                for (const auto& detail : pickingDetails) {
+                    productIds.push_back(detail.productId);
+                    locationIds.push_back(detail.locationId);
+                    if (checkStock) {
+                        positionKeys.push_back({detail.productId, detail.warehouseId, detail.locationId});
+                    }
+                }
+                std::map<std::string, ERP::Product::DTO::ProductDTO> products;
+                for (auto& product : productService_->getProductsByIds(productIds, currentUserId, userRoleIds)) {
+                    products.emplace(product.id, std::move(product));
+                }
+                std::map<std::string, ERP::Catalog::DTO::LocationDTO> locations;
+                for (auto& location : locationService_->getLocationsByIds(locationIds, currentUserId, userRoleIds)) {
+                    locations.emplace(location.id, std::move(location));
+                }
+                std::map<std::string, double> available; // Position key -> available quantity not yet requested by earlier details
+                if (checkStock) {
+                    for (const auto& inventory : inventoryManagementService_->getInventoryByKeys(positionKeys, currentUserId, userRoleIds)) {
+                        available[InventoryPositionCache::makeKey(inventory.productId, inventory.warehouseId, inventory.locationId)] = inventory.availableQuantity.value_or(0.0);
+                    }
+                }
+
+                for (const auto& detail : pickingDetails) {
+                    auto product = products.find(detail.productId);
+                    if (product == products.end() || product->second.status != ERP::Common::EntityStatus::ACTIVE) {
+                        ERP::Logger::Logger::getInstance().warning("PickingService: Product " + detail.productId + " not found or not active in picking detail.");
+                        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Sản phẩm trong chi tiết lấy hàng không hợp lệ.");
+                        return false;
+                    }
+                    auto location = locations.find(detail.locationId);
+                    if (location == locations.end() || location->second.status != ERP::Common::EntityStatus::ACTIVE || location->second.warehouseId != detail.warehouseId) {
+                        ERP::Logger::Logger::getInstance().warning("PickingService: Location " + detail.locationId + " not found or not active or does not belong to warehouse " + detail.warehouseId + " in picking detail.");
+                        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Vị trí lấy hàng không hợp lệ.");
+                        return false;
+                    }
+                    if (detail.requestedQuantity <= 0) {
+                        ERP::Logger::Logger::getInstance().warning("PickingService: Invalid requested quantity in picking detail for product " + detail.productId);
+                        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InvalidInput, "Số lượng yêu cầu trong chi tiết lấy hàng không hợp lệ.");
+                        return false;
+                    }
+                    if (!checkStock) {
+                        continue;
+                    }
+                    // Check if enough available inventory for picking
+                    auto stock = available.find(InventoryPositionCache::makeKey(detail.productId, detail.warehouseId, detail.locationId));
+                    const double availableQuantity = stock != available.end() ? stock->second : 0.0;
+                    if (availableQuantity < detail.requestedQuantity) {
+                        ERP::Logger::Logger::getInstance().warning("PickingService: Insufficient available stock for product " + detail.productId + " at " + detail.warehouseId + "/" + detail.locationId + ". Requested: " + std::to_string(detail.requestedQuantity) + ", Available: " + std::to_string(availableQuantity));
+                        ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::InsufficientStock, "Không đủ tồn kho khả dụng để tạo yêu cầu lấy hàng.");
+                        return false;
+                    }
+                    stock->second -= detail.requestedQuantity;
+                }
+                return true;
+            }
+
         } // namespace Services
     } // namespace Warehouse
 } // namespace ERP
\ No newline at end of file
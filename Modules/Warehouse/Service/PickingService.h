@@ -21,6 +21,7 @@
 #include "SalesOrderService.h"  // SalesOrder Service interface (dependency)
 #include "CustomerService.h"    // Customer Service interface (dependency)
 #include "WarehouseService.h"   // Warehouse Service interface (dependency)
+#include "LocationService.h"    // Location Service interface (dependency)
 #include "ProductService.h"     // Product Service interface (dependency)
 #include "InventoryManagementService.h" // Inventory Management Service interface (dependency)
 #include "ISecurityManager.h"   // Security Manager interface
@@ -35,6 +36,7 @@
 namespace ERP { namespace Customer { namespace Services { class ICustomerService; } } }
 namespace ERP { namespace Sales { namespace Services { class ISalesOrderService; } } }
 namespace ERP { namespace Catalog { namespace Services { class IWarehouseService; } } }
+namespace ERP { namespace Catalog { namespace Services { class ILocationService; } } }
 namespace ERP { namespace Product { namespace Services { class IProductService; } } }
 namespace ERP { namespace Warehouse { namespace Services { class IInventoryManagementService; } } }
 
@@ -178,6 +180,7 @@ namespace ERP {
                  * @param salesOrderService Shared pointer to ISalesOrderService (dependency).
                  * @param customerService Shared pointer to ICustomerService (dependency).
                  * @param warehouseService Shared pointer to IWarehouseService (dependency).
+                 * @param locationService Shared pointer to ILocationService (dependency).
                  * @param productService Shared pointer to IProductService (dependency).
                  * @param inventoryManagementService Shared pointer to IInventoryManagementService (dependency).
                  * @param authorizationService Shared pointer to IAuthorizationService.
@@ -190,6 +193,7 @@ namespace ERP {
                     std::shared_ptr<ERP::Sales::Services::ISalesOrderService> salesOrderService,
                     std::shared_ptr<ERP::Customer::Services::ICustomerService> customerService,
                     std::shared_ptr<ERP::Catalog::Services::IWarehouseService> warehouseService,
+                    std::shared_ptr<ERP::Catalog::Services::ILocationService> locationService,
                     std::shared_ptr<ERP::Product::Services::IProductService> productService,
                     std::shared_ptr<ERP::Warehouse::Services::IInventoryManagementService> inventoryManagementService,
                     std::shared_ptr<ERP::Security::Service::IAuthorizationService> authorizationService,
@@ -246,10 +250,23 @@ namespace ERP {
                 std::shared_ptr<ERP::Sales::Services::ISalesOrderService> salesOrderService_;
                 std::shared_ptr<ERP::Customer::Services::ICustomerService> customerService_;
                 std::shared_ptr<ERP::Catalog::Services::IWarehouseService> warehouseService_;
+                std::shared_ptr<ERP::Catalog::Services::ILocationService> locationService_;
                 std::shared_ptr<ERP::Product::Services::IProductService> productService_;
                 std::shared_ptr<ERP::Warehouse::Services::IInventoryManagementService> inventoryManagementService_;
                 // Inherited: authorizationService_, auditLogService_, connectionPool_, securityManager_
 
+                /**
+                 * @brief Validates picking details with one bulk lookup each for products, locations and, if
+                 * requested, inventory, instead of one lookup per detail.
+                 * @param checkStock If true, each position must have the quantity its details request available.
+                 * @return true if every detail is valid, false otherwise (the error has been reported).
+                 */
+                bool validatePickingDetails(
+                    const std::vector<ERP::Warehouse::DTO::PickingDetailDTO>& pickingDetails,
+                    bool checkStock,
+                    const std::string& currentUserId,
+                    const std::vector<std::string>& userRoleIds);
+
                 // EventBus is typically accessed as a singleton.
                 ERP::EventBus::EventBus& eventBus_ = ERP::EventBus::EventBus::getInstance();
             };
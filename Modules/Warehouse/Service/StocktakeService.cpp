@@ -18,10 +18,14 @@
 #include "InventoryManagementService.h" // InventoryManagementService (for adjustments)
 #include "WarehouseService.h"       // WarehouseService (for warehouse/location validation)
 #include "ProductService.h"         // ProductService (for product validation)
+#include "InventoryPositionCache.h"  // Position keys of the inventory snapshot
+#include "TaskEngine.h"              // For asynchronous reconciliation
 
 #include <sstream>
 #include <stdexcept>
 #include <algorithm> // For std::all_of if needed
+#include <cmath>     // For std::abs
+#include <unordered_map>
 
 namespace ERP {
     namespace Warehouse {
@@ -572,10 +576,21 @@ namespace ERP {
             bool StocktakeService::reconcileStocktake(
                 const std::string& requestId,
                 const std::string& currentUserId,
-                const std::vector<std::string>& userRoleIds) {
+                const std::vector<std::string>& userRoleIds,
+                const StocktakeReconciliationProgressCallback& onProgress) {
                 ERP::Logger::Logger::getInstance().info("StocktakeService: Attempting to reconcile stocktake request: " + requestId + " by " + currentUserId + ".");
 
+                StocktakeReconciliationProgress progress;
+                progress.requestId = requestId;
+                auto reportProgress = [&](StocktakeReconciliationPhase phase) {
+                    progress.phase = phase;
+                    if (onProgress) {
+                        onProgress(progress);
+                    }
+                };
+
                 if (!checkPermission(currentUserId, userRoleIds, "Warehouse.ReconcileStocktake", "Bạn không có quyền đối chiếu kiểm kê.")) {
+                    reportProgress(StocktakeReconciliationPhase::FAILED);
                     return false;
                 }
 
@@ -583,6 +598,7 @@ namespace ERP {
                 if (!requestOpt) {
                     ERP::Logger::Logger::getInstance().warning("StocktakeService: Stocktake request with ID " + requestId + " not found for reconciliation.");
                     ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::NotFound, "Không tìm thấy yêu cầu kiểm kê để đối chiếu.");
+                    reportProgress(StocktakeReconciliationPhase::FAILED);
                     return false;
                 }
 
@@ -590,63 +606,94 @@ namespace ERP {
                 if (stocktakeRequest.status != ERP::Warehouse::DTO::StocktakeRequestStatus::COUNTED) {
                     ERP::Logger::Logger::getInstance().warning("StocktakeService: Stocktake request " + requestId + " is not in COUNTED status. Current status: " + stocktakeRequest.getStatusString());
                     ERP::ErrorHandling::ErrorHandler::handle(ERP::Common::ErrorCode::OperationFailed, "Yêu cầu kiểm kê chưa được đếm xong hoặc không ở trạng thái 'Đã đếm'.");
+                    reportProgress(StocktakeReconciliationPhase::FAILED);
                     return false;
                 }
 
-                // Get all details for this stocktake request
-                std::vector<ERP::Warehouse::DTO::StocktakeDetailDTO> details = stocktakeDetailDAO_->getStocktakeDetailsByRequestId(requestId);
-
+                reportProgress(StocktakeReconciliationPhase::LOADING);
                 bool success = executeTransaction(
                     [&](std::shared_ptr<ERP::Database::DBConnection> db_conn) {
-                        for (auto& detail : details) {
-                            if (detail.difference != 0.0) {
-                                ERP::Logger::Logger::getInstance().info("StocktakeService: Reconciling difference for product " + detail.productId + " at " + detail.warehouseId + "/" + detail.locationId + ". Difference: " + std::to_string(detail.difference));
-
-                                ERP::Warehouse::DTO::InventoryTransactionDTO invTxn;
-                                invTxn.id = ERP::Utils::generateUUID();
-                                invTxn.productId = detail.productId;
-                                invTxn.warehouseId = detail.warehouseId;
-                                invTxn.locationId = detail.locationId;
-                                invTxn.transactionDate = ERP::Utils::DateUtils::now();
-                                invTxn.referenceDocumentId = stocktakeRequest.id;
-                                invTxn.referenceDocumentType = "Stocktake";
-                                invTxn.notes = "Inventory adjustment from Stocktake " + stocktakeRequest.id;
-                                invTxn.status = ERP::Common::EntityStatus::ACTIVE;
-                                invTxn.createdAt = ERP::Utils::DateUtils::now();
-                                invTxn.createdBy = currentUserId;
-
-                                if (detail.difference > 0) { // System quantity > Counted quantity (Shortage) -> Adjustment Out
-                                    invTxn.type = ERP::Warehouse::DTO::InventoryTransactionType::ADJUSTMENT_OUT;
-                                    invTxn.quantity = std::abs(detail.difference);
-                                    // Get current unit cost from inventory for adjustment
-                                    std::optional<ERP::Warehouse::DTO::InventoryDTO> currentInv = inventoryManagementService_->getInventoryByProductLocation(detail.productId, detail.warehouseId, detail.locationId, userRoleIds);
-                                    invTxn.unitCost = currentInv ? currentInv->unitCost : 0.0;
-
-                                    if (!inventoryManagementService_->adjustInventory(invTxn, currentUserId, userRoleIds)) {
-                                        ERP::Logger::Logger::getInstance().error("StocktakeService: Failed to post ADJUSTMENT_OUT for detail " + detail.id + ".");
-                                        return false;
-                                    }
-                                }
-                                else if (detail.difference < 0) { // System quantity < Counted quantity (Overage) -> Adjustment In
-                                    invTxn.type = ERP::Warehouse::DTO::InventoryTransactionType::ADJUSTMENT_IN;
+                        // Step 1: The details and a snapshot of the counted warehouse (or location), one query each
+                        std::vector<ERP::Warehouse::DTO::StocktakeDetailDTO> details = stocktakeDetailDAO_->getStocktakeDetailsByRequestId(requestId);
+                        std::map<std::string, std::any> inventoryFilter;
+                        inventoryFilter["warehouse_id"] = stocktakeRequest.warehouseId;
+                        if (stocktakeRequest.locationId) {
+                            inventoryFilter["location_id"] = *stocktakeRequest.locationId;
+                        }
+                        std::unordered_map<std::string, double> snapshot; // Position key -> quantity on hand
+                        for (const auto& inventory : inventoryManagementService_->getAllInventory(inventoryFilter, userRoleIds)) {
+                            snapshot[InventoryPositionCache::makeKey(inventory.productId, inventory.warehouseId, inventory.locationId)] += inventory.quantity;
+                        }
+                        progress.totalLines = details.size();
+                        reportProgress(StocktakeReconciliationPhase::DIFFING);
+
+                        // Step 2: Diff every position against the snapshot in one pass.
+                        // A position counted on several lines (e.g. split count sheets) is diffed once, against the sum
+                        // of its counts; its other lines share that result and adjustment.
+                        // A shortage is costed from the cost layers when posted; an overage at the product's purchase price.
+                        std::unordered_map<std::string, double> countedByPosition;
+                        for (const auto& detail : details) {
+                            countedByPosition[InventoryPositionCache::makeKey(detail.productId, detail.warehouseId, detail.locationId)] += detail.countedQuantity;
+                        }
+                        std::unordered_map<std::string, std::size_t> firstLineOfPosition;
+                        std::vector<ERP::Warehouse::DTO::InventoryTransactionDTO> adjustments;
+                        std::unordered_map<std::string, double> purchasePrices; // Product -> unit cost of adjustments in
+                        const auto now = ERP::Utils::DateUtils::now();
+                        for (std::size_t i = 0; i < details.size(); ++i) {
+                            auto& detail = details[i];
+                            const std::string positionKey = InventoryPositionCache::makeKey(detail.productId, detail.warehouseId, detail.locationId);
+                            auto [firstIt, firstLine] = firstLineOfPosition.try_emplace(positionKey, i);
+                            if (!firstLine) {
+                                const auto& first = details[firstIt->second];
+                                detail.systemQuantity = first.systemQuantity;
+                                detail.difference = first.difference;
+                                detail.adjustmentTransactionId = first.adjustmentTransactionId;
+                            } else {
+                                auto it = snapshot.find(positionKey);
+                                detail.systemQuantity = it != snapshot.end() ? it->second : 0.0;
+                                detail.difference = detail.systemQuantity - countedByPosition[positionKey];
+                                if (detail.difference != 0.0) {
+                                    ERP::Warehouse::DTO::InventoryTransactionDTO invTxn;
+                                    invTxn.id = ERP::Utils::generateUUID();
+                                    invTxn.productId = detail.productId;
+                                    invTxn.warehouseId = detail.warehouseId;
+                                    invTxn.locationId = detail.locationId;
                                     invTxn.quantity = std::abs(detail.difference);
-                                    // For adjustment in, cost might be standard cost or zero, depending on policy.
-                                    // For simplicity, using 0.0 or product's last purchase cost.
-                                    std::optional<ERP::Product::DTO::ProductDTO> product = productService_->getProductById(detail.productId, userRoleIds);
-                                    invTxn.unitCost = product ? product->purchasePrice.value_or(0.0) : 0.0;
-
-                                    if (!inventoryManagementService_->adjustInventory(invTxn, currentUserId, userRoleIds)) {
-                                        ERP::Logger::Logger::getInstance().error("StocktakeService: Failed to post ADJUSTMENT_IN for detail " + detail.id + ".");
-                                        return false;
+                                    invTxn.transactionDate = now;
+                                    invTxn.referenceDocumentId = stocktakeRequest.id;
+                                    invTxn.referenceDocumentType = "Stocktake";
+                                    invTxn.notes = "Inventory adjustment from Stocktake " + stocktakeRequest.id;
+                                    if (detail.difference > 0) { // System quantity > Counted quantity (Shortage) -> Adjustment Out
+                                        invTxn.type = ERP::Warehouse::DTO::InventoryTransactionType::ADJUSTMENT_OUT;
+                                    } else { // System quantity < Counted quantity (Overage) -> Adjustment In
+                                        invTxn.type = ERP::Warehouse::DTO::InventoryTransactionType::ADJUSTMENT_IN;
+                                        auto priceIt = purchasePrices.find(detail.productId);
+                                        if (priceIt == purchasePrices.end()) {
+                                            std::optional<ERP::Product::DTO::ProductDTO> product = productService_->getProductById(detail.productId, userRoleIds);
+                                            priceIt = purchasePrices.emplace(detail.productId, product ? product->purchasePrice.value_or(0.0) : 0.0).first;
+                                        }
+                                        invTxn.unitCost = priceIt->second;
                                     }
-                                }
-                                // Link transaction ID to stocktake detail
-                                detail.adjustmentTransactionId = invTxn.id;
-                                if (!stocktakeDetailDAO_->update(detail)) { // Update the detail with transaction ID
-                                    ERP::Logger::Logger::getInstance().error("StocktakeService: Failed to update stocktake detail with adjustment transaction ID.");
-                                    return false;
+                                    detail.adjustmentTransactionId = invTxn.id; // Kept by the batch insert
+                                    adjustments.push_back(std::move(invTxn));
                                 }
                             }
+                            if (++progress.processedLines % RECONCILIATION_PROGRESS_INTERVAL == 0) {
+                                progress.adjustmentLines = adjustments.size();
+                                reportProgress(StocktakeReconciliationPhase::DIFFING);
+                            }
+                        }
+                        progress.adjustmentLines = adjustments.size();
+                        reportProgress(StocktakeReconciliationPhase::APPLYING);
+
+                        // Step 3: Post every adjustment as one batch (cost layers included), then write the details back
+                        if (!inventoryManagementService_->recordInventoryMovements(adjustments, currentUserId, userRoleIds)) {
+                            ERP::Logger::Logger::getInstance().error("StocktakeService: Failed to post " + std::to_string(adjustments.size()) + " stocktake adjustments.");
+                            return false;
+                        }
+                        if (!stocktakeDetailDAO_->updateReconciliationResults(details, currentUserId)) {
+                            ERP::Logger::Logger::getInstance().error("StocktakeService: Failed to update stocktake details with reconciliation results.");
+                            return false;
                         }
 
                         // Update Stocktake Request status to RECONCILED
@@ -664,16 +711,32 @@ namespace ERP {
                 );
 
                 if (success) {
-                    ERP::Logger::Logger::getInstance().info("StocktakeService: Stocktake request " + requestId + " reconciled successfully.");
+                    ERP::Logger::Logger::getInstance().info("StocktakeService: Stocktake request " + requestId + " reconciled successfully. " + std::to_string(progress.adjustmentLines) + " of " + std::to_string(progress.totalLines) + " lines adjusted.");
                     recordAuditLog(currentUserId, securityManager_->getUserService()->getUserName(currentUserId), getCurrentSessionId(),
                         ERP::Security::DTO::AuditActionType::PROCESS_END, ERP::Common::LogSeverity::INFO, // Could be specialized activity type
                         "Warehouse", "StocktakeReconciliation", requestId, "StocktakeRequest", stocktakeRequest.warehouseId + "/" + stocktakeRequest.locationId.value_or("All"),
-                        stocktakeRequest.toMap(), stocktakeRequest.toMap(), "Stocktake reconciled. Adjustments posted.");
+                        stocktakeRequest.toMap(), stocktakeRequest.toMap(), "Stocktake reconciled. " + std::to_string(progress.adjustmentLines) + " adjustments posted.");
+                    reportProgress(StocktakeReconciliationPhase::COMPLETED);
                     return true;
                 }
+                reportProgress(StocktakeReconciliationPhase::FAILED);
                 return false;
             }
 
+            std::future<bool> StocktakeService::reconcileStocktakeAsync(
+                const std::string& requestId,
+                const std::string& currentUserId,
+                const std::vector<std::string>& userRoleIds,
+                StocktakeReconciliationProgressCallback onProgress) {
+                ERP::Logger::Logger::getInstance().info("StocktakeService: Queuing reconciliation of stocktake request: " + requestId + ".");
+                // A full-warehouse count runs for a while; interactive tasks go first
+                return ERP::TaskEngine::TaskEngine::getInstance().submit("StocktakeReconciliation_" + requestId,
+                    [this, requestId, currentUserId, userRoleIds, onProgress = std::move(onProgress)]() {
+                        return reconcileStocktake(requestId, currentUserId, userRoleIds, onProgress);
+                    },
+                    ERP::TaskEngine::TaskPriority::LOW);
+            }
+
         } // namespace Services
     } // namespace Warehouse
 } // namespace ERP
\ No newline at end of file
@@ -94,6 +94,11 @@ void InventoryManagementWidget::setupUI() {
     connect(inventoryTable_, &QTableWidget::itemClicked, this, &InventoryManagementWidget::onInventoryTableItemClicked);
     mainLayout->addWidget(inventoryTable_);
 
+    loadMoreButton_ = new QPushButton("Tải thêm", this);
+    loadMoreButton_->setEnabled(false);
+    connect(loadMoreButton_, &QPushButton::clicked, this, &InventoryManagementWidget::loadMoreInventory);
+    mainLayout->addWidget(loadMoreButton_);
+
     // Form elements for displaying inventory details (read-only)
     QGridLayout *formLayout = new QGridLayout();
     idLineEdit_ = new QLineEdit(this); idLineEdit_->setReadOnly(true);
@@ -157,12 +162,27 @@ void InventoryManagementWidget::setupUI() {
 void InventoryManagementWidget::loadInventory() {
     ERP::Logger::Logger::getInstance().info("InventoryManagementWidget: Loading inventory...");
     inventoryTable_->setRowCount(0); // Clear existing rows
+    nextInventoryPage_ = ERP::DAOBase::PageRequest();
+    nextInventoryPage_.pageSize = INVENTORY_PAGE_SIZE;
+    appendInventoryPage();
+    ERP::Logger::Logger::getInstance().info("InventoryManagementWidget: Inventory loaded successfully.");
+}
 
-    std::vector<ERP::Warehouse::DTO::InventoryDTO> inventories = inventoryService_->getInventory({}, currentUserId_, currentUserRoleIds_);
+void InventoryManagementWidget::loadMoreInventory() {
+    appendInventoryPage();
+}
 
-    inventoryTable_->setRowCount(inventories.size());
-    for (int i = 0; i < inventories.size(); ++i) {
-        const auto& inventory = inventories[i];
+void InventoryManagementWidget::appendInventoryPage() {
+    // Only one page is fetched per call; the "Tải thêm" button fetches the next one
+    ERP::DAOBase::Page<ERP::Warehouse::DTO::InventoryDTO> page =
+        inventoryService_->getInventoryPage({}, nextInventoryPage_, currentUserId_, currentUserRoleIds_);
+    const std::vector<ERP::Warehouse::DTO::InventoryDTO>& inventories = page.items;
+
+    int firstRow = inventoryTable_->rowCount();
+    inventoryTable_->setRowCount(firstRow + static_cast<int>(inventories.size()));
+    for (int n = 0; n < static_cast<int>(inventories.size()); ++n) {
+        const int i = firstRow + n;
+        const auto& inventory = inventories[n];
         
         QString productName = "N/A";
         std::optional<ERP::Product::DTO::ProductDTO> product = productService_->getProductById(inventory.productId, currentUserId_, currentUserRoleIds_);
@@ -194,7 +214,9 @@ void InventoryManagementWidget::loadInventory() {
         inventoryTable_->item(i, 3)->setData(Qt::UserRole+1, QString::fromStdString(inventory.id)); // Store Inventory ID
     }
     inventoryTable_->resizeColumnsToContents();
-    ERP::Logger::Logger::getInstance().info("InventoryManagementWidget: Inventory loaded successfully.");
+
+    nextInventoryPage_ = page.nextRequest(nextInventoryPage_);
+    loadMoreButton_->setEnabled(page.hasMore);
 }
 
 void InventoryManagementWidget::populateProductComboBox(QComboBox* comboBox) {
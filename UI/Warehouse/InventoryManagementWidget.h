@@ -38,6 +38,7 @@
 #include "Product.h"                    // Product DTO (for display)
 #include "Warehouse.h"                  // Warehouse DTO (for display)
 #include "Location.h"                   // Location DTO (for display)
+#include "DAOBase/Paging.h"             // PageRequest for paged loading
 
 
 namespace ERP {
@@ -71,6 +72,7 @@ public:
 
 private slots:
     void loadInventory();
+    void loadMoreInventory();
     void onRecordGoodsReceiptClicked();
     void onRecordGoodsIssueClicked();
     void onAdjustInventoryClicked();
@@ -89,6 +91,9 @@ private:
     std::vector<std::string> currentUserRoleIds_;
 
     QTableWidget *inventoryTable_;
+    QPushButton *loadMoreButton_;
+    ERP::DAOBase::PageRequest nextInventoryPage_; // Cursor of the next page to load
+    static constexpr std::size_t INVENTORY_PAGE_SIZE = 200;
     QPushButton *recordGoodsReceiptButton_;
     QPushButton *recordGoodsIssueButton_;
     QPushButton *adjustInventoryButton_;
@@ -118,6 +123,7 @@ private:
 
     // Helper functions
     void setupUI();
+    void appendInventoryPage();
     void populateProductComboBox(QComboBox* comboBox);
     void populateWarehouseComboBox(QComboBox* comboBox);
     void populateLocationComboBox(QComboBox* comboBox, const std::string& warehouseId = "");
@@ -52,6 +52,7 @@
 #include "ScheduledTaskDAO.h"
 #include "TaskExecutionLogDAO.h"
 #include "TaskLogDAO.h"
+#include "Modules/TaskEngine/DAO/JobQueueDAO.h"
 
 // Services Interfaces
 #include "IAuthenticationService.h"
@@ -147,6 +148,7 @@
 #include "ScheduledTaskService.h"
 #include "TaskExecutionLogService.h"
 #include "TaskEngine.h" // Singleton
+#include "JobQueue.h"   // Durable jobs on the TaskEngine
 
 // Utilities and Common
 #include "Logger.h"
@@ -223,21 +225,33 @@ int main(int argc, char* argv[]) {
     ERP::Database::DTO::DatabaseConfig dbConfig;
     dbConfig.type = ERP::Database::DTO::DatabaseType::SQLite;
     dbConfig.database = "erp_manufacturing.db"; // SQLite database file
+    dbConfig.readWriteSplit = true; // One writer, read-only readers for reports and lookups (WAL)
 
     try {
         ERP::Database::DatabaseInitializer dbInitializer(dbConfig);
         if (!dbInitializer.initializeDatabase()) {
             QMessageBox::critical(nullptr, "Lỗi Khởi Tạo Cơ Sở Dữ Liệu", "Không thể khởi tạo cơ sở dữ liệu. Vui lòng kiểm tra log.");
-            ERP::Logger::Logger::getInstance().critical("main", "Database initialization failed. Exiting.");
+            ERP::Logger::Logger::getInstance().critical("Database initialization failed. Exiting.", "main");
             return 1;
         }
+        // Diagnostics command: report which hot queries are served by an index, then exit.
+        if (QApplication::arguments().contains("--db-diagnostics")) {
+            std::vector<ERP::Database::QueryPlanReport> reports = dbInitializer.runIndexDiagnostics();
+            int scans = 0;
+            for (const auto& report : reports) {
+                if (!report.usesIndex) ++scans;
+            }
+            ERP::Logger::Logger::getInstance().info("Index diagnostics: " + std::to_string(reports.size() - scans) + " of " +
+                                                    std::to_string(reports.size()) + " probed queries use an index.", "main");
+            return scans == 0 ? 0 : 2;
+        }
         // Initialize the ConnectionPool with the config
         ERP::Database::ConnectionPool::getInstance().initialize(dbConfig);
-        ERP::Logger::Logger::getInstance().info("main", "Database connection pool initialized.");
+        ERP::Logger::Logger::getInstance().info("Database connection pool initialized.", "main");
 
     } catch (const std::exception& e) {
         QMessageBox::critical(nullptr, "Lỗi Cơ Sở Dữ Liệu", QString("Lỗi nghiêm trọng khi kết nối/khởi tạo cơ sở dữ liệu: %1").arg(e.what()));
-        ERP::Logger::Logger::getInstance().critical("main", "Critical database error: " + std::string(e.what()));
+        ERP::Logger::Logger::getInstance().critical("Critical database error: " + std::string(e.what()), "main");
         return 1;
     }
 
@@ -286,6 +300,7 @@ int main(int argc, char* argv[]) {
     auto scheduledTaskDAO = std::make_shared<ERP::Scheduler::DAOs::ScheduledTaskDAO>(ERP::Database::ConnectionPool::getInstancePtr());
     auto taskExecutionLogDAO = std::make_shared<ERP::Scheduler::DAOs::TaskExecutionLogDAO>(ERP::Database::ConnectionPool::getInstancePtr());
     auto taskLogDAO = std::make_shared<ERP::TaskEngine::DAOs::TaskLogDAO>(ERP::Database::ConnectionPool::getInstancePtr());
+    auto jobQueueDAO = std::make_shared<ERP::TaskEngine::DAOs::JobQueueDAO>(ERP::Database::ConnectionPool::getInstancePtr());
 
     // Core Services / Singletons (should be initialized first as they are fundamental)
     auto auditLogService = std::make_shared<ERP::Security::Service::AuditLogService>(auditLogDAO, ERP::Database::ConnectionPool::getInstancePtr());
@@ -343,7 +358,7 @@ int main(int argc, char* argv[]) {
     // ERP_Warehouse_Services (depend on Product, Catalog, Sales, Security)
     auto inventoryTransactionService = std::make_shared<ERP::Warehouse::Services::InventoryTransactionService>(inventoryTransactionDAO, productService, warehouseService, locationService, authorizationService, auditLogService, ERP::Database::ConnectionPool::getInstancePtr(), securityManager);
     auto inventoryManagementService = std::make_shared<ERP::Warehouse::Services::IInventoryManagementService>(inventoryDAO, inventoryCostLayerDAO, productService, warehouseService, locationService, inventoryTransactionService, authorizationService, auditLogService, ERP::Database::ConnectionPool::getInstancePtr(), securityManager);
-    auto pickingService = std::make_shared<ERP::Warehouse::Services::IPickingService>(pickingRequestDAO, pickingDetailDAO, salesOrderService, customerService, warehouseService, productService, inventoryManagementService, authorizationService, auditLogService, ERP::Database::ConnectionPool::getInstancePtr(), securityManager);
+    auto pickingService = std::make_shared<ERP::Warehouse::Services::IPickingService>(pickingRequestDAO, pickingDetailDAO, salesOrderService, customerService, warehouseService, locationService, productService, inventoryManagementService, authorizationService, auditLogService, ERP::Database::ConnectionPool::getInstancePtr(), securityManager);
     auto stocktakeService = std::make_shared<ERP::Warehouse::Services::IStocktakeService>(stocktakeRequestDAO, stocktakeDetailDAO, inventoryManagementService, warehouseService, productService, authorizationService, auditLogService, ERP::Database::ConnectionPool::getInstancePtr(), securityManager);
     
     // ERP_Material_Services (depend on Product, Catalog, Warehouse, Manufacturing, Security)
@@ -445,7 +460,9 @@ int main(int argc, char* argv[]) {
 
 
     ERP::TaskEngine::TaskEngine::getInstance().start();
-    ERP::Logger::Logger::getInstance().info("main", "TaskEngine stopped.");
+    ERP::Logger::Logger::getInstance().info("TaskEngine stopped.", "main");
+    auto jobQueue = std::make_shared<ERP::TaskEngine::JobQueue>(jobQueueDAO);
+    jobQueue->start(); // Returns jobs left leased by the previous run to the queue
 
     // --- UI Initialization ---
     // Create UI widgets, passing necessary service dependencies
@@ -528,11 +545,15 @@ int main(int argc, char* argv[]) {
     int execResult = a.exec();
 
     // --- Cleanup ---
+    auditLogService->flush(); // Pending audit entries must reach the database before the pool goes away
+    jobQueue->stop(); // Before the TaskEngine, so running jobs can finish
     ERP::TaskEngine::TaskEngine::getInstance().stop();
-    ERP::Logger::Logger::getInstance().info("main", "TaskEngine stopped.");
+    ERP::Logger::Logger::getInstance().info("TaskEngine stopped.", "main");
+    ERP::EventBus::EventBus::getInstance().shutdown(); // Delivers events still queued for asynchronous subscribers
     ERP::Database::ConnectionPool::getInstance().shutdown();
-    ERP::Logger::Logger::getInstance().info("main", "Database connection pool shut down.");
+    ERP::Logger::Logger::getInstance().info("Database connection pool shut down.", "main");
     ERP::Logger::Logger::getInstance().info("Application exited.");
+    ERP::Logger::Logger::getInstance().shutdown(); // Writes the messages still in the log buffer
 
     return execResult;
 }
\ No newline at end of file